@@ -9,9 +9,12 @@
     - GoPlayer is a base class for players
     - GoGame represents a game with a tree of game nodes
     - The regions code represents some higher level objects on the board
-      (GoRegion, GoBlock, GoChain, GoRegionBoard, GoRegionUtil)
+      (GoRegion, GoBlock, GoChain, GoRegionBoard, GoRegionUtil);
+      GoRegionBoardSynchronizer keeps a GoRegionBoard up to date with the
+      moves of a GoBoard
     - The static safety solver code is based on regions (GoBensonSolver,
-      GoSafetySolver, GoStaticSafetySolver, GoSafetyUtil)
+      GoSafetySolver, GoStaticSafetySolver, GoSafetyUtil); GoSafetyCache
+      caches the results of the solvers
     - GoGtpEngine is a GtpEngine which contains a GoBoard, GoPlayer and GoGame
 
     @section godependencies Dependencies
@@ -5,17 +5,19 @@
 #include "SgSystem.h"
 #include "FeBasicFeatures.h"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include "FePatternBase.h"
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
-#include "GoLadder.h"
+#include "GoLadderCache.h"
 #include "GoOpeningKnowledge.h"
 #include "GoPattern12Point.h"
 #include "GoPattern3x3.h"
-#include "GoSafetySolver.h"
+#include "GoSafetyCache.h"
 #include "GoSetupUtil.h"
+#include "SgPointArray.h"
 #include "SgPointSet.h"
 #include "SgWrite.h"
 
@@ -26,7 +28,11 @@ using SgPointUtil::Pt;
 //----------------------------------------------------------------------------
 namespace {
 
-
+/** The ladder reader shared with the move filter and the knowledge. */
+inline GoLadderCache& Ladders()
+{
+    return GoLadderCache::Global();
+}
 
 inline FeBasicFeature ComputeFeature(FeBasicFeature baseFeature,
                                      int baseValue, int value)
@@ -138,7 +144,7 @@ void FindCaptureFeatures(const GoBoard& bd, SgPoint anchor,
     else // other capture
     {
         const GoLadderStatus ls =
-              GoLadderUtil::LadderStatus(bd, anchor);
+              Ladders().LadderStatus(bd, anchor);
         f = (ls == GO_LADDER_CAPTURED) ? FE_CAPTURE_LADDER
                                        : FE_CAPTURE_NOT_LADDER;
         features.Set(f);
@@ -149,7 +155,7 @@ void FindExtensionFeatures(const GoBoard& bd, SgPoint anchor,
                            FeMoveFeatures& features)
 {
     SG_ASSERT(bd.NumLiberties(anchor) == 1);
-    GoLadderStatus ls = GoLadderUtil::LadderStatus(bd, anchor);
+    GoLadderStatus ls = Ladders().LadderStatus(bd, anchor);
     if (ls == GO_LADDER_CAPTURED)
         features.Set(FE_EXTENSION_LADDER);
     else
@@ -172,7 +178,7 @@ void FindAtariFeatures(const GoBoard& bd, SgPoint anchor,
     SG_ASSERT(bd.IsLibertyOfBlock(move, anchor));
               
     bool hasFeature = false;
-    if (GoLadderUtil::IsLadderCaptureMove(bd, anchor, move))
+    if (Ladders().IsLadderCaptureMove(bd, anchor, move))
     {
         features.Set(FE_ATARI_LADDER);
         SetStoneFeature(bd, move, bd.Opponent(), FE_KILL_STONES_1, features);
@@ -343,7 +349,7 @@ inline void TryLadderEscapeMove(const GoBoard& bd, SgPoint anchor,
     if (! tried.Contains(move))
     {
         tried.PushBack(move);
-        if (GoLadderUtil::IsLadderEscapeMove(bd, anchor, move))
+        if (Ladders().IsLadderEscapeMove(bd, anchor, move))
             works.PushBack(move);
     }
 }
@@ -396,7 +402,7 @@ void CheckSelfLadder(const GoBoard& bd, SgPoint anchor,
     //    FE_TWO_LIB_SELF_LADDER
     const SgBlackWhite toPlay = bd.ToPlay();
     for (GoBoard::LibertyCopyIterator it(bd, anchor); it; ++it)
-        if (! GoLadderUtil::IsLadderEscapeMove(bd, anchor, *it))
+        if (! Ladders().IsLadderEscapeMove(bd, anchor, *it))
         {
             features[*it].Set(FE_TWO_LIB_SELF_LADDER);
             SetStoneFeature(bd, *it, toPlay, FE_KILL_OWN_STONES_1,
@@ -414,7 +420,8 @@ bool WouldBeLadderCaptured(const GoBoard& constBd, SgPoint move)
     SG_ASSERT(bd.NumEmptyNeighbors(move) == 2);
     SG_ASSERT(bd.NumNeighbors(move, toPlay) == 0);
     bd.Play(move);
-    const bool wouldBeCaptured = GoLadderUtil::Ladder(bd, move, opponent);
+    const bool wouldBeCaptured =
+        Ladders().IsLadderCaptured(bd, move, opponent);
     bd.Undo();
     return wouldBeCaptured;
 }
@@ -428,16 +435,15 @@ void CheckProtectedLiberty(const GoBoard& bd,
     SG_UNUSED(byLadder);
     bool isKoCut;
     const bool isOurProtected =
-    GoLadderUtil::IsProtectedLiberty(bd, p, toPlay,
-                                     byLadder, isKoCut, true);
+    Ladders().IsProtectedLiberty(bd, p, toPlay, byLadder, isKoCut, true);
     if (isOurProtected)
         features[p].Set(FE_OUR_PROTECTED_LIBERTY);
     else if (isKoCut)
         features[p].Set(FE_OUR_CUT_WITH_KO);
 
     const bool isOppProtected =
-    GoLadderUtil::IsProtectedLiberty(bd, p, SgOppBW(toPlay),
-                                     byLadder, isKoCut, true);
+    Ladders().IsProtectedLiberty(bd, p, SgOppBW(toPlay), byLadder, isKoCut,
+                                 true);
     if (isOppProtected)
     {
         features[p].Set(FE_OPP_PROTECTED_LIBERTY);
@@ -484,7 +490,7 @@ void FindOwn2LibFeatures(const GoBoard& bd, SgPoint anchor,
     SgPoint toEscape(SG_NULLPOINT);
 
     const GoLadderStatus status =
-    GoLadderUtil::LadderStatus(bd, anchor, false, &toCapture, &toEscape);
+    Ladders().LadderStatus(bd, anchor, false, &toCapture, &toEscape);
     if (status == GO_LADDER_UNSETTLED)
     {
         SG_ASSERT(toEscape != SG_NULLPOINT);
@@ -574,7 +580,7 @@ void FindCutConnectFeatures(const GoBoard& bd, SgPoint anchor,
     const SgBlackWhite color = bd.GetStone(anchor);
     for (GoBoard::LibertyCopyIterator it(bd, anchor); it; ++it)
         if (  bd.NumNeighbors(*it, color) > 1
-           && ! GoLadderUtil::IsProtectedLiberty(bd, *it, color)
+           && ! Ladders().IsProtectedLiberty(bd, *it, color)
            )
             CheckCutConnect(bd, anchor, color, *it, features);
 }
@@ -659,8 +665,7 @@ void FindSafeTerritoryFeatures(const GoBoard& bd,
     //FE_SAFE_TERRITORY_OPP_KO,  // play in opponent territory, active ko
 
     SgBWSet safe;
-    GoSafetySolver safetySolver(bd);
-    safetySolver.FindSafePoints(&safe);
+    GoSafetyCache::Global().FindSafePoints(bd, &safe);
     if (! safe.BothEmpty())
     {
         const bool isKo = bd.KoPoint() != SG_NULLPOINT;
@@ -843,21 +848,46 @@ void FindDistPrevMoveFeatures(const GoBoard& bd,
         SetDistances2ndLastMove(lastMove2, legalBoardMoves, features);
 }
 
-int FindClosestStoneDistance(const GoBoard& bd,
-                             SgPoint empty, SgBlackWhite color)
+/** Update distance[p] from the neighbor of p in direction dir. */
+inline void RelaxDistance(SgPointArray<int>& distance, SgPoint p, int dir,
+                          int stepCost)
 {
-    int distance = 99999;
+    distance[p] = std::min(distance[p], distance[p + dir] + stepCost);
+}
 
-    for (GoBoard::Iterator it(bd); it; ++it) // @todo: slow, loop from
-                                             // closest to furtherst instead
-        if (  bd.GetColor(*it) == color
-           && Distance(empty, *it) < distance)
+/** Compute Distance() from each point to the closest stone of a color.
+    Two-pass chamfer distance transform with cost 2 for orthogonal steps
+    and 3 for diagonal steps. The cheapest path with these steps between
+    two points costs dx + dy + max(dx, dy), which is exactly Distance(), and
+    two raster passes find it for all points in O(size * size), instead of
+    comparing every empty point with every stone. */
+void FindClosestStoneDistances(const GoBoard& bd, SgBlackWhite color,
+                               SgPointArray<int>& distance)
+{
+    const int INFINITE_DISTANCE = 99999;
+    distance.Fill(INFINITE_DISTANCE); // also off-board neighbors
+    for (GoBoard::Iterator it(bd); it; ++it)
+        if (bd.GetColor(*it) == color)
+            distance[*it] = 0;
+    const int size = bd.Size();
+    for (int row = 1; row <= size; ++row)
+        for (int col = 1; col <= size; ++col)
         {
-            distance = Distance(empty, *it);
+            const SgPoint p = SgPointUtil::Pt(col, row);
+            RelaxDistance(distance, p, -SG_WE, 2);
+            RelaxDistance(distance, p, -SG_NS, 2);
+            RelaxDistance(distance, p, -SG_NS - SG_WE, 3);
+            RelaxDistance(distance, p, -SG_NS + SG_WE, 3);
+        }
+    for (int row = size; row >= 1; --row)
+        for (int col = size; col >= 1; --col)
+        {
+            const SgPoint p = SgPointUtil::Pt(col, row);
+            RelaxDistance(distance, p, SG_WE, 2);
+            RelaxDistance(distance, p, SG_NS, 2);
+            RelaxDistance(distance, p, SG_NS + SG_WE, 3);
+            RelaxDistance(distance, p, SG_NS - SG_WE, 3);
         }
-
-    SG_ASSERT(distance < 99999);
-    return distance;
 }
 
 void FindClosestDistanceFeaturesForColor(const GoBoard& bd,
@@ -869,9 +899,11 @@ void FindClosestDistanceFeaturesForColor(const GoBoard& bd,
     if (bd.All(color).IsEmpty())
         return;
 
+    SgPointArray<int> closest;
+    FindClosestStoneDistances(bd, color, closest);
     for (GoPointList::Iterator it(legalBoardMoves); it; ++it)
     {
-        int distance = FindClosestStoneDistance(bd, *it, color);
+        int distance = closest[*it];
         SG_ASSERT(distance >= 2);
         if (distance > MAX_CLOSEST_DISTANCE)
             distance = MAX_CLOSEST_DISTANCE;
@@ -1126,16 +1158,7 @@ float FeFeatures::EvaluateActiveFeatures(const FeActiveArray& active,
                                          size_t nuActive,
                                          const FeFeatureWeights& weights)
 {
-    float value = 0.0;
-    for (FeActiveIterator it = active.begin();
-                          it < active.begin() + nuActive; ++it)
-    {
-        value += weights.m_w[*it];
-        for (FeActiveIterator it2 = it + 1;
-                              it2 < active.begin() + nuActive; ++it2)
-            value += weights.Combine(*it, *it2);
-    }
-    return value;
+    return weights.Evaluate(active.data(), nuActive);
 }
 
 float FeFeatures::EvaluateMoveFeatures(const FeMoveFeatures& features,
@@ -1365,10 +1388,30 @@ void FeMoveFeatures::WriteFeatures(std::ostream& stream,
 GoEvalArray<float> FeFullBoardFeatures::
 EvaluateFeatures(const FeFeatureWeights& weights) const
 {
+    // Collect the active features of all legal moves and pass, then
+    // evaluate them in one batch
+    const int nuMoves = m_legalMoves.Length() + 1;
+    int active[SG_MAX_MOVES * MAX_ACTIVE_LENGTH];
+    size_t nuActive[SG_MAX_MOVES];
+    SgPoint moves[SG_MAX_MOVES];
+    float values[SG_MAX_MOVES];
+    SG_ASSERT(nuMoves <= SG_MAX_MOVES);
+    int* next = active;
+    int m = 0;
+    for (GoPointList::Iterator it(m_legalMoves); it; ++it, ++m)
+        moves[m] = *it;
+    moves[m] = SG_PASS;
+    FeActiveArray moveActive;
+    for (m = 0; m < nuMoves; ++m)
+    {
+        nuActive[m] = m_features[moves[m]].ActiveFeatures(moveActive);
+        next = std::copy(moveActive.begin(),
+                         moveActive.begin() + nuActive[m], next);
+    }
+    weights.EvaluateBatch(active, nuActive, nuMoves, values);
     GoEvalArray<float> eval(0);
-    for (GoPointList::Iterator it(m_legalMoves); it; ++it)
-            eval[*it] = FeFeatures::EvaluateMoveFeatures(m_features[*it], weights);
-    eval[SG_PASS] = FeFeatures::EvaluateMoveFeatures(m_features[SG_PASS], weights);
+    for (m = 0; m < nuMoves; ++m)
+        eval[moves[m]] = values[m];
     return eval;
 }
 
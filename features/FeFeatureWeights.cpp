@@ -20,34 +20,88 @@ const std::size_t FeFeatureWeights::MAX_FEATURE_INDEX = 2200;
 
 //----------------------------------------------------------------------------
 
+namespace {
+
+/** Round k up to a multiple of 4 floats */
+size_t Stride(size_t k)
+{
+    return (k + 3) / 4 * 4;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
 FeFeatureWeights::FeFeatureWeights(size_t nuFeatures, size_t k)
     : m_nuFeatures(nuFeatures),
       m_k(k),
       m_minID(std::numeric_limits<size_t>::max()),
-      m_maxID(std::numeric_limits<size_t>::min())
+      m_maxID(std::numeric_limits<size_t>::min()),
+      m_w(nuFeatures, 0),
+      m_stride(Stride(k)),
+      m_v(nuFeatures * Stride(k), 0),
+      m_halfSquaredNorm(nuFeatures, 0)
 {
     SG_ASSERT(  nuFeatures == 0
              || nuFeatures == MAX_FEATURE_INDEX);
-    m_w.resize(nuFeatures, 0);
-    m_v.resize(k); // create empty vectors
-    for (size_t i = 0; i < k; ++i)
-        m_v[i].resize(nuFeatures, 0);
+    SG_ASSERT(k <= MAX_K);
     SG_ASSERT(IsAllocated());
 }
 
+float FeFeatureWeights::Evaluate(const int* active, size_t nuActive) const
+{
+    // Sum of the v-values of the active features; the loops over the
+    // latent factors run over contiguous memory and can be vectorized
+    float sum[MAX_K];
+    for (size_t k = 0; k < m_k; ++k)
+        sum[k] = 0;
+    float value = 0;
+    for (size_t n = 0; n < nuActive; ++n)
+    {
+        const size_t i = static_cast<size_t>(active[n]);
+        if (i >= m_w.size())
+            continue;
+        value += m_w[i] - m_halfSquaredNorm[i];
+        const float* v = Row(i);
+        for (size_t k = 0; k < m_k; ++k)
+            sum[k] += v[k];
+    }
+    float squaredNorm = 0;
+    for (size_t k = 0; k < m_k; ++k)
+        squaredNorm += sum[k] * sum[k];
+    return value + 0.5f * squaredNorm;
+}
+
+void FeFeatureWeights::EvaluateBatch(const int* active,
+                                     const size_t* nuActive,
+                                     size_t nuMoves, float* values) const
+{
+    for (size_t m = 0; m < nuMoves; ++m)
+    {
+        values[m] = Evaluate(active, nuActive[m]);
+        active += nuActive[m];
+    }
+}
+
 bool FeFeatureWeights::IsAllocated() const
 {
     return m_w.size() == m_nuFeatures
-    && m_w.capacity() == m_nuFeatures
-    && m_v.size() == m_k
-    && m_v.capacity() == m_k
-    && ( (m_v.size() == 0)
-        ||
-        (
-         m_v[0].size() == m_nuFeatures
-         && m_v[0].capacity() == m_nuFeatures
-         )
-        );
+        && m_stride >= m_k
+        && m_stride % 4 == 0
+        && m_v.size() == m_nuFeatures * m_stride
+        && m_halfSquaredNorm.size() == m_nuFeatures;
+}
+
+void FeFeatureWeights::SetV(size_t i, size_t k, float v)
+{
+    SG_ASSERT(i < m_nuFeatures);
+    SG_ASSERT(k < m_k);
+    float* row = &m_v[i * m_stride];
+    row[k] = v;
+    float squaredNorm = 0;
+    for (size_t j = 0; j < m_k; ++j)
+        squaredNorm += row[j] * row[j];
+    m_halfSquaredNorm[i] = 0.5f * squaredNorm;
 }
 
 FeFeatureWeights FeFeatureWeights::Read(std::istream& stream)
@@ -64,6 +118,8 @@ FeFeatureWeights FeFeatureWeights::Read(std::istream& stream)
     size_t k;
     stream >> k;
     SG_ASSERT(! stream.fail());
+    if (k > MAX_K)
+        throw SgException("Too many latent factors");
 
     FeFeatureWeights f(MAX_FEATURE_INDEX, k);
     for (size_t i = 0; i < nuFeatures; ++i)
@@ -97,7 +153,7 @@ FeFeatureWeights FeFeatureWeights::Read(std::istream& stream)
             float v;
             stream >> v;
             SG_ASSERT(! stream.fail());
-            f.m_v[j][index] = v;
+            f.SetV(index, j, v);
         }
         SG_ASSERT(! stream.fail());
     }
@@ -145,7 +201,7 @@ std::ostream& operator<<(std::ostream& stream,
                    << w.m_w[i] << "\nv = \n";
             for (size_t k = 0; k < w.m_k; ++k)
                 stream << "v[" << k << "][" << i << "] = "
-                       << w.m_v[k][i] << '\n';
+                       << w.V(i, k) << '\n';
         }
     }
     return stream;
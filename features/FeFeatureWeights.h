@@ -21,6 +21,9 @@ class FeFeatureWeights
 public:
     static const size_t MAX_FEATURE_INDEX;
 
+    /** Largest supported number of latent factors k */
+    static const size_t MAX_K = 64;
+
     FeFeatureWeights(size_t nuFeatures, size_t k);
 
     bool IsAllocated() const;
@@ -28,6 +31,28 @@ public:
     /** Combine v-values of features i and j */
     float Combine(int i, int j) const;
 
+    /** Evaluate a move with the given active features.
+        Computes the sum of the w-values plus the sum of Combine(i, j) over
+        all pairs of features, in O(n * k) instead of O(n * n * k) with the
+        factorization machine identity
+        sum_{i<j} <v_i, v_j> = (|sum_i v_i|^2 - sum_i |v_i|^2) / 2.
+        Features that are not covered by the weights are ignored. */
+    float Evaluate(const int* active, size_t nuActive) const;
+
+    /** Evaluate several moves in one call.
+        @param active The active features of all moves, back to back
+        @param nuActive The number of active features of each move
+        @param nuMoves The number of moves
+        @param[out] values The value of each move */
+    void EvaluateBatch(const int* active, const size_t* nuActive,
+                       size_t nuMoves, float* values) const;
+
+    /** v-value of feature i for latent factor k */
+    float V(size_t i, size_t k) const;
+
+    /** Set v-value of feature i for latent factor k */
+    void SetV(size_t i, size_t k, float v);
+
     /** Read features in the format produced by Wistuba's tool. */
     static FeFeatureWeights Read(std::istream& stream);
 
@@ -47,9 +72,20 @@ public:
     // length m_nuFeatures
     std::vector<float> m_w;
 
-    // length k of length m_nuFeatures
-    // todo other order should be more cache friendly.
-    std::vector<std::vector<float> > m_v;
+private:
+    /** Distance between the v-values of two features in m_v.
+        m_k rounded up to a multiple of 4 floats, so that the rows are
+        aligned to 16 bytes if the allocation of m_v is. */
+    size_t m_stride;
+
+    /** v-values in feature-major order: v-value of feature i for latent
+        factor k is at m_v[i * m_stride + k]. The padding is 0. */
+    std::vector<float> m_v;
+
+    /** |v_i|^2 / 2 for each feature, maintained by SetV(). */
+    std::vector<float> m_halfSquaredNorm;
+
+    const float* Row(size_t i) const;
 };
 
 //----------------------------------------------------------------------------
@@ -61,28 +97,32 @@ std::ostream& operator<<(std::ostream& stream,
 
 inline float FeFeatureWeights::Combine(int i, int j) const
 {
-    //    if (   static_cast<size_t>(i) >= m_w.size()
-    //        || static_cast<size_t>(j) >= m_w.size())
-    //    {
-    //        SgDebug() << i << ' ' << j << ' ' << m_w.size() << std::endl;
-    //    }
-    //SG_ASSERT(static_cast<size_t>(i) < m_w.size());
-    //SG_ASSERT(static_cast<size_t>(j) < m_w.size());
     if (  static_cast<size_t>(i) >= m_w.size()
        || static_cast<size_t>(j) >= m_w.size())
     {
         //SgDebug() << "skipping feature pair " << i << ", " << j << '\n';
         return 0.0;
     }
+    const float* vi = Row(i);
+    const float* vj = Row(j);
     float sum = 0.0;
     for (size_t k = 0; k < m_k; ++k)
-    {
-        SG_ASSERT(m_v[k].size() == m_w.size());
-        sum += m_v[k][i] * m_v[k][j];
-    }
+        sum += vi[k] * vj[k];
     return sum;
 }
 
+inline const float* FeFeatureWeights::Row(size_t i) const
+{
+    SG_ASSERT(i < m_nuFeatures);
+    return &m_v[i * m_stride];
+}
+
+inline float FeFeatureWeights::V(size_t i, size_t k) const
+{
+    SG_ASSERT(k < m_k);
+    return Row(i)[k];
+}
+
 //----------------------------------------------------------------------------
 
 #endif // FE_FEATURE_WEIGHTS_H
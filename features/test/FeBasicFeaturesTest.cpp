@@ -12,6 +12,7 @@
 #include "GoBoard.h"
 #include "GoSetupUtil.h"
 #include "SgDebug.h"
+#include "SgRandom.h"
 #include "SgWrite.h"
 
 using SgPointUtil::Pt;
@@ -1012,6 +1013,41 @@ BOOST_AUTO_TEST_CASE(FeBasicFeaturesTest_ClosestStone)
     }
 }
 
+/** Compare the closest stone features on a board with scattered stones
+    with the distance to every stone of each color. */
+BOOST_AUTO_TEST_CASE(FeBasicFeaturesTest_ClosestStoneAllPoints)
+{
+    GoBoard bd(13);
+    SgRandom random;
+    for (int i = 0; i < 12; ++i)
+    {
+        const SgPoint p = Pt(random.Int(13) + 1, random.Int(13) + 1);
+        if (bd.IsLegal(p))
+            bd.Play(p);
+    }
+    FeFullBoardFeatures f(bd);
+    f.FindAllFeatures();
+    for (GoPointList::Iterator it(f.LegalMoves()); it; ++it)
+        for (SgBWIterator cit; cit; ++cit)
+        {
+            int distance = MAX_CLOSEST_DISTANCE;
+            for (GoBoard::Iterator it2(bd); it2; ++it2)
+                if (bd.GetColor(*it2) == *cit)
+                {
+                    const int dx = std::abs(SgPointUtil::Col(*it)
+                                          - SgPointUtil::Col(*it2));
+                    const int dy = std::abs(SgPointUtil::Row(*it)
+                                          - SgPointUtil::Row(*it2));
+                    distance = std::min(distance,
+                                        dx + dy + std::max(dx, dy));
+                }
+            const FeBasicFeature base = (*cit == bd.ToPlay()) ?
+                                        FE_DIST_CLOSEST_OWN_STONE_2 :
+                                        FE_DIST_CLOSEST_OPP_STONE_2;
+            BOOST_CHECK(f.BasicFeatures(*it).test(base + distance - 2));
+        }
+}
+
 BOOST_AUTO_TEST_CASE(FeBasicFeaturesTest_FeEvalDetail)
 {
     const double eps = 1.0e-5;
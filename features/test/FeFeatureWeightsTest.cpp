@@ -0,0 +1,145 @@
+//----------------------------------------------------------------------------
+/** @file FeFeatureWeightsTest.cpp
+ Unit tests for FeFeatureWeights. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "FeFeatureWeights.h"
+
+#include <sstream>
+#include <vector>
+#include "FeBasicFeatures.h"
+#include "GoBoard.h"
+#include "SgRandom.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Evaluation with the sum over all pairs of features, as in the
+    definition of the factorization machine. */
+float PairwiseEvaluation(const FeFeatureWeights& weights,
+                         const std::vector<int>& active)
+{
+    float value = 0;
+    for (size_t i = 0; i < active.size(); ++i)
+    {
+        if (static_cast<size_t>(active[i]) < weights.m_w.size())
+            value += weights.m_w[active[i]];
+        for (size_t j = i + 1; j < active.size(); ++j)
+            value += weights.Combine(active[i], active[j]);
+    }
+    return value;
+}
+
+BOOST_AUTO_TEST_CASE(FeFeatureWeightsTest_Evaluate)
+{
+    const size_t k = 10;
+    FeFeatureWeights weights(FeFeatureWeights::MAX_FEATURE_INDEX, k);
+    SgRandom random;
+    for (size_t i = 0; i < weights.m_nuFeatures; ++i)
+    {
+        weights.m_w[i] = random.Float(2) - 1;
+        for (size_t j = 0; j < k; ++j)
+            weights.SetV(i, j, random.Float(1) - 0.5f);
+    }
+    for (int n = 0; n < 100; ++n)
+    {
+        std::vector<int> active;
+        const int nuActive = random.Int(MAX_ACTIVE_LENGTH + 1);
+        for (int i = 0; i < nuActive; ++i)
+            active.push_back(random.Int(
+                static_cast<int>(FeFeatureWeights::MAX_FEATURE_INDEX)));
+        const float expected = PairwiseEvaluation(weights, active);
+        const float value = active.empty() ? 0 :
+                            weights.Evaluate(&active[0], active.size());
+        BOOST_CHECK_SMALL(value - expected, 1e-3f);
+    }
+}
+
+/** Features not covered by the weights do not contribute. */
+BOOST_AUTO_TEST_CASE(FeFeatureWeightsTest_EvaluateOutOfBounds)
+{
+    FeFeatureWeights weights(FeFeatureWeights::MAX_FEATURE_INDEX, 2);
+    weights.m_w[3] = 1;
+    weights.m_w[5] = 2;
+    weights.SetV(3, 0, 0.5);
+    weights.SetV(3, 1, 1);
+    weights.SetV(5, 0, 2);
+    weights.SetV(5, 1, -3);
+    const int active[3] = { 3, 3000, 5 };
+    BOOST_CHECK_CLOSE(weights.Evaluate(active, 3), 3.f + 1.f - 3.f, 1e-4f);
+    BOOST_CHECK_CLOSE(weights.Evaluate(active, 1), 1.f, 1e-4f);
+    BOOST_CHECK_EQUAL(weights.Evaluate(active, 0), 0.f);
+}
+
+BOOST_AUTO_TEST_CASE(FeFeatureWeightsTest_EvaluateBatch)
+{
+    FeFeatureWeights weights(FeFeatureWeights::MAX_FEATURE_INDEX, 1);
+    weights.m_w[1] = 1;
+    weights.m_w[2] = 2;
+    weights.SetV(1, 0, 3);
+    weights.SetV(2, 0, 4);
+    const int active[5] = { 1, 2, 2, 1, 2 };
+    const size_t nuActive[3] = { 2, 1, 2 };
+    float values[3];
+    weights.EvaluateBatch(active, nuActive, 3, values);
+    BOOST_CHECK_CLOSE(values[0], 15.f, 1e-4f);
+    BOOST_CHECK_CLOSE(values[1], 2.f, 1e-4f);
+    BOOST_CHECK_CLOSE(values[2], 15.f, 1e-4f);
+}
+
+/** Test that the evaluation of all moves of a board with the default
+    weights matches the sum of the terms in EvaluateMoveFeaturesDetail(),
+    which uses Combine() for each pair of features. */
+BOOST_AUTO_TEST_CASE(FeFeatureWeightsTest_EvaluateFeatures)
+{
+    const FeFeatureWeights weights = FeFeatureWeights::ReadDefaultWeights();
+    BOOST_REQUIRE(weights.m_nuFeatures > 0);
+    GoBoard bd(19);
+    bd.Play(Pt(4, 4), SG_BLACK);
+    bd.Play(Pt(16, 16), SG_WHITE);
+    bd.Play(Pt(16, 4), SG_BLACK);
+    bd.Play(Pt(4, 16), SG_WHITE);
+    bd.Play(Pt(3, 6), SG_BLACK);
+    bd.Play(Pt(5, 4), SG_WHITE);
+    FeFullBoardFeatures features(bd);
+    features.FindAllFeatures();
+    const GoEvalArray<float> eval = features.EvaluateFeatures(weights);
+    GoPointList moves = features.LegalMoves();
+    moves.PushBack(SG_PASS);
+    for (GoPointList::Iterator it(moves); it; ++it)
+    {
+        const std::vector<FeFeatures::FeEvalDetail> detail =
+            FeFeatures::EvaluateMoveFeaturesDetail(features.Features()[*it],
+                                                   weights);
+        float expected = 0;
+        for (size_t i = 0; i < detail.size(); ++i)
+            expected += detail[i].m_w + detail[i].m_v_sum;
+        BOOST_CHECK_SMALL(eval[*it] - expected, 1e-4f);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(FeFeatureWeightsTest_Read)
+{
+    std::istringstream in("size:2,k:3 5,0.5 7,-1 "
+                          "5,0.1,0.2,0.3 7,-0.4,0.5,-0.6 ");
+    const FeFeatureWeights weights = FeFeatureWeights::Read(in);
+    BOOST_CHECK_EQUAL(weights.m_k, 3u);
+    BOOST_CHECK_EQUAL(weights.m_minID, 5u);
+    BOOST_CHECK_EQUAL(weights.m_maxID, 7u);
+    BOOST_CHECK_CLOSE(weights.m_w[5], 0.5f, 1e-4f);
+    BOOST_CHECK_CLOSE(weights.m_w[7], -1.f, 1e-4f);
+    BOOST_CHECK_CLOSE(weights.V(5, 2), 0.3f, 1e-4f);
+    BOOST_CHECK_CLOSE(weights.V(7, 1), 0.5f, 1e-4f);
+    BOOST_CHECK_EQUAL(weights.V(6, 0), 0.f);
+    BOOST_CHECK_CLOSE(weights.Combine(5, 7), -0.04f + 0.1f - 0.18f, 1e-3f);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
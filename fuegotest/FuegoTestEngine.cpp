@@ -10,6 +10,8 @@
 #include <boost/algorithm/string.hpp>
 #include "GoGtpCommandUtil.h"
 #include "GoGtpExtraCommands.h"
+#include "GoRegionBoardBenchmark.h"
+#include "GoUctPlayoutBenchmark.h"
 #include "SpAveragePlayer.h"
 #include "SpCapturePlayer.h"
 #include "SpDumbTacticalPlayer.h"
@@ -23,6 +25,7 @@
 #include "SpSafePlayer.h"
 
 using std::string;
+using std::vector;
 using boost::trim_copy;
 
 //----------------------------------------------------------------------------
@@ -31,9 +34,18 @@ FuegoTestEngine::FuegoTestEngine(int fixedBoardSize, const char* programPath,
                                  const string& player)
     : GoGtpEngine(fixedBoardSize, programPath),
       m_extraCommands(Board()),
-      m_safetyCommands(Board())
+      m_safetyCommands(Board()),
+      m_playoutBitBoard(false)
 {
+    Register("fuegotest_bit_board_check", &FuegoTestEngine::CmdBitBoardCheck,
+             this);
     Register("fuegotest_param", &FuegoTestEngine::CmdParam, this);
+    Register("fuegotest_param_playout", &FuegoTestEngine::CmdParamPlayout,
+             this);
+    Register("fuegotest_playout_benchmark",
+             &FuegoTestEngine::CmdPlayoutBenchmark, this);
+    Register("fuegotest_region_benchmark",
+             &FuegoTestEngine::CmdRegionBenchmark, this);
     m_extraCommands.Register(*this);
     m_safetyCommands.Register(*this);
     SetPlayer(player);
@@ -48,11 +60,37 @@ void FuegoTestEngine::CmdAnalyzeCommands(GtpCommand& cmd)
     m_extraCommands.AddGoGuiAnalyzeCommands(cmd);
     m_safetyCommands.AddGoGuiAnalyzeCommands(cmd);
     cmd <<
-        "param/FuegoTest Param/fuegotest_param\n";
+        "string/FuegoTest Bit Board Check/fuegotest_bit_board_check 100\n"
+        "param/FuegoTest Param/fuegotest_param\n"
+        "param/FuegoTest Param Playout/fuegotest_param_playout\n"
+        "string/FuegoTest Playout Benchmark/fuegotest_playout_benchmark "
+        "10000\n"
+        "string/FuegoTest Region Benchmark/fuegotest_region_benchmark 10\n";
     string response = cmd.Response();
     cmd.SetResponse(GoGtpCommandUtil::SortResponseAnalyzeCommands(response));
 }
 
+/** Differential test of GoUctBitBoard against GoUctBoard.
+    Runs playouts in the current position with the parameters set with
+    fuegotest_param_playout, see GoUctPlayoutBenchmark::CheckBitBoard().
+    Fails with a description of the first difference.
+    Arguments: number of playouts <br>
+    Returns: number of moves compared */
+void FuegoTestEngine::CmdBitBoardCheck(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    size_t nuPlayouts = cmd.ArgMin<size_t>(0, 1);
+    try
+    {
+        cmd << GoUctPlayoutBenchmark::CheckBitBoard(Board(), m_playoutParam,
+                                                    nuPlayouts);
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+}
+
 void FuegoTestEngine::CmdName(GtpCommand& cmd)
 {
     if (m_playerId == "")
@@ -100,6 +138,127 @@ void FuegoTestEngine::CmdParam(GtpCommand& cmd)
         throw GtpFailure() << "need 0 or 2 arguments";
 }
 
+/** Playout policy parameters used by fuegotest_playout_benchmark.
+    This command is compatible with the GoGui analyze command type "param".
+    Parameters:
+    @arg @c bit_board Use GoUctBitBoard instead of GoUctBoard in the
+      benchmark
+    @arg @c nakade_heuristic See GoUctPlayoutPolicyParam::m_useNakadeHeuristic
+    @arg @c skip_rare_heuristics
+      See GoUctPlayoutPolicyParam::m_skipRareHeuristics
+    @arg @c use_patterns_in_playout Use gamma patterns instead of the
+      simple patterns. See GoUctPlayoutPolicyParam::m_usePatternsInPlayout
+    @arg @c use_global_gamma_playout
+      See GoUctPlayoutPolicyParam::m_useGlobalGammaPlayout
+    @arg @c fillboard_tries See GoUctPlayoutPolicyParam::m_fillboardTries
+    @arg @c pattern_gamma_threshold
+      See GoUctPlayoutPolicyParam::m_patternGammaThreshold
+    @arg @c skip_hit_rate See GoUctPlayoutPolicyParam::m_skipHitRate */
+void FuegoTestEngine::CmdParamPlayout(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(2);
+    GoUctPlayoutPolicyParam& p = m_playoutParam;
+    if (cmd.NuArg() == 0)
+    {
+        cmd << "[bool] bit_board " << m_playoutBitBoard << '\n'
+            << "[bool] nakade_heuristic " << p.m_useNakadeHeuristic << '\n'
+            << "[bool] skip_rare_heuristics " << p.m_skipRareHeuristics
+            << '\n'
+            << "[bool] use_global_gamma_playout "
+            << p.m_useGlobalGammaPlayout << '\n'
+            << "[bool] use_patterns_in_playout "
+            << p.m_usePatternsInPlayout << '\n'
+            << "[int] fillboard_tries " << p.m_fillboardTries << '\n'
+            << "[float] pattern_gamma_threshold "
+            << p.m_patternGammaThreshold << '\n'
+            << "[float] skip_hit_rate " << p.m_skipHitRate << '\n';
+    }
+    else if (cmd.NuArg() == 2)
+    {
+        string name = cmd.Arg(0);
+        if (name == "bit_board")
+            m_playoutBitBoard = cmd.Arg<bool>(1);
+        else if (name == "nakade_heuristic")
+            p.m_useNakadeHeuristic = cmd.Arg<bool>(1);
+        else if (name == "skip_rare_heuristics")
+            p.m_skipRareHeuristics = cmd.Arg<bool>(1);
+        else if (name == "use_global_gamma_playout")
+            p.m_useGlobalGammaPlayout = cmd.Arg<bool>(1);
+        else if (name == "use_patterns_in_playout")
+            p.m_usePatternsInPlayout = cmd.Arg<bool>(1);
+        else if (name == "fillboard_tries")
+            p.m_fillboardTries = cmd.ArgMin<int>(1, 0);
+        else if (name == "pattern_gamma_threshold")
+            p.m_patternGammaThreshold = cmd.Arg<float>(1);
+        else if (name == "skip_hit_rate")
+            p.m_skipHitRate = cmd.ArgMinMax<float>(1, 0.f, 1.f);
+        else
+            throw GtpFailure() << "unknown parameter: " << name;
+    }
+    else
+        throw GtpFailure() << "need 0 or 2 arguments";
+}
+
+/** Measure the playout throughput in the current position.
+    Runs playouts with GoUctPlayoutBenchmark using the parameters set with
+    fuegotest_param_playout. The response contains one line for each number
+    of threads and a line per move type with the time split of the move
+    generation, which is measured in an additional run with the first number
+    of threads. All lines consist of space-separated key value pairs; the
+    scaling efficiency is relative to the run with the first number of
+    threads.
+    Arguments: number of playouts [number of threads...] (default 1) */
+void FuegoTestEngine::CmdPlayoutBenchmark(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(17);
+    size_t nuPlayouts = cmd.ArgMin<size_t>(0, 1);
+    vector<int> nuThreads;
+    for (size_t i = 1; i < cmd.NuArg(); ++i)
+        nuThreads.push_back(cmd.ArgMin<int>(i, 1));
+    if (nuThreads.empty())
+        nuThreads.push_back(1);
+    const GoBoard& bd = Board();
+    cmd << "size " << bd.Size()
+        << " nakade " << m_playoutParam.m_useNakadeHeuristic
+        << " gamma " << m_playoutParam.m_usePatternsInPlayout
+        << " global_gamma " << m_playoutParam.m_useGlobalGammaPlayout
+        << " fillboard " << m_playoutParam.m_fillboardTries
+        << " skip " << m_playoutParam.m_skipRareHeuristics
+        << " bit_board " << m_playoutBitBoard << '\n';
+    GoUctPlayoutBenchmarkResult baseline;
+    for (size_t i = 0; i < nuThreads.size(); ++i)
+    {
+        GoUctPlayoutBenchmarkResult result =
+            GoUctPlayoutBenchmark::Run(bd, m_playoutParam, nuPlayouts,
+                                       nuThreads[i], false,
+                                       m_playoutBitBoard);
+        if (i == 0)
+            baseline = result;
+        result.Write(cmd, &baseline);
+    }
+    GoUctPlayoutBenchmark::Run(bd, m_playoutParam, nuPlayouts, nuThreads[0],
+                               true, m_playoutBitBoard).WriteMoveTypes(cmd);
+}
+
+/** Compare the incremental update of the regions with rebuilding them.
+    Replays the moves of the current game with GoRegionBoardBenchmark.
+    Arguments: number of repetitions <br>
+    Returns: a line of space-separated key value pairs with the mean times per
+    move in microseconds */
+void FuegoTestEngine::CmdRegionBenchmark(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(1);
+    int nuRepetitions = cmd.ArgMin<int>(0, 1);
+    try
+    {
+        GoRegionBoardBenchmark::Run(Board(), nuRepetitions).Write(cmd);
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+}
+
 void FuegoTestEngine::CmdVersion(GtpCommand& cmd)
 {
 #ifdef VERSION
@@ -8,6 +8,7 @@
 #include "GoGtpEngine.h"
 #include "GoGtpExtraCommands.h"
 #include "GoSafetyCommands.h"
+#include "GoUctPlayoutPolicy.h"
 
 //----------------------------------------------------------------------------
 
@@ -28,10 +29,19 @@ public:
     ~FuegoTestEngine();
 
     /** @page fuegotestenginecommands FuegoTestEngine Commands
-        - @link CmdParam() @c fuegotest_param @endlink */
+        - @link CmdBitBoardCheck() @c fuegotest_bit_board_check @endlink
+        - @link CmdParam() @c fuegotest_param @endlink
+        - @link CmdParamPlayout() @c fuegotest_param_playout @endlink
+        - @link CmdPlayoutBenchmark() @c fuegotest_playout_benchmark @endlink
+        - @link CmdRegionBenchmark() @c fuegotest_region_benchmark @endlink
+    */
     void CmdAnalyzeCommands(GtpCommand& cmd);
+    void CmdBitBoardCheck(GtpCommand& cmd);
     void CmdName(GtpCommand& cmd);
     void CmdParam(GtpCommand& cmd);
+    void CmdParamPlayout(GtpCommand& cmd);
+    void CmdPlayoutBenchmark(GtpCommand& cmd);
+    void CmdRegionBenchmark(GtpCommand& cmd);
     void CmdVersion(GtpCommand& cmd);
 
 private:
@@ -39,6 +49,12 @@ private:
 
     GoSafetyCommands m_safetyCommands;
 
+    /** Policy parameters used by CmdPlayoutBenchmark(). */
+    GoUctPlayoutPolicyParam m_playoutParam;
+
+    /** Use GoUctBitBoard in CmdPlayoutBenchmark(). */
+    bool m_playoutBitBoard;
+
     /** Player ID as in CreatePlayer() */
     std::string m_playerId;
 
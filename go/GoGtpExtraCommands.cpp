@@ -11,6 +11,7 @@
 #include "GoBoardUtil.h"
 #include "GoGtpCommandUtil.h"
 #include "GoLadder.h"
+#include "GoLadderCache.h"
 #include "GoStaticLadder.h"
 
 using boost::format;
@@ -29,6 +30,8 @@ void GoGtpExtraCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "sboard/Go CFG Distance/go_cfg_distance %p\n"
         "sboard/Go CFG Distance N/go_cfg_distance %p %s\n"
         "string/Go Ladder/go_ladder %p\n"
+        "none/Go Ladder Cache Clear/go_ladder_cache_clear\n"
+        "string/Go Ladder Cache Stat/go_ladder_cache_stat\n"
         "string/Go Static Ladder/go_static_ladder %p\n";
 }
 
@@ -78,6 +81,21 @@ void GoGtpExtraCommands::CmdLadder(GtpCommand& cmd)
     }
 }
 
+/** Clear the cache of the ladder results (GoLadderCache::Global()). */
+void GoGtpExtraCommands::CmdLadderCacheClear(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    GoLadderCache::Global().Clear();
+}
+
+/** Statistics of the cache of the ladder results
+    (GoLadderCache::Global()). */
+void GoGtpExtraCommands::CmdLadderCacheStat(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    GoLadderCache::Global().WriteStatistics(cmd);
+}
+
 /** Return static ladder status.
     Arguments: prey point<br>
     Returns: escaped|captured|unsettled<br>
@@ -99,6 +117,10 @@ void GoGtpExtraCommands::Register(GtpEngine& e)
 {
     Register(e, "go_cfg_distance", &GoGtpExtraCommands::CmdCfgDistance);
     Register(e, "go_ladder", &GoGtpExtraCommands::CmdLadder);
+    Register(e, "go_ladder_cache_clear",
+             &GoGtpExtraCommands::CmdLadderCacheClear);
+    Register(e, "go_ladder_cache_stat",
+             &GoGtpExtraCommands::CmdLadderCacheStat);
     Register(e, "go_static_ladder", &GoGtpExtraCommands::CmdStaticLadder);
 }
 
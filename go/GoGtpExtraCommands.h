@@ -28,12 +28,16 @@ public:
     /** @page gogtpextracommands GoGtpExtraCommands Commands
         - @link CmdCfgDistance() @c go_cfg_distance @endlink
         - @link CmdLadder() @c go_ladder @endlink
+        - @link CmdLadderCacheClear() @c go_ladder_cache_clear @endlink
+        - @link CmdLadderCacheStat() @c go_ladder_cache_stat @endlink
         - @link CmdStaticLadder() @c go_static_ladder @endlink */
     /** @name Command Callbacks */
     // @{
     // The callback functions are documented in the cpp file
     void CmdCfgDistance(GtpCommand& cmd);
     void CmdLadder(GtpCommand& cmd);
+    void CmdLadderCacheClear(GtpCommand& cmd);
+    void CmdLadderCacheStat(GtpCommand& cmd);
     void CmdStaticLadder(GtpCommand& cmd);
     // @} // @name
 
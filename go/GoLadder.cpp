@@ -29,11 +29,18 @@ const int GOOD_FOR_HUNTER = -1000;
 //----------------------------------------------------------------------------
 
 GoLadder::GoLadder()
+    : m_path(0),
+      m_overflow(false)
 { }
 
-inline bool GoLadder::CheckMoveOverflow() const
+inline bool GoLadder::CheckMoveOverflow()
 {
-    return m_bd->MoveNumber() >= m_maxMoveNumber;
+    if (m_bd->MoveNumber() >= m_maxMoveNumber)
+    {
+        m_overflow = true;
+        return true;
+    }
+    return false;
 }
 
 void GoLadder::InitMaxMoveNumber()
@@ -109,6 +116,7 @@ int GoLadder::PlayHunterMove(int depth, SgPoint move, SgPoint lib1,
     SG_ASSERT(move == lib1 || move == lib2);
     // TODO: only pass move and otherLib
     int result = 0;
+    AddToPath(move);
     if (PlayIfLegal(*m_bd, move, m_hunterColor))
     {
         // Find new adjacent blocks: only block just played can be new
@@ -177,6 +185,7 @@ int GoLadder::PlayPreyMove(int depth, SgPoint move, SgPoint lib1,
         }
         m_partOfPrey.Include(move);
     }
+    AddToPath(move);
     if (PlayIfLegal(*m_bd, move, m_preyColor))
     {
         if (move == lib1)
@@ -310,6 +319,8 @@ int GoLadder::HunterLadder(int depth, SgPoint lib1, SgPoint lib2,
     if (CheckMoveOverflow())
         return GOOD_FOR_PREY;
     int result = 0;
+    AddToPath(lib1);
+    AddToPath(lib2);
     if (m_bd->NumEmptyNeighbors(lib1) < m_bd->NumEmptyNeighbors(lib2))
     {
         std::swap(lib1, lib2);
@@ -398,6 +409,7 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
     InitMaxMoveNumber();
     if (sequence)
         sequence->Clear();
+    AddToPath(prey);
     if (! m_bd->Occupied(prey))
         return 0;
     if (CheckMoveOverflow())
@@ -456,6 +468,8 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                 // Liberties of blocks.
                 ++libit;
                 SgPoint lib2 = *libit;
+                AddToPath(lib1);
+                AddToPath(lib2);
                 movesToTry.PushBack(lib1);
                 movesToTry.PushBack(lib2);
 
@@ -469,6 +483,7 @@ int GoLadder::Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                 // Try whether any of these moves lead to escape.
                 for (SgVectorIterator<SgPoint> it(movesToTry); it; ++it)
                 {
+                    AddToPath(*it);
                     if (PlayIfLegal(*m_bd, *it, m_preyColor))
                     {
                         if (Ladder(bd, prey, m_hunterColor, 0, twoLibIsEscape)
@@ -520,6 +535,7 @@ bool GoLadder::IsSnapback(SgPoint prey)
     if (m_bd->IsSingleStone(prey) && m_bd->InAtari(prey))
     {
         SgPoint liberty = *GoBoard::LibertyIterator(*m_bd, prey);
+        AddToPath(liberty);
         if (PlayIfLegal(*m_bd, liberty, SgOppBW(m_bd->GetStone(prey))))
         {
             isSnapback = (m_bd->InAtari(liberty)
@@ -536,23 +552,8 @@ bool GoLadderUtil::Ladder(const GoBoard& bd, SgPoint prey,
                           SgBlackWhite toPlay, bool twoLibIsEscape,
                           SgVector<SgPoint>* sequence)
 {
-    SG_ASSERT(bd.IsValidPoint(prey));
-    SG_ASSERT(bd.Occupied(prey));
-    // @todo for an unsettled block with 2 liberties, it
-    // immediately says it can escape, but does not return a move.
-    // Sequence is empty.  Have to special case this and look for
-    // moves that escape from ladder myself.
-#ifndef NDEBUG
-    SgHashCode oldHash = bd.GetHashCode();
-#endif
     GoLadder ladder;
-    int result = ladder.Ladder(bd, prey, toPlay, sequence, twoLibIsEscape);
-#ifndef NDEBUG
-    // Make sure Ladder didn't change the board position.
-    SG_ASSERT(oldHash == bd.GetHashCode());
-#endif
-    SG_ASSERT(result != 0);
-    return (result < 0);
+    return Ladder(ladder, bd, prey, toPlay, twoLibIsEscape, sequence);
 }
 
 GoLadderStatus GoLadderUtil::LadderStatus(const GoBoard& bd, SgPoint prey,
@@ -560,116 +561,31 @@ GoLadderStatus GoLadderUtil::LadderStatus(const GoBoard& bd, SgPoint prey,
                                           SgPoint* toCapture,
                                           SgPoint* toEscape)
 {
-    SG_ASSERT(bd.IsValidPoint(prey));
-    SG_ASSERT(bd.Occupied(prey));
-#ifndef NDEBUG
-    SgHashCode oldHash = bd.GetHashCode();
-#endif
-    // Unsettled only if can capture when hunter plays first, and can escape
-    // if prey plays first.
     GoLadder ladder;
-    SgBlackWhite preyColor = bd.GetStone(prey);
-    SgVector<SgPoint> captureSequence;
-    GoLadderStatus status = GO_LADDER_ESCAPED;
-    if (ladder.Ladder(bd, prey, SgOppBW(preyColor), &captureSequence,
-                      twoLibIsEscape) < 0)
-    {
-        SgVector<SgPoint> escapeSequence;
-        if (ladder.Ladder(bd, prey, preyColor, &escapeSequence,
-                          twoLibIsEscape) < 0)
-            status = GO_LADDER_CAPTURED;
-        else
-        {
-            status = GO_LADDER_UNSETTLED;
-            // Unsettled = ladder depends on who plays first, so there must
-            // be a move that can be played.
-            SG_ASSERT(captureSequence.NonEmpty());
-            // escapeSequence can be empty in 2 libs, prey to play case
-            SG_ASSERT(twoLibIsEscape || escapeSequence.NonEmpty());
-            if (toCapture)
-                *toCapture = captureSequence.Front();
-            if (toEscape)
-                *toEscape = escapeSequence.IsEmpty() ? SG_PASS :
-                                                       escapeSequence.Front();
-        }
-    }
-#ifndef NDEBUG
-    // Make sure Ladder didn't change the board position.
-    SG_ASSERT(oldHash == bd.GetHashCode());
-#endif
-    return status;
+    return LadderStatus(ladder, bd, prey, twoLibIsEscape, toCapture,
+                        toEscape);
 }
 
-bool GoLadderUtil::IsLadderCaptureMove(const GoBoard& constBd, 
-									   SgPoint prey, SgPoint firstMove)
+bool GoLadderUtil::IsLadderCaptureMove(const GoBoard& bd, SgPoint prey,
+                                       SgPoint firstMove)
 {
-    SG_ASSERT(constBd.NumLiberties(prey) == 2);
-    SG_ASSERT(constBd.IsLibertyOfBlock(firstMove, constBd.Anchor(prey)));
-    
-    GoModBoard mbd(constBd);
-    GoBoard& bd = mbd.Board();
-    const SgBlackWhite defender = bd.GetStone(prey);
-    const SgBlackWhite attacker = SgOppBW(defender);
-    GoRestoreToPlay r(bd);
-    bd.SetToPlay(attacker);
-    if (PlayIfLegal(bd, firstMove, attacker))
-    {
-	    GoLadder ladder;
-        bool isCapture = ladder.Ladder(bd, prey, defender, 
-                                       0, false/*twoLibIsEscape*/
-                                      ) < 0;
-    	bd.Undo();
-        return isCapture;
-    }
-    else
-    	return false;
+    GoLadder ladder;
+    return IsLadderCaptureMove(ladder, bd, prey, firstMove);
 }
 
-bool GoLadderUtil::IsLadderEscapeMove(const GoBoard& constBd, 
-									   SgPoint prey, SgPoint firstMove)
+bool GoLadderUtil::IsLadderEscapeMove(const GoBoard& bd, SgPoint prey,
+                                      SgPoint firstMove)
 {
-    GoModBoard mbd(constBd);
-    GoBoard& bd = mbd.Board();
-    const SgBlackWhite defender = bd.GetStone(prey);
-    const SgBlackWhite attacker = SgOppBW(defender);
-    GoRestoreToPlay r(bd);
-    bd.SetToPlay(defender);
-    if (PlayIfLegal(bd, firstMove, defender))
-    {
-	    GoLadder ladder;
-        bool isCapture = ladder.Ladder(bd, prey, attacker, 
-                                       0, false/*twoLibIsEscape*/
-                                      ) < 0;
-    	bd.Undo();
-        return ! isCapture;
-    }
-    else
-    	return false;
+    GoLadder ladder;
+    return IsLadderEscapeMove(ladder, bd, prey, firstMove);
 }
 
-void GoLadderUtil::FindLadderEscapeMoves(const GoBoard& bd, SgPoint prey, 
-                           SgVector<SgPoint>& escapeMoves)
+void GoLadderUtil::FindLadderEscapeMoves(const GoBoard& bd, SgPoint prey,
+                                         SgVector<SgPoint>& escapeMoves)
 {
-    SG_ASSERT(bd.NumLiberties(prey) == 1);
-    SG_ASSERT(escapeMoves.IsEmpty());
-    
-    const SgPoint lib = bd.TheLiberty(prey);
-    SgVector<SgPoint> candidates;
-    candidates.PushBack(lib);
-    if (IsLadderEscapeMove(bd, prey, lib))
-    	escapeMoves.PushBack(lib);
-    for (GoAdjBlockIterator<GoBoard> it(bd, prey, 1); it; ++it)
-    {
-        // check if prey can escape by capturing *it on p.
-        SgPoint p = bd.TheLiberty(*it);
-        if (! candidates.Contains(p))
-        {
-		    candidates.PushBack(p);
-        	if (IsLadderEscapeMove(bd, prey, p))
-            	escapeMoves.PushBack(p);
-        }
-    }
-}                           
+    GoLadder ladder;
+    FindLadderEscapeMoves(ladder, bd, prey, escapeMoves);
+}
 
 bool GoLadderUtil::IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
                                       SgBlackWhite color)
@@ -680,61 +596,13 @@ bool GoLadderUtil::IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
                               true);
 }
 
-bool GoLadderUtil::IsProtectedLiberty(const GoBoard& bd1, SgPoint liberty,
+bool GoLadderUtil::IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
                                       SgBlackWhite col, bool& byLadder,
                                       bool& isKoCut, bool tryLadder)
 {
-    byLadder = false;
-    isKoCut = false;
-    GoModBoard mbd(bd1);
-    GoBoard& bd = mbd.Board();
-
-    const SgBlackWhite toPlay = bd1.ToPlay();
-    bd.SetToPlay(SgOppBW(col));
-    bool isProtected;
-    if (! PlayIfLegal(bd, liberty))
-        isProtected = bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE);
-        // opponent cannot play there
-    else
-    {
-        if (bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE))
-           isProtected = true;
-        else
-        {
-            if (bd.InAtari(liberty))
-            {
-                if (bd.NumStones(liberty) > 1)
-                    isProtected = true;
-                else
-                {
-                    SgPoint p = bd.TheLiberty(liberty);
-                    if (PlayIfLegal(bd, p))
-                    {
-                        isProtected =    (bd.NumStones(p) != 1)
-                                      || (bd.NumLiberties(p) != 1);
-                                      // yes, can re-capture there
-                        bd.Undo();
-                    }
-                    else
-                        isProtected = false;
-
-                    if (! isProtected)
-                        isKoCut = true;
-                }
-            }
-            else if (tryLadder)
-            {
-                isProtected = Ladder(bd, liberty, bd.ToPlay(), true);
-                if (isProtected)
-                    byLadder = true;
-            }
-            else // don't try ladder
-                isProtected = false;
-        }
-        bd.Undo();
-    }
-    bd.SetToPlay(toPlay);
-    return isProtected;
+    GoLadder ladder;
+    return IsProtectedLiberty(ladder, bd, liberty, col, byLadder, isKoCut,
+                              tryLadder);
 }
 
 SgPoint GoLadderUtil::TryLadder(const GoBoard& bd, SgPoint prey,
@@ -11,6 +11,7 @@
 #define GO_LADDER_H
 
 #include "GoBoard.h"
+#include "GoBoardUtil.h"
 #include "SgBoardColor.h"
 #include "GoModBoard.h"
 #include "SgPoint.h"
@@ -50,6 +51,19 @@ public:
     int Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
                SgVector<SgPoint>* sequence, bool twoLibIsEscape = false);
 
+    /** Record the prey and the points where moves are tried.
+        The points are added to 'path' in all following calls of Ladder()
+        until this function is called with a null pointer. The result of
+        Ladder() depends only on the blocks at and next to these points, see
+        GoLadderCache. */
+    void RecordPath(SgPointSet* path);
+
+    /** Whether a call of Ladder() was aborted because the maximum number of
+        moves was reached.
+        The result of an aborted ladder depends on the move number of the
+        board. Refers to all calls since the construction of this object. */
+    bool Overflow() const;
+
 private:
     /** Maximum number of moves in ladder.
         If board has simple ko rule, ladders could not terminate. */
@@ -66,7 +80,15 @@ private:
 
     SgBlackWhite m_hunterColor;
 
-    bool CheckMoveOverflow() const;
+    /** See RecordPath() */
+    SgPointSet* m_path;
+
+    /** See Overflow() */
+    bool m_overflow;
+
+    void AddToPath(SgPoint p);
+
+    bool CheckMoveOverflow();
 
     void InitMaxMoveNumber();
 
@@ -99,6 +121,22 @@ private:
     void ReduceToBlocks(GoPointList& stones);
 };
 
+inline void GoLadder::AddToPath(SgPoint p)
+{
+    if (m_path)
+        m_path->Include(p);
+}
+
+inline bool GoLadder::Overflow() const
+{
+    return m_overflow;
+}
+
+inline void GoLadder::RecordPath(SgPointSet* path)
+{
+    m_path = path;
+}
+
 //----------------------------------------------------------------------------
 
 namespace GoLadderUtil {
@@ -160,9 +198,250 @@ bool IsLadderEscapeMove(const GoBoard& bd, SgPoint prey, SgPoint firstMove);
 void FindLadderEscapeMoves(const GoBoard& bd, SgPoint prey, 
                            SgVector<SgPoint>& escapeMoves);
 
+/** @name Versions with a given ladder reader
+    The following functions read the ladders with a LADDER object, which
+    must have a member function Ladder() with the signature of
+    GoLadder::Ladder(). The functions without this argument use a new
+    GoLadder; GoLadderCache uses these functions with itself to share
+    the results of the ladder reading between the callers. */
+// @{
+
+template<class LADDER>
+bool Ladder(LADDER& ladder, const GoBoard& bd, SgPoint prey,
+            SgBlackWhite toPlay, bool fTwoLibIsEscape = false,
+            SgVector<SgPoint>* sequence = 0);
+
+template<class LADDER>
+GoLadderStatus LadderStatus(LADDER& ladder, const GoBoard& bd, SgPoint prey,
+                            bool fTwoLibIsEscape = false,
+                            SgPoint* toCapture = 0, SgPoint* toEscape = 0);
+
+template<class LADDER>
+bool IsProtectedLiberty(LADDER& ladder, const GoBoard& bd, SgPoint liberty,
+                        SgBlackWhite col, bool& byLadder, bool& isKoCut,
+                        bool tryLadder = true);
+
+template<class LADDER>
+bool IsLadderCaptureMove(LADDER& ladder, const GoBoard& bd, SgPoint prey,
+                         SgPoint firstMove);
+
+template<class LADDER>
+bool IsLadderEscapeMove(LADDER& ladder, const GoBoard& bd, SgPoint prey,
+                        SgPoint firstMove);
+
+template<class LADDER>
+void FindLadderEscapeMoves(LADDER& ladder, const GoBoard& bd, SgPoint prey,
+                           SgVector<SgPoint>& escapeMoves);
+
+// @} // name
+
 } // namespace GoLadderUtil
 
 //----------------------------------------------------------------------------
 
+template<class LADDER>
+bool GoLadderUtil::Ladder(LADDER& ladder, const GoBoard& bd, SgPoint prey,
+                          SgBlackWhite toPlay, bool twoLibIsEscape,
+                          SgVector<SgPoint>* sequence)
+{
+    SG_ASSERT(bd.IsValidPoint(prey));
+    SG_ASSERT(bd.Occupied(prey));
+    // @todo for an unsettled block with 2 liberties, it
+    // immediately says it can escape, but does not return a move.
+    // Sequence is empty.  Have to special case this and look for
+    // moves that escape from ladder myself.
+#ifndef NDEBUG
+    SgHashCode oldHash = bd.GetHashCode();
+#endif
+    int result = ladder.Ladder(bd, prey, toPlay, sequence, twoLibIsEscape);
+#ifndef NDEBUG
+    // Make sure Ladder didn't change the board position.
+    SG_ASSERT(oldHash == bd.GetHashCode());
+#endif
+    SG_ASSERT(result != 0);
+    return (result < 0);
+}
+
+template<class LADDER>
+GoLadderStatus GoLadderUtil::LadderStatus(LADDER& ladder, const GoBoard& bd,
+                                          SgPoint prey, bool twoLibIsEscape,
+                                          SgPoint* toCapture,
+                                          SgPoint* toEscape)
+{
+    SG_ASSERT(bd.IsValidPoint(prey));
+    SG_ASSERT(bd.Occupied(prey));
+#ifndef NDEBUG
+    SgHashCode oldHash = bd.GetHashCode();
+#endif
+    // Unsettled only if can capture when hunter plays first, and can escape
+    // if prey plays first.
+    SgBlackWhite preyColor = bd.GetStone(prey);
+    SgVector<SgPoint> captureSequence;
+    GoLadderStatus status = GO_LADDER_ESCAPED;
+    if (ladder.Ladder(bd, prey, SgOppBW(preyColor), &captureSequence,
+                      twoLibIsEscape) < 0)
+    {
+        SgVector<SgPoint> escapeSequence;
+        if (ladder.Ladder(bd, prey, preyColor, &escapeSequence,
+                          twoLibIsEscape) < 0)
+            status = GO_LADDER_CAPTURED;
+        else
+        {
+            status = GO_LADDER_UNSETTLED;
+            // Unsettled = ladder depends on who plays first, so there must
+            // be a move that can be played.
+            SG_ASSERT(captureSequence.NonEmpty());
+            // escapeSequence can be empty in 2 libs, prey to play case
+            SG_ASSERT(twoLibIsEscape || escapeSequence.NonEmpty());
+            if (toCapture)
+                *toCapture = captureSequence.Front();
+            if (toEscape)
+                *toEscape = escapeSequence.IsEmpty() ? SG_PASS :
+                                                       escapeSequence.Front();
+        }
+    }
+#ifndef NDEBUG
+    // Make sure Ladder didn't change the board position.
+    SG_ASSERT(oldHash == bd.GetHashCode());
+#endif
+    return status;
+}
+
+template<class LADDER>
+bool GoLadderUtil::IsLadderCaptureMove(LADDER& ladder,
+                                       const GoBoard& constBd, SgPoint prey,
+                                       SgPoint firstMove)
+{
+    SG_ASSERT(constBd.NumLiberties(prey) == 2);
+    SG_ASSERT(constBd.IsLibertyOfBlock(firstMove, constBd.Anchor(prey)));
+
+    GoModBoard mbd(constBd);
+    GoBoard& bd = mbd.Board();
+    const SgBlackWhite defender = bd.GetStone(prey);
+    const SgBlackWhite attacker = SgOppBW(defender);
+    GoRestoreToPlay r(bd);
+    bd.SetToPlay(attacker);
+    if (GoBoardUtil::PlayIfLegal(bd, firstMove, attacker))
+    {
+        bool isCapture = ladder.Ladder(bd, prey, defender,
+                                       0, false/*twoLibIsEscape*/
+                                      ) < 0;
+        bd.Undo();
+        return isCapture;
+    }
+    else
+        return false;
+}
+
+template<class LADDER>
+bool GoLadderUtil::IsLadderEscapeMove(LADDER& ladder,
+                                      const GoBoard& constBd, SgPoint prey,
+                                      SgPoint firstMove)
+{
+    GoModBoard mbd(constBd);
+    GoBoard& bd = mbd.Board();
+    const SgBlackWhite defender = bd.GetStone(prey);
+    const SgBlackWhite attacker = SgOppBW(defender);
+    GoRestoreToPlay r(bd);
+    bd.SetToPlay(defender);
+    if (GoBoardUtil::PlayIfLegal(bd, firstMove, defender))
+    {
+        bool isCapture = ladder.Ladder(bd, prey, attacker,
+                                       0, false/*twoLibIsEscape*/
+                                      ) < 0;
+        bd.Undo();
+        return ! isCapture;
+    }
+    else
+        return false;
+}
+
+template<class LADDER>
+void GoLadderUtil::FindLadderEscapeMoves(LADDER& ladder, const GoBoard& bd,
+                                         SgPoint prey,
+                                         SgVector<SgPoint>& escapeMoves)
+{
+    SG_ASSERT(bd.NumLiberties(prey) == 1);
+    SG_ASSERT(escapeMoves.IsEmpty());
+
+    const SgPoint lib = bd.TheLiberty(prey);
+    SgVector<SgPoint> candidates;
+    candidates.PushBack(lib);
+    if (IsLadderEscapeMove(ladder, bd, prey, lib))
+        escapeMoves.PushBack(lib);
+    for (GoAdjBlockIterator<GoBoard> it(bd, prey, 1); it; ++it)
+    {
+        // check if prey can escape by capturing *it on p.
+        SgPoint p = bd.TheLiberty(*it);
+        if (! candidates.Contains(p))
+        {
+            candidates.PushBack(p);
+            if (IsLadderEscapeMove(ladder, bd, prey, p))
+                escapeMoves.PushBack(p);
+        }
+    }
+}
+
+template<class LADDER>
+bool GoLadderUtil::IsProtectedLiberty(LADDER& ladder, const GoBoard& bd1,
+                                      SgPoint liberty, SgBlackWhite col,
+                                      bool& byLadder, bool& isKoCut,
+                                      bool tryLadder)
+{
+    byLadder = false;
+    isKoCut = false;
+    GoModBoard mbd(bd1);
+    GoBoard& bd = mbd.Board();
+
+    const SgBlackWhite toPlay = bd1.ToPlay();
+    bd.SetToPlay(SgOppBW(col));
+    bool isProtected;
+    if (! GoBoardUtil::PlayIfLegal(bd, liberty))
+        isProtected = bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE);
+        // opponent cannot play there
+    else
+    {
+        if (bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE))
+           isProtected = true;
+        else
+        {
+            if (bd.InAtari(liberty))
+            {
+                if (bd.NumStones(liberty) > 1)
+                    isProtected = true;
+                else
+                {
+                    SgPoint p = bd.TheLiberty(liberty);
+                    if (GoBoardUtil::PlayIfLegal(bd, p))
+                    {
+                        isProtected =    (bd.NumStones(p) != 1)
+                                      || (bd.NumLiberties(p) != 1);
+                                      // yes, can re-capture there
+                        bd.Undo();
+                    }
+                    else
+                        isProtected = false;
+
+                    if (! isProtected)
+                        isKoCut = true;
+                }
+            }
+            else if (tryLadder)
+            {
+                isProtected = Ladder(ladder, bd, liberty, bd.ToPlay(), true);
+                if (isProtected)
+                    byLadder = true;
+            }
+            else // don't try ladder
+                isProtected = false;
+        }
+        bd.Undo();
+    }
+    bd.SetToPlay(toPlay);
+    return isProtected;
+}
+
+//----------------------------------------------------------------------------
+
 #endif // GO_LADDER_H
 
@@ -0,0 +1,250 @@
+//----------------------------------------------------------------------------
+/** @file GoLadderCache.cpp
+    See GoLadderCache.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoLadderCache.h"
+
+#include <iostream>
+#include "GoBoard.h"
+#include "SgWrite.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Add the blocks with stones in 'points' to 'region'.
+    Adds the stones and the border of the blocks, which contains their
+    liberties and the adjacent opponent stones. */
+void AddBlocks(const GoBoard& bd, const SgPointSet& points,
+               SgPointSet& region)
+{
+    SgPointSet stones;
+    for (SgSetIterator it(points & bd.Occupied()); it; ++it)
+        if (! stones.Contains(*it))
+            for (GoBoard::StoneIterator it2(bd, *it); it2; ++it2)
+                stones.Include(*it2);
+    region |= stones;
+    region |= stones.Border(bd.Size());
+}
+
+/** The points that the result of a ladder depends on.
+    GoLadder looks at the blocks next to the points where it tries moves,
+    which includes the prey, and at the blocks adjacent to the prey and the
+    blocks captured or merged with the prey during the ladder. The
+    liberties of a block change only if a stone is added to or removed from
+    its border, so it is sufficient to include the borders of all these
+    blocks. */
+SgPointSet LadderRegion(const GoBoard& bd, const SgPointSet& path)
+{
+    SgPointSet region(path);
+    region |= path.Border(bd.Size());
+    const SgPointSet nearPath(region);
+    AddBlocks(bd, nearPath, region);
+    const SgPointSet nearBlocks(region);
+    AddBlocks(bd, nearBlocks, region);
+    return region;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoLadderCache::Data::Data()
+    : m_isValid(false),
+      m_stamp(0),
+      m_size(0),
+      m_koPoint(SG_NULLPOINT),
+      m_toPlay(SG_BLACK),
+      m_result(0)
+{ }
+
+bool GoLadderCache::Data::IsValid() const
+{
+    return m_isValid;
+}
+
+void GoLadderCache::Data::Invalidate()
+{
+    m_isValid = false;
+}
+
+bool GoLadderCache::Data::IsBetterThan(const Data& data) const
+{
+    return m_stamp > data.m_stamp;
+}
+
+bool GoLadderCache::Data::Matches(const GoBoard& bd) const
+{
+    return m_size == bd.Size()
+        && m_koPoint == bd.KoPoint()
+        && (m_koPoint == SG_NULLPOINT || m_toPlay == bd.ToPlay())
+        && (bd.All(SG_BLACK) & m_region) == m_stones[SG_BLACK]
+        && (bd.All(SG_WHITE) & m_region) == m_stones[SG_WHITE];
+}
+
+//----------------------------------------------------------------------------
+
+GoLadderCache::GoLadderCache(int maxHash)
+    : m_table(maxHash),
+      m_nuLookups(0),
+      m_nuHits(0),
+      m_nuStores(0)
+{ }
+
+void GoLadderCache::Clear()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_table.Clear();
+    m_nuLookups = 0;
+    m_nuHits = 0;
+    m_nuStores = 0;
+}
+
+void GoLadderCache::FindLadderEscapeMoves(const GoBoard& bd, SgPoint prey,
+                                          SgVector<SgPoint>& escapeMoves)
+{
+    GoLadderUtil::FindLadderEscapeMoves(*this, bd, prey, escapeMoves);
+}
+
+GoLadderCache& GoLadderCache::Global()
+{
+    static GoLadderCache s_cache;
+    return s_cache;
+}
+
+bool GoLadderCache::IsLadderCaptured(const GoBoard& bd, SgPoint prey,
+                                     SgBlackWhite toPlay,
+                                     bool twoLibIsEscape,
+                                     SgVector<SgPoint>* sequence)
+{
+    return GoLadderUtil::Ladder(*this, bd, prey, toPlay, twoLibIsEscape,
+                                sequence);
+}
+
+bool GoLadderCache::IsLadderCaptureMove(const GoBoard& bd, SgPoint prey,
+                                        SgPoint firstMove)
+{
+    return GoLadderUtil::IsLadderCaptureMove(*this, bd, prey, firstMove);
+}
+
+bool GoLadderCache::IsLadderEscapeMove(const GoBoard& bd, SgPoint prey,
+                                       SgPoint firstMove)
+{
+    return GoLadderUtil::IsLadderEscapeMove(*this, bd, prey, firstMove);
+}
+
+bool GoLadderCache::IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
+                                       SgBlackWhite col, bool& byLadder,
+                                       bool& isKoCut, bool tryLadder)
+{
+    return GoLadderUtil::IsProtectedLiberty(*this, bd, liberty, col,
+                                            byLadder, isKoCut, tryLadder);
+}
+
+bool GoLadderCache::IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
+                                       SgBlackWhite col)
+{
+    bool ignoreLadder;
+    bool ignoreKo;
+    return IsProtectedLiberty(bd, liberty, col, ignoreLadder, ignoreKo,
+                              true);
+}
+
+int GoLadderCache::Ladder(const GoBoard& bd, SgPoint prey,
+                          SgBlackWhite toPlay, SgVector<SgPoint>* sequence,
+                          bool twoLibIsEscape)
+{
+    if (! bd.Occupied(prey))
+    {
+        if (sequence)
+            sequence->Clear();
+        return 0;
+    }
+    const SgPoint anchor = bd.Anchor(prey);
+    const GoRules& rules = bd.Rules();
+    const unsigned int key = anchor
+                             + SG_MAXPOINT * (toPlay
+                                              + 2 * twoLibIsEscape
+                                              + 4 * rules.AllowSuicide()
+                                              + 8 * rules.GetKoRule());
+    SgHashCode code(key);
+    Data data;
+    if (! Lookup(code, bd, data))
+    {
+        GoLadder ladder;
+        SgPointSet path;
+        ladder.RecordPath(&path);
+        data.m_result = ladder.Ladder(bd, anchor, toPlay, &data.m_sequence,
+                                      twoLibIsEscape);
+        // The result of an aborted ladder depends on the move number
+        if (! ladder.Overflow())
+        {
+            data.m_size = bd.Size();
+            data.m_koPoint = bd.KoPoint();
+            data.m_toPlay = bd.ToPlay();
+            data.m_region = LadderRegion(bd, path);
+            data.m_stones[SG_BLACK] = bd.All(SG_BLACK) & data.m_region;
+            data.m_stones[SG_WHITE] = bd.All(SG_WHITE) & data.m_region;
+            Store(code, data);
+        }
+    }
+    if (sequence)
+        *sequence = data.m_sequence;
+    return data.m_result;
+}
+
+GoLadderStatus GoLadderCache::LadderStatus(const GoBoard& bd, SgPoint prey,
+                                           bool twoLibIsEscape,
+                                           SgPoint* toCapture,
+                                           SgPoint* toEscape)
+{
+    return GoLadderUtil::LadderStatus(*this, bd, prey, twoLibIsEscape,
+                                      toCapture, toEscape);
+}
+
+bool GoLadderCache::Lookup(const SgHashCode& code, const GoBoard& bd,
+                           Data& data)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    ++m_nuLookups;
+    if (! m_table.Lookup(code, &data) || ! data.Matches(bd))
+        return false;
+    ++m_nuHits;
+    return true;
+}
+
+size_t GoLadderCache::NuHits() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_nuHits;
+}
+
+size_t GoLadderCache::NuLookups() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_nuLookups;
+}
+
+void GoLadderCache::Store(const SgHashCode& code, Data& data)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    data.m_isValid = true;
+    data.m_stamp = ++m_nuStores;
+    m_table.Store(code, data);
+}
+
+void GoLadderCache::WriteStatistics(ostream& out) const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    out << SgWriteLabel("Entries") << m_table.MaxHash() << '\n'
+        << SgWriteLabel("Lookups") << m_nuLookups << '\n'
+        << SgWriteLabel("Hits") << m_nuHits << '\n'
+        << SgWriteLabel("Stores") << m_nuStores << '\n'
+        << SgWriteLabel("Collisions") << m_table.NuCollisions() << '\n';
+}
+
+//----------------------------------------------------------------------------
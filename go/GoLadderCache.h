@@ -0,0 +1,166 @@
+//----------------------------------------------------------------------------
+/** @file GoLadderCache.h
+    Cache for the results of the ladder reading. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_LADDERCACHE_H
+#define GO_LADDERCACHE_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <boost/thread/mutex.hpp>
+#include "GoLadder.h"
+#include "SgBWSet.h"
+#include "SgHashTable.h"
+#include "SgPointSet.h"
+#include "SgVector.h"
+
+//----------------------------------------------------------------------------
+
+/** Ladder reader that memoizes the results of GoLadder.
+    The same ladders are read over and over by the move filter, the ladder
+    knowledge and the move features, in the positions of the search tree
+    that differ only in moves far away from the ladder. Each read plays out
+    the whole ladder with GoBoard::Play() and GoBoard::Undo(), which is
+    expensive for long ladders on 19x19.
+    The results are stored keyed by the anchor of the prey, the color to
+    play first and the rules. Each entry also stores the region that the
+    result depends on: the stones and liberties of all blocks at or next to
+    the prey and the points where GoLadder tried moves, and the blocks next
+    to these blocks. An entry is used as long as the stones in its region
+    are the same, so it is invalidated only by a stone that lands on the
+    path of the ladder or changes the blocks along the path.
+    GoLadder tries the moves in the order of the liberties of the blocks,
+    which depends on the history of the position. A cached result has the
+    same sign as a new read, but the sequence and the depth encoded in the
+    result are those of the position where it was stored.
+    The repetition check of GoBoard::IsLegal() for other ko rules than
+    GoRules::SIMPLEKO depends on the history of the game, which is not part
+    of the region; a positional superko inside of a ladder is ignored.
+    GoLadderCache has the same Ladder() function as GoLadder, so it can be
+    used with the versions of the GoLadderUtil functions that take a ladder
+    reader. All functions are thread-safe. The ladders are read outside of
+    the lock. */
+class GoLadderCache
+{
+public:
+    /** Constructor.
+        @param maxHash The number of entries of the hash table */
+    explicit GoLadderCache(int maxHash = 16384);
+
+    /** The cache shared by the move filter, knowledge and features. */
+    static GoLadderCache& Global();
+
+    /** Cached version of GoLadder::Ladder(). */
+    int Ladder(const GoBoard& bd, SgPoint prey, SgBlackWhite toPlay,
+               SgVector<SgPoint>* sequence, bool twoLibIsEscape = false);
+
+    /** Cached version of GoLadderUtil::Ladder(). */
+    bool IsLadderCaptured(const GoBoard& bd, SgPoint prey,
+                          SgBlackWhite toPlay, bool twoLibIsEscape = false,
+                          SgVector<SgPoint>* sequence = 0);
+
+    /** Cached version of GoLadderUtil::LadderStatus(). */
+    GoLadderStatus LadderStatus(const GoBoard& bd, SgPoint prey,
+                                bool twoLibIsEscape = false,
+                                SgPoint* toCapture = 0,
+                                SgPoint* toEscape = 0);
+
+    /** Cached version of GoLadderUtil::IsLadderCaptureMove(). */
+    bool IsLadderCaptureMove(const GoBoard& bd, SgPoint prey,
+                             SgPoint firstMove);
+
+    /** Cached version of GoLadderUtil::IsLadderEscapeMove(). */
+    bool IsLadderEscapeMove(const GoBoard& bd, SgPoint prey,
+                            SgPoint firstMove);
+
+    /** Cached version of GoLadderUtil::FindLadderEscapeMoves(). */
+    void FindLadderEscapeMoves(const GoBoard& bd, SgPoint prey,
+                               SgVector<SgPoint>& escapeMoves);
+
+    /** Cached version of GoLadderUtil::IsProtectedLiberty(). */
+    bool IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
+                            SgBlackWhite col, bool& byLadder,
+                            bool& isKoCut, bool tryLadder = true);
+
+    /** Cached version of the simple form of
+        GoLadderUtil::IsProtectedLiberty(). */
+    bool IsProtectedLiberty(const GoBoard& bd, SgPoint liberty,
+                            SgBlackWhite col);
+
+    /** Remove all entries and reset the statistics. */
+    void Clear();
+
+    /** Write the number of lookups and hits. */
+    void WriteStatistics(std::ostream& out) const;
+
+    std::size_t NuLookups() const;
+
+    std::size_t NuHits() const;
+
+private:
+    /** Entry of the hash table as required by SgHashTable. */
+    struct Data
+    {
+        bool m_isValid;
+
+        /** Number of the store, used for replacing the oldest entry. */
+        std::size_t m_stamp;
+
+        int m_size;
+
+        /** GoBoard::KoPoint() of the position. */
+        SgPoint m_koPoint;
+
+        /** GoBoard::ToPlay() of the position.
+            Only relevant if there is a ko point. */
+        SgBlackWhite m_toPlay;
+
+        /** The points that the result depends on. */
+        SgPointSet m_region;
+
+        /** The stones in m_region. */
+        SgBWSet m_stones;
+
+        /** Return value of GoLadder::Ladder() */
+        int m_result;
+
+        SgVector<SgPoint> m_sequence;
+
+        Data();
+
+        bool IsValid() const;
+
+        void Invalidate();
+
+        bool IsBetterThan(const Data& data) const;
+
+        /** Check if the result is valid in a position. */
+        bool Matches(const GoBoard& bd) const;
+    };
+
+    /** Protects all other members. */
+    mutable boost::mutex m_mutex;
+
+    SgHashTable<Data,4> m_table;
+
+    std::size_t m_nuLookups;
+
+    std::size_t m_nuHits;
+
+    std::size_t m_nuStores;
+
+    bool Lookup(const SgHashCode& code, const GoBoard& bd, Data& data);
+
+    void Store(const SgHashCode& code, Data& data);
+
+    /** Not implemented */
+    GoLadderCache(const GoLadderCache&);
+
+    /** Not implemented */
+    GoLadderCache& operator=(const GoLadderCache&);
+};
+
+//----------------------------------------------------------------------------
+
+#endif // GO_LADDERCACHE_H
@@ -78,7 +78,9 @@ GoRegion::GoRegion(const GoBoard& board, const SgPointSet& points,
           m_eyes(),
           m_vitalPoint(SG_NULLMOVE),
           m_1vcDepth(0),
-          m_miaiStrategy(color)
+          m_miaiStrategy(color),
+          m_hasBasicFlags(false),
+          m_basicMiaiStrategy(color)
 {
 #ifndef NDEBUG
     ++s_alloc;
@@ -1032,6 +1034,13 @@ int GoRegion::s_free = 0;
 void GoRegion::ComputeBasicFlags()
 {
     SG_ASSERT(! IsValid());
+    if (m_hasBasicFlags)
+    {
+        m_flags = m_basicFlags;
+        m_computedFlags = m_basicComputedFlags;
+        m_miaiStrategy = m_basicMiaiStrategy;
+        return;
+    }
     m_flags.set(GO_REGION_VALID);
     DoComputeFlag(GO_REGION_SMALL);
     DoComputeFlag(GO_REGION_CORRIDOR);
@@ -1039,6 +1048,10 @@ void GoRegion::ComputeBasicFlags()
     DoComputeFlag(GO_REGION_STATIC_1VC);
     DoComputeFlag(GO_REGION_STATIC_2V);
     SetFlag(GO_REGION_USED_FOR_MERGE, false);
+    m_basicFlags = m_flags;
+    m_basicComputedFlags = m_computedFlags;
+    m_basicMiaiStrategy = m_miaiStrategy;
+    m_hasBasicFlags = true;
 }
 
 bool GoRegion::Has2Conn() const
@@ -196,8 +196,17 @@ public:
     void ResetNonBlockFlags()
     {   m_computedFlags.reset(); // clear all other flags.
         m_computedFlags.set(GO_REGION_COMPUTED_BLOCKS);
+        m_flags.reset(); // also resets GO_REGION_VALID
         m_eyes.Clear();
-        Invalidate();
+        m_miaiStrategy.Clear();
+        m_hasBasicFlags = false;
+    }
+
+    /** For incremental update - the chains were deleted by GoRegionBoard */
+    void ClearChains()
+    {
+        m_chains.Clear();
+        m_computedFlags.reset(GO_REGION_COMPUTED_CHAINS);
     }
 
     /** is region data valid? */
@@ -208,7 +217,10 @@ public:
 
     /** Computes GO_REGION_SMALL, GO_REGION_CORRIDOR, 
         GO_REGION_SINGLE_BLOCK_BOUNDARY, 
-        GO_REGION_STATIC_1VC, GO_REGION_STATIC_2V */
+        GO_REGION_STATIC_1VC, GO_REGION_STATIC_2V.
+        These flags depend only on the points and blocks of the region, so
+        they are stored and reused by ReInitialize() until the next
+        ResetNonBlockFlags(). */
     void ComputeBasicFlags();
 
     /** compute flag */
@@ -393,6 +405,18 @@ private:
     /** Miai strategy to keep region safe. */
     SgMiaiStrategy m_miaiStrategy;
 
+    /** Is m_basicFlags up to date? */
+    bool m_hasBasicFlags;
+
+    /** m_flags after ComputeBasicFlags() */
+    GoRegionFlags m_basicFlags;
+
+    /** m_computedFlags after ComputeBasicFlags() */
+    GoRegionFlags m_basicComputedFlags;
+
+    /** m_miaiStrategy after ComputeBasicFlags() */
+    SgMiaiStrategy m_basicMiaiStrategy;
+
     /** A simple test if all cuts between blocks are protected. 
         Works only for corridors (@see IsCorridor):
         If corridor, then opp. can get at most 2 libs (Opp2L).
@@ -106,7 +106,7 @@ void GoRegionBoard::Clear()
     m_allRegions[SG_WHITE].Clear();
     m_allChains[SG_BLACK].Clear();
     m_allChains[SG_WHITE].Clear();
-    m_stack.Clear();
+    ClearStack();
     m_code.Clear();
     m_invalid = true;
     m_computedHealthy = false;
@@ -127,6 +127,40 @@ void GoRegionBoard::Clear()
         m_block[p] = 0;
 }
 
+void GoRegionBoard::ClearStack()
+{
+    while (! m_stack.IsEmpty())
+    {
+        int val = m_stack.PopEvent();
+        switch (val)
+        {
+            case SG_NEXTMOVE:
+            break;
+            case REGION_REMOVE:
+                delete static_cast<GoRegion*>(m_stack.PopPtr());
+            break;
+            case REGION_ADD:
+            case REGION_ADD_BLOCK:
+                m_stack.PopPtr();
+            break;
+            case REGION_REMOVE_BLOCK:
+            {   GoBlock* b = static_cast<GoBlock*>(m_stack.PopPtr());
+                for (int nu = m_stack.PopInt(); nu > 0; --nu)
+                    m_stack.PopPtr();
+                delete b;
+            }
+            break;
+            case REGION_ADD_STONE:
+            case REGION_ADD_STONE_TO_BLOCK:
+                m_stack.PopPtr();
+                m_stack.PopInt();
+            break;
+            default:
+                SG_ASSERT(false);
+        }
+    }
+}
+
 void GoRegionBoard::UpdateBlock(int move, SgBlackWhite moveColor)
 {
     SgPoint anchor = Board().Anchor(move); // board is already up to date.
@@ -201,6 +235,12 @@ void GoRegionBoard::OnExecutedUncodedMove(int move, SgBlackWhite moveColor)
             // can't handle yet,
             // should be forbidden anyway. @todo allowed in Chinese rules.
             bool fWasCapture = Board().LastMoveInfo(GO_MOVEFLAG_CAPTURING);
+            SgPointSet changed;
+            changed.Include(move);
+            if (fWasCapture)
+                for (GoPointList::Iterator it(Board().CapturedStones());
+                     it; ++it)
+                    changed.Include(*it);
 
             UpdateBlock(move, moveColor);
 
@@ -231,23 +271,12 @@ void GoRegionBoard::OnExecutedUncodedMove(int move, SgBlackWhite moveColor)
                 MergeAdjacentAndAddBlock(move, SgOppBW(moveColor));
             }
 
+            OnChanged(changed);
             m_code = Board().GetHashCode();
             if (HEAVYCHECK)
                 CheckConsistency();
         }
     }
-
-    {
-        for (SgBWIterator cit; cit; ++cit)
-        {
-            SgBlackWhite color(*cit);
-            for (SgVectorIteratorOf<GoRegion> it(AllRegions(color)); it; ++it)
-            {   GoRegion* r1 = *it;
-                if (! r1->IsValid())
-                    r1->ComputeBasicFlags();
-            }
-        }
-    }
 }
 
 void GoRegionBoard::CheckConsistency() const
@@ -507,7 +536,7 @@ void GoRegionBoard::OnUndoneMove()
         SgDebug() << "OnUndoneMove " << '\n';
 
     const bool IS_UNDO = false;
-    SgVectorOf<GoRegion> changed;
+    SgPointSet changed;
 
     for (int val = m_stack.PopEvent(); val != SG_NEXTMOVE;
          val = m_stack.PopEvent())
@@ -518,7 +547,6 @@ void GoRegionBoard::OnUndoneMove()
             case REGION_REMOVE:
             {   GoRegion* r = static_cast<GoRegion*>(m_stack.PopPtr());
                 AddRegion(r, IS_UNDO);
-                changed.Insert(r);
             }
             break;
             case REGION_ADD:
@@ -529,18 +557,19 @@ void GoRegionBoard::OnUndoneMove()
             case REGION_REMOVE_BLOCK:
             {   GoBlock* b = static_cast<GoBlock*>(m_stack.PopPtr());
                 AddBlock(b, IS_UNDO);
+                changed |= b->Stones();
                 for (int nu = m_stack.PopInt(); nu > 0; --nu)
                 {
                     GoRegion* r = static_cast<GoRegion*>(m_stack.PopPtr());
                     if (CHECK)
                         SG_ASSERT(! r->Blocks().Contains(b));
                     r->BlocksNonConst().PushBack(b);
-                    changed.Insert(r);
                 }
             }
             break;
             case REGION_ADD_BLOCK:
             {   GoBlock* b = static_cast<GoBlock*>(m_stack.PopPtr());
+                changed |= b->Stones();
                 RemoveBlock(b, IS_UNDO, true);
             }
             break;
@@ -549,7 +578,7 @@ void GoRegionBoard::OnUndoneMove()
                 SgPoint p = m_stack.PopInt();
                 r->OnRemoveStone(p);
                 m_region[r->Color()][p] = r;
-                changed.Insert(r);
+                changed.Include(p);
             }
             break;
             case REGION_ADD_STONE_TO_BLOCK:
@@ -564,11 +593,7 @@ void GoRegionBoard::OnUndoneMove()
         }
     }
 
-    for (SgVectorIteratorOf<GoRegion> it(changed); it; ++it)
-    {
-        (*it)->ResetNonBlockFlags();
-        (*it)->ComputeBasicFlags();
-    }
+    OnChanged(changed);
 
     if (HEAVYCHECK)
     {
@@ -593,6 +618,7 @@ void GoRegionBoard::ReInitializeBlocksRegions()
 {
     SG_ASSERT(UpToDate());
 
+    ClearChains();
     for (SgBWIterator cit; cit; ++cit)
     {
         SgBlackWhite color(*cit);
@@ -601,6 +627,8 @@ void GoRegionBoard::ReInitializeBlocksRegions()
         for (SgVectorIteratorOf<GoRegion> it2(AllRegions(color)); it2; ++it2)
             (*it2)->ReInitialize();
     }
+    FindBlocksWithEye();
+    m_computedHealthy = false;
 }
 
 GoRegion* GoRegionBoard::GenRegion(const SgPointSet& area,
@@ -686,6 +714,74 @@ void GoRegionBoard::GenChains()
     m_chainsCode = Board().GetHashCode();
 }
 
+void GoRegionBoard::ClearChains()
+{
+    for (SgBWIterator cit; cit; ++cit)
+    {
+        SgBlackWhite color(*cit);
+        for (SgVectorIteratorOf<GoChain> it(AllChains(color)); it; ++it)
+            delete *it;
+        AllChains(color).Clear();
+        for (SgVectorIteratorOf<GoRegion> it(AllRegions(color)); it; ++it)
+            (*it)->ClearChains();
+    }
+    m_chainsCode.Clear();
+}
+
+void GoRegionBoard::OnChanged(const SgPointSet& changed)
+{
+    const int size = Board().Size();
+    // The liberties of the blocks next to the changed points have changed,
+    // so recompute the flags of all regions adjacent to these blocks
+    SgPointSet affected(changed | changed.Border(size));
+    // Only the safety solvers create chains, and they rebuild them in each
+    // position
+    if (AllChains(SG_BLACK).NonEmpty() || AllChains(SG_WHITE).NonEmpty())
+        ClearChains();
+    m_chainsCode.Clear();
+    SgVectorOf<GoBlock> blocks;
+    SgPointSet stones(affected & Board().Occupied());
+    while (stones.NonEmpty())
+    {
+        GoBlock* b = m_block[stones.PointOf()];
+        affected |= b->Stones().Border(size);
+        stones -= b->Stones();
+        blocks.PushBack(b);
+    }
+    for (SgBWIterator cit; cit; ++cit)
+    {
+        SgBlackWhite color(*cit);
+        for (SgVectorIteratorOf<GoRegion> it(AllRegions(color)); it; ++it)
+        {
+            GoRegion* r = *it;
+            if (! r->Points().Overlaps(affected))
+                continue;
+            if (r->IsValid())
+                r->ResetNonBlockFlags();
+            // Regions restored by an undo can refer to deleted chains
+            r->ClearChains();
+            r->ComputeBasicFlags();
+            for (SgVectorIteratorOf<GoBlock> it2(r->Blocks()); it2; ++it2)
+                if (! blocks.Contains(*it2))
+                    blocks.PushBack(*it2);
+        }
+    }
+    // The healthy regions and eyes of the other blocks did not change
+    for (SgVectorIteratorOf<GoBlock> it(blocks); it; ++it)
+    {
+        GoBlock* b = *it;
+        b->ReInitialize();
+        for (GoBoard::StoneIterator it2(Board(), b->Anchor()); it2; ++it2)
+            for (GoNbIterator nb(Board(), *it2); nb; ++nb)
+            {
+                const GoRegion* r = m_region[b->Color()][*nb];
+                if (r != 0 && r->Blocks().IsLength(1))
+                    b->TestFor1Eye(r);
+            }
+    }
+    m_computedHealthy = false;
+}
+
 void GoRegionBoard::WriteBlocks(std::ostream& stream) const
 {
     for (SgBWIterator cit; cit; ++cit)
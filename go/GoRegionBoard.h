@@ -227,6 +227,23 @@ private:
     void FindBlocksWithEye();
 
     // Execute move helpers
+    /** Delete all chains */
+    void ClearChains();
+
+    /** Clear the undo information of all moves.
+        Deletes the blocks and regions that were removed by the moves and are
+        only referenced by the undo information. */
+    void ClearStack();
+
+    /** Update the data that is not updated incrementally after a move was
+        executed or undone.
+        Recomputes the flags of the regions that contain changed points or
+        are adjacent to blocks next to changed points, and the eyes of the
+        blocks next to these regions. Resets the healthy regions and safe
+        flags of these blocks. Deletes the chains, if a solver created them.
+        @param changed The points that changed color */
+    void OnChanged(const SgPointSet& changed);
+
     /** Generate the block with given anchor */
     GoBlock* GenBlock(SgPoint anchor, SgBlackWhite color);
 
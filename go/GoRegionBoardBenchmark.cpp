@@ -0,0 +1,105 @@
+//----------------------------------------------------------------------------
+/** @file GoRegionBoardBenchmark.cpp
+    See GoRegionBoardBenchmark.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoRegionBoardBenchmark.h"
+
+#include <iomanip>
+#include <iostream>
+#include "GoBoard.h"
+#include "GoRegionBoard.h"
+#include "GoRegionBoardSynchronizer.h"
+#include "GoSafetySolver.h"
+#include "SgBWSet.h"
+#include "SgException.h"
+#include "SgTime.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+GoRegionBoardBenchmarkResult::GoRegionBoardBenchmarkResult()
+    : m_nuMoves(0),
+      m_playTime(0),
+      m_undoTime(0),
+      m_rebuildTime(0),
+      m_solveTime(0),
+      m_solveRebuildTime(0)
+{ }
+
+void GoRegionBoardBenchmarkResult::Write(ostream& out) const
+{
+    const double n = m_nuMoves > 0 ? double(m_nuMoves) : 1;
+    out << fixed << setprecision(3)
+        << "moves " << m_nuMoves
+        << " play_us " << 1e6 * m_playTime / n
+        << " undo_us " << 1e6 * m_undoTime / n
+        << " rebuild_us " << 1e6 * m_rebuildTime / n
+        << " solve_us " << 1e6 * m_solveTime / n
+        << " solve_rebuild_us " << 1e6 * m_solveRebuildTime / n
+        << " speedup " << setprecision(1)
+        << (m_playTime > 0 ? m_rebuildTime / m_playTime : 0)
+        << '\n';
+}
+
+//----------------------------------------------------------------------------
+
+GoRegionBoardBenchmarkResult GoRegionBoardBenchmark::Run(const GoBoard& bd,
+                                                         int nuRepetitions)
+{
+    GoRegionBoardBenchmarkResult result;
+    GoBoard publisher(bd.Size(), bd.Setup(), bd.Rules());
+    for (int i = 0; i < nuRepetitions; ++i)
+    {
+        GoRegionBoardSynchronizer synchronizer(publisher);
+        synchronizer.UpdateSubscriber();
+        synchronizer.Regions().GenBlocksRegions();
+        const size_t nuRebuilds = synchronizer.NuRebuilds();
+        for (int j = 0; j < bd.MoveNumber(); ++j)
+        {
+            const GoPlayerMove move = bd.Move(j);
+            publisher.Play(move);
+            if (publisher.LastMoveInfo(GO_MOVEFLAG_SUICIDE))
+                throw SgException("GoRegionBoardBenchmark: suicide move");
+            double time = SgTime::Get(SG_TIME_REAL);
+            synchronizer.UpdateSubscriber();
+            result.m_playTime += SgTime::Get(SG_TIME_REAL) - time;
+            time = SgTime::Get(SG_TIME_REAL);
+            {
+                GoRegionBoard regions(publisher);
+            }
+            result.m_rebuildTime += SgTime::Get(SG_TIME_REAL) - time;
+            ++result.m_nuMoves;
+        }
+        while (publisher.MoveNumber() > 0)
+        {
+            publisher.Undo();
+            const double time = SgTime::Get(SG_TIME_REAL);
+            synchronizer.UpdateSubscriber();
+            result.m_undoTime += SgTime::Get(SG_TIME_REAL) - time;
+        }
+        for (int j = 0; j < bd.MoveNumber(); ++j)
+        {
+            publisher.Play(bd.Move(j));
+            SgBWSet safe;
+            double time = SgTime::Get(SG_TIME_REAL);
+            synchronizer.UpdateSubscriber();
+            GoSafetySolver(synchronizer.Board(), &synchronizer.Regions())
+                .FindSafePoints(&safe);
+            result.m_solveTime += SgTime::Get(SG_TIME_REAL) - time;
+            time = SgTime::Get(SG_TIME_REAL);
+            GoSafetySolver(publisher).FindSafePoints(&safe);
+            result.m_solveRebuildTime += SgTime::Get(SG_TIME_REAL) - time;
+        }
+        while (publisher.MoveNumber() > 0)
+            publisher.Undo();
+        synchronizer.UpdateSubscriber();
+        SG_ASSERT(synchronizer.NuRebuilds() == nuRebuilds);
+        SG_UNUSED(nuRebuilds);
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------
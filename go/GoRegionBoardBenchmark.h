@@ -0,0 +1,72 @@
+//----------------------------------------------------------------------------
+/** @file GoRegionBoardBenchmark.h
+    Benchmark for the incremental update of GoRegionBoard. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_REGIONBOARDBENCHMARK_H
+#define GO_REGIONBOARDBENCHMARK_H
+
+#include <cstddef>
+#include <iosfwd>
+
+class GoBoard;
+
+//----------------------------------------------------------------------------
+
+/** Result of a GoRegionBoardBenchmark run. */
+struct GoRegionBoardBenchmarkResult
+{
+    /** Number of moves replayed in all repetitions. */
+    std::size_t m_nuMoves;
+
+    /** Time in seconds for updating the regions with
+        GoRegionBoardSynchronizer after each move, including the move on the
+        board of the synchronizer. */
+    double m_playTime;
+
+    /** Time in seconds for updating the regions after undoing each move. */
+    double m_undoTime;
+
+    /** Time in seconds for building the regions from scratch in the
+        position after each move, as the safety solvers do without a shared
+        GoRegionBoard. */
+    double m_rebuildTime;
+
+    /** Time in seconds for updating the regions after each move and running
+        GoSafetySolver on them, as GoUctDefaultMoveFilter does. */
+    double m_solveTime;
+
+    /** Time in seconds for running GoSafetySolver without a shared
+        GoRegionBoard in the position after each move. */
+    double m_solveRebuildTime;
+
+    GoRegionBoardBenchmarkResult();
+
+    /** Write the result as a single line of space-separated key value
+        pairs, with the mean times per move in microseconds. */
+    void Write(std::ostream& out) const;
+};
+
+//----------------------------------------------------------------------------
+
+/** Compare the cost of the incremental update of a GoRegionBoard with
+    rebuilding it in each position of a game. */
+namespace GoRegionBoardBenchmark
+{
+    /** Replay the moves of a board.
+        Starts from the setup of the board, plays all moves of the board and
+        undoes them again. Measures the time of the incremental update in
+        each position and the time for building the regions from scratch.
+        Then replays the moves again and measures the safety solver with and
+        without the incrementally updated regions.
+        @param bd The board with the moves of the game, e.g. loaded from a
+        game record
+        @param nuRepetitions The number of times the moves are replayed
+        @throws SgException If the game contains a suicide move, which is not
+        supported by the incremental update */
+    GoRegionBoardBenchmarkResult Run(const GoBoard& bd, int nuRepetitions);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_REGIONBOARDBENCHMARK_H
@@ -0,0 +1,71 @@
+//----------------------------------------------------------------------------
+/** @file GoRegionBoardSynchronizer.cpp
+    See GoRegionBoardSynchronizer.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoRegionBoardSynchronizer.h"
+
+//----------------------------------------------------------------------------
+
+GoRegionBoardSynchronizer::GoRegionBoardSynchronizer(
+                                                  const GoBoard& publisher)
+    : GoBoardSynchronizer(publisher),
+      m_regions(m_bd),
+      m_nuMoves(0),
+      m_nuIncrementalUpdates(0),
+      m_nuRebuilds(0)
+{
+    SetSubscriber(m_bd);
+}
+
+GoRegionBoardSynchronizer::~GoRegionBoardSynchronizer()
+{ }
+
+void GoRegionBoardSynchronizer::ClearRegions()
+{
+    m_regions.Clear();
+    m_nuMoves = 0;
+    ++m_nuRebuilds;
+}
+
+void GoRegionBoardSynchronizer::OnBoardChange()
+{
+    ClearRegions();
+}
+
+void GoRegionBoardSynchronizer::OnPlay(GoPlayerMove move)
+{
+    // GoRegionBoard cannot handle the removal of own stones
+    if (m_bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE))
+        ClearRegions();
+    else
+    {
+        m_regions.OnExecutedMove(move);
+        ++m_nuMoves;
+        ++m_nuIncrementalUpdates;
+    }
+}
+
+void GoRegionBoardSynchronizer::OnUndo()
+{
+    if (m_nuMoves == 0)
+        ClearRegions();
+    else
+    {
+        m_regions.OnUndoneMove();
+        --m_nuMoves;
+        ++m_nuIncrementalUpdates;
+    }
+}
+
+void GoRegionBoardSynchronizer::PrePlay(GoPlayerMove move)
+{
+    SG_UNUSED(move);
+    // A rebuild of the regions clears their undo stack
+    if (! m_regions.UpToDate())
+        m_nuMoves = 0;
+    m_regions.ExecuteMovePrologue();
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+//----------------------------------------------------------------------------
+/** @file GoRegionBoardSynchronizer.h
+    Incremental update of a GoRegionBoard to the position of a GoBoard. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_REGIONBOARDSYNCHRONIZER_H
+#define GO_REGIONBOARDSYNCHRONIZER_H
+
+#include <cstddef>
+#include "GoBoard.h"
+#include "GoBoardSynchronizer.h"
+#include "GoRegionBoard.h"
+
+//----------------------------------------------------------------------------
+
+/** Keeps a GoRegionBoard up to date with the position of a GoBoard.
+    The moves of the publisher board are replayed on an own board with
+    GoBoardSynchronizer, and the blocks and regions are updated with
+    GoRegionBoard::OnExecutedMove() and GoRegionBoard::OnUndoneMove() instead
+    of being rebuilt from scratch in every position. This is meant for users
+    that analyze consecutive positions of a game or search with the safety
+    solvers, like GoUctDefaultMoveFilter.
+    The region board is rebuilt only if the board is initialized with a new
+    size or setup, after a suicide move, or if moves are undone that were
+    played before the last rebuild. */
+class GoRegionBoardSynchronizer
+    : public GoBoardSynchronizer
+{
+public:
+    /** Constructor.
+        Call UpdateSubscriber() to update the regions to the position of the
+        publisher.
+        @param publisher The board to follow */
+    explicit GoRegionBoardSynchronizer(const GoBoard& publisher);
+
+    ~GoRegionBoardSynchronizer();
+
+    /** The board of the regions.
+        Has the position of the publisher after UpdateSubscriber(). */
+    const GoBoard& Board() const;
+
+    /** The regions of Board().
+        The regions are computed when needed, e.g. by
+        GoRegionBoard::GenBlocksRegions() or the safety solvers. The solvers
+        can modify the regions (e.g. merge chains or set flags), which is
+        compatible with the incremental update. */
+    GoRegionBoard& Regions();
+
+    /** Number of moves and undos that updated the regions incrementally. */
+    std::size_t NuIncrementalUpdates() const;
+
+    /** Number of times that the regions were cleared, because they could
+        not be updated incrementally. */
+    std::size_t NuRebuilds() const;
+
+protected:
+    void OnBoardChange();
+
+    void PrePlay(GoPlayerMove move);
+
+    void OnPlay(GoPlayerMove move);
+
+    void OnUndo();
+
+private:
+    GoBoard m_bd;
+
+    GoRegionBoard m_regions;
+
+    /** Number of moves on the undo stack of m_regions. */
+    int m_nuMoves;
+
+    std::size_t m_nuIncrementalUpdates;
+
+    std::size_t m_nuRebuilds;
+
+    void ClearRegions();
+};
+
+inline const GoBoard& GoRegionBoardSynchronizer::Board() const
+{
+    return m_bd;
+}
+
+inline std::size_t GoRegionBoardSynchronizer::NuIncrementalUpdates() const
+{
+    return m_nuIncrementalUpdates;
+}
+
+inline std::size_t GoRegionBoardSynchronizer::NuRebuilds() const
+{
+    return m_nuRebuilds;
+}
+
+inline GoRegionBoard& GoRegionBoardSynchronizer::Regions()
+{
+    return m_regions;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GO_REGIONBOARDSYNCHRONIZER_H
@@ -0,0 +1,182 @@
+//----------------------------------------------------------------------------
+/** @file GoSafetyCache.cpp
+    See GoSafetyCache.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoSafetyCache.h"
+
+#include <iostream>
+#include "GoBensonSolver.h"
+#include "GoBoard.h"
+#include "GoRegion.h"
+#include "GoRegionBoard.h"
+#include "GoSafetySolver.h"
+#include "SgWrite.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Points of the regions of each color that contain opponent stones. */
+void FindPotentialCapture(const GoBoard& bd, const GoRegionBoard& regions,
+                          SgBWSet& potentialCapture)
+{
+    potentialCapture.Clear();
+    for (SgBWIterator cit; cit; ++cit)
+    {
+        const SgBlackWhite c = *cit;
+        const SgPointSet& oppStones = bd.All(SgOppBW(c));
+        for (SgVectorIteratorOf<GoRegion> it(regions.AllRegions(c)); it; ++it)
+            if ((*it)->Points().Overlaps(oppStones))
+                potentialCapture[c] |= (*it)->Points();
+    }
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoSafetyCache::Data::Data()
+    : m_isValid(false),
+      m_size(0),
+      m_stamp(0)
+{ }
+
+bool GoSafetyCache::Data::IsValid() const
+{
+    return m_isValid;
+}
+
+void GoSafetyCache::Data::Invalidate()
+{
+    m_isValid = false;
+}
+
+bool GoSafetyCache::Data::IsBetterThan(const Data& data) const
+{
+    return m_stamp > data.m_stamp;
+}
+
+//----------------------------------------------------------------------------
+
+GoSafetyCache::Statistics::Statistics()
+    : m_nuLookups(0),
+      m_nuHits(0)
+{ }
+
+//----------------------------------------------------------------------------
+
+GoSafetyCache::GoSafetyCache(int maxHash)
+    : m_safetySolver(maxHash),
+      m_bensonSolver(maxHash),
+      m_nuStores(0)
+{ }
+
+void GoSafetyCache::Clear()
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    m_safetySolver.Clear();
+    m_bensonSolver.Clear();
+    m_safetySolverStatistics = Statistics();
+    m_bensonSolverStatistics = Statistics();
+    m_nuStores = 0;
+}
+
+void GoSafetyCache::FindBensonSafePoints(const GoBoard& bd, SgBWSet* safe,
+                                         GoRegionBoard* regions)
+{
+    SG_ASSERT(safe);
+    Data data;
+    if (Lookup(m_bensonSolver, m_bensonSolverStatistics, bd, data))
+    {
+        *safe = data.m_safe;
+        return;
+    }
+    GoBensonSolver solver(bd, regions);
+    solver.FindSafePoints(&data.m_safe);
+    *safe = data.m_safe;
+    Store(m_bensonSolver, bd, data);
+}
+
+void GoSafetyCache::FindSafePoints(const GoBoard& bd, SgBWSet* safe,
+                                   SgBWSet* potentialCapture,
+                                   GoRegionBoard* regions)
+{
+    SG_ASSERT(safe);
+    Data data;
+    if (! Lookup(m_safetySolver, m_safetySolverStatistics, bd, data))
+    {
+        GoSafetySolver solver(bd, regions);
+        solver.FindSafePoints(&data.m_safe);
+        const GoSafetySolver& constSolver = solver;
+        FindPotentialCapture(bd, *constSolver.Regions(),
+                             data.m_potentialCapture);
+        Store(m_safetySolver, bd, data);
+    }
+    *safe = data.m_safe;
+    if (potentialCapture)
+        *potentialCapture = data.m_potentialCapture;
+}
+
+GoSafetyCache& GoSafetyCache::Global()
+{
+    static GoSafetyCache s_cache;
+    return s_cache;
+}
+
+bool GoSafetyCache::Lookup(const Table& table, Statistics& statistics,
+                           const GoBoard& bd, Data& data)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    ++statistics.m_nuLookups;
+    if (! table.Lookup(bd.GetHashCode(), &data) || data.m_size != bd.Size())
+        return false;
+    ++statistics.m_nuHits;
+    return true;
+}
+
+size_t GoSafetyCache::NuHits() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_safetySolverStatistics.m_nuHits
+        + m_bensonSolverStatistics.m_nuHits;
+}
+
+size_t GoSafetyCache::NuLookups() const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    return m_safetySolverStatistics.m_nuLookups
+        + m_bensonSolverStatistics.m_nuLookups;
+}
+
+void GoSafetyCache::Store(Table& table, const GoBoard& bd, Data& data)
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    data.m_isValid = true;
+    data.m_size = bd.Size();
+    data.m_stamp = ++m_nuStores;
+    table.Store(bd.GetHashCode(), data);
+}
+
+void GoSafetyCache::WriteStatistics(ostream& out) const
+{
+    boost::mutex::scoped_lock lock(m_mutex);
+    out << SgWriteLabel("Entries") << m_safetySolver.MaxHash() << '\n'
+        << SgWriteLabel("SafetyLookups")
+        << m_safetySolverStatistics.m_nuLookups << '\n'
+        << SgWriteLabel("SafetyHits")
+        << m_safetySolverStatistics.m_nuHits << '\n'
+        << SgWriteLabel("BensonLookups")
+        << m_bensonSolverStatistics.m_nuLookups << '\n'
+        << SgWriteLabel("BensonHits")
+        << m_bensonSolverStatistics.m_nuHits << '\n'
+        << SgWriteLabel("Stores") << m_nuStores << '\n'
+        << SgWriteLabel("Collisions")
+        << (m_safetySolver.NuCollisions() + m_bensonSolver.NuCollisions())
+        << '\n';
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,140 @@
+//----------------------------------------------------------------------------
+/** @file GoSafetyCache.h
+    Cache for the results of the safety solvers. */
+//----------------------------------------------------------------------------
+
+#ifndef GO_SAFETYCACHE_H
+#define GO_SAFETYCACHE_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <boost/thread/mutex.hpp>
+#include "SgBWSet.h"
+#include "SgHashTable.h"
+
+class GoBoard;
+class GoRegionBoard;
+
+//----------------------------------------------------------------------------
+
+/** Cache for the safe points found by GoSafetySolver and GoBensonSolver.
+    The solvers build a GoRegionBoard with all blocks and regions from
+    scratch, which is expensive, and the same positions are analyzed
+    repeatedly, e.g. by the root filter and the search setup of consecutive
+    searches, when pondering, or by the move features.
+    The results are stored in hash tables with a bounded number of entries
+    keyed by GoBoard::GetHashCode(); if the table is full, the oldest entry in
+    the probed block is replaced. The results of the solvers depend only on
+    the stones on the board, so they are valid for both colors to play.
+    All functions are thread-safe. The solvers run outside of the lock, so
+    two threads can compute the same position at the same time. */
+class GoSafetyCache
+{
+public:
+    /** Constructor.
+        @param maxHash The number of entries of each hash table */
+    explicit GoSafetyCache(int maxHash = 4096);
+
+    /** The cache used by the players and features. */
+    static GoSafetyCache& Global();
+
+    /** Find the safe points with GoSafetySolver.
+        @param bd The position
+        @param[out] safe The safe points
+        @param[out] potentialCapture If not null, the points that are in a
+        region of a color that contains stones of the opponent (see
+        GoSafetySolver::PotentialCaptureMove()). Unlike
+        GoSafetySolver::PotentialCaptureMove(), this does not depend on the
+        color to play.
+        @param regions If not null, the region board is used by the solver on
+        a cache miss; otherwise a temporary one is created. Callers who keep a
+        region board up to date with the moves of the game avoid building the
+        blocks and regions from scratch. The region board is not updated on a
+        cache hit. */
+    void FindSafePoints(const GoBoard& bd, SgBWSet* safe,
+                        SgBWSet* potentialCapture = 0,
+                        GoRegionBoard* regions = 0);
+
+    /** Find the safe points with GoBensonSolver.
+        @see FindSafePoints() */
+    void FindBensonSafePoints(const GoBoard& bd, SgBWSet* safe,
+                              GoRegionBoard* regions = 0);
+
+    /** Remove all entries and reset the statistics. */
+    void Clear();
+
+    /** Write the number of lookups and hits of both solvers. */
+    void WriteStatistics(std::ostream& out) const;
+
+    std::size_t NuLookups() const;
+
+    std::size_t NuHits() const;
+
+private:
+    /** Entry of the hash tables as required by SgHashTable. */
+    struct Data
+    {
+        bool m_isValid;
+
+        /** The board size of the position.
+            The hash code does not contain the board size; e.g. the empty
+            boards of all sizes have the same hash code. */
+        int m_size;
+
+        /** Number of the store, used for replacing the oldest entry. */
+        std::size_t m_stamp;
+
+        SgBWSet m_safe;
+
+        SgBWSet m_potentialCapture;
+
+        Data();
+
+        bool IsValid() const;
+
+        void Invalidate();
+
+        bool IsBetterThan(const Data& data) const;
+    };
+
+    typedef SgHashTable<Data,4> Table;
+
+    /** Lookup and hit counts of a hash table.
+        SgHashTable::NuFound() also counts entries of other board sizes. */
+    struct Statistics
+    {
+        std::size_t m_nuLookups;
+
+        std::size_t m_nuHits;
+
+        Statistics();
+    };
+
+    /** Protects all other members. */
+    mutable boost::mutex m_mutex;
+
+    Table m_safetySolver;
+
+    Table m_bensonSolver;
+
+    Statistics m_safetySolverStatistics;
+
+    Statistics m_bensonSolverStatistics;
+
+    std::size_t m_nuStores;
+
+    bool Lookup(const Table& table, Statistics& statistics,
+                const GoBoard& bd, Data& data);
+
+    void Store(Table& table, const GoBoard& bd, Data& data);
+
+    /** Not implemented */
+    GoSafetyCache(const GoSafetyCache&);
+
+    /** Not implemented */
+    GoSafetyCache& operator=(const GoSafetyCache&);
+};
+
+//----------------------------------------------------------------------------
+
+#endif // GO_SAFETYCACHE_H
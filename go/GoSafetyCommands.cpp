@@ -10,6 +10,7 @@
 #include "GoBoard.h"
 #include "GoGtpCommandUtil.h"
 #include "GoModBoard.h"
+#include "GoSafetyCache.h"
 #include "GoSafetySolver.h"
 #include "GoSafetyUtil.h"
 #include "SgPointSet.h"
@@ -25,6 +26,8 @@ GoSafetyCommands::GoSafetyCommands(const GoBoard& bd)
 void GoSafetyCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
 {
     cmd <<
+        "none/Go Safe Cache Clear/go_safe_cache_clear\n"
+        "string/Go Safe Cache Stat/go_safe_cache_stat\n"
         "plist/Go Safe Dame Static/go_safe_dame_static\n"
         "gfx/Go Safe Benson/go_safe_gfx benson\n"
         "gfx/Go Safe Static/go_safe_gfx static\n"
@@ -32,6 +35,22 @@ void GoSafetyCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         ;
 }
 
+/** Clear the cache of the safety solver results (GoSafetyCache::Global()).
+    Also resets the statistics. */
+void GoSafetyCommands::CmdCacheClear(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    GoSafetyCache::Global().Clear();
+}
+
+/** Statistics of the cache of the safety solver results
+    (GoSafetyCache::Global()). */
+void GoSafetyCommands::CmdCacheStat(GtpCommand& cmd)
+{
+    cmd.CheckArgNone();
+    GoSafetyCache::Global().WriteStatistics(cmd);
+}
+
 /** Return dame points after running static safety algorithm. */
 void GoSafetyCommands::CmdDameStatic(GtpCommand& cmd)
 {
@@ -160,6 +179,8 @@ SgBWSet GoSafetyCommands::GetSafe(int& totalRegions, const std::string& type)
 void GoSafetyCommands::Register(GtpEngine& e)
 {
     Register(e, "go_safe", &GoSafetyCommands::CmdSafe);
+    Register(e, "go_safe_cache_clear", &GoSafetyCommands::CmdCacheClear);
+    Register(e, "go_safe_cache_stat", &GoSafetyCommands::CmdCacheStat);
     Register(e, "go_safe_dame_static", &GoSafetyCommands::CmdDameStatic);
     Register(e, "go_safe_gfx", &GoSafetyCommands::CmdGfx);
     Register(e, "go_safe_winner", &GoSafetyCommands::CmdWinner);
@@ -24,6 +24,8 @@ public:
     void AddGoGuiAnalyzeCommands(GtpCommand& cmd);
 
     /** @page gosafetycommands GoSafetyCommands Commands
+        - @link CmdCacheClear() @c go_safe_cache_clear @endlink
+        - @link CmdCacheStat() @c go_safe_cache_stat @endlink
         - @link CmdDameStatic() @c go_safe_dame_static @endlink
         - @link CmdGfx() @c go_safe_gfx @endlink
         - @link CmdSafe() @c go_safe @endlink
@@ -31,6 +33,8 @@ public:
     /** @name Command Callbacks */
     // @{
     // The callback functions are documented in the cpp file
+    void CmdCacheClear(GtpCommand& cmd);
+    void CmdCacheStat(GtpCommand& cmd);
     void CmdDameStatic(GtpCommand& cmd);
     void CmdGfx(GtpCommand& cmd);
     void CmdSafe(GtpCommand& cmd);
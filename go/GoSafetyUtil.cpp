@@ -14,7 +14,7 @@
 #include "GoModBoard.h"
 #include "GoRegion.h"
 #include "GoRegionBoard.h"
-#include "GoSafetySolver.h"
+#include "GoSafetyCache.h"
 #include "SgBoardColor.h"
 #include "SgBWSet.h"
 #include "SgVector.h"
@@ -548,10 +548,8 @@ bool GoSafetyUtil::ExtendedIsTerritory(const GoBoard& board,
                         
 SgEmptyBlackWhite GoSafetyUtil::GetWinner(const GoBoard& bd)
 {
-    GoRegionBoard regionAttachment(bd);
-    GoSafetySolver solver(bd, &regionAttachment);
     SgBWSet safe;
-    solver.FindSafePoints(&safe);
+    GoSafetyCache::Global().FindSafePoints(bd, &safe);
     const float komi = bd.Rules().Komi().ToFloat();
     return ::GetWinner(bd, safe, komi);
 }
@@ -0,0 +1,151 @@
+//----------------------------------------------------------------------------
+/** @file GoLadderCacheTest.cpp
+    Unit tests for GoLadderCache. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoEyeUtil.h"
+#include "GoLadder.h"
+#include "GoLadderCache.h"
+#include "GoSetupUtil.h"
+#include "SgRandom.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Set up a position with a ladder of the white stone at C8, which is
+    captured if Black plays first. */
+void SetupLadder(GoBoard& bd)
+{
+    std::string s(".........\n"
+                  ".XO......\n"
+                  "..X......\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    bd.Init(boardSize, setup);
+}
+
+/** Play a random legal move that does not fill a single point eye, or a
+    pass if there is no such move. */
+void PlayRandomMove(GoBoard& bd, SgRandom& random)
+{
+    std::vector<SgPoint> moves;
+    for (GoBoard::Iterator it(bd); it; ++it)
+        if (  bd.IsLegal(*it)
+           && ! GoEyeUtil::IsSinglePointEye(bd, *it, bd.ToPlay())
+           )
+            moves.push_back(*it);
+    if (moves.empty())
+        bd.Play(SG_PASS);
+    else
+        bd.Play(moves[random.Int(static_cast<int>(moves.size()))]);
+}
+
+//----------------------------------------------------------------------------
+
+/** Compare the cached results with GoLadder for all blocks with at most
+    two liberties in the positions of a random sequence of moves and
+    undos.
+    Only the outcome is compared, because the sequence found by GoLadder
+    depends on the order of the liberties of the blocks. */
+BOOST_AUTO_TEST_CASE(GoLadderCacheTest_SameAsLadder)
+{
+    SgRandom random;
+    GoLadderCache cache(1024);
+    GoBoard bd(9);
+    for (int i = 0; i < 400; ++i)
+    {
+        if (bd.MoveNumber() > 0 && random.Int(4) == 0)
+            bd.Undo();
+        else
+            PlayRandomMove(bd, random);
+        for (GoBlockIterator it(bd); it; ++it)
+        {
+            if (bd.NumLiberties(*it) > 2)
+                continue;
+            for (SgBWIterator itColor; itColor; ++itColor)
+                for (int twoLib = 0; twoLib < 2; ++twoLib)
+                {
+                    GoLadder ladder;
+                    SgVector<SgPoint> expectedSequence;
+                    const int expected =
+                        ladder.Ladder(bd, *it, *itColor, &expectedSequence,
+                                      twoLib != 0);
+                    SgVector<SgPoint> sequence;
+                    const int result =
+                        cache.Ladder(bd, *it, *itColor, &sequence,
+                                     twoLib != 0);
+                    BOOST_REQUIRE_EQUAL(result < 0, expected < 0);
+                    BOOST_REQUIRE_EQUAL(sequence.IsEmpty(),
+                                        expectedSequence.IsEmpty());
+                    if (sequence.NonEmpty())
+                        BOOST_REQUIRE(bd.IsEmpty(sequence.Front()));
+                }
+        }
+    }
+    BOOST_CHECK(cache.NuLookups() > 0);
+    BOOST_CHECK(cache.NuHits() > 0);
+    BOOST_CHECK(cache.NuHits() < cache.NuLookups());
+}
+
+/** Test that an entry is used after a move far away from the ladder and
+    not used after a move on the path of the ladder. */
+BOOST_AUTO_TEST_CASE(GoLadderCacheTest_Invalidate)
+{
+    GoLadderCache cache;
+    GoBoard bd;
+    SetupLadder(bd);
+    const SgPoint prey = Pt(3, 8);
+    SgVector<SgPoint> sequence;
+    BOOST_CHECK(cache.IsLadderCaptured(bd, prey, SG_BLACK, false,
+                                       &sequence));
+    BOOST_REQUIRE(sequence.Length() > 2);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 0u);
+    bd.Play(Pt(1, 1), SG_WHITE);
+    SgVector<SgPoint> cachedSequence;
+    BOOST_CHECK(cache.IsLadderCaptured(bd, prey, SG_BLACK, false,
+                                       &cachedSequence));
+    BOOST_CHECK(cachedSequence == sequence);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+    bd.Play(sequence.Back(), SG_WHITE);
+    const bool expected =
+        GoLadderUtil::Ladder(bd, prey, SG_BLACK, false, 0);
+    BOOST_CHECK_EQUAL(cache.IsLadderCaptured(bd, prey, SG_BLACK), expected);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+    BOOST_CHECK_EQUAL(cache.NuLookups(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(GoLadderCacheTest_Clear)
+{
+    GoLadderCache cache;
+    GoBoard bd;
+    SetupLadder(bd);
+    const SgPoint prey = Pt(3, 8);
+    BOOST_CHECK(cache.IsLadderCaptured(bd, prey, SG_BLACK));
+    BOOST_CHECK(cache.IsLadderCaptured(bd, prey, SG_BLACK));
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.NuLookups(), 0u);
+    BOOST_CHECK(cache.IsLadderCaptured(bd, prey, SG_BLACK));
+    BOOST_CHECK_EQUAL(cache.NuHits(), 0u);
+}
+
+//----------------------------------------------------------------------------
+
+} // namespace
+
+//----------------------------------------------------------------------------
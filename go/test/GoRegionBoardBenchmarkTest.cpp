@@ -0,0 +1,42 @@
+//----------------------------------------------------------------------------
+/** @file GoRegionBoardBenchmarkTest.cpp
+    Unit tests for GoRegionBoardBenchmark. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoRegionBoardBenchmark.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(GoRegionBoardBenchmarkTest_Run)
+{
+    GoBoard bd(9);
+    bd.Play(Pt(3, 3), SG_BLACK);
+    bd.Play(Pt(7, 7), SG_WHITE);
+    bd.Play(SG_PASS, SG_BLACK);
+    bd.Play(Pt(3, 7), SG_WHITE);
+    GoRegionBoardBenchmarkResult result = GoRegionBoardBenchmark::Run(bd, 2);
+    BOOST_CHECK_EQUAL(result.m_nuMoves, 8u);
+    BOOST_CHECK(result.m_playTime >= 0);
+    BOOST_CHECK(result.m_undoTime >= 0);
+    BOOST_CHECK(result.m_rebuildTime >= 0);
+    BOOST_CHECK(result.m_solveTime >= 0);
+    BOOST_CHECK(result.m_solveRebuildTime >= 0);
+    // The board of the benchmark is not modified
+    BOOST_CHECK_EQUAL(bd.MoveNumber(), 4);
+    std::ostringstream out;
+    result.Write(out);
+    BOOST_CHECK(out.str().find("moves 8 ") == 0);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,192 @@
+//----------------------------------------------------------------------------
+/** @file GoRegionBoardSynchronizerTest.cpp
+    Unit tests for GoRegionBoardSynchronizer. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBensonSolver.h"
+#include "GoBlock.h"
+#include "GoBoard.h"
+#include "GoEyeUtil.h"
+#include "GoRegion.h"
+#include "GoRegionBoardSynchronizer.h"
+#include "GoSafetySolver.h"
+#include "SgRandom.h"
+
+using std::set;
+using std::string;
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Describe the blocks and regions of a region board independent of their
+    order, including the flags that the solvers use. */
+string Describe(const GoRegionBoard& regions)
+{
+    const GoRegionFlag flags[] = {
+        GO_REGION_SMALL,
+        GO_REGION_CORRIDOR,
+        GO_REGION_SINGLE_BLOCK_BOUNDARY,
+        GO_REGION_STATIC_1VC,
+        GO_REGION_STATIC_2V
+    };
+    std::ostringstream out;
+    for (SgBWIterator cit; cit; ++cit)
+    {
+        set<string> lines;
+        for (SgVectorIteratorOf<GoBlock> it(regions.AllBlocks(*cit)); it;
+             ++it)
+        {
+            std::ostringstream line;
+            line << "block";
+            for (SgSetIterator it2((*it)->Stones()); it2; ++it2)
+                line << ' ' << *it2;
+            line << " eye " << (*it)->Has1Eye();
+            lines.insert(line.str());
+        }
+        for (SgVectorIteratorOf<GoRegion> it(regions.AllRegions(*cit)); it;
+             ++it)
+        {
+            std::ostringstream line;
+            line << "region";
+            for (SgSetIterator it2((*it)->Points()); it2; ++it2)
+                line << ' ' << *it2;
+            set<SgPoint> anchors;
+            for (SgVectorIteratorOf<GoBlock> it2((*it)->Blocks()); it2; ++it2)
+                anchors.insert((*it2)->Anchor());
+            line << " blocks";
+            for (set<SgPoint>::const_iterator it2 = anchors.begin();
+                 it2 != anchors.end(); ++it2)
+                line << ' ' << *it2;
+            line << " flags";
+            for (size_t i = 0; i < sizeof(flags) / sizeof(flags[0]); ++i)
+                line << ' ' << ((*it)->ComputedFlag(flags[i]) ?
+                                int((*it)->GetFlag(flags[i])) : -1);
+            lines.insert(line.str());
+        }
+        out << "color " << *cit << '\n';
+        for (set<string>::const_iterator it = lines.begin();
+             it != lines.end(); ++it)
+            out << *it << '\n';
+    }
+    return out.str();
+}
+
+/** Play a random legal move that does not fill a single point eye, or a
+    pass if there is no such move. */
+void PlayRandomMove(GoBoard& bd, SgRandom& random)
+{
+    std::vector<SgPoint> moves;
+    for (GoBoard::Iterator it(bd); it; ++it)
+        if (  bd.IsLegal(*it)
+           && ! GoEyeUtil::IsSinglePointEye(bd, *it, bd.ToPlay())
+           )
+            moves.push_back(*it);
+    if (moves.empty())
+        bd.Play(SG_PASS);
+    else
+        bd.Play(moves[random.Int(static_cast<int>(moves.size()))]);
+}
+
+/** Compare the incrementally updated regions with regions built from
+    scratch in the positions of a random sequence of moves and undos.
+    The safety solvers run on the incrementally updated regions in most
+    positions, like in GoUctDefaultMoveFilter, and must find the same safe
+    points as on regions built from scratch. */
+BOOST_AUTO_TEST_CASE(GoRegionBoardSynchronizerTest_SameAsRebuild)
+{
+    SgRandom random;
+    GoBoard bd(9);
+    GoRegionBoardSynchronizer synchronizer(bd);
+    const GoBoard& regionsBd = synchronizer.Board();
+    for (int i = 0; i < 300; ++i)
+    {
+        if (bd.MoveNumber() > 0 && random.Int(4) == 0)
+            bd.Undo();
+        else
+            PlayRandomMove(bd, random);
+        synchronizer.UpdateSubscriber();
+        BOOST_REQUIRE(regionsBd.GetHashCode() == bd.GetHashCode());
+        GoRegionBoard& regions = synchronizer.Regions();
+        {
+            GoRegionBoard expected(regionsBd);
+            BOOST_CHECK_EQUAL(Describe(regions), Describe(expected));
+        }
+        if (i % 3 == 2)
+            continue;
+        if (i % 3 == 0)
+        {
+            SgBWSet safe;
+            GoSafetySolver(regionsBd, &regions).FindSafePoints(&safe);
+            SgBWSet expectedSafe;
+            GoSafetySolver(bd).FindSafePoints(&expectedSafe);
+            BOOST_CHECK(safe == expectedSafe);
+        }
+        else
+        {
+            SgBWSet safe;
+            GoBensonSolver(regionsBd, &regions).FindSafePoints(&safe);
+            SgBWSet expectedSafe;
+            GoBensonSolver(bd).FindSafePoints(&expectedSafe);
+            BOOST_CHECK(safe == expectedSafe);
+        }
+        GoRegionBoard expected(regionsBd);
+        BOOST_CHECK_EQUAL(Describe(regions), Describe(expected));
+    }
+    BOOST_CHECK_EQUAL(synchronizer.NuRebuilds(), 1u);
+    BOOST_CHECK_EQUAL(synchronizer.NuIncrementalUpdates(), 300u);
+}
+
+/** Test that the regions are rebuilt if the board is initialized with a new
+    size, after a suicide move, and if moves are undone that were played
+    before the last rebuild. */
+BOOST_AUTO_TEST_CASE(GoRegionBoardSynchronizerTest_Rebuild)
+{
+    GoBoard bd(9);
+    bd.Play(Pt(3, 3), SG_BLACK);
+    GoRegionBoardSynchronizer synchronizer(bd);
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.NuRebuilds(), 1u);
+    BOOST_CHECK_EQUAL(synchronizer.NuIncrementalUpdates(), 1u);
+    bd.Init(5);
+    bd.Rules().SetAllowSuicide(true);
+    bd.Play(Pt(1, 2), SG_BLACK);
+    bd.Play(Pt(2, 1), SG_BLACK);
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.NuRebuilds(), 2u);
+    BOOST_CHECK_EQUAL(synchronizer.NuIncrementalUpdates(), 3u);
+    BOOST_CHECK_EQUAL(synchronizer.Board().Size(), 5);
+    BOOST_CHECK_EQUAL(synchronizer.Regions().AllBlocks(SG_BLACK).Length(),
+                      2);
+    bd.Play(Pt(1, 1), SG_WHITE);
+    BOOST_REQUIRE(bd.LastMoveInfo(GO_MOVEFLAG_SUICIDE));
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.NuRebuilds(), 3u);
+    bd.Undo();
+    bd.Undo();
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.NuRebuilds(), 5u);
+    BOOST_CHECK_EQUAL(synchronizer.NuIncrementalUpdates(), 3u);
+    GoRegionBoard& regions = synchronizer.Regions();
+    regions.GenBlocksRegions();
+    BOOST_CHECK_EQUAL(regions.AllBlocks(SG_BLACK).Length(), 1);
+    BOOST_CHECK_EQUAL(regions.AllBlocks(SG_WHITE).Length(), 0);
+    BOOST_CHECK_EQUAL(regions.AllRegions(SG_BLACK).Length(), 1);
+    bd.Play(Pt(2, 1), SG_BLACK);
+    synchronizer.UpdateSubscriber();
+    BOOST_CHECK_EQUAL(synchronizer.NuRebuilds(), 5u);
+    BOOST_CHECK_EQUAL(synchronizer.NuIncrementalUpdates(), 4u);
+    BOOST_CHECK_EQUAL(regions.AllBlocks(SG_BLACK).Length(), 2);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,154 @@
+//----------------------------------------------------------------------------
+/** @file GoSafetyCacheTest.cpp
+    Unit tests for GoSafetyCache. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <sstream>
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBensonSolver.h"
+#include "GoBoard.h"
+#include "GoEyeUtil.h"
+#include "GoSafetyCache.h"
+#include "GoSafetySolver.h"
+#include "SgRandom.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Play a random legal move that does not fill a single point eye.
+    @return false if there is no such move */
+bool PlayRandomMove(GoBoard& bd, SgRandom& random)
+{
+    std::vector<SgPoint> moves;
+    for (GoBoard::Iterator it(bd); it; ++it)
+        if (  bd.IsLegal(*it)
+           && ! GoEyeUtil::IsSinglePointEye(bd, *it, bd.ToPlay())
+           )
+            moves.push_back(*it);
+    if (moves.empty())
+        return false;
+    bd.Play(moves[random.Int(static_cast<int>(moves.size()))]);
+    return true;
+}
+
+/** Compare the results of the cache with the results of the solvers in the
+    positions of a random game, looking up each position twice. */
+BOOST_AUTO_TEST_CASE(GoSafetyCacheTest_SameAsSolvers)
+{
+    GoSafetyCache cache;
+    SgRandom random;
+    GoBoard bd(9);
+    size_t nuPositions = 0;
+    size_t nuSafe = 0;
+    while (nuPositions < 200 && PlayRandomMove(bd, random))
+    {
+        ++nuPositions;
+        const SgBlackWhite toPlay = bd.ToPlay();
+        SgBWSet expectedSafe;
+        GoSafetySolver solver(bd);
+        solver.FindSafePoints(&expectedSafe);
+        SgBWSet expectedBensonSafe;
+        GoBensonSolver bensonSolver(bd);
+        bensonSolver.FindSafePoints(&expectedBensonSafe);
+        nuSafe += expectedSafe.Both().Size();
+        for (int i = 0; i < 2; ++i)
+        {
+            SgBWSet safe;
+            SgBWSet potentialCapture;
+            cache.FindSafePoints(bd, &safe, &potentialCapture);
+            BOOST_CHECK(safe == expectedSafe);
+            for (SgSetIterator it(safe[toPlay]); it; ++it)
+                if (bd.GetColor(*it) != toPlay)
+                    BOOST_CHECK_EQUAL(potentialCapture[toPlay].Contains(*it),
+                                      solver.PotentialCaptureMove(*it,
+                                                                  toPlay));
+            SgBWSet bensonSafe;
+            cache.FindBensonSafePoints(bd, &bensonSafe);
+            BOOST_CHECK(bensonSafe == expectedBensonSafe);
+        }
+    }
+    BOOST_CHECK(nuSafe > 0);
+    BOOST_CHECK_EQUAL(cache.NuLookups(), 4 * nuPositions);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 2 * nuPositions);
+}
+
+/** Test that the empty boards of different sizes, which have the same hash
+    code, are distinguished. */
+BOOST_AUTO_TEST_CASE(GoSafetyCacheTest_BoardSize)
+{
+    GoSafetyCache cache;
+    SgBWSet safe;
+    GoSetup setup;
+    // Black owns the whole 3x3 board with two eyes
+    setup.AddBlack(Pt(1, 1));
+    setup.AddBlack(Pt(1, 2));
+    setup.AddBlack(Pt(2, 2));
+    setup.AddBlack(Pt(3, 2));
+    setup.AddBlack(Pt(1, 3));
+    setup.AddBlack(Pt(3, 3));
+    setup.AddBlack(Pt(3, 1));
+    GoBoard bd(3, setup);
+    cache.FindBensonSafePoints(bd, &safe);
+    BOOST_CHECK_EQUAL(safe[SG_BLACK].Size(), 9);
+    GoBoard emptyBd(9);
+    cache.FindBensonSafePoints(emptyBd, &safe);
+    BOOST_CHECK(safe.BothEmpty());
+    emptyBd.Init(13);
+    cache.FindBensonSafePoints(emptyBd, &safe);
+    BOOST_CHECK(safe.BothEmpty());
+    BOOST_CHECK_EQUAL(cache.NuHits(), 0u);
+    cache.FindBensonSafePoints(emptyBd, &safe);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+    cache.FindBensonSafePoints(bd, &safe);
+    BOOST_CHECK_EQUAL(safe[SG_BLACK].Size(), 9);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 2u);
+    BOOST_CHECK_EQUAL(cache.NuLookups(), 5u);
+}
+
+BOOST_AUTO_TEST_CASE(GoSafetyCacheTest_Clear)
+{
+    GoSafetyCache cache;
+    GoBoard bd(9);
+    SgBWSet safe;
+    cache.FindSafePoints(bd, &safe);
+    cache.FindSafePoints(bd, &safe);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.NuLookups(), 0u);
+    cache.FindSafePoints(bd, &safe);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 0u);
+    std::ostringstream out;
+    cache.WriteStatistics(out);
+    BOOST_CHECK(! out.str().empty());
+}
+
+/** Test that the oldest entry is replaced if the table is full. */
+BOOST_AUTO_TEST_CASE(GoSafetyCacheTest_Replace)
+{
+    GoSafetyCache cache(1);
+    GoBoard bd(9);
+    SgBWSet safe;
+    cache.FindSafePoints(bd, &safe);
+    for (int i = 1; i <= 4; ++i)
+    {
+        bd.Play(Pt(i, 1), SG_BLACK);
+        cache.FindSafePoints(bd, &safe);
+    }
+    // The table has 4 entries (a block of size 4), the empty board is the
+    // oldest entry and was replaced
+    cache.FindSafePoints(bd, &safe);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+    GoBoard emptyBd(9);
+    cache.FindSafePoints(emptyBd, &safe);
+    BOOST_CHECK_EQUAL(cache.NuHits(), 1u);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,685 @@
+//----------------------------------------------------------------------------
+/** @file GoUctBitBoard.cpp
+    See GoUctBitBoard.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctBitBoard.h"
+
+#include <sstream>
+#include "GoBoardUtil.h"
+#include "GoPattern3x3.h"
+#include "GoUctBoard.h"
+#include "SgException.h"
+#include "SgNbIterator.h"
+#include "SgStack.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Do a consistency check.
+    Check some data structures for consistency after and before each play
+    (and at some other places).
+    This is an expensive check and therefore has to be enabled at compile
+    time. */
+const bool CONSISTENCY = false;
+
+/** Offsets of the 8 neighbors in the order of the digits of
+    GoPattern3x3::CodeOf8Neighbors(), most significant digit first.
+    PATTERN_DIR[7 - i] is the opposite direction of PATTERN_DIR[i]. */
+const int PATTERN_DIR[8] = {
+    - SG_NS - SG_WE, - SG_NS, - SG_NS + SG_WE, - SG_WE,
+    SG_WE, SG_NS - SG_WE, SG_NS, SG_NS + SG_WE
+};
+
+/** Index of a direction in PATTERN_DIR. */
+int PatternDirIndex(int dir)
+{
+    for (int i = 0; i < 8; ++i)
+        if (PATTERN_DIR[i] == dir)
+            return i;
+    SG_ASSERT(false);
+    return -1;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctBitBoard::GoUctBitBoard(const GoBoard& bd)
+    : m_const(bd.Size())
+{
+    m_size = -1;
+    m_patternCodes = true;
+    Init(bd);
+}
+
+GoUctBitBoard::~GoUctBitBoard()
+{ }
+
+void GoUctBitBoard::CheckConsistency() const
+{
+    if (! CONSISTENCY)
+        return;
+    for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
+    {
+        if (IsBorder(p))
+            continue;
+        int c = m_color[p];
+        SG_ASSERT_EBW(c);
+        int n = 0;
+        for (SgNb4Iterator it(p); it; ++it)
+            if (m_color[*it] == SG_EMPTY)
+                ++n;
+        SG_ASSERT(n == NumEmptyNeighbors(p));
+        n = 0;
+        for (SgNb4Iterator it(p); it; ++it)
+            if (m_color[*it] == SG_BLACK)
+                ++n;
+        SG_ASSERT(n == NumNeighbors(p, SG_BLACK));
+        n = 0;
+        for (SgNb4Iterator it(p); it; ++it)
+            if (m_color[*it] == SG_WHITE)
+                ++n;
+        SG_ASSERT(n == NumNeighbors(p, SG_WHITE));
+        if (c == SG_BLACK || c == SG_WHITE)
+            CheckConsistencyBlock(p);
+        if (c == SG_EMPTY)
+            SG_ASSERT(m_block[p] == 0);
+        if (m_patternCodes && ! InCorner(p))
+        {
+            if (Line(p) > 1)
+                SG_ASSERT(m_patternCode[p]
+                          == GoPattern3x3::CodeOf8Neighbors(*this, p));
+            else
+                SG_ASSERT(m_patternCode[p]
+                          == GoPattern3x3::CodeOfEdgeNeighbors(*this, p));
+        }
+    }
+}
+
+void GoUctBitBoard::CheckConsistencyBlock(SgPoint point) const
+{
+    SG_ASSERT(Occupied(point));
+    SgBlackWhite color = GetColor(point);
+    GoPointList stones;
+    SgBitboard liberties;
+    SgMarker mark;
+    SgStack<SgPoint,SG_MAXPOINT> stack;
+    stack.Push(point);
+    bool anchorFound = false;
+    SG_DEBUG_ONLY(anchorFound);
+    const Block* block = m_block[point];
+    while (! stack.IsEmpty())
+    {
+        SgPoint p = stack.Pop();
+        if (IsBorder(p) || ! mark.NewMark(p))
+            continue;
+        if (GetColor(p) == color)
+        {
+            stones.PushBack(p);
+            if (p == block->m_anchor)
+                anchorFound = true;
+            stack.Push(p - SG_NS);
+            stack.Push(p - SG_WE);
+            stack.Push(p + SG_WE);
+            stack.Push(p + SG_NS);
+        }
+        else if (GetColor(p) == SG_EMPTY)
+            liberties.Include(p);
+    }
+    SG_ASSERT(anchorFound);
+    SG_ASSERT(color == block->m_color);
+    SG_ASSERT(stones.SameElements(block->m_stones));
+    SG_ASSERT(liberties == block->m_liberties);
+    SG_ASSERT(liberties.Size() == block->m_nuLiberties);
+    SG_ASSERT(stones.Length() == NumStones(point));
+}
+
+/** Add a liberty to the adjacent blocks of a color.
+    Blocks adjacent to the point in more than one direction already contain
+    the liberty when they are visited again, so no marker is needed. The
+    stone of the current move has no block yet and is skipped. */
+void GoUctBitBoard::AddLibToAdjBlocks(SgPoint p, SgBlackWhite c)
+{
+    if (NumNeighbors(p, c) == 0)
+        return;
+    Block* b;
+    if (m_color[p - SG_NS] == c && (b = m_block[p - SG_NS]) != 0)
+        b->IncludeLiberty(p);
+    if (m_color[p + SG_NS] == c && (b = m_block[p + SG_NS]) != 0)
+        b->IncludeLiberty(p);
+    if (m_color[p - SG_WE] == c && (b = m_block[p - SG_WE]) != 0)
+        b->IncludeLiberty(p);
+    if (m_color[p + SG_WE] == c && (b = m_block[p + SG_WE]) != 0)
+        b->IncludeLiberty(p);
+}
+
+void GoUctBitBoard::AddStoneToBlock(SgPoint p, Block* block)
+{
+    // Stone already placed
+    SG_ASSERT(IsColor(p, block->m_color));
+    block->m_stones.PushBack(p);
+    if (IsEmpty(p - SG_NS))
+        block->IncludeLiberty(p - SG_NS);
+    if (IsEmpty(p - SG_WE))
+        block->IncludeLiberty(p - SG_WE);
+    if (IsEmpty(p + SG_WE))
+        block->IncludeLiberty(p + SG_WE);
+    if (IsEmpty(p + SG_NS))
+        block->IncludeLiberty(p + SG_NS);
+    m_block[p] = block;
+}
+
+void GoUctBitBoard::CreateSingleStoneBlock(SgPoint p, SgBlackWhite c)
+{
+    // Stone already placed
+    SG_ASSERT(IsColor(p, c));
+    SG_ASSERT(NumNeighbors(p, c) == 0);
+    Block& block = m_blockArray[p];
+    block.InitSingleStoneBlock(c, p);
+    if (IsEmpty(p - SG_NS))
+        block.m_liberties.Include(p - SG_NS);
+    if (IsEmpty(p - SG_WE))
+        block.m_liberties.Include(p - SG_WE);
+    if (IsEmpty(p + SG_WE))
+        block.m_liberties.Include(p + SG_WE);
+    if (IsEmpty(p + SG_NS))
+        block.m_liberties.Include(p + SG_NS);
+    block.m_nuLiberties = NumEmptyNeighbors(p);
+    m_block[p] = &block;
+}
+
+void GoUctBitBoard::MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks)
+{
+    // Stone already placed
+    SG_ASSERT(IsColor(p, adjBlocks[0]->m_color));
+    SG_ASSERT(NumNeighbors(p, adjBlocks[0]->m_color) > 1);
+    Block* largestBlock = 0;
+    int largestBlockStones = 0;
+    for (SgArrayList<Block*,4>::Iterator it(adjBlocks); it; ++it)
+    {
+        Block* adjBlock = *it;
+        int numStones = adjBlock->m_stones.Length();
+        if (numStones > largestBlockStones)
+        {
+            largestBlockStones = numStones;
+            largestBlock = adjBlock;
+        }
+    }
+    largestBlock->m_stones.PushBack(p);
+    for (SgArrayList<Block*,4>::Iterator it(adjBlocks); it; ++it)
+    {
+        Block* adjBlock = *it;
+        if (adjBlock == largestBlock)
+            continue;
+        for (Block::StoneIterator stn(adjBlock->m_stones); stn; ++stn)
+        {
+            largestBlock->m_stones.PushBack(*stn);
+            m_block[*stn] = largestBlock;
+        }
+        largestBlock->m_liberties |= adjBlock->m_liberties;
+    }
+    m_block[p] = largestBlock;
+    SgBitboard& liberties = largestBlock->m_liberties;
+    if (IsEmpty(p - SG_NS))
+        liberties.Include(p - SG_NS);
+    if (IsEmpty(p - SG_WE))
+        liberties.Include(p - SG_WE);
+    if (IsEmpty(p + SG_WE))
+        liberties.Include(p + SG_WE);
+    if (IsEmpty(p + SG_NS))
+        liberties.Include(p + SG_NS);
+    largestBlock->m_nuLiberties = liberties.Size();
+}
+
+void GoUctBitBoard::UpdateBlocksAfterAddStone(SgPoint p, SgBlackWhite c,
+                                        const SgArrayList<Block*,4>& adjBlocks)
+{
+    // Stone already placed
+    SG_ASSERT(IsColor(p, c));
+    int n = adjBlocks.Length();
+    if (n == 0)
+        CreateSingleStoneBlock(p, c);
+    else
+    {
+        if (n == 1)
+            AddStoneToBlock(p, adjBlocks[0]);
+        else
+            MergeBlocks(p, adjBlocks);
+    }
+}
+
+/** Update the pattern codes of the neighbors of a point after its color
+    changed by delta. */
+inline void GoUctBitBoard::UpdatePatternCodes(SgPoint p, int delta)
+{
+    const boost::array<int,8>& weight = m_patternWeight[p];
+    for (int i = 0; i < 8; ++i)
+        m_patternCode[p + PATTERN_DIR[i]] += delta * weight[i];
+}
+
+void GoUctBitBoard::Init(const GoBoard& bd)
+{
+    if (bd.Size() != m_size)
+        InitSize(bd);
+    m_prisoners[SG_BLACK] = bd.NumPrisoners(SG_BLACK);
+    m_prisoners[SG_WHITE] = bd.NumPrisoners(SG_WHITE);
+    m_koPoint = bd.KoPoint();
+    m_lastMove = bd.GetLastMove();
+    m_secondLastMove = bd.Get2ndLastMove();
+    m_toPlay = bd.ToPlay();
+    for (GoBoard::Iterator it(bd); it; ++it)
+    {
+        const SgPoint p = *it;
+        const SgBoardColor c = bd.GetColor(p);
+        m_color[p] = c;
+        m_nuNeighbors[SG_BLACK][p] = bd.NumNeighbors(p, SG_BLACK);
+        m_nuNeighbors[SG_WHITE][p] = bd.NumNeighbors(p, SG_WHITE);
+        m_nuNeighborsEmpty[p] = bd.NumEmptyNeighbors(p);
+        if (bd.IsEmpty(p))
+            m_block[p] = 0;
+        else if (bd.Anchor(p) == p)
+        {
+            SG_ASSERT(c == m_color[p]);
+            Block& block = m_blockArray[p];
+            block.InitNewBlock(c, p);
+            for (GoBoard::StoneIterator it2(bd, p); it2; ++it2)
+            {
+                block.m_stones.PushBack(*it2);
+                m_block[*it2] = &block;
+            }
+            for (GoBoard::LibertyIterator it2(bd, p); it2; ++it2)
+                block.m_liberties.Include(*it2);
+            block.m_nuLiberties = bd.NumLiberties(p);
+        }
+    }
+    if (m_patternCodes)
+        InitPatternCodes();
+    CheckConsistency();
+}
+
+/** Compute the pattern codes of the current position.
+    Starts with the codes of the empty board and adds the stones. */
+void GoUctBitBoard::InitPatternCodes()
+{
+    m_patternCode = m_emptyPatternCode;
+    for (Iterator it(*this); it; ++it)
+        if (m_color[*it] != SG_EMPTY)
+            UpdatePatternCodes(*it, m_color[*it] - SG_EMPTY);
+}
+
+void GoUctBitBoard::InitPatternWeights()
+{
+    for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
+    {
+        m_patternWeight[p].assign(0);
+        m_emptyPatternCode[p] = 0;
+    }
+    for (Iterator it(*this); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (Line(p) > 1)
+        {
+            int weight = GoPattern3x3::POWER3_8;
+            for (int i = 0; i < 8; ++i)
+            {
+                weight /= 3;
+                m_patternWeight[p + PATTERN_DIR[i]][7 - i] = weight;
+            }
+            // All digits are SG_EMPTY (2)
+            m_emptyPatternCode[p] = GoPattern3x3::POWER3_8 - 1;
+        }
+        else if (Pos(p) > 1)
+        {
+            const int up = Up(p);
+            const int other = GoPatternBase::OtherDir(up);
+            const int dir[5] = { other, up + other, up, up - other, - other };
+            int weight = GoPattern3x3::POWER3_5;
+            for (int i = 0; i < 5; ++i)
+            {
+                weight /= 3;
+                m_patternWeight[p + dir[i]][PatternDirIndex(- dir[i])] =
+                    weight;
+            }
+            m_emptyPatternCode[p] = GoPattern3x3::POWER3_5 - 1;
+        }
+    }
+}
+
+void GoUctBitBoard::InitSize(const GoBoard& bd)
+{
+    m_size = bd.Size();
+    m_nuNeighbors[SG_BLACK].Fill(0);
+    m_nuNeighbors[SG_WHITE].Fill(0);
+    m_nuNeighborsEmpty.Fill(0);
+    m_block.Fill(0);
+    for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
+    {
+        if (bd.IsBorder(p))
+        {
+            m_color[p] = SG_BORDER;
+            m_isBorder[p] = true;
+        }
+        else
+            m_isBorder[p] = false;
+    }
+    m_const.ChangeSize(m_size);
+    InitPatternWeights();
+}
+
+void GoUctBitBoard::NeighborBlocks(SgPoint p, SgBlackWhite c,
+                                SgPoint anchors[]) const
+{
+    SG_ASSERT(IsEmpty(p));
+    SgReserveMarker reserve(m_marker);
+    SG_UNUSED(reserve);
+    m_marker.Clear();
+    int i = 0;
+    if (NumNeighbors(p, c) > 0)
+    {
+        if (IsColor(p - SG_NS, c) && m_marker.NewMark(Anchor(p - SG_NS)))
+            anchors[i++] = Anchor(p - SG_NS);
+        if (IsColor(p - SG_WE, c) && m_marker.NewMark(Anchor(p - SG_WE)))
+            anchors[i++] = Anchor(p - SG_WE);
+        if (IsColor(p + SG_WE, c) && m_marker.NewMark(Anchor(p + SG_WE)))
+            anchors[i++] = Anchor(p + SG_WE);
+        if (IsColor(p + SG_NS, c) && m_marker.NewMark(Anchor(p + SG_NS)))
+            anchors[i++] = Anchor(p + SG_NS);
+    }
+    anchors[i] = SG_ENDPOINT;
+}
+
+void GoUctBitBoard::AddStone(SgPoint p, SgBlackWhite c)
+{
+    SG_ASSERT(IsEmpty(p));
+    SG_ASSERT_BW(c);
+    m_color[p] = c;
+    --m_nuNeighborsEmpty[p - SG_NS];
+    --m_nuNeighborsEmpty[p - SG_WE];
+    --m_nuNeighborsEmpty[p + SG_WE];
+    --m_nuNeighborsEmpty[p + SG_NS];
+    SgArray<int,SG_MAXPOINT>& nuNeighbors = m_nuNeighbors[c];
+    ++nuNeighbors[p - SG_NS];
+    ++nuNeighbors[p - SG_WE];
+    ++nuNeighbors[p + SG_WE];
+    ++nuNeighbors[p + SG_NS];
+    if (m_patternCodes)
+        UpdatePatternCodes(p, c - SG_EMPTY);
+}
+
+/** Remove liberty from an adjacent block and kill it if it is an opponent
+    block without liberties.
+    A block adjacent to the point in more than one direction does no longer
+    contain the liberty when it is visited again, so no marker is needed. */
+inline void GoUctBitBoard::RemoveLib(Block* b, SgPoint p, SgBlackWhite opp,
+                                     SgArrayList<Block*,4>& ownAdjBlocks)
+{
+    if (b == 0 || ! b->m_liberties.Contains(p))
+        return;
+    b->ExcludeLiberty(p);
+    if (b->m_color == opp)
+    {
+        if (b->m_nuLiberties == 0)
+            KillBlock(b);
+    }
+    else
+        ownAdjBlocks.PushBack(b);
+}
+
+/** Remove liberty from adjacent blocks and kill opponent blocks without
+    liberties.
+    As a side effect, computes adjacent blocks of own color to avoid a
+    second call to GetAdjacentBlocks() in UpdateBlocksAfterAddStone(). */
+void GoUctBitBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
+                                     SgArrayList<Block*,4>& ownAdjBlocks)
+{
+    RemoveLib(m_block[p - SG_NS], p, opp, ownAdjBlocks);
+    RemoveLib(m_block[p - SG_WE], p, opp, ownAdjBlocks);
+    RemoveLib(m_block[p + SG_WE], p, opp, ownAdjBlocks);
+    RemoveLib(m_block[p + SG_NS], p, opp, ownAdjBlocks);
+}
+
+void GoUctBitBoard::KillBlock(const Block* block)
+{
+    SgBlackWhite c = block->m_color;
+    SgBlackWhite opp = SgOppBW(c);
+    SgArray<int,SG_MAXPOINT>& nuNeighbors = m_nuNeighbors[c];
+    for (Block::StoneIterator it(block->m_stones); it; ++it)
+    {
+        SgPoint p = *it;
+        AddLibToAdjBlocks(p, opp);
+        m_color[p] = SG_EMPTY;
+        ++m_nuNeighborsEmpty[p - SG_NS];
+        ++m_nuNeighborsEmpty[p - SG_WE];
+        ++m_nuNeighborsEmpty[p + SG_WE];
+        ++m_nuNeighborsEmpty[p + SG_NS];
+        --nuNeighbors[p - SG_NS];
+        --nuNeighbors[p - SG_WE];
+        --nuNeighbors[p + SG_WE];
+        --nuNeighbors[p + SG_NS];
+        if (m_patternCodes)
+            UpdatePatternCodes(p, SG_EMPTY - c);
+        m_capturedStones.PushBack(p);
+        m_block[p] = 0;
+    }
+    int nuStones = block->m_stones.Length();
+    m_prisoners[c] += nuStones;
+    if (nuStones == 1)
+        // Remember that single stone was captured, check conditions on
+        // capturing block later
+        m_koPoint = block->m_anchor;
+}
+
+bool GoUctBitBoard::SelfAtari(SgPoint p, SgBlackWhite toPlay,
+                              int& nuStones) const
+{
+    SG_ASSERT(IsEmpty(p));
+    // No self-atari, enough liberties
+    if (NumEmptyNeighbors(p) >= 2)
+        return false;
+    SgBitboard liberties;
+    SgArrayList<const Block*,4> ownBlocks;
+    const Block* captured = 0;
+    for (SgNb4Iterator it(p); it; ++it)
+    {
+        const SgPoint nb = *it;
+        const SgBoardColor c = m_color[nb];
+        if (c == SG_EMPTY)
+            liberties.Include(nb);
+        else if (c == toPlay)
+        {
+            const Block* b = m_block[nb];
+            if (b->m_nuLiberties > 2)
+                return false;
+            if (! ownBlocks.Contains(b))
+            {
+                ownBlocks.PushBack(b);
+                liberties |= b->m_liberties;
+            }
+        }
+        else if (c == SgOppBW(toPlay) && m_block[nb]->m_nuLiberties == 1)
+        {
+            // Captured block, its stone at nb becomes a liberty. A second
+            // captured stone adjacent to p is a second liberty.
+            if (captured != 0)
+                return false;
+            captured = m_block[nb];
+            liberties.Include(nb);
+        }
+    }
+    liberties.Exclude(p);
+    if (liberties.Size() != 1)
+        return false;
+    if (captured != 0)
+    {
+        if (ownBlocks.IsEmpty()) // ko-type capture, OK
+            return false;
+        // Check if the other captured stones are liberties of the new block
+        for (Block::StoneIterator it(captured->m_stones); it; ++it)
+        {
+            const SgPoint s = *it;
+            if (liberties.Contains(s))
+                continue;
+            for (SgNb4Iterator it2(s); it2; ++it2)
+                if (m_color[*it2] == toPlay
+                    && ownBlocks.Contains(m_block[*it2]))
+                    return false;
+        }
+    }
+    nuStones = 1;
+    for (SgArrayList<const Block*,4>::Iterator it(ownBlocks); it; ++it)
+        nuStones += (*it)->m_stones.Length();
+    return true;
+}
+
+void GoUctBitBoard::SetPatternCodes(bool enable)
+{
+    if (enable && ! m_patternCodes)
+        InitPatternCodes();
+    m_patternCodes = enable;
+}
+
+void GoUctBitBoard::Play(SgPoint p)
+{
+    SG_ASSERT(p >= 0); // No special move, see SgMove
+    SG_ASSERT(p == SG_PASS || (IsValidPoint(p) && IsEmpty(p)));
+    CheckConsistency();
+    m_koPoint = SG_NULLPOINT;
+    m_capturedStones.Clear();
+    SgBlackWhite opp = SgOppBW(m_toPlay);
+    if (p != SG_PASS)
+    {
+        AddStone(p, m_toPlay);
+        SgArrayList<Block*,4> adjBlocks;
+        if (NumNeighbors(p, SG_BLACK) > 0 || NumNeighbors(p, SG_WHITE) > 0)
+            RemoveLibAndKill(p, opp, adjBlocks);
+        UpdateBlocksAfterAddStone(p, m_toPlay, adjBlocks);
+        if (m_koPoint != SG_NULLPOINT)
+            if (NumStones(p) > 1 || NumLiberties(p) > 1)
+                m_koPoint = SG_NULLPOINT;
+        SG_ASSERT(HasLiberties(p)); // Suicide not supported by GoUctBitBoard
+    }
+    m_secondLastMove = m_lastMove;
+    m_lastMove = p;
+    m_toPlay = opp;
+    CheckConsistency();
+}
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Throw an exception that describes a difference found by
+    GoUctBitBoardUtil::CheckEqual(). */
+void ThrowDifference(const GoUctBitBoard& bd, SgPoint p,
+                     const std::string& what)
+{
+    std::ostringstream message;
+    message << "GoUctBitBoard differs from GoUctBoard: " << what;
+    if (p != SG_NULLPOINT)
+        message << ' ' << SgWritePoint(p);
+    message << '\n' << bd;
+    throw SgException(message.str());
+}
+
+template<class BOARD>
+GoPointList Liberties(const BOARD& bd, SgPoint p)
+{
+    GoPointList result;
+    for (typename BOARD::LibertyIterator it(bd, p); it; ++it)
+        result.PushBack(*it);
+    return result;
+}
+
+template<class BOARD>
+GoPointList Stones(const BOARD& bd, SgPoint p)
+{
+    GoPointList result;
+    for (typename BOARD::StoneIterator it(bd, p); it; ++it)
+        result.PushBack(*it);
+    return result;
+}
+
+} // namespace
+
+void GoUctBitBoardUtil::CheckEqual(const GoUctBitBoard& bitBd,
+                                   const GoUctBoard& bd)
+{
+    if (bitBd.Size() != bd.Size())
+        ThrowDifference(bitBd, SG_NULLPOINT, "Size");
+    if (bitBd.ToPlay() != bd.ToPlay())
+        ThrowDifference(bitBd, SG_NULLPOINT, "ToPlay");
+    if (bitBd.GetLastMove() != bd.GetLastMove())
+        ThrowDifference(bitBd, SG_NULLPOINT, "GetLastMove");
+    if (bitBd.Get2ndLastMove() != bd.Get2ndLastMove())
+        ThrowDifference(bitBd, SG_NULLPOINT, "Get2ndLastMove");
+    if (! bitBd.CapturedStones().SameElements(bd.CapturedStones()))
+        ThrowDifference(bitBd, SG_NULLPOINT, "CapturedStones");
+    for (SgBWIterator it; it; ++it)
+        if (bitBd.NumPrisoners(*it) != bd.NumPrisoners(*it))
+            ThrowDifference(bitBd, SG_NULLPOINT, "NumPrisoners");
+    const bool patternCodes = (bitBd.PatternCodes() && bd.PatternCodes());
+    for (GoUctBitBoard::Iterator it(bitBd); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (bitBd.GetColor(p) != bd.GetColor(p))
+            ThrowDifference(bitBd, p, "GetColor");
+        if (bitBd.NumEmptyNeighbors(p) != bd.NumEmptyNeighbors(p))
+            ThrowDifference(bitBd, p, "NumEmptyNeighbors");
+        for (SgBWIterator it2; it2; ++it2)
+            if (bitBd.NumNeighbors(p, *it2) != bd.NumNeighbors(p, *it2))
+                ThrowDifference(bitBd, p, "NumNeighbors");
+        if (bitBd.AreInSameBlock(p, p + SG_WE)
+            != bd.AreInSameBlock(p, p + SG_WE)
+            || bitBd.AreInSameBlock(p, p + SG_NS)
+               != bd.AreInSameBlock(p, p + SG_NS))
+            ThrowDifference(bitBd, p, "AreInSameBlock");
+        if (patternCodes)
+        {
+            if (bitBd.Line(p) > 1)
+            {
+                if (bitBd.CodeOf8Neighbors(p) != bd.CodeOf8Neighbors(p))
+                    ThrowDifference(bitBd, p, "CodeOf8Neighbors");
+            }
+            else if (bitBd.Pos(p) > 1)
+            {
+                if (bitBd.CodeOfEdgeNeighbors(p)
+                    != bd.CodeOfEdgeNeighbors(p))
+                    ThrowDifference(bitBd, p, "CodeOfEdgeNeighbors");
+            }
+        }
+        if (bitBd.Occupied(p))
+        {
+            if (bitBd.NumStones(p) != bd.NumStones(p)
+                || ! Stones(bitBd, p).SameElements(Stones(bd, p)))
+                ThrowDifference(bitBd, p, "stones");
+            if (bitBd.NumLiberties(p) != bd.NumLiberties(p)
+                || ! Liberties(bitBd, p).SameElements(Liberties(bd, p)))
+                ThrowDifference(bitBd, p, "liberties");
+            if (bitBd.InAtari(p) && bitBd.TheLiberty(p) != bd.TheLiberty(p))
+                ThrowDifference(bitBd, p, "TheLiberty");
+            continue;
+        }
+        for (SgBWIterator it2; it2; ++it2)
+        {
+            const SgBlackWhite c = *it2;
+            if (bitBd.IsLegal(p, c) != bd.IsLegal(p, c))
+                ThrowDifference(bitBd, p, "IsLegal");
+            if (bitBd.CanCapture(p, c) != bd.CanCapture(p, c))
+                ThrowDifference(bitBd, p, "CanCapture");
+            if (GoBoardUtil::SelfAtariForColor(bitBd, p, c)
+                != GoBoardUtil::SelfAtariForColor(bd, p, c))
+                ThrowDifference(bitBd, p, "SelfAtariForColor");
+        }
+        int nuStones = 0;
+        int bitNuStones = 0;
+        const bool selfAtari = GoBoardUtil::SelfAtari(bd, p, nuStones);
+        if (GoBoardUtil::SelfAtari(bitBd, p, bitNuStones) != selfAtari
+            || (selfAtari && bitNuStones != nuStones))
+            ThrowDifference(bitBd, p, "SelfAtari");
+    }
+}
+
+//----------------------------------------------------------------------------
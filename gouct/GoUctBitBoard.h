@@ -0,0 +1,1072 @@
+//----------------------------------------------------------------------------
+/** @file GoUctBitBoard.h
+    Go board for Monte Carlo simulations with bitboard liberty sets. */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_BITBOARD_H
+#define GOUCT_BITBOARD_H
+
+#include <boost/array.hpp>
+#include "GoBoard.h"
+#include "GoBoardUtil.h"
+#include "GoPlayerMove.h"
+#include "SgArray.h"
+#include "SgArrayList.h"
+#include "SgBitboard.h"
+#include "SgBoardConst.h"
+#include "SgBoardColor.h"
+#include "SgMarker.h"
+#include "SgBWArray.h"
+#include "SgNbIterator.h"
+#include "SgPoint.h"
+#include "SgPointArray.h"
+#include "SgPointIterator.h"
+
+//----------------------------------------------------------------------------
+
+class GoUctBitBoard;
+typedef GoNb4Iterator<GoUctBitBoard> GoUctBitNbIterator;
+
+//----------------------------------------------------------------------------
+
+/** Go board for Monte Carlo simulations that stores the liberties of the
+    blocks as bitboards.
+    This board has the same interface and makes the same assumptions as
+    GoUctBoard (no undo, alternating play, simple-ko rule, no suicide) and
+    can be used as the BOARD template argument of the playout policies
+    instead of it. It differs only in the representation of the liberties:
+    each block stores its liberties in a SgBitboard and caches their number.
+    Adding and removing a liberty is a single bit operation that also
+    detects duplicates, so no markers are needed to avoid adding a liberty
+    twice, merging blocks is a union of the bitboards, and the
+    self-atari check (GoBoardUtil::SelfAtari(), specialized for this class
+    below) computes the liberties of the block that a move would create as
+    a union of bitboards instead of walking the liberty lists.
+    Iterating over the liberties returns them in increasing order, not in
+    the order in which they were added as in GoUctBoard, so functions that
+    select one of the liberties can select a different liberty.
+    See GoUctBitBoardUtil::CheckEqual() for a differential test against
+    GoUctBoard. */
+class GoUctBitBoard
+{
+public:
+    /** Marker that can be used in client code.
+        This marker is never used by this class, it is intended for external
+        functions that operate on the board and can profit from the fast clear
+        operation of SgMarker (if reused), but cannot store its own
+        marker (or don't want to use a global variable for thread-safety).
+        Since only one function can use this marker at a time, you should
+        assert with SgReserveMarker that the marker is not used in a
+        conflicting way. */
+    mutable SgMarker m_userMarker;
+
+    explicit GoUctBitBoard(const GoBoard& bd);
+
+    ~GoUctBitBoard();
+
+    const SgBoardConst& BoardConst() const;
+
+    /** Re-initializes the board from GoBoard position. */
+    void Init(const GoBoard& bd);
+
+    /** Return the size of this board. */
+    SgGrid Size() const;
+
+    /** Check if point is occupied by a stone.
+        Can be called with border points. */
+    bool Occupied(SgPoint p) const;
+
+    bool IsEmpty(SgPoint p) const;
+
+    bool IsBorder(SgPoint p) const;
+
+    bool IsColor(SgPoint p, int c) const;
+
+    SgBoardColor GetColor(SgPoint p) const;
+
+    SgBlackWhite GetStone(SgPoint p) const;
+
+    /** %Player whose turn it is to play. */
+    SgBlackWhite ToPlay() const;
+
+    /** Opponent of player whose turn it is to play. */
+    SgBlackWhite Opponent() const;
+
+    /** See SgBoardConst::Line */
+    SgGrid Line(SgPoint p) const;
+
+    /** See SgBoardConst::Pos */
+    SgGrid Pos(SgPoint p) const;
+
+    /** Returns the offset to the point on the line above this point.
+        Returns zero for points outside the board, and for the center
+        point(s). */
+    int Up(SgPoint p) const;
+
+    /** Returns the offset along left side of the board.
+        Left and right are as seen from the edge toward the center of the
+        board.
+        Returns zero for the same points as Up does. */
+    int Left(SgPoint p) const;
+
+    /** Returns the offset along right side of the board.
+        @see Left for more info. */
+    int Right(SgPoint p) const;
+
+    /** Same as Left/Right, but the side is passed in as an index (0 or 1). */
+    int Side(SgPoint p, int index) const;
+
+    bool IsSuicide(SgPoint p, SgBlackWhite toPlay) const;
+
+    bool IsValidPoint(SgPoint p) const;
+
+    bool HasEmptyNeighbors(SgPoint p) const;
+
+    int NumEmptyNeighbors(SgPoint p) const;
+
+    /** Includes diagonals. */
+    int Num8EmptyNeighbors(SgPoint p) const;
+
+    bool HasNeighbors(SgPoint p, SgBlackWhite c) const;
+
+    int NumNeighbors(SgPoint p, SgBlackWhite c) const;
+
+    /** Includes diagonals. */
+    int Num8Neighbors(SgPoint p, SgBlackWhite c) const;
+
+    bool HasDiagonals(SgPoint p, SgBoardColor c) const;
+
+    int NumDiagonals(SgPoint p, SgBoardColor c) const;
+
+    int NumEmptyDiagonals(SgPoint p) const;
+
+    bool HasNeighborsOrDiags(SgPoint p, SgBlackWhite c) const;
+
+    bool InCorner(SgPoint p) const;
+
+    bool OnEdge(SgPoint p) const;
+
+    bool InCenter(SgPoint p) const;
+
+    /** See SgBoardConst::FirstBoardPoint */
+    int FirstBoardPoint() const;
+
+    /** See SgBoardConst::FirstBoardPoint */
+    int LastBoardPoint() const;
+
+    /** Play a move for the current player.
+        @see Play(SgPoint,SgBlackWhite); */
+    void Play(SgPoint p);
+
+    /** Check whether the move at 'p' is legal.
+        Since it's not clear how 'p' was arrived at, any value of 'p' is
+        admissible, even out of point range and on border points; just return
+        false on such input. */
+    bool IsLegal(int p, SgBlackWhite player) const;
+
+    /** Check whether the move at 'p' is legal for color to play.
+        @see IsLegal(int, SgBlackWhite). */
+    bool IsLegal(int p) const;
+
+    bool IsSuicide(SgPoint p) const;
+
+    /** Whether the most recent move captured any stones. */
+    bool CapturingMove() const;
+
+    /** The stones removed from the board by the most recent move.
+        Can be used for incremental update of other data structures.
+        Only valid directly after a GoUctBitBoard::Play, otherwise undefined. */
+    const GoPointList& CapturedStones() const;
+
+    /** The stones captured by the most recent move.
+        @see CapturedStones */
+    int NuCapturedStones() const;
+
+    /** The total number of stones of 'color' that have been
+        captured by the opponent throughout the game. */
+    int NumPrisoners(SgBlackWhite color) const;
+
+    /** Return last move played.
+        @return The last move played or SG_NULLMOVE, if
+        - No move was played yet
+        - The last move was not by the opposite color of the current player */
+    SgPoint GetLastMove() const;
+
+    /** 2nd Last move = last move by ToPlay().
+        Conditions similar to GetLastMove(). */
+    SgPoint Get2ndLastMove() const;
+
+    /** Return the number of stones in the block at 'p'.
+        Not defined for empty or border points. */
+    int NumStones(SgPoint p) const;
+
+    /** Return NumStones(p) == 1. */
+    bool IsSingleStone(SgPoint p) const;
+
+    /** Return whether the two stones are located in the same block.
+        Return false if one of the stones is an empty or border point. */
+    bool AreInSameBlock(SgPoint stone1, SgPoint stone2) const;
+
+    /** Return a reference point in the block at a point.
+        @note In contrast to GoBoard, the anchor point is not guaranteed
+        to be the smallest point (this functionality is not needed in
+        Monte Carlo simulations)
+        Requires: Occupied(p). */
+    SgPoint Anchor(SgPoint p) const;
+
+    /** See GoBoard::IsInBlock */
+    bool IsInBlock(SgPoint p, SgPoint anchor) const;
+
+    /** See GoBoard::IsLibertyOfBlock */
+    bool IsLibertyOfBlock(SgPoint p, SgPoint anchor) const;
+
+    /** Get adjacent opponent blocks with a maximum number of liberties for a
+        given block.
+        Not defined for empty points.
+        @param p The block to check.
+        @param maxLib The maximum number of liberties of the neighbors.
+        @param anchors Resulting neighbor anchors and an additional SG_ENDPOINT.
+        @param maxAnchors Array size of anchors (for detecting overflow in
+        debug mode)
+        @return Number of anchors (without the SG_ENDPOINT) */
+    int AdjacentBlocks(SgPoint p, int maxLib, SgPoint anchors[],
+                       int maxAnchors) const;
+
+    /** %List anchor of each block of color 'c' adjacent to the
+        empty point 'p'.
+        Assert if 'p' is not empty.
+        Fill an array of points, terminated by SG_ENDPOINT. */
+    void NeighborBlocks(SgPoint p, SgBlackWhite c, SgPoint anchors[]) const;
+
+    /** %List anchor of each block of color 'c' with at most 'maxLib'
+        liberties adjacent to the empty point 'p'.
+        Assert if 'p' is not empty.
+        Fill an array of points, terminated by SG_ENDPOINT. */
+    void NeighborBlocks(SgPoint p, SgBlackWhite c, int maxLib,
+                        SgPoint anchors[]) const;
+
+    /** Return the liberty of 'blockInAtari' which must have exactly
+        one liberty. */
+    SgPoint TheLiberty(SgPoint blockInAtari) const;
+
+    /** Return the number of liberties of the block at 'p'.
+        Not defined for empty or border points. */
+    int NumLiberties(SgPoint p) const;
+
+    /** Return whether block has at most n liberties. */
+    bool AtMostNumLibs(SgPoint block, int n) const;
+
+    /** Return whether block has at least n liberties. */
+    bool AtLeastNumLibs(SgPoint block, int n) const;
+
+    /** Return whether the number of liberties of the block at 'p' is one.
+        Requires: Occupied(p) */
+    bool InAtari(SgPoint p) const;
+
+    /** Check if point is occupied and in atari.
+        Faster than Occupied(p) || InAtari(p).
+        May be called for border points. */
+    bool OccupiedInAtari(SgPoint p) const;
+
+    /** Return whether playing colour c at p can capture anything,
+        ignoring any possible repetition. */
+    bool CanCapture(SgPoint p, SgBlackWhite c) const;
+
+    /** Check if a move would be self-atari.
+        Computes the liberties of the block that the move would create as the
+        union of the liberties of the adjacent own blocks. Returns the same
+        result as the generic GoBoardUtil::SelfAtari(), which is specialized
+        for this class to call this function.
+        @param p The move, must be empty
+        @param toPlay The color of the move
+        @param[out] nuStones The number of stones put into self-atari, only
+        set if the return value is true */
+    bool SelfAtari(SgPoint p, SgBlackWhite toPlay, int& nuStones) const;
+
+    /** Checks whether all the board data structures are in a consistent
+        state. */
+    void CheckConsistency() const;
+
+    /** @name Incremental 3x3 pattern codes
+        The codes are the same as the ones computed by
+        GoPattern3x3::CodeOf8Neighbors() and
+        GoPattern3x3::CodeOfEdgeNeighbors(), but they are updated whenever
+        Play() changes the color of a point, such that matching a 3x3 pattern
+        in the playouts needs only a single array lookup. */
+    //@{
+
+    /** Whether the pattern codes are maintained.
+        Default is true. */
+    bool PatternCodes() const;
+
+    /** Enable or disable the pattern codes.
+        Disabling saves the update cost in Play() if no patterns are used.
+        Enabling recomputes the codes for the current position. */
+    void SetPatternCodes(bool enable);
+
+    /** Code of the 8 neighbors of a point not on the first line.
+        Requires: PatternCodes() and Line(p) > 1 */
+    int CodeOf8Neighbors(SgPoint p) const;
+
+    /** Code of the 5 neighbors of a point on the edge but not in a corner.
+        Requires: PatternCodes(), Line(p) == 1 and Pos(p) > 1 */
+    int CodeOfEdgeNeighbors(SgPoint p) const;
+
+    //@}
+
+private:
+    /** Data related to a block of stones on the board. */
+    struct Block
+    {
+    public:
+        typedef SgBitboard::Iterator LibertyIterator;
+
+        typedef GoPointList::Iterator StoneIterator;
+
+        SgPoint m_anchor;
+
+        SgBlackWhite m_color;
+
+        /** Number of elements of m_liberties. */
+        int m_nuLiberties;
+
+        SgBitboard m_liberties;
+
+        GoPointList m_stones;
+
+        void InitSingleStoneBlock(SgBlackWhite c, SgPoint anchor)
+        {
+            SG_ASSERT_BW(c);
+            m_color = c;
+            m_anchor = anchor;
+            m_stones.SetTo(anchor);
+            m_liberties.Clear();
+            m_nuLiberties = 0;
+        }
+
+        void InitNewBlock(SgBlackWhite c, SgPoint anchor)
+        {
+            SG_ASSERT_BW(c);
+            m_color = c;
+            m_anchor = anchor;
+            m_stones.Clear();
+            m_liberties.Clear();
+            m_nuLiberties = 0;
+        }
+
+        /** Add a liberty, if it is not already a liberty. */
+        void IncludeLiberty(SgPoint p)
+        {
+            if (! m_liberties.Contains(p))
+            {
+                m_liberties.Include(p);
+                ++m_nuLiberties;
+            }
+        }
+
+        /** Remove a liberty.
+            Requires: p is a liberty. */
+        void ExcludeLiberty(SgPoint p)
+        {
+            SG_ASSERT(m_liberties.Contains(p));
+            m_liberties.Exclude(p);
+            --m_nuLiberties;
+        }
+    };
+
+    SgPoint m_lastMove;
+
+    SgPoint m_secondLastMove;
+
+    /** Point which is currently illegal for simple Ko rule. */
+    SgPoint m_koPoint;
+
+    /** Whose turn it is to play. */
+    SgBlackWhite m_toPlay;
+
+    SgArray<Block*,SG_MAXPOINT> m_block;
+
+    /** Number of prisoners of each color */
+    SgBWArray<int> m_prisoners;
+
+    /** The current board position. */
+    SgArray<int,SG_MAXPOINT> m_color;
+
+    /** Number of black and white neighbors. */
+    SgArray<int,SG_MAXPOINT> m_nuNeighborsEmpty;
+
+    /** Number of black and white neighbors. */
+    SgBWArray<SgArray<int,SG_MAXPOINT> > m_nuNeighbors;
+
+    /** Data that's constant for this board size. */
+    SgBoardConst m_const;
+
+    /** The current board size. */
+    SgGrid m_size;
+
+    SgPointArray<Block> m_blockArray;
+
+    mutable SgMarker m_marker;
+
+    GoPointList m_capturedStones;
+
+    SgArray<bool,SG_MAXPOINT> m_isBorder;
+
+    /** See PatternCodes() */
+    bool m_patternCodes;
+
+    /** 3x3 pattern code of each point.
+        The 8-neighbor code for points with Line(p) > 1, the edge code for
+        edge points with Pos(p) > 1, undefined for corners and border
+        points. */
+    SgArray<int,SG_MAXPOINT> m_patternCode;
+
+    /** Pattern codes of the empty board. */
+    SgArray<int,SG_MAXPOINT> m_emptyPatternCode;
+
+    /** Weight of a point in the pattern codes of its 8 neighbors.
+        Indexed by the point and the direction from the point to the
+        neighbor, in the order of the digits of
+        GoPattern3x3::CodeOf8Neighbors(). If the color of a point changes by
+        delta, the code of the neighbor in direction i changes by
+        delta * m_patternWeight[p][i]. The weight is 0 for neighbors without
+        a pattern code (border and corner points). */
+    SgArray<boost::array<int,8>,SG_MAXPOINT> m_patternWeight;
+
+    /** Not implemented. */
+    GoUctBitBoard(const GoUctBitBoard&);
+
+    /** Not implemented. */
+    GoUctBitBoard& operator=(const GoUctBitBoard&);
+
+    void AddLibToAdjBlocks(SgPoint p, SgBlackWhite c);
+
+    void AddStoneToBlock(SgPoint p, Block* block);
+
+    void CreateSingleStoneBlock(SgPoint p, SgBlackWhite c);
+
+    void InitSize(const GoBoard& bd);
+
+    void InitPatternCodes();
+
+    void InitPatternWeights();
+
+    void UpdatePatternCodes(SgPoint p, int delta);
+
+    void MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks);
+
+    void RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
+                          SgArrayList<Block*,4>& ownAdjBlocks);
+
+    void RemoveLib(Block* b, SgPoint p, SgBlackWhite opp,
+                   SgArrayList<Block*,4>& ownAdjBlocks);
+
+    void UpdateBlocksAfterAddStone(SgPoint p, SgBlackWhite c,
+                                   const SgArrayList<Block*,4>& adjBlocks);
+
+    void CheckConsistencyBlock(SgPoint p) const;
+
+    void AddStone(SgPoint p, SgBlackWhite c);
+
+    void KillBlock(const Block* block);
+
+    bool HasLiberties(SgPoint p) const;
+
+public:
+    friend class LibertyIterator;
+    friend class StoneIterator;
+
+    /** Iterate through all points on the given board. */
+    class Iterator
+        : public SgPointRangeIterator
+    {
+    public:
+        Iterator(const GoUctBitBoard& bd);
+    };
+
+    /** Iterate through all the liberties of a block.
+        Point 'p' must be occupied.
+        Liberties should only be accessed for the current board position.
+        No moves are allowed to be executed during the iteration. */
+    class LibertyIterator
+    {
+    public:
+        LibertyIterator(const GoUctBitBoard& bd, SgPoint p);
+
+        /** Advance the state of the iteration to the next liberty. */
+        void operator++();
+
+        /** Return the current liberty. */
+        SgPoint operator*() const;
+
+        /** Return true if iteration is valid, otherwise false. */
+        operator bool() const;
+
+    private:
+        GoUctBitBoard::Block::LibertyIterator m_it;
+
+        const GoUctBitBoard& m_board;
+
+        /** Not implemented.
+            Prevent unintended usage of operator bool() as an int.
+            Detects bug of forgetting to dereference iterator - 
+            it instead of *it
+        */
+        operator int() const;
+
+        /** Not implemented. */
+        LibertyIterator(const LibertyIterator&);
+
+        /** Not implemented. */
+        LibertyIterator& operator=(const LibertyIterator&);
+    };
+
+    /** Iterate through all the stones of a block.
+        Point 'p' must be occupied.
+        Also, the stones can only be accessed for the current board position. */
+    class StoneIterator
+    {
+    public:
+        StoneIterator(const GoUctBitBoard& bd, SgPoint p);
+
+        /** Advance the state of the iteration to the next stone. */
+        void operator++();
+
+        /** Return the current stone. */
+        SgPoint operator*() const;
+
+        /** Return true if iteration is valid, otherwise false. */
+        operator bool() const;
+
+    private:
+        GoUctBitBoard::Block::StoneIterator m_it;
+
+        const GoUctBitBoard& m_board;
+
+        /** Not implemented.
+            Prevent unintended usage of operator bool() as an int.
+            Detects bug of forgetting to dereference iterator - 
+            it instead of *it
+        */
+        operator int() const;
+
+        /** Not implemented. */
+        StoneIterator(const StoneIterator&);
+
+        /** Not implemented. */
+        StoneIterator& operator=(const StoneIterator&);
+    };
+};
+
+//----------------------------------------------------------------------------
+
+inline std::ostream& operator<<(std::ostream& out, const GoUctBitBoard& bd)
+{
+    return GoWriteBoard(out, bd);
+}
+
+inline GoUctBitBoard::Iterator::Iterator(const GoUctBitBoard& bd)
+    : SgPointRangeIterator(bd.BoardConst().BoardIterAddress(),
+                           bd.BoardConst().BoardIterEnd())
+{ }
+
+inline GoUctBitBoard::LibertyIterator::LibertyIterator(const GoUctBitBoard& bd,
+                                                    SgPoint p)
+    : m_it(bd.m_block[p]->m_liberties),
+      m_board(bd)
+{
+    SG_ASSERT(m_board.Occupied(p));
+}
+
+inline void GoUctBitBoard::LibertyIterator::operator++()
+{
+    ++m_it;
+}
+
+inline SgPoint GoUctBitBoard::LibertyIterator::operator*() const
+{
+    return *m_it;
+}
+
+inline GoUctBitBoard::LibertyIterator::operator bool() const
+{
+    return m_it;
+}
+
+inline GoUctBitBoard::StoneIterator::StoneIterator(const GoUctBitBoard& bd,
+                                                SgPoint p)
+    : m_it(bd.m_block[p]->m_stones),
+      m_board(bd)
+{
+    SG_ASSERT(m_board.Occupied(p));
+}
+
+inline void GoUctBitBoard::StoneIterator::operator++()
+{
+    ++m_it;
+}
+
+inline SgPoint GoUctBitBoard::StoneIterator::operator*() const
+{
+    return *m_it;
+}
+
+inline GoUctBitBoard::StoneIterator::operator bool() const
+{
+    return m_it;
+}
+
+inline int GoUctBitBoard::AdjacentBlocks(SgPoint point, int maxLib,
+                                      SgPoint anchors[], int maxAnchors) const
+{
+    SG_DEBUG_ONLY(maxAnchors);
+    SG_ASSERT(Occupied(point));
+    const SgBlackWhite other = SgOppBW(GetStone(point));
+    int n = 0;
+    SgReserveMarker reserve(m_marker);
+    SG_UNUSED(reserve);
+    m_marker.Clear();
+    for (StoneIterator it(*this, point); it; ++it)
+    {
+        if (NumNeighbors(*it, other) > 0)
+        {
+            SgPoint p = *it;
+            if (IsColor(p - SG_NS, other)
+                && m_marker.NewMark(Anchor(p - SG_NS))
+                && AtMostNumLibs(p - SG_NS, maxLib))
+                anchors[n++] = Anchor(p - SG_NS);
+            if (IsColor(p - SG_WE, other)
+                && m_marker.NewMark(Anchor(p - SG_WE))
+                && AtMostNumLibs(p - SG_WE, maxLib))
+                anchors[n++] = Anchor(p - SG_WE);
+            if (IsColor(p + SG_WE, other)
+                && m_marker.NewMark(Anchor(p + SG_WE))
+                && AtMostNumLibs(p + SG_WE, maxLib))
+                anchors[n++] = Anchor(p + SG_WE);
+            if (IsColor(p + SG_NS, other)
+                && m_marker.NewMark(Anchor(p + SG_NS))
+                && AtMostNumLibs(p + SG_NS, maxLib))
+                anchors[n++] = Anchor(p + SG_NS);
+        }
+    };
+    // Detect array overflow.
+    SG_ASSERT(n < maxAnchors);
+    anchors[n] = SG_ENDPOINT;
+    return n;
+}
+
+inline SgPoint GoUctBitBoard::Anchor(SgPoint p) const
+{
+    SG_ASSERT(Occupied(p));
+    return m_block[p]->m_anchor;
+}
+
+inline bool GoUctBitBoard::AreInSameBlock(SgPoint p1, SgPoint p2) const
+{
+    return Occupied(p1) && Occupied(p2) && Anchor(p1) == Anchor(p2);
+}
+
+inline bool GoUctBitBoard::AtLeastNumLibs(SgPoint block, int n) const
+{
+    return NumLiberties(block) >= n;
+}
+
+inline bool GoUctBitBoard::AtMostNumLibs(SgPoint block, int n) const
+{
+    return NumLiberties(block) <= n;
+}
+
+inline const GoPointList& GoUctBitBoard::CapturedStones() const
+{
+    return m_capturedStones;
+}
+
+inline bool GoUctBitBoard::CapturingMove() const
+{
+    return ! m_capturedStones.IsEmpty();
+}
+
+inline int GoUctBitBoard::CodeOf8Neighbors(SgPoint p) const
+{
+    SG_ASSERT(m_patternCodes);
+    SG_ASSERT(Line(p) > 1);
+    return m_patternCode[p];
+}
+
+inline int GoUctBitBoard::CodeOfEdgeNeighbors(SgPoint p) const
+{
+    SG_ASSERT(m_patternCodes);
+    SG_ASSERT(Line(p) == 1);
+    SG_ASSERT(Pos(p) > 1);
+    return m_patternCode[p];
+}
+
+inline int GoUctBitBoard::FirstBoardPoint() const
+{
+    return m_const.FirstBoardPoint();
+}
+
+inline const SgBoardConst& GoUctBitBoard::BoardConst() const
+{
+    return m_const;
+}
+
+inline SgPoint GoUctBitBoard::Get2ndLastMove() const
+{
+    return m_secondLastMove;
+}
+
+inline SgBoardColor GoUctBitBoard::GetColor(SgPoint p) const
+{
+    return m_color[p];
+}
+
+inline SgPoint GoUctBitBoard::GetLastMove() const
+{
+    return m_lastMove;
+}
+
+inline SgBlackWhite GoUctBitBoard::GetStone(SgPoint p) const
+{
+    SG_ASSERT(Occupied(p));
+    return m_color[p];
+}
+
+inline bool GoUctBitBoard::HasDiagonals(SgPoint p, SgBoardColor c) const
+{
+    return (IsColor(p - SG_NS - SG_WE, c)
+            || IsColor(p - SG_NS + SG_WE, c)
+            || IsColor(p + SG_NS - SG_WE, c)
+            || IsColor(p + SG_NS + SG_WE, c));
+}
+
+inline bool GoUctBitBoard::HasEmptyNeighbors(SgPoint p) const
+{
+    return m_nuNeighborsEmpty[p] != 0;
+}
+
+inline bool GoUctBitBoard::HasLiberties(SgPoint p) const
+{
+    return NumLiberties(p) > 0;
+}
+
+inline bool GoUctBitBoard::HasNeighbors(SgPoint p, SgBlackWhite c) const
+{
+    return (m_nuNeighbors[c][p] > 0);
+}
+
+inline bool GoUctBitBoard::HasNeighborsOrDiags(SgPoint p, SgBlackWhite c) const
+{
+    return HasNeighbors(p, c) || HasDiagonals(p, c);
+}
+
+inline bool GoUctBitBoard::InAtari(SgPoint p) const
+{
+    SG_ASSERT(Occupied(p));
+    return AtMostNumLibs(p, 1);
+}
+
+inline bool GoUctBitBoard::IsInBlock(SgPoint p, SgPoint anchor) const
+{
+    SG_ASSERT(Occupied(anchor));
+    const Block* b = m_block[p];
+    return (b != 0 && b->m_anchor == anchor);
+}
+
+inline bool GoUctBitBoard::IsLibertyOfBlock(SgPoint p, SgPoint anchor) const
+{
+    SG_ASSERT(IsEmpty(p));
+    SG_ASSERT(Occupied(anchor));
+    SG_ASSERT(Anchor(anchor) == anchor);
+    const Block* b = m_block[anchor];
+    if (m_nuNeighbors[b->m_color][p] == 0)
+        return false;
+    return (   m_block[p - SG_NS] == b
+            || m_block[p - SG_WE] == b
+            || m_block[p + SG_WE] == b
+            || m_block[p + SG_NS] == b);
+}
+
+inline bool GoUctBitBoard::CanCapture(SgPoint p, SgBlackWhite c) const
+{
+    SgBlackWhite opp = SgOppBW(c);
+    for (GoUctBitNbIterator nb(*this, p); nb; ++nb)
+        if (IsColor(*nb, opp) && AtMostNumLibs(*nb, 1))
+            return true;
+    return false;
+}
+
+inline bool GoUctBitBoard::IsSuicide(SgPoint p, SgBlackWhite toPlay) const
+{
+    if (HasEmptyNeighbors(p))
+        return false;
+    SgBlackWhite opp = SgOppBW(toPlay);
+    for (GoUctBitNbIterator it(*this, p); it; ++it)
+    {
+        SgEmptyBlackWhite c = GetColor(*it);
+        if (c == toPlay && NumLiberties(*it) > 1)
+            return false;
+        if (c == opp && NumLiberties(*it) == 1)
+            return false;
+    }
+    return true;
+}
+
+inline bool GoUctBitBoard::IsBorder(SgPoint p) const
+{
+    SG_ASSERT(p != SG_PASS);
+    return m_isBorder[p];
+}
+
+inline bool GoUctBitBoard::IsColor(SgPoint p, int c) const
+{
+    SG_ASSERT(p != SG_PASS);
+    SG_ASSERT_EBW(c);
+    return m_color[p] == c;
+}
+
+inline bool GoUctBitBoard::IsEmpty(SgPoint p) const
+{
+    SG_ASSERT(p != SG_PASS);
+    return m_color[p] == SG_EMPTY;
+}
+
+inline bool GoUctBitBoard::IsLegal(int p, SgBlackWhite player) const
+{
+    SG_ASSERT_BW(player);
+    if (p == SG_PASS)
+        return true;
+    SG_ASSERT(SgPointUtil::InBoardRange(p));
+    if (! IsEmpty(p))
+        return false;
+    // Suicide
+    if (IsSuicide(p, player))
+        return false;
+    // Repetition
+    if (p == m_koPoint && m_toPlay == player)
+        return false;
+    return true;
+}
+
+inline bool GoUctBitBoard::IsLegal(int p) const
+{
+    return IsLegal(p, ToPlay());
+}
+
+inline bool GoUctBitBoard::IsSingleStone(SgPoint p) const
+{
+    return (Occupied(p) && NumNeighbors(p, GetColor(p)) == 0);
+}
+
+inline bool GoUctBitBoard::IsSuicide(SgPoint p) const
+{
+    return IsSuicide(p, ToPlay());
+}
+
+inline bool GoUctBitBoard::IsValidPoint(SgPoint p) const
+{
+    return SgPointUtil::InBoardRange(p) && ! IsBorder(p);
+}
+
+inline int GoUctBitBoard::LastBoardPoint() const
+{
+    return m_const.LastBoardPoint();
+}
+
+inline int GoUctBitBoard::Left(SgPoint p) const
+{
+    return m_const.Left(p);
+}
+
+inline SgGrid GoUctBitBoard::Line(SgPoint p) const
+{
+    return m_const.Line(p);
+}
+
+inline void GoUctBitBoard::NeighborBlocks(SgPoint p, SgBlackWhite c, int maxLib,
+                                       SgPoint anchors[]) const
+{
+    SG_ASSERT(IsEmpty(p));
+    SgReserveMarker reserve(m_marker);
+    SG_UNUSED(reserve);
+    m_marker.Clear();
+    int i = 0;
+    if (NumNeighbors(p, c) > 0)
+    {
+        if (IsColor(p - SG_NS, c) && m_marker.NewMark(Anchor(p - SG_NS))
+            && AtMostNumLibs(p - SG_NS, maxLib))
+            anchors[i++] = Anchor(p - SG_NS);
+        if (IsColor(p - SG_WE, c) && m_marker.NewMark(Anchor(p - SG_WE))
+            && AtMostNumLibs(p - SG_WE, maxLib))
+            anchors[i++] = Anchor(p - SG_WE);
+        if (IsColor(p + SG_WE, c) && m_marker.NewMark(Anchor(p + SG_WE))
+            && AtMostNumLibs(p + SG_WE, maxLib))
+            anchors[i++] = Anchor(p + SG_WE);
+        if (IsColor(p + SG_NS, c) && m_marker.NewMark(Anchor(p + SG_NS))
+            && AtMostNumLibs(p + SG_NS, maxLib))
+            anchors[i++] = Anchor(p + SG_NS);
+    }
+    anchors[i] = SG_ENDPOINT;
+}
+
+inline int GoUctBitBoard::Num8Neighbors(SgPoint p, SgBlackWhite c) const
+{
+    return NumNeighbors(p, c) + NumDiagonals(p, c);
+}
+
+inline int GoUctBitBoard::Num8EmptyNeighbors(SgPoint p) const
+{
+    return NumEmptyNeighbors(p) + NumEmptyDiagonals(p);
+}
+
+inline int GoUctBitBoard::NuCapturedStones() const
+{
+    return m_capturedStones.Length();
+}
+
+inline int GoUctBitBoard::NumDiagonals(SgPoint p, SgBoardColor c) const
+{
+    int n = 0;
+    if (IsColor(p - SG_NS - SG_WE, c))
+        ++n;
+    if (IsColor(p - SG_NS + SG_WE, c))
+        ++n;
+    if (IsColor(p + SG_NS - SG_WE, c))
+        ++n;
+    if (IsColor(p + SG_NS + SG_WE, c))
+        ++n;
+    return n;
+}
+
+inline int GoUctBitBoard::NumEmptyDiagonals(SgPoint p) const
+{
+    return NumDiagonals(p, SG_EMPTY);
+}
+
+inline int GoUctBitBoard::NumEmptyNeighbors(SgPoint p) const
+{
+    return m_nuNeighborsEmpty[p];
+}
+
+inline int GoUctBitBoard::NumLiberties(SgPoint p) const
+{
+    SG_ASSERT(IsValidPoint(p));
+    SG_ASSERT(Occupied(p));
+    return m_block[p]->m_nuLiberties;
+}
+
+inline int GoUctBitBoard::NumNeighbors(SgPoint p, SgBlackWhite c) const
+{
+    return m_nuNeighbors[c][p];
+}
+
+inline int GoUctBitBoard::NumPrisoners(SgBlackWhite color) const
+{
+    return m_prisoners[color];
+}
+
+inline int GoUctBitBoard::NumStones(SgPoint block) const
+{
+    SG_ASSERT(Occupied(block));
+    return m_block[block]->m_stones.Length();
+}
+
+inline bool GoUctBitBoard::Occupied(SgPoint p) const
+{
+    return (m_block[p] != 0);
+}
+
+inline bool GoUctBitBoard::OccupiedInAtari(SgPoint p) const
+{
+    const Block* b = m_block[p];
+    return (b != 0 && b->m_nuLiberties <= 1);
+}
+
+inline SgBlackWhite GoUctBitBoard::Opponent() const
+{
+    return SgOppBW(m_toPlay);
+}
+
+inline bool GoUctBitBoard::PatternCodes() const
+{
+    return m_patternCodes;
+}
+
+inline SgGrid GoUctBitBoard::Pos(SgPoint p) const
+{
+    return m_const.Pos(p);
+}
+
+inline int GoUctBitBoard::Right(SgPoint p) const
+{
+    return m_const.Right(p);
+}
+
+inline int GoUctBitBoard::Side(SgPoint p, int index) const
+{
+    return m_const.Side(p, index);
+}
+
+inline SgGrid GoUctBitBoard::Size() const
+{
+    return m_size;
+}
+
+inline SgPoint GoUctBitBoard::TheLiberty(SgPoint p) const
+{
+    SG_ASSERT(Occupied(p));
+    SG_ASSERT(NumLiberties(p) == 1);
+    return m_block[p]->m_liberties.First();
+}
+
+inline SgBlackWhite GoUctBitBoard::ToPlay() const
+{
+    return m_toPlay;
+}
+
+inline int GoUctBitBoard::Up(SgPoint p) const
+{
+    return m_const.Up(p);
+}
+
+//----------------------------------------------------------------------------
+
+/** Specialization of GoBoardUtil::SelfAtari() for GoUctBitBoard.
+    See GoUctBitBoard::SelfAtari() */
+template<>
+inline bool GoBoardUtil::SelfAtari(const GoUctBitBoard& bd, SgPoint p,
+                                   int& numStones)
+{
+    return bd.SelfAtari(p, bd.ToPlay(), numStones);
+}
+
+/** Specialization of GoBoardUtil::SelfAtariForColor() for GoUctBitBoard.
+    See GoUctBitBoard::SelfAtari() */
+template<>
+inline bool GoBoardUtil::SelfAtariForColor(const GoUctBitBoard& bd,
+                                           SgPoint p, SgBlackWhite toPlay)
+{
+    int numStones;
+    return bd.SelfAtari(p, toPlay, numStones);
+}
+
+//----------------------------------------------------------------------------
+
+class GoUctBoard;
+
+/** Utility functions for GoUctBitBoard. */
+namespace GoUctBitBoardUtil
+{
+    /** Compare a GoUctBitBoard with a GoUctBoard in the same position.
+        Compares the colors and neighbor counts of all points, the stones
+        and liberties of the blocks, the legality of all moves and the
+        results of the self-atari checks, which use the bitboards in
+        GoUctBitBoard and the generic implementation in GoUctBoard.
+        @throws SgException with a description of the first difference */
+    void CheckEqual(const GoUctBitBoard& bitBd, const GoUctBoard& bd);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_BITBOARD_H
+
@@ -9,6 +9,7 @@
 #include <boost/static_assert.hpp>
 #include <algorithm>
 #include "GoBoardUtil.h"
+#include "GoPattern3x3.h"
 #include "SgNbIterator.h"
 #include "SgStack.h"
 
@@ -23,6 +24,24 @@ namespace {
     time. */
 const bool CONSISTENCY = false;
 
+/** Offsets of the 8 neighbors in the order of the digits of
+    GoPattern3x3::CodeOf8Neighbors(), most significant digit first.
+    PATTERN_DIR[7 - i] is the opposite direction of PATTERN_DIR[i]. */
+const int PATTERN_DIR[8] = {
+    - SG_NS - SG_WE, - SG_NS, - SG_NS + SG_WE, - SG_WE,
+    SG_WE, SG_NS - SG_WE, SG_NS, SG_NS + SG_WE
+};
+
+/** Index of a direction in PATTERN_DIR. */
+int PatternDirIndex(int dir)
+{
+    for (int i = 0; i < 8; ++i)
+        if (PATTERN_DIR[i] == dir)
+            return i;
+    SG_ASSERT(false);
+    return -1;
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -31,6 +50,7 @@ GoUctBoard::GoUctBoard(const GoBoard& bd)
     : m_const(bd.Size())
 {
     m_size = -1;
+    m_patternCodes = true;
     Init(bd);
 }
 
@@ -66,6 +86,15 @@ void GoUctBoard::CheckConsistency() const
             CheckConsistencyBlock(p);
         if (c == SG_EMPTY)
             SG_ASSERT(m_block[p] == 0);
+        if (m_patternCodes && ! InCorner(p))
+        {
+            if (Line(p) > 1)
+                SG_ASSERT(m_patternCode[p]
+                          == GoPattern3x3::CodeOf8Neighbors(*this, p));
+            else
+                SG_ASSERT(m_patternCode[p]
+                          == GoPattern3x3::CodeOfEdgeNeighbors(*this, p));
+        }
     }
 }
 
@@ -104,6 +133,12 @@ void GoUctBoard::CheckConsistencyBlock(SgPoint point) const
     SG_ASSERT(stones.SameElements(block->m_stones));
     SG_ASSERT(liberties.SameElements(block->m_liberties));
     SG_ASSERT(stones.Length() == NumStones(point));
+    const int nuLibs = liberties.Length();
+    SG_DEBUG_ONLY(nuLibs);
+    SG_ASSERT(block->m_lowLibs == (nuLibs <= 2 ? nuLibs : 0));
+    SG_ASSERT(block->m_lowLibs == 0
+              || m_lowLibBlocks[block->m_lowLibs - 1][color]
+                                [block->m_lowLibIndex] == block);
 }
 
 void GoUctBoard::AddLibToAdjBlocks(SgPoint p, SgBlackWhite c)
@@ -117,16 +152,26 @@ void GoUctBoard::AddLibToAdjBlocks(SgPoint p, SgBlackWhite c)
     {
         m_marker2.Include(b->m_anchor);
         b->m_liberties.PushBack(p);
+        UpdateLowLibBlocks(b);
     }
     if (m_color[p + SG_NS] == c && (b = m_block[p + SG_NS]) != 0
         && m_marker2.NewMark(b->m_anchor))
+    {
         b->m_liberties.PushBack(p);
+        UpdateLowLibBlocks(b);
+    }
     if (m_color[p - SG_WE] == c && (b = m_block[p - SG_WE]) != 0
         && m_marker2.NewMark(b->m_anchor))
+    {
         b->m_liberties.PushBack(p);
+        UpdateLowLibBlocks(b);
+    }
     if (m_color[p + SG_WE] == c && (b = m_block[p + SG_WE]) != 0
         && ! m_marker2.Contains(b->m_anchor))
+    {
         b->m_liberties.PushBack(p);
+        UpdateLowLibBlocks(b);
+    }
 }
 
 void GoUctBoard::AddStoneToBlock(SgPoint p, Block* block)
@@ -143,6 +188,7 @@ void GoUctBoard::AddStoneToBlock(SgPoint p, Block* block)
     if (IsEmpty(p + SG_NS) && ! IsAdjacentTo(p + SG_NS, block))
         block->m_liberties.PushBack(p + SG_NS);
     m_block[p] = block;
+    UpdateLowLibBlocks(block);
 }
 
 void GoUctBoard::CreateSingleStoneBlock(SgPoint p, SgBlackWhite c)
@@ -161,6 +207,40 @@ void GoUctBoard::CreateSingleStoneBlock(SgPoint p, SgBlackWhite c)
     if (IsEmpty(p + SG_NS))
         block.m_liberties.PushBack(p + SG_NS);
     m_block[p] = &block;
+    UpdateLowLibBlocks(&block);
+}
+
+void GoUctBoard::RemoveLowLibBlock(Block* block)
+{
+    SG_ASSERT(block->m_lowLibs == 1 || block->m_lowLibs == 2);
+    BlockList& list = m_lowLibBlocks[block->m_lowLibs - 1][block->m_color];
+    const int index = block->m_lowLibIndex;
+    SG_ASSERT(list[index] == block);
+    Block* last = list.Last();
+    list[index] = last;
+    last->m_lowLibIndex = index;
+    list.PopBack();
+    block->m_lowLibs = 0;
+}
+
+/** Move a block to the list of m_lowLibBlocks for its current number of
+    liberties, or remove it, if it has more than two liberties.
+    Must be called whenever the number of liberties of a block changed. */
+inline void GoUctBoard::UpdateLowLibBlocks(Block* block)
+{
+    const int nuLibs = block->m_liberties.Length();
+    const int lowLibs = (nuLibs <= 2 ? nuLibs : 0);
+    if (lowLibs == block->m_lowLibs)
+        return;
+    if (block->m_lowLibs != 0)
+        RemoveLowLibBlock(block);
+    if (lowLibs != 0)
+    {
+        BlockList& list = m_lowLibBlocks[lowLibs - 1][block->m_color];
+        block->m_lowLibs = lowLibs;
+        block->m_lowLibIndex = list.Length();
+        list.PushBack(block);
+    }
 }
 
 bool GoUctBoard::IsAdjacentTo(SgPoint p,
@@ -207,6 +287,8 @@ void GoUctBoard::MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks)
         for (Block::LibertyIterator lib(adjBlock->m_liberties); lib; ++lib)
             if (m_marker.NewMark(*lib))
                 largestBlock->m_liberties.PushBack(*lib);
+        if (adjBlock->m_lowLibs != 0)
+            RemoveLowLibBlock(adjBlock);
     }
     m_block[p] = largestBlock;
     if (IsEmpty(p - SG_NS) && m_marker.NewMark(p - SG_NS))
@@ -217,6 +299,7 @@ void GoUctBoard::MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks)
         largestBlock->m_liberties.PushBack(p + SG_WE);
     if (IsEmpty(p + SG_NS) && m_marker.NewMark(p + SG_NS))
         largestBlock->m_liberties.PushBack(p + SG_NS);
+    UpdateLowLibBlocks(largestBlock);
 }
 
 void GoUctBoard::UpdateBlocksAfterAddStone(SgPoint p, SgBlackWhite c,
@@ -236,6 +319,15 @@ void GoUctBoard::UpdateBlocksAfterAddStone(SgPoint p, SgBlackWhite c,
     }
 }
 
+/** Update the pattern codes of the neighbors of a point after its color
+    changed by delta. */
+inline void GoUctBoard::UpdatePatternCodes(SgPoint p, int delta)
+{
+    const boost::array<int,8>& weight = m_patternWeight[p];
+    for (int i = 0; i < 8; ++i)
+        m_patternCode[p + PATTERN_DIR[i]] += delta * weight[i];
+}
+
 void GoUctBoard::Init(const GoBoard& bd)
 {
     if (bd.Size() != m_size)
@@ -246,6 +338,11 @@ void GoUctBoard::Init(const GoBoard& bd)
     m_lastMove = bd.GetLastMove();
     m_secondLastMove = bd.Get2ndLastMove();
     m_toPlay = bd.ToPlay();
+    for (int i = 0; i < 2; ++i)
+    {
+        m_lowLibBlocks[i][SG_BLACK].Clear();
+        m_lowLibBlocks[i][SG_WHITE].Clear();
+    }
     for (GoBoard::Iterator it(bd); it; ++it)
     {
         const SgPoint p = *it;
@@ -268,11 +365,125 @@ void GoUctBoard::Init(const GoBoard& bd)
             }
             for (GoBoard::LibertyIterator it2(bd, p); it2; ++it2)
                 block.m_liberties.PushBack(*it2);
+            UpdateLowLibBlocks(&block);
         }
     }
+    if (m_patternCodes)
+        InitPatternCodes();
     CheckConsistency();
 }
 
+void GoUctBoard::TakeSnapshot()
+{
+    if (! m_snapshot)
+        m_snapshot.reset(new Snapshot());
+    Snapshot& s = *m_snapshot;
+    s.m_size = m_size;
+    s.m_lastMove = m_lastMove;
+    s.m_secondLastMove = m_secondLastMove;
+    s.m_koPoint = m_koPoint;
+    s.m_toPlay = m_toPlay;
+    s.m_prisoners = m_prisoners;
+    s.m_block = m_block;
+    s.m_color = m_color;
+    s.m_nuNeighborsEmpty = m_nuNeighborsEmpty;
+    s.m_nuNeighbors = m_nuNeighbors;
+    s.m_patternCodes = m_patternCodes;
+    if (m_patternCodes)
+        s.m_patternCode = m_patternCode;
+    s.m_capturedStones = m_capturedStones;
+    s.m_lowLibBlocks = m_lowLibBlocks;
+    s.m_usedBlocks.Clear();
+    for (Iterator it(*this); it; ++it)
+    {
+        const Block* block = m_block[*it];
+        if (block != 0 && block->m_anchor == *it)
+        {
+            const int index = static_cast<int>(block - &m_blockArray[0]);
+            s.m_usedBlocks.PushBack(index);
+            s.m_blockArray[index] = *block;
+        }
+    }
+}
+
+void GoUctBoard::RestoreSnapshot()
+{
+    SG_ASSERT(m_snapshot);
+    const Snapshot& s = *m_snapshot;
+    SG_ASSERT(s.m_size == m_size);
+    m_lastMove = s.m_lastMove;
+    m_secondLastMove = s.m_secondLastMove;
+    m_koPoint = s.m_koPoint;
+    m_toPlay = s.m_toPlay;
+    m_prisoners = s.m_prisoners;
+    m_block = s.m_block;
+    m_color = s.m_color;
+    m_nuNeighborsEmpty = s.m_nuNeighborsEmpty;
+    m_nuNeighbors = s.m_nuNeighbors;
+    m_capturedStones = s.m_capturedStones;
+    m_lowLibBlocks = s.m_lowLibBlocks;
+    for (SgArrayList<int,SG_MAX_ONBOARD>::Iterator it(s.m_usedBlocks); it;
+         ++it)
+        m_blockArray[*it] = s.m_blockArray[*it];
+    if (m_patternCodes)
+    {
+        // Pattern codes may have been enabled after the snapshot was taken
+        if (s.m_patternCodes)
+            m_patternCode = s.m_patternCode;
+        else
+            InitPatternCodes();
+    }
+    CheckConsistency();
+}
+
+/** Compute the pattern codes of the current position.
+    Starts with the codes of the empty board and adds the stones. */
+void GoUctBoard::InitPatternCodes()
+{
+    m_patternCode = m_emptyPatternCode;
+    for (Iterator it(*this); it; ++it)
+        if (m_color[*it] != SG_EMPTY)
+            UpdatePatternCodes(*it, m_color[*it] - SG_EMPTY);
+}
+
+void GoUctBoard::InitPatternWeights()
+{
+    for (SgPoint p = 0; p < SG_MAXPOINT; ++p)
+    {
+        m_patternWeight[p].assign(0);
+        m_emptyPatternCode[p] = 0;
+    }
+    for (Iterator it(*this); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (Line(p) > 1)
+        {
+            int weight = GoPattern3x3::POWER3_8;
+            for (int i = 0; i < 8; ++i)
+            {
+                weight /= 3;
+                m_patternWeight[p + PATTERN_DIR[i]][7 - i] = weight;
+            }
+            // All digits are SG_EMPTY (2)
+            m_emptyPatternCode[p] = GoPattern3x3::POWER3_8 - 1;
+        }
+        else if (Pos(p) > 1)
+        {
+            const int up = Up(p);
+            const int other = GoPatternBase::OtherDir(up);
+            const int dir[5] = { other, up + other, up, up - other, - other };
+            int weight = GoPattern3x3::POWER3_5;
+            for (int i = 0; i < 5; ++i)
+            {
+                weight /= 3;
+                m_patternWeight[p + dir[i]][PatternDirIndex(- dir[i])] =
+                    weight;
+            }
+            m_emptyPatternCode[p] = GoPattern3x3::POWER3_5 - 1;
+        }
+    }
+}
+
 void GoUctBoard::InitSize(const GoBoard& bd)
 {
     m_size = bd.Size();
@@ -291,6 +502,7 @@ void GoUctBoard::InitSize(const GoBoard& bd)
             m_isBorder[p] = false;
     }
     m_const.ChangeSize(m_size);
+    InitPatternWeights();
 }
 
 void GoUctBoard::NeighborBlocks(SgPoint p, SgBlackWhite c,
@@ -329,6 +541,8 @@ void GoUctBoard::AddStone(SgPoint p, SgBlackWhite c)
     ++nuNeighbors[p - SG_WE];
     ++nuNeighbors[p + SG_WE];
     ++nuNeighbors[p + SG_NS];
+    if (m_patternCodes)
+        UpdatePatternCodes(p, c - SG_EMPTY);
 }
 
 /** Remove liberty from adjacent blocks and kill opponent blocks without
@@ -349,6 +563,8 @@ void GoUctBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
         {
             if (b->m_liberties.Length() == 0)
                 KillBlock(b);
+            else
+                UpdateLowLibBlocks(b);
         }
         else
             ownAdjBlocks.PushBack(b);
@@ -360,6 +576,8 @@ void GoUctBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
         {
             if (b->m_liberties.Length() == 0)
                 KillBlock(b);
+            else
+                UpdateLowLibBlocks(b);
         }
         else
             ownAdjBlocks.PushBack(b);
@@ -371,6 +589,8 @@ void GoUctBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
         {
             if (b->m_liberties.Length() == 0)
                 KillBlock(b);
+            else
+                UpdateLowLibBlocks(b);
         }
         else
             ownAdjBlocks.PushBack(b);
@@ -382,13 +602,15 @@ void GoUctBoard::RemoveLibAndKill(SgPoint p, SgBlackWhite opp,
         {
             if (b->m_liberties.Length() == 0)
                 KillBlock(b);
+            else
+                UpdateLowLibBlocks(b);
         }
         else
             ownAdjBlocks.PushBack(b);
     }
 }
 
-void GoUctBoard::KillBlock(const Block* block)
+void GoUctBoard::KillBlock(Block* block)
 {
     SgBlackWhite c = block->m_color;
     SgBlackWhite opp = SgOppBW(c);
@@ -406,6 +628,8 @@ void GoUctBoard::KillBlock(const Block* block)
         --nuNeighbors[p - SG_WE];
         --nuNeighbors[p + SG_WE];
         --nuNeighbors[p + SG_NS];
+        if (m_patternCodes)
+            UpdatePatternCodes(p, SG_EMPTY - c);
         m_capturedStones.PushBack(p);
         m_block[p] = 0;
     }
@@ -415,6 +639,15 @@ void GoUctBoard::KillBlock(const Block* block)
         // Remember that single stone was captured, check conditions on
         // capturing block later
         m_koPoint = block->m_anchor;
+    if (block->m_lowLibs != 0)
+        RemoveLowLibBlock(block);
+}
+
+void GoUctBoard::SetPatternCodes(bool enable)
+{
+    if (enable && ! m_patternCodes)
+        InitPatternCodes();
+    m_patternCodes = enable;
 }
 
 void GoUctBoard::Play(SgPoint p)
@@ -9,6 +9,8 @@
 #include <bitset>
 #include <cstring>
 #include <stdint.h>
+#include <boost/array.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/static_assert.hpp>
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
@@ -64,6 +66,19 @@ public:
     /** Re-initializes the board from GoBoard position. */
     void Init(const GoBoard& bd);
 
+    /** Remember the current position for a fast reset with
+        RestoreSnapshot().
+        Converting a GoBoard position with Init() iterates over the whole
+        board and rebuilds all blocks; restoring a snapshot is a copy of the
+        flat point arrays and of the blocks on the board. The memory for the
+        snapshot is allocated by the first call. */
+    void TakeSnapshot();
+
+    /** Restore the position of the last TakeSnapshot().
+        Can be used multiple times for the same snapshot. The board size must
+        not have changed since the snapshot was taken. */
+    void RestoreSnapshot();
+
     /** Return the size of this board. */
     SgGrid Size() const;
 
@@ -267,10 +282,55 @@ public:
         ignoring any possible repetition. */
     bool CanCapture(SgPoint p, SgBlackWhite c) const;
 
+    /** @name Blocks with few liberties
+        The blocks with one and two liberties are kept in a list per color
+        and number of liberties, which is updated in Play() whenever the
+        number of liberties of a block changes. Heuristics in the playouts
+        can look up these blocks instead of scanning the board. The order of
+        the blocks in a list is undefined. */
+    //@{
+
+    /** Number of blocks of a color with exactly nuLib liberties.
+        Requires: nuLib == 1 || nuLib == 2 */
+    int NumLowLibBlocks(SgBlackWhite c, int nuLib) const;
+
+    /** Anchor of the i'th block of a color with exactly nuLib liberties.
+        Requires: 0 <= i < NumLowLibBlocks(c, nuLib) */
+    SgPoint LowLibBlock(SgBlackWhite c, int nuLib, int i) const;
+
+    //@}
+
     /** Checks whether all the board data structures are in a consistent
         state. */
     void CheckConsistency() const;
 
+    /** @name Incremental 3x3 pattern codes
+        The codes are the same as the ones computed by
+        GoPattern3x3::CodeOf8Neighbors() and
+        GoPattern3x3::CodeOfEdgeNeighbors(), but they are updated whenever
+        Play() changes the color of a point, such that matching a 3x3 pattern
+        in the playouts needs only a single array lookup. */
+    //@{
+
+    /** Whether the pattern codes are maintained.
+        Default is true. */
+    bool PatternCodes() const;
+
+    /** Enable or disable the pattern codes.
+        Disabling saves the update cost in Play() if no patterns are used.
+        Enabling recomputes the codes for the current position. */
+    void SetPatternCodes(bool enable);
+
+    /** Code of the 8 neighbors of a point not on the first line.
+        Requires: PatternCodes() and Line(p) > 1 */
+    int CodeOf8Neighbors(SgPoint p) const;
+
+    /** Code of the 5 neighbors of a point on the edge but not in a corner.
+        Requires: PatternCodes(), Line(p) == 1 and Pos(p) > 1 */
+    int CodeOfEdgeNeighbors(SgPoint p) const;
+
+    //@}
+
 private:
     /** Data related to a block of stones on the board. */
     struct Block
@@ -294,6 +354,13 @@ private:
 
         GoPointList m_stones;
 
+        /** Number of liberties if the block is in one of the lists of
+            m_lowLibBlocks, 0 otherwise. */
+        int m_lowLibs;
+
+        /** Index of the block in its list in m_lowLibBlocks. */
+        int m_lowLibIndex;
+
         void InitSingleStoneBlock(SgBlackWhite c, SgPoint anchor)
         {
             SG_ASSERT_BW(c);
@@ -301,6 +368,7 @@ private:
             m_anchor = anchor;
             m_stones.SetTo(anchor);
             m_liberties.Clear();
+            m_lowLibs = 0;
         }
 
         void InitNewBlock(SgBlackWhite c, SgPoint anchor)
@@ -310,9 +378,12 @@ private:
             m_anchor = anchor;
             m_stones.Clear();
             m_liberties.Clear();
+            m_lowLibs = 0;
         }
     };
 
+    typedef SgArrayList<Block*,SG_MAX_ONBOARD> BlockList;
+
     SgPoint m_lastMove;
 
     SgPoint m_secondLastMove;
@@ -345,6 +416,11 @@ private:
 
     SgPointArray<Block> m_blockArray;
 
+    /** Blocks with one and two liberties.
+        Indexed by the number of liberties minus one and the color.
+        See NumLowLibBlocks() */
+    SgArray<SgBWArray<BlockList>,2> m_lowLibBlocks;
+
     mutable SgMarker m_marker;
 
     SgMarker m_marker2;
@@ -353,6 +429,71 @@ private:
 
     SgArray<bool,SG_MAXPOINT> m_isBorder;
 
+    /** See PatternCodes() */
+    bool m_patternCodes;
+
+    /** 3x3 pattern code of each point.
+        The 8-neighbor code for points with Line(p) > 1, the edge code for
+        edge points with Pos(p) > 1, undefined for corners and border
+        points. */
+    SgArray<int,SG_MAXPOINT> m_patternCode;
+
+    /** Pattern codes of the empty board. */
+    SgArray<int,SG_MAXPOINT> m_emptyPatternCode;
+
+    /** Weight of a point in the pattern codes of its 8 neighbors.
+        Indexed by the point and the direction from the point to the
+        neighbor, in the order of the digits of
+        GoPattern3x3::CodeOf8Neighbors(). If the color of a point changes by
+        delta, the code of the neighbor in direction i changes by
+        delta * m_patternWeight[p][i]. The weight is 0 for neighbors without
+        a pattern code (border and corner points). */
+    SgArray<boost::array<int,8>,SG_MAXPOINT> m_patternWeight;
+
+    /** Position saved by TakeSnapshot().
+        The blocks are stored at the same index as in m_blockArray, such that
+        the block pointers in m_block stay valid after a restore. Only the
+        blocks on the board are copied, the content of free blocks is
+        irrelevant. */
+    struct Snapshot
+    {
+        SgGrid m_size;
+
+        SgPoint m_lastMove;
+
+        SgPoint m_secondLastMove;
+
+        SgPoint m_koPoint;
+
+        SgBlackWhite m_toPlay;
+
+        SgBWArray<int> m_prisoners;
+
+        SgArray<Block*,SG_MAXPOINT> m_block;
+
+        SgArray<int,SG_MAXPOINT> m_color;
+
+        SgArray<int,SG_MAXPOINT> m_nuNeighborsEmpty;
+
+        SgBWArray<SgArray<int,SG_MAXPOINT> > m_nuNeighbors;
+
+        /** Whether m_patternCode was saved. */
+        bool m_patternCodes;
+
+        SgArray<int,SG_MAXPOINT> m_patternCode;
+
+        GoPointList m_capturedStones;
+
+        SgArray<SgBWArray<BlockList>,2> m_lowLibBlocks;
+
+        /** Indices in m_blockArray of the blocks on the board. */
+        SgArrayList<int,SG_MAX_ONBOARD> m_usedBlocks;
+
+        SgPointArray<Block> m_blockArray;
+    };
+
+    boost::scoped_ptr<Snapshot> m_snapshot;
+
     /** Not implemented. */
     GoUctBoard(const GoUctBoard&);
 
@@ -365,8 +506,18 @@ private:
 
     void CreateSingleStoneBlock(SgPoint p, SgBlackWhite c);
 
+    void RemoveLowLibBlock(Block* block);
+
+    void UpdateLowLibBlocks(Block* block);
+
     void InitSize(const GoBoard& bd);
 
+    void InitPatternCodes();
+
+    void InitPatternWeights();
+
+    void UpdatePatternCodes(SgPoint p, int delta);
+
     bool IsAdjacentTo(SgPoint p, const Block* block) const;
 
     void MergeBlocks(SgPoint p, const SgArrayList<Block*,4>& adjBlocks);
@@ -383,7 +534,7 @@ private:
 
     void AddStone(SgPoint p, SgBlackWhite c);
 
-    void KillBlock(const Block* block);
+    void KillBlock(Block* block);
 
     bool HasLiberties(SgPoint p) const;
 
@@ -601,6 +752,21 @@ inline bool GoUctBoard::CapturingMove() const
     return ! m_capturedStones.IsEmpty();
 }
 
+inline int GoUctBoard::CodeOf8Neighbors(SgPoint p) const
+{
+    SG_ASSERT(m_patternCodes);
+    SG_ASSERT(Line(p) > 1);
+    return m_patternCode[p];
+}
+
+inline int GoUctBoard::CodeOfEdgeNeighbors(SgPoint p) const
+{
+    SG_ASSERT(m_patternCodes);
+    SG_ASSERT(Line(p) == 1);
+    SG_ASSERT(Pos(p) > 1);
+    return m_patternCode[p];
+}
+
 inline int GoUctBoard::FirstBoardPoint() const
 {
     return m_const.FirstBoardPoint();
@@ -783,6 +949,13 @@ inline SgGrid GoUctBoard::Line(SgPoint p) const
     return m_const.Line(p);
 }
 
+inline SgPoint GoUctBoard::LowLibBlock(SgBlackWhite c, int nuLib,
+                                       int i) const
+{
+    SG_ASSERT(nuLib == 1 || nuLib == 2);
+    return m_lowLibBlocks[nuLib - 1][c][i]->m_anchor;
+}
+
 inline void GoUctBoard::NeighborBlocks(SgPoint p, SgBlackWhite c, int maxLib,
                                        SgPoint anchors[]) const
 {
@@ -855,6 +1028,12 @@ inline int GoUctBoard::NumLiberties(SgPoint p) const
     return m_block[p]->m_liberties.Length();
 }
 
+inline int GoUctBoard::NumLowLibBlocks(SgBlackWhite c, int nuLib) const
+{
+    SG_ASSERT(nuLib == 1 || nuLib == 2);
+    return m_lowLibBlocks[nuLib - 1][c].Length();
+}
+
 inline int GoUctBoard::NumNeighbors(SgPoint p, SgBlackWhite c) const
 {
     return m_nuNeighbors[c][p];
@@ -887,6 +1066,11 @@ inline SgBlackWhite GoUctBoard::Opponent() const
     return SgOppBW(m_toPlay);
 }
 
+inline bool GoUctBoard::PatternCodes() const
+{
+    return m_patternCodes;
+}
+
 inline SgGrid GoUctBoard::Pos(SgPoint p) const
 {
     return m_const.Pos(p);
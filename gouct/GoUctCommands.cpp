@@ -11,7 +11,7 @@
 #include "GoGame.h"
 #include "GoGtpCommandUtil.h"
 #include "GoBoardUtil.h"
-#include "GoSafetySolver.h"
+#include "GoSafetyCache.h"
 #include "GoUctDefaultPriorKnowledge.h"
 #include "GoUctDefaultMoveFilter.h"
 #include "GoUctEstimatorStat.h"
@@ -19,6 +19,7 @@
 #include "GoUctLadderKnowledge.h"
 #include "GoUctPatterns.h"
 #include "GoUctPlayer.h"
+#include "GoUctPlayoutEvaluator.h"
 #include "GoUctPlayoutPolicy.h"
 #include "GoUctUtil.h"
 #include "GoUtil.h"
@@ -26,6 +27,7 @@
 #include "SgGtpUtil.h"
 #include "SgPointSetUtil.h"
 #include "SgRestorer.h"
+#include "SgTime.h"
 #include "SgUctTreeUtil.h"
 #include "SgWrite.h"
 
@@ -51,6 +53,7 @@ bool IsBlockedInDeterministicMode(const string& name)
     	|| name == "reuse_subtree"
         || name == "number_threads"
         || name == "max_nodes"
+        || name == "async_knowledge_threads"
         ;
 }
 
@@ -312,6 +315,7 @@ void GoUctCommands::AddGoGuiAnalyzeCommands(GtpCommand& cmd)
         "none/IsPolicyMove/is_policy_move\n"
         "gfx/Uct Ladder Knowledge/uct_ladder_knowledge\n"
         "none/Uct Max Memory/uct_max_memory %s\n"
+        "none/Uct Memory Mode/uct_memory_mode %s\n"
         "plist/Uct Moves/uct_moves\n"
         "none/Uct Node Info/uct_node_info\n"
         "param/Uct Param GlobalSearch/uct_param_globalsearch\n"
@@ -438,6 +442,42 @@ void GoUctCommands::CmdEstimatorStat(GtpCommand& cmd)
                                 stepSize, fileName);
 }
 
+/** Evaluate a file of positions with playouts only.
+    Uses GoUctPlayoutEvaluator with the playout policy parameters of the
+    player (see CmdParamPolicy()) and the number of threads of the search.
+    No search tree is built. The input and output files can be named pipes
+    for streaming the positions and results.
+    Arguments: input file, output file, number of playouts per position <br>
+    Returns: number of positions evaluated and the time in seconds
+    @see GoUctPlayoutEvaluator::EvaluateStream() */
+void GoUctCommands::CmdEvaluatePositions(GtpCommand& cmd)
+{
+    cmd.CheckNuArg(3);
+    string inFileName = cmd.Arg(0);
+    string outFileName = cmd.Arg(1);
+    size_t nuPlayouts = cmd.ArgMin<size_t>(2, 1);
+    std::ifstream in(inFileName.c_str());
+    if (! in)
+        throw GtpFailure() << "could not open " << inFileName;
+    std::ofstream out(outFileName.c_str());
+    if (! out)
+        throw GtpFailure() << "could not create " << outFileName;
+    GoUctPlayoutEvaluator evaluator(Player().m_playoutPolicyParam,
+                                    int(Search().NumberThreads()));
+    double startTime = SgTime::Get(SG_TIME_REAL);
+    size_t nuPositions;
+    try
+    {
+        nuPositions = evaluator.EvaluateStream(in, out, nuPlayouts);
+    }
+    catch (const SgException& e)
+    {
+        throw GtpFailure(e.what());
+    }
+    cmd << nuPositions << ' ' << std::fixed << std::setprecision(2)
+        << SgTime::Get(SG_TIME_REAL) - startTime;
+}
+
 /** Return final score.
     Does a small search and uses the territory statistics to determine the
     status of blocks. */
@@ -544,6 +584,19 @@ void GoUctCommands::CmdMaxMemory(GtpCommand& cmd)
     }
 }
 
+/** Get or set how the search trees allocate their memory.
+    Clears the search trees, if the mode is set.
+    Arguments: @c default|huge_pages|hugetlb (optional)
+    @see SgUctSearch::MemoryMode() */
+void GoUctCommands::CmdMemoryMode(GtpCommand& cmd)
+{
+    cmd.CheckNuArgLessEqual(1);
+    if (cmd.NuArg() == 0)
+        cmd << SgGtpUtil::MemoryModeToString(Search().MemoryMode());
+    else
+        Search().SetMemoryMode(SgGtpUtil::MemoryModeArg(cmd, 0));
+}
+
 /** Return a list of all moves that the search would generate in the current
     position.
     Arguments: none
@@ -765,8 +818,14 @@ void GoUctCommands::CmdParamPlayer(GtpCommand& cmd)
         See GoUctPlayoutPolicyParam::m_statisticsEnabled
     @arg @c nakade_heuristic
         See GoUctPlayoutPolicyParam::m_useNakadeHeuristic
+    @arg @c skip_rare_heuristics
+        See GoUctPlayoutPolicyParam::m_skipRareHeuristics
+    @arg @c skip_hit_rate
+        See GoUctPlayoutPolicyParam::m_skipHitRate
     @arg @c fillboard_tries
-        See GoUctPlayoutPolicyParam::m_fillboardTries */
+        See GoUctPlayoutPolicyParam::m_fillboardTries
+    @arg @c use_global_gamma_playout
+        See GoUctPlayoutPolicyParam::m_useGlobalGammaPlayout */
 void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
 {
     cmd.CheckNuArgLessEqual(2);
@@ -776,7 +835,11 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
         // Boolean parameters first for better layout of GoGui parameter
         // dialog, alphabetically otherwise
         cmd << "[bool] nakade_heuristic " << p.m_useNakadeHeuristic << '\n'
+            << "[bool] skip_rare_heuristics " << p.m_skipRareHeuristics
+            << '\n'
             << "[bool] statistics_enabled " << p.m_statisticsEnabled << '\n'
+            << "[bool] use_global_gamma_playout "
+            << p.m_useGlobalGammaPlayout << '\n'
             << "[bool] use_patterns_in_playout " 
             << p.m_usePatternsInPlayout << '\n'
             << "[bool] use_patterns_in_prior_knowledge " 
@@ -789,6 +852,7 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
             << CombinationTypeToString(p.m_combinationType) << '\n'
             << "[float] pattern_gamma_threshold "
             << p.m_patternGammaThreshold << '\n'
+            << "[float] skip_hit_rate " << p.m_skipHitRate << '\n'
             ;
     }
     else if (cmd.NuArg() == 2)
@@ -796,8 +860,12 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
         string name = cmd.Arg(0);
         if (name == "nakade_heuristic")
             p.m_useNakadeHeuristic = cmd.Arg<bool>(1);
+        else if (name == "skip_rare_heuristics")
+            p.m_skipRareHeuristics = cmd.Arg<bool>(1);
         else if (name == "statistics_enabled")
             p.m_statisticsEnabled = cmd.Arg<bool>(1);
+        else if (name == "use_global_gamma_playout")
+            p.m_useGlobalGammaPlayout = cmd.Arg<bool>(1);
         else if (name == "use_patterns_in_playout")
             p.m_usePatternsInPlayout = cmd.Arg<bool>(1);
         else if (name == "use_patterns_in_prior_knowledge")
@@ -816,6 +884,8 @@ void GoUctCommands::CmdParamPolicy(GtpCommand& cmd)
         }
         else if (name == "pattern_gamma_threshold")
             p.m_patternGammaThreshold = cmd.Arg<float>(1);
+        else if (name == "skip_hit_rate")
+            p.m_skipHitRate = cmd.ArgMinMax<float>(1, 0.f, 1.f);
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
@@ -917,8 +987,12 @@ void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
     @arg @c lock_free See SgUctSearch::LockFree
     @arg @c log_games See SgUctSearch::LogGames
     @arg @c prune_full_tree See SgUctSearch::PruneFullTree
+    @arg @c prune_in_place See SgUctSearch::PruneInPlace
+    @arg @c profile_phases See SgUctSearch::ProfilePhases
+    @arg @c transpositions See SgUctSearch::Transpositions
     @arg @c rave See SgUctSearch::Rave
     @arg @c weight_rave_updates SgUctSearch::WeightRaveUpdates
+    @arg @c async_knowledge_threads See SgUctSearch::AsyncKnowledgeThreads
     @arg @c bias_term_constant See SgUctSearch::BiasTermConstant
     @arg @c bias_term_frequency See SgUctSearch::BiasTermFrequency
     @arg @c expand_threshold See SgUctSearch::ExpandThreshold
@@ -926,6 +1000,7 @@ void GoUctCommands::CmdParamTreeFilter(GtpCommand& cmd)
     @arg @c knowledge_threshold See SgUctSearch::KnowledgeThreshold
     @arg @c live_gfx @c none|counts|sequence See GoUctSearch::LiveGfx
     @arg @c live_gfx_interval See GoUctSearch::LiveGfxInterval
+    @arg @c max_knowledge_requests See SgUctSearch::MaxKnowledgeRequests
     @arg @c max_nodes See SgUctSearch::MaxNodes
     @arg @c move_select @c value|count|bound|rave See SgUctSearch::MoveSelect
     @arg @c number_threads See SgUctSearch::NumberThreads
@@ -947,13 +1022,18 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             << "[bool] lock_free " << s.LockFree() << '\n'
             << "[bool] log_games " << s.LogGames() << '\n'
             << "[bool] prune_full_tree " << s.PruneFullTree() << '\n'
+            << "[bool] profile_phases " << s.ProfilePhases() << '\n'
+            << "[bool] prune_in_place " << s.PruneInPlace() << '\n'
             << "[bool] rave " << s.Rave() << '\n'
+            << "[bool] transpositions " << s.Transpositions() << '\n'
             << "[bool] update_multiple_playouts_as_single " 
             << s.UpdateMultiplePlayoutsAsSingle() << '\n'
             << "[bool] virtual_loss " << s.VirtualLoss() << '\n'
             << "[bool] weight_rave_updates " << s.WeightRaveUpdates() << '\n'
             << "[string] additive_predictor_decay "
             << s.AdditiveKnowledge().PredictorDecay() << '\n'
+            << "[string] async_knowledge_threads "
+            << s.AsyncKnowledgeThreads() << '\n'
             << "[string] bias_term_constant " << s.BiasTermConstant() << '\n'
             << "[string] bias_term_frequency "
             << s.BiasTermFrequency() << '\n'
@@ -962,6 +1042,8 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             << "[string] first_play_urgency " << s.FirstPlayUrgency() << '\n'
             << "[string] knowledge_threshold "
             << KnowledgeThresholdToString(s.KnowledgeThreshold()) << '\n'
+            << "[string] max_knowledge_requests "
+            << s.MaxKnowledgeRequests() << '\n'
             << "[string] max_knowledge_threads " 
             << s.MaxKnowledgeThreads() << '\n'
             << "[list/none/counts/sequence] live_gfx "
@@ -991,6 +1073,8 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
 
         if (name == "additive_predictor_decay")
             s.AdditiveKnowledge().SetPredictorDecay(cmd.Arg<float>(1));
+        else if (name == "async_knowledge_threads")
+            s.SetAsyncKnowledgeThreads(cmd.Arg<unsigned int>(1));
         else if (name == "bias_term_constant")
             s.SetBiasTermConstant(cmd.Arg<float>(1));
         else if (name == "bias_term_frequency")
@@ -1015,6 +1099,8 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             s.SetLockFree(cmd.Arg<bool>(1));
         else if (name == "log_games")
             s.SetLogGames(cmd.Arg<bool>(1));
+        else if (name == "max_knowledge_requests")
+            s.SetMaxKnowledgeRequests(cmd.Arg<size_t>(1));
         else if (name == "max_knowledge_threads")
             s.SetMaxKnowledgeThreads(cmd.Arg<unsigned int>(1));
         else if (name == "max_nodes")
@@ -1027,6 +1113,10 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             s.SetNumberPlayouts(cmd.ArgMin<int>(1, 1));
         else if (name == "prune_full_tree")
             s.SetPruneFullTree(cmd.Arg<bool>(1));
+        else if (name == "profile_phases")
+            s.SetProfilePhases(cmd.Arg<bool>(1));
+        else if (name == "prune_in_place")
+            s.SetPruneInPlace(cmd.Arg<bool>(1));
         else if (name == "prune_min_count")
             s.SetPruneMinCount(cmd.ArgMin<SgUctValue>(1, SgUctValue(1)));
         else if (name == "randomize_rave_frequency")
@@ -1037,6 +1127,8 @@ void GoUctCommands::CmdParamSearch(GtpCommand& cmd)
             s.SetRaveWeightFinal(cmd.Arg<float>(1));
         else if (name == "rave_weight_initial")
             s.SetRaveWeightInitial(cmd.Arg<float>(1));
+        else if (name == "transpositions")
+            s.SetTranspositions(cmd.Arg<bool>(1));
         else if (name == "update_multiple_playouts_as_single")
             s.SetUpdateMultiplePlayoutsAsSingle(cmd.Arg<bool>(1));
         else if (name == "virtual_loss")
@@ -1333,7 +1425,13 @@ void GoUctCommands::CmdStatPolicyClear(GtpCommand& cmd)
 }
 
 /** Write statistics of search and tree.
-    Arguments: none
+    Arguments: none or one of
+    - @c count Count of the root node
+    - @c games_played Number of games played in the last search
+    - @c nodes Number of nodes in the tree
+    - @c phases Cycles spent in the phases of the last search, if enabled
+      with <tt>uct_param_search profile_phases 1</tt>
+      (see SgUctSearchStat::WritePhases())
     @see SgUctSearch::WriteStatistics() */
 void GoUctCommands::CmdStatSearch(GtpCommand& cmd)
 {
@@ -1357,6 +1455,8 @@ void GoUctCommands::CmdStatSearch(GtpCommand& cmd)
             cmd << search.GamesPlayed() << '\n';
         else if (name == "nodes")
             cmd << search.Tree().NuNodes() << '\n';
+        else if (name == "phases")
+            search.Statistics().WritePhases(cmd);
         else
             throw GtpFailure() << "unknown parameter: " << name;
     }
@@ -1577,9 +1677,8 @@ SgPointSet GoUctCommands::DoFinalStatusSearch()
 
     SgPointArray<SgUctStatistics> territoryStatistics =
         ThreadState(0).m_territoryStatistics;
-    GoSafetySolver safetySolver(bd);
     SgBWSet safe;
-    safetySolver.FindSafePoints(&safe);
+    GoSafetyCache::Global().FindSafePoints(bd, &safe);
     for (GoBlockIterator it(bd); it; ++it)
     {
         SgBlackWhite c = bd.GetStone(*it);
@@ -1655,9 +1754,12 @@ void GoUctCommands::Register(GtpEngine& e)
     Register(e, "uct_bounds", &GoUctCommands::CmdBounds);
     Register(e, "uct_default_policy", &GoUctCommands::CmdDefaultPolicy);
     Register(e, "uct_estimator_stat", &GoUctCommands::CmdEstimatorStat);
+    Register(e, "uct_evaluate_positions",
+             &GoUctCommands::CmdEvaluatePositions);
     Register(e, "uct_gfx", &GoUctCommands::CmdGfx);
     Register(e, "uct_ladder_knowledge", &GoUctCommands::CmdLadderKnowledge);
     Register(e, "uct_max_memory", &GoUctCommands::CmdMaxMemory);
+    Register(e, "uct_memory_mode", &GoUctCommands::CmdMemoryMode);
     Register(e, "uct_moves", &GoUctCommands::CmdMoves);
     Register(e, "uct_node_info", &GoUctCommands::CmdNodeInfo);
     Register(e, "uct_param_feature_knowledge",
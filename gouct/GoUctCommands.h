@@ -58,11 +58,13 @@ public:
         - @link CmdDefaultPolicy() @c uct_default_policy @endlink
         - @link CmdDeterministicMode() @c deterministic_mode @endlink
         - @link CmdEstimatorStat() @c uct_estimator_stat @endlink
+        - @link CmdEvaluatePositions() @c uct_evaluate_positions @endlink
         - @link CmdGfx() @c uct_gfx @endlink
         - @link CmdIsPolicyCorrectedMove() @c is_policy_corrected_move
           @endlink
         - @link CmdLadderKnowledge() @c uct_ladder_knowledge @endlink
         - @link CmdMaxMemory() @c uct_max_memory @endlink
+        - @link CmdMemoryMode() @c uct_memory_mode @endlink
         - @link CmdMoves() @c uct_moves @endlink
         - @link CmdNodeInfo() @c uct_node_info @endlink
         - @link CmdParamGlobalSearch() @c uct_param_globalsearch @endlink
@@ -100,6 +102,7 @@ public:
     void CmdDefaultPolicy(GtpCommand& cmd);
     void CmdDeterministicMode(GtpCommand&);
     void CmdEstimatorStat(GtpCommand& cmd);
+    void CmdEvaluatePositions(GtpCommand& cmd);
     void CmdFinalScore(GtpCommand&);
     void CmdFinalStatusList(GtpCommand&);
     void CmdGfx(GtpCommand& cmd);
@@ -107,6 +110,7 @@ public:
     void CmdIsPolicyMove(GtpCommand& cmd);
     void CmdLadderKnowledge(GtpCommand& cmd);
     void CmdMaxMemory(GtpCommand& cmd);
+    void CmdMemoryMode(GtpCommand& cmd);
     void CmdMoves(GtpCommand& cmd);
     void CmdNodeInfo(GtpCommand& cmd);
     void CmdParamGlobalSearch(GtpCommand& cmd);
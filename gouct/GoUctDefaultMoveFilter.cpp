@@ -6,11 +6,11 @@
 #include "SgSystem.h"
 #include "GoUctDefaultMoveFilter.h"
 
-#include "GoBensonSolver.h"
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
+#include "GoLadderCache.h"
 #include "GoModBoard.h"
-#include "GoSafetySolver.h"
+#include "GoSafetyCache.h"
 #include "SgWrite.h"
 
 //----------------------------------------------------------------------------
@@ -83,7 +83,8 @@ GoUctDefaultMoveFilterParam::GoUctDefaultMoveFilterParam()
 
 GoUctDefaultMoveFilter::GoUctDefaultMoveFilter(const GoBoard& bd, const GoUctDefaultMoveFilterParam &param)
     : m_bd(bd),
-      m_param(param)
+      m_param(param),
+      m_regions(bd)
 { }
 
 std::vector<SgPoint> GoUctDefaultMoveFilter::Get()
@@ -102,15 +103,19 @@ std::vector<SgPoint> GoUctDefaultMoveFilter::Get()
         // will not be pruned. This alternate safety pruning is not going to
         // improve or worsen playing strength, but may cause earlier passes,
         // which is nice in games against humans
-        GoSafetySolver safetySolver(m_bd);
-        safetySolver.FindSafePoints(&alternateSafe);
+        GoSafetyCache& cache = GoSafetyCache::Global();
+        m_regions.UpdateSubscriber();
+        const GoBoard& regionsBd = m_regions.Board();
+        SgBWSet potentialCapture;
+        cache.FindSafePoints(regionsBd, &alternateSafe, &potentialCapture,
+                             &m_regions.Regions());
 
         // Benson solver guarantees that capturing moves of dead blocks are
         // liberties of the dead blocks and that no move in Benson safe territory
         // is a ko threat
-        GoBensonSolver bensonSolver(m_bd);
         SgBWSet unconditionalSafe;
-        bensonSolver.FindSafePoints(&unconditionalSafe);
+        cache.FindBensonSafePoints(regionsBd, &unconditionalSafe,
+                                   &m_regions.Regions());
 
         for (GoBoard::Iterator it(m_bd); it; ++it)
         {
@@ -130,7 +135,7 @@ std::vector<SgPoint> GoUctDefaultMoveFilter::Get()
                    || isUnconditionalSafeOpp
                    || (isUnconditionalSafe && ! hasOppNeighbors)
                    || (  alternateSafe[toPlay].Contains(p)
-                      && ! safetySolver.PotentialCaptureMove(p, toPlay)
+                      && ! potentialCapture[toPlay].Contains(p)
                       )
                    )
                     rootFilter.push_back(p);
@@ -146,8 +151,10 @@ std::vector<SgPoint> GoUctDefaultMoveFilter::Get()
             const SgPoint p = *it;
             if (m_bd.GetStone(p) == toPlay && m_bd.InAtari(p))
             {
-                if (m_ladder.Ladder(m_bd, p, toPlay, &m_ladderSequence,
-                                    false/*twoLibIsEscape*/) < 0)
+                if (GoLadderCache::Global().Ladder(m_bd, p, toPlay,
+                                                   &m_ladderSequence,
+                                                   false/*twoLibIsEscape*/)
+                    < 0)
                 {
                     if (m_ladderSequence.Length() >= m_param.m_minLadderLength)
                         rootFilter.push_back(m_bd.TheLiberty(p));
@@ -170,8 +177,10 @@ std::vector<SgPoint> GoUctDefaultMoveFilter::Get()
                 && m_bd.NumStones(p) >= 5
                 && m_bd.NumLiberties(p) == 2
                 && LibertiesAreDiagonal(m_bd, p)
-                && m_ladder.Ladder(m_bd, p, toPlay, &m_ladderSequence,
-                                    false/*twoLibIsEscape*/) > 0
+                && GoLadderCache::Global().Ladder(m_bd, p, toPlay,
+                                                  &m_ladderSequence,
+                                                  false/*twoLibIsEscape*/)
+                   > 0
                 && m_ladderSequence.Length() >= m_param.m_minLadderLength
                 )
                     rootFilter.push_back(m_ladderSequence[0]);
@@ -5,8 +5,9 @@
 #ifndef GOUCT_DEFAULTROOTFILTER_H
 #define GOUCT_DEFAULTROOTFILTER_H
 
-#include "GoLadder.h"
+#include "GoRegionBoardSynchronizer.h"
 #include "GoUctMoveFilter.h"
+#include "SgVector.h"
 
 class GoBoard;
 
@@ -143,7 +144,9 @@ private:
 
     const GoUctDefaultMoveFilterParam &m_param;
 
-    GoLadder m_ladder;
+    /** Regions of the position for the safety solvers.
+        Updated incrementally between the positions of a game. */
+    GoRegionBoardSynchronizer m_regions;
 
     /** Local variable in Get().
         Reused for efficiency. */
@@ -0,0 +1,205 @@
+//----------------------------------------------------------------------------
+/** @file GoUctGlobalGammaMoveGenerator.h */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_GLOBALGAMMAMOVEGENERATOR_H
+#define GOUCT_GLOBALGAMMAMOVEGENERATOR_H
+
+#include "GoBoard.h"
+#include "GoUctPatterns.h"
+#include "GoUctUtil.h"
+#include "SgBWArray.h"
+#include "SgFenwickTree.h"
+#include "SgRandom.h"
+
+//----------------------------------------------------------------------------
+
+/** Select a move on the whole board with probability proportional to the
+    gamma value of its 3x3 pattern.
+    Unlike GoUctGammaMoveGenerator, which only considers pattern moves near
+    the last two moves, this generator keeps a weight for every empty point
+    and samples from all of them, like the softmax playout policies of
+    pattern-based Monte Carlo programs. The weights are the gamma values of
+    the patterns (usually GoUctPatterns::PATTERN_GLOBAL), or 1 for patterns
+    without a gamma value and for corner points.
+    The weights are stored in a SgFenwickTree per color to play. After a
+    move, only the points whose 3x3 neighborhood changed (the neighbors of
+    the new stone and of the captured stones) are updated, and a move is
+    selected in O(log n), so the cost per move does not grow with the
+    board size.
+    The weights do not depend on whether a move is legal or fills an eye,
+    because this depends on the liberties of adjacent blocks, which can
+    change without a change of the 3x3 pattern. Instead, a selected point is
+    checked with GoUctUtil::GeneratePoint(). Rejected points get weight 0
+    while selecting the move and their weights are restored afterwards. */
+template<class BOARD>
+class GoUctGlobalGammaMoveGenerator
+{
+public:
+    GoUctGlobalGammaMoveGenerator(const BOARD& bd,
+                                  const GoUctPatterns<BOARD>& patterns,
+                                  SgRandom& random);
+
+    /** Compute the weights of all points on the board. */
+    void StartPlayout();
+
+    /** Update the weights after a move.
+        Must be called after each play on the board. */
+    void OnPlay();
+
+    /** Select a move for the color to play.
+        @return A point that fulfills GoUctUtil::GeneratePoint() or
+        SG_NULLMOVE, if there is no such point */
+    SgPoint Generate();
+
+    /** The current weight of a point.
+        0 for points that are not empty. */
+    double Weight(SgPoint p, SgBlackWhite toPlay) const;
+
+    /** Compute the weight of a point in the current position.
+        Weight() is equal to this value for all points after StartPlayout()
+        and OnPlay(). */
+    double ComputeWeight(SgPoint p, SgBlackWhite toPlay) const;
+
+    /** The sum of the weights of all points. */
+    double TotalWeight(SgBlackWhite toPlay) const;
+
+private:
+    typedef SgFenwickTree<SG_MAXPOINT> Tree;
+
+    const BOARD& m_bd;
+
+    const GoUctPatterns<BOARD>& m_patterns;
+
+    SgRandom& m_random;
+
+    SgBWArray<Tree> m_weights;
+
+    /** Number of points with a non-zero weight. */
+    int m_nuPoints;
+
+    /** Points rejected in Generate(). */
+    GoPointList m_rejected;
+
+    void UpdatePoint(SgPoint p);
+
+    /** Update a point and its 8 neighbors. */
+    void Update8Neighborhood(SgPoint p);
+};
+
+template<class BOARD>
+GoUctGlobalGammaMoveGenerator<BOARD>::GoUctGlobalGammaMoveGenerator(
+                                    const BOARD& bd,
+                                    const GoUctPatterns<BOARD>& patterns,
+                                    SgRandom& random)
+    : m_bd(bd),
+      m_patterns(patterns),
+      m_random(random),
+      m_nuPoints(0)
+{ }
+
+template<class BOARD>
+inline double GoUctGlobalGammaMoveGenerator<BOARD>::ComputeWeight(SgPoint p,
+                                                SgBlackWhite toPlay) const
+{
+    if (! m_bd.IsEmpty(p))
+        return 0;
+    const float gamma = m_patterns.GetPatternGamma(m_bd, p, toPlay);
+    return gamma > 0 ? gamma : 1;
+}
+
+template<class BOARD>
+SgPoint GoUctGlobalGammaMoveGenerator<BOARD>::Generate()
+{
+    const SgBlackWhite toPlay = m_bd.ToPlay();
+    Tree& tree = m_weights[toPlay];
+    SG_ASSERT(m_rejected.IsEmpty());
+    SgPoint move = SG_NULLMOVE;
+    // Rejected points are removed from the tree, so there is at least one
+    // point with non-zero weight left as long as this condition holds
+    while (m_rejected.Length() < m_nuPoints)
+    {
+        const SgPoint p =
+            tree.Find(m_random.Float_01() * tree.Total());
+        if (tree.Get(p) == 0) // Rounding error, see SgFenwickTree::Find
+            continue;
+        if (GoUctUtil::GeneratePoint(m_bd, p, toPlay))
+        {
+            move = p;
+            break;
+        }
+        m_rejected.PushBack(p);
+        tree.Set(p, 0);
+    }
+    for (GoPointList::Iterator it(m_rejected); it; ++it)
+        tree.Set(*it, ComputeWeight(*it, toPlay));
+    m_rejected.Clear();
+    return move;
+}
+
+template<class BOARD>
+void GoUctGlobalGammaMoveGenerator<BOARD>::OnPlay()
+{
+    const SgPoint lastMove = m_bd.GetLastMove();
+    if (SgIsSpecialMove(lastMove))
+        return;
+    Update8Neighborhood(lastMove);
+    for (GoPointList::Iterator it(m_bd.CapturedStones()); it; ++it)
+        Update8Neighborhood(*it);
+}
+
+template<class BOARD>
+void GoUctGlobalGammaMoveGenerator<BOARD>::StartPlayout()
+{
+    m_weights[SG_BLACK].Clear();
+    m_weights[SG_WHITE].Clear();
+    m_nuPoints = 0;
+    for (typename BOARD::Iterator it(m_bd); it; ++it)
+        UpdatePoint(*it);
+}
+
+template<class BOARD>
+inline double GoUctGlobalGammaMoveGenerator<BOARD>::TotalWeight(
+                                                SgBlackWhite toPlay) const
+{
+    return m_weights[toPlay].Total();
+}
+
+template<class BOARD>
+inline void GoUctGlobalGammaMoveGenerator<BOARD>::Update8Neighborhood(
+                                                                 SgPoint p)
+{
+    UpdatePoint(p);
+    UpdatePoint(p - SG_NS - SG_WE);
+    UpdatePoint(p - SG_NS);
+    UpdatePoint(p - SG_NS + SG_WE);
+    UpdatePoint(p - SG_WE);
+    UpdatePoint(p + SG_WE);
+    UpdatePoint(p + SG_NS - SG_WE);
+    UpdatePoint(p + SG_NS);
+    UpdatePoint(p + SG_NS + SG_WE);
+}
+
+template<class BOARD>
+inline void GoUctGlobalGammaMoveGenerator<BOARD>::UpdatePoint(SgPoint p)
+{
+    if (m_bd.IsBorder(p))
+        return;
+    const bool wasEmpty = (m_weights[SG_BLACK].Get(p) > 0);
+    const bool isEmpty = m_bd.IsEmpty(p);
+    if (isEmpty != wasEmpty)
+        m_nuPoints += (isEmpty ? 1 : -1);
+    m_weights[SG_BLACK].Set(p, ComputeWeight(p, SG_BLACK));
+    m_weights[SG_WHITE].Set(p, ComputeWeight(p, SG_WHITE));
+}
+
+template<class BOARD>
+inline double GoUctGlobalGammaMoveGenerator<BOARD>::Weight(SgPoint p,
+                                                SgBlackWhite toPlay) const
+{
+    return m_weights[toPlay].Get(p);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_GLOBALGAMMAMOVEGENERATOR_H
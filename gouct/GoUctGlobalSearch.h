@@ -17,7 +17,7 @@
 #include "GoBoardUtil.h"
 #include "GoEyeUtil.h"
 #include "GoRegionBoard.h"
-#include "GoSafetySolver.h"
+#include "GoSafetyCache.h"
 #include "GoAdditiveKnowledge.h"
 #include "GoUctDefaultMoveFilter.h"
 #include "GoUctDefaultPriorKnowledge.h"
@@ -887,8 +887,7 @@ void GoUctGlobalSearch<POLICY,FACTORY>::OnStartSearch()
     if (GOUCT_USE_SAFETY_SOLVER)
     {
         const GoBoard& bd = Board();
-        GoSafetySolver solver(bd, &m_regions);
-        solver.FindSafePoints(&m_safe);
+        GoSafetyCache::Global().FindSafePoints(bd, &m_safe, 0, &m_regions);
         for (GoBoard::Iterator it(bd); it; ++it)
             m_allSafe[*it] = m_safe.OneContains(*it);
     }
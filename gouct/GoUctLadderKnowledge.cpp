@@ -7,14 +7,20 @@
 #include "GoUctLadderKnowledge.h"
 
 #include "GoBoardUtil.h"
+#include "GoLadderCache.h"
 
-using GoLadderUtil::IsLadderCaptureMove;
 using namespace GoUctLadderKnowledgeParameters;
 
 //----------------------------------------------------------------------------
 namespace
 {    
 
+    /** The ladder reader shared with the move filter and the features. */
+    inline GoLadderCache& Ladders()
+    {
+        return GoLadderCache::Global();
+    }
+
     /** Copy into list, in case bd is modified and LibertyIterator can not
         be used directly */
     inline void GetLiberties(const GoBoard& bd, SgPoint block,
@@ -43,7 +49,7 @@ namespace
                 for (SgVectorIterator<SgPoint> it(liberties);  it; ++it)
                 {
                     const SgPoint lib = *it;
-                    if (IsLadderCaptureMove(bd, block, lib))
+                    if (Ladders().IsLadderCaptureMove(bd, block, lib))
                     {
                         ladderCaptureBlocks.PushBack(block);
                         break;
@@ -132,7 +138,7 @@ void GoUctLadderKnowledge::Initialize2LibTacticsLadderMoves()
                 for (SgVectorIterator<SgPoint> it(liberties); it; ++it)
                 {
                     const SgPoint lib = *it;
-                    if (IsLadderCaptureMove(m_bd, oppAnchor, lib))
+                    if (Ladders().IsLadderCaptureMove(m_bd, oppAnchor, lib))
                         good2LibTacticMove.PushBack(lib);
                 }
             }
@@ -156,7 +162,7 @@ void GoUctLadderKnowledge::LadderAttack(SgPoint p)
     GetLiberties(m_bd, p, liberties);
     for (SgVectorIterator<SgPoint> it(liberties); it; ++it)
     {
-        if (IsLadderCaptureMove(m_bd, p, *it)) 
+        if (Ladders().IsLadderCaptureMove(m_bd, p, *it))
             Add(*it, 1.0, LADDER_CAPTURE_BONUS);
     }
 }
@@ -168,7 +174,7 @@ void GoUctLadderKnowledge::LadderDefense(SgPoint p)
     SG_ASSERT(m_bd.InAtari(p));
 
     SgVector<SgPoint> escapeMoves;
-    GoLadderUtil::FindLadderEscapeMoves(m_bd, p, escapeMoves);
+    Ladders().FindLadderEscapeMoves(m_bd, p, escapeMoves);
     if (escapeMoves.IsEmpty()) // Do not try to escape
     {
         if (! MightBeNakadeStones(m_bd, p))
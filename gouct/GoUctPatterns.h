@@ -12,6 +12,8 @@
 #include "GoBoard.h"
 #include "GoBoardUtil.h"
 #include "GoPattern3x3.h"
+#include "GoUctBitBoard.h"
+#include "GoUctBoard.h"
 #include "GoUctGlobalPatternData.h"
 #include "GoUctLocalPatternData.h"
 #include "GoUctPatternData.h"
@@ -69,6 +71,72 @@
     @endverbatim */
 
 //----------------------------------------------------------------------------
+
+/** Pattern codes used by GoUctPatterns.
+    The generic functions compute the codes from the board. The overloads
+    for GoUctBoard and GoUctBitBoard return the codes that the board
+    maintains incrementally (see GoUctBoard::PatternCodes()). */
+namespace GoUctPatternsUtil
+{
+    template<class BOARD>
+    int CodeOf8Neighbors(const BOARD& bd, SgPoint p);
+
+    int CodeOf8Neighbors(const GoUctBoard& bd, SgPoint p);
+
+    int CodeOf8Neighbors(const GoUctBitBoard& bd, SgPoint p);
+
+    template<class BOARD>
+    int CodeOfEdgeNeighbors(const BOARD& bd, SgPoint p);
+
+    int CodeOfEdgeNeighbors(const GoUctBoard& bd, SgPoint p);
+
+    int CodeOfEdgeNeighbors(const GoUctBitBoard& bd, SgPoint p);
+}
+
+template<class BOARD>
+inline int GoUctPatternsUtil::CodeOf8Neighbors(const BOARD& bd, SgPoint p)
+{
+    return GoPattern3x3::CodeOf8Neighbors(bd, p);
+}
+
+inline int GoUctPatternsUtil::CodeOf8Neighbors(const GoUctBoard& bd,
+                                               SgPoint p)
+{
+    if (bd.PatternCodes())
+        return bd.CodeOf8Neighbors(p);
+    return GoPattern3x3::CodeOf8Neighbors(bd, p);
+}
+
+inline int GoUctPatternsUtil::CodeOf8Neighbors(const GoUctBitBoard& bd,
+                                               SgPoint p)
+{
+    if (bd.PatternCodes())
+        return bd.CodeOf8Neighbors(p);
+    return GoPattern3x3::CodeOf8Neighbors(bd, p);
+}
+
+template<class BOARD>
+inline int GoUctPatternsUtil::CodeOfEdgeNeighbors(const BOARD& bd, SgPoint p)
+{
+    return GoPattern3x3::CodeOfEdgeNeighbors(bd, p);
+}
+
+inline int GoUctPatternsUtil::CodeOfEdgeNeighbors(const GoUctBoard& bd,
+                                                  SgPoint p)
+{
+    if (bd.PatternCodes())
+        return bd.CodeOfEdgeNeighbors(p);
+    return GoPattern3x3::CodeOfEdgeNeighbors(bd, p);
+}
+
+inline int GoUctPatternsUtil::CodeOfEdgeNeighbors(const GoUctBitBoard& bd,
+                                                  SgPoint p)
+{
+    if (bd.PatternCodes())
+        return bd.CodeOfEdgeNeighbors(p);
+    return GoPattern3x3::CodeOfEdgeNeighbors(bd, p);
+}
+
 //----------------------------------------------------------------------------
 
 template<class BOARD>
@@ -172,16 +240,15 @@ const
 template<class BOARD>
 inline bool GoUctPatterns<BOARD>::MatchAnyCenter(SgPoint p) const
 {
-    return m_table[m_bd.ToPlay()]
-                  [GoPattern3x3::CodeOf8Neighbors(m_bd, p)].IsPattern();
+    const int code = GoUctPatternsUtil::CodeOf8Neighbors(m_bd, p);
+    return m_table[m_bd.ToPlay()][code].IsPattern();
 }
 
 template<class BOARD>
 inline bool GoUctPatterns<BOARD>::MatchAnyEdge(SgPoint p) const
 {
-    return
-        m_edgeTable[m_bd.ToPlay()]
-                   [GoPattern3x3::CodeOfEdgeNeighbors(m_bd, p)].IsPattern();
+    const int code = GoUctPatternsUtil::CodeOfEdgeNeighbors(m_bd, p);
+    return m_edgeTable[m_bd.ToPlay()][code].IsPattern();
 }
 
 template<class BOARD>
@@ -251,17 +318,16 @@ template<class BOARD>
 inline float GoUctPatterns<BOARD>::
 MatchAnyCenterForGamma(SgPoint p, const SgBlackWhite toPlay) const
 {
-    return m_table[toPlay]
-                  [GoPattern3x3::CodeOf8Neighbors(m_bd, p)].GetGammaValue();
+    const int code = GoUctPatternsUtil::CodeOf8Neighbors(m_bd, p);
+    return m_table[toPlay][code].GetGammaValue();
 }
 
 template<class BOARD>
 inline float GoUctPatterns<BOARD>::
 MatchAnyEdgeForGamma(SgPoint p, const SgBlackWhite toPlay) const
 {
-    return m_edgeTable[toPlay]
-                      [GoPattern3x3::CodeOfEdgeNeighbors(m_bd, p)]
-                      .GetGammaValue();
+    const int code = GoUctPatternsUtil::CodeOfEdgeNeighbors(m_bd, p);
+    return m_edgeTable[toPlay][code].GetGammaValue();
 }
 
 template<class BOARD>
@@ -285,8 +351,8 @@ template<class BOARD>
 inline bool GoUctPatterns<BOARD>::MatchAnyCenter(SgPoint p, float& gamma)
 const
 {
-	const PatternInfo& pi = m_table[m_bd.ToPlay()]
-                                   [GoPattern3x3::CodeOf8Neighbors(m_bd, p)];
+    const int code = GoUctPatternsUtil::CodeOf8Neighbors(m_bd, p);
+	const PatternInfo& pi = m_table[m_bd.ToPlay()][code];
     gamma = pi.GetGammaValue();
 	return pi.IsPattern();
 }
@@ -294,9 +360,8 @@ const
 template<class BOARD>
 inline bool GoUctPatterns<BOARD>::MatchAnyEdge(SgPoint p, float& gamma) const
 {
-	const PatternInfo& pi =
-            m_edgeTable[m_bd.ToPlay()]
-                       [GoPattern3x3::CodeOfEdgeNeighbors(m_bd, p)];
+    const int code = GoUctPatternsUtil::CodeOfEdgeNeighbors(m_bd, p);
+	const PatternInfo& pi = m_edgeTable[m_bd.ToPlay()][code];
     gamma = pi.GetGammaValue();
 	return pi.IsPattern();
 }
@@ -206,7 +206,11 @@ public:
     /** Reuse subtree from last search.
         Reuses the subtree from the last search, if the current position is
         a number of regular game moves later than the position that the
-        previous search corresponds to. Default is true. */
+        previous search corresponds to. Default is true.
+        If pruning of a full tree is enabled in the search (see
+        SgUctSearch::PruneFullTree()), the subtree is promoted to the root
+        in place (see SgUctSearch::PromoteSubtree()), otherwise it is copied
+        to a new tree. */
     bool ReuseSubtree() const;
 
     /** See ReuseSubtree() */
@@ -321,8 +325,10 @@ public:
     SgPoint DoSearch(SgBlackWhite toPlay, double maxTime,
                      bool isDuringPondering);
 
-    void FindInitTree(SgUctTree& initTree, SgBlackWhite toPlay,
-                      double maxTime);
+    void CheckInitTree(SgUctTree& initTree) const;
+
+    SgUctTree& FindInitTree(SgBlackWhite toPlay, double maxTime,
+                            bool& isTruncated);
 
     void SetDefaultParameters(int boardSize);
 
@@ -803,11 +809,11 @@ SgPoint GoUctPlayer<SEARCH, THREAD>::DoSearch(SgBlackWhite toPlay,
     double timeInitTree = 0;
     if (m_reuseSubtree)
     {
-        initTree = &m_search.GetTempTree();
         timeInitTree = -timer.GetTime();
-        FindInitTree(*initTree, toPlay, maxTime);
+        bool isTruncated = false;
+        initTree = &FindInitTree(toPlay, maxTime, isTruncated);
         timeInitTree += timer.GetTime();
-        if (isDuringPondering)
+        if (isDuringPondering && isTruncated)
         {
             bool aborted = SgUserAbort();
             m_mpiSynchronizer->SynchronizeUserAbort(aborted);
@@ -893,19 +899,52 @@ SgPoint GoUctPlayer<SEARCH, THREAD>::DoSearch(SgBlackWhite toPlay,
     Goes back in the tree until the node is found, the search tree is valid
     for and checks if the path of nodes corresponds to an alternating
     sequence of moves starting with the color to play of the search tree.
+    @param toPlay
+    @param maxTime Maximum time for copying the subtree
+    @param[out] isTruncated Set to true, if the subtree was copied and the
+    copy could have been truncated by SgUserAbort() or the time limit
+    @return The initial tree, a temporary tree of the search (see
+    SgUctSearch::GetTempTree())
     @see SetReuseSubtree */
 template <class SEARCH, class THREAD>
-void GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgUctTree& initTree, 
-                                               SgBlackWhite toPlay,
-                                               double maxTime)
+SgUctTree& GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgBlackWhite toPlay,
+                                                     double maxTime,
+                                                     bool& isTruncated)
 {
     Board().SetToPlay(toPlay);
     std::vector<SgPoint> sequence;
     if (! m_search.BoardHistory().SequenceToCurrent(Board(), sequence))
     {
         SgDebug() << "GoUctPlayer: No tree to reuse found\n";
-        return;
+        return m_search.GetTempTree();
     }
+    if (m_search.PruneFullTree())
+    {
+        // Promoting in place is a constant time operation and keeps the
+        // whole subtree. Unreachable nodes stay in the allocators until the
+        // search prunes the full tree, so the reuse is measured by the
+        // number of games instead of the number of nodes.
+        const SgUctValue oldTreeCount = m_search.Tree().Root().PosCount();
+        SgUctTree& initTree = m_search.PromoteSubtree(sequence);
+        CheckInitTree(initTree);
+        const SgUctValue initTreeCount = initTree.Root().PosCount();
+        if (oldTreeCount > 0 && initTreeCount > 0)
+        {
+            const float reuse = float(initTreeCount / oldTreeCount);
+            const int reusePercent = static_cast<int>(100 * reuse);
+            SgDebug() << "GoUctPlayer: Reusing subtree with " << initTreeCount
+                      << " games (" << reusePercent << "%)\n";
+            m_statistics.m_reuse.Add(reuse);
+        }
+        else
+        {
+            SgDebug() << "GoUctPlayer: Subtree to reuse has 0 games\n";
+            m_statistics.m_reuse.Add(0.f);
+        }
+        return initTree;
+    }
+    isTruncated = true;
+    SgUctTree& initTree = m_search.GetTempTree();
     SgUctTreeUtil::ExtractSubtree(m_search.Tree(), initTree, sequence, true,
                                   maxTime, m_search.PruneMinCount());
     const size_t initTreeNodes = initTree.NuNodes();
@@ -925,8 +964,15 @@ void GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgUctTree& initTree,
         SgDebug() << "GoUctPlayer: Subtree to reuse has 0 nodes\n";
         m_statistics.m_reuse.Add(0.f);
     }
+    CheckInitTree(initTree);
+    return initTree;
+}
 
-    // Check consistency
+/** Check consistency of the initial tree with the current position.
+    Clears the tree if a root child has an illegal move. */
+template <class SEARCH, class THREAD>
+void GoUctPlayer<SEARCH, THREAD>::CheckInitTree(SgUctTree& initTree) const
+{
     if (initTree.Root().HasChildren())
     {
         for (SgUctChildIterator it(initTree, initTree.Root()); it; ++it)
@@ -937,6 +983,7 @@ void GoUctPlayer<SEARCH, THREAD>::FindInitTree(SgUctTree& initTree,
                 initTree.Clear();
                 // Should not happen, if no bugs
                 SG_ASSERT(false);
+                return;
             }
     }
 }
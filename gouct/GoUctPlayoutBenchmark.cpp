@@ -0,0 +1,283 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutBenchmark.cpp
+    See GoUctPlayoutBenchmark.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctPlayoutBenchmark.h"
+
+#include <iomanip>
+#include <iostream>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include "GoBoard.h"
+#include "GoUctBitBoard.h"
+#include "GoUctBoard.h"
+#include "SgTime.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Board and policy of a thread. */
+template<class BOARD>
+class Worker
+{
+public:
+    Worker(const GoBoard& bd, const GoUctPlayoutPolicyParam& param,
+           size_t nuPlayouts, bool timeMoveTypes);
+
+    /** Play the playouts.
+        Accumulates the statistics in the result. */
+    void Run();
+
+    /** The statistics of this worker (m_nuThreads and m_time are not
+        used). */
+    const GoUctPlayoutBenchmarkResult& Result() const;
+
+private:
+    const GoBoard& m_bd;
+
+    size_t m_nuPlayouts;
+
+    bool m_timeMoveTypes;
+
+    BOARD m_uctBd;
+
+    GoUctPlayoutPolicy<BOARD> m_policy;
+
+    GoUctPlayoutBenchmarkResult m_result;
+
+    SgPoint GenerateMove();
+};
+
+template<class BOARD>
+Worker<BOARD>::Worker(const GoBoard& bd, const GoUctPlayoutPolicyParam& param,
+                      size_t nuPlayouts, bool timeMoveTypes)
+    : m_bd(bd),
+      m_nuPlayouts(nuPlayouts),
+      m_timeMoveTypes(timeMoveTypes),
+      m_uctBd(bd),
+      m_policy(m_uctBd, param)
+{ }
+
+template<class BOARD>
+inline SgPoint Worker<BOARD>::GenerateMove()
+{
+    if (! m_timeMoveTypes)
+        return m_policy.GenerateMove();
+    double startTime = SgTime::Get(SG_TIME_REAL);
+    SgPoint move = m_policy.GenerateMove();
+    m_result.m_moveTypeTime[m_policy.MoveType()] +=
+        SgTime::Get(SG_TIME_REAL) - startTime;
+    return move;
+}
+
+template<class BOARD>
+const GoUctPlayoutBenchmarkResult& Worker<BOARD>::Result() const
+{
+    return m_result;
+}
+
+template<class BOARD>
+void Worker<BOARD>::Run()
+{
+    const size_t maxLength = 3 * m_bd.Size() * m_bd.Size();
+    for (size_t i = 0; i < m_nuPlayouts; ++i)
+    {
+        m_uctBd.Init(m_bd);
+        m_policy.StartPlayout();
+        int nuPassMoves = 0;
+        for (size_t length = 0; length < maxLength; ++length)
+        {
+            SgPoint move = GenerateMove();
+            ++m_result.m_nuMoveType[m_policy.MoveType()];
+            m_uctBd.Play(move);
+            m_policy.OnPlay();
+            ++m_result.m_nuMoves;
+            if (move != SG_PASS)
+                nuPassMoves = 0;
+            else if (++nuPassMoves == 2)
+                break;
+        }
+        m_policy.EndPlayout();
+        ++m_result.m_nuPlayouts;
+    }
+}
+
+template<class BOARD>
+GoUctPlayoutBenchmarkResult RunWorkers(const GoBoard& bd,
+                                       const GoUctPlayoutPolicyParam& param,
+                                       size_t nuPlayouts, int nuThreads,
+                                       bool timeMoveTypes)
+{
+    SG_ASSERT(nuThreads >= 1);
+    // Create the workers in this thread, because the constructor of SgRandom
+    // used in the policies is not thread-safe
+    vector<boost::shared_ptr<Worker<BOARD> > > workers;
+    for (int i = 0; i < nuThreads; ++i)
+    {
+        size_t n = nuPlayouts / nuThreads;
+        if (static_cast<size_t>(i) < nuPlayouts % nuThreads)
+            ++n;
+        workers.push_back(boost::shared_ptr<Worker<BOARD> >(
+                              new Worker<BOARD>(bd, param, n, timeMoveTypes)));
+    }
+    double startTime = SgTime::Get(SG_TIME_REAL);
+    if (nuThreads == 1)
+        workers[0]->Run();
+    else
+    {
+        boost::thread_group threads;
+        for (int i = 0; i < nuThreads; ++i)
+            threads.create_thread(boost::bind(&Worker<BOARD>::Run,
+                                              workers[i]));
+        threads.join_all();
+    }
+    GoUctPlayoutBenchmarkResult result;
+    result.m_time = SgTime::Get(SG_TIME_REAL) - startTime;
+    result.m_nuThreads = nuThreads;
+    for (int i = 0; i < nuThreads; ++i)
+    {
+        const GoUctPlayoutBenchmarkResult& r = workers[i]->Result();
+        result.m_nuPlayouts += r.m_nuPlayouts;
+        result.m_nuMoves += r.m_nuMoves;
+        for (int j = 0; j < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++j)
+        {
+            result.m_nuMoveType[j] += r.m_nuMoveType[j];
+            result.m_moveTypeTime[j] += r.m_moveTypeTime[j];
+        }
+    }
+    return result;
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctPlayoutBenchmarkResult::GoUctPlayoutBenchmarkResult()
+    : m_nuThreads(0),
+      m_nuPlayouts(0),
+      m_nuMoves(0),
+      m_time(0)
+{
+    m_nuMoveType.assign(0);
+    m_moveTypeTime.assign(0);
+}
+
+double GoUctPlayoutBenchmarkResult::MoveGenerationTime() const
+{
+    double time = 0;
+    for (size_t i = 0; i < m_moveTypeTime.size(); ++i)
+        time += m_moveTypeTime[i];
+    return time;
+}
+
+double GoUctPlayoutBenchmarkResult::MovesPerSecond() const
+{
+    return m_time > 0 ? double(m_nuMoves) / m_time : 0;
+}
+
+double GoUctPlayoutBenchmarkResult::PlayoutsPerSecond() const
+{
+    return m_time > 0 ? double(m_nuPlayouts) / m_time : 0;
+}
+
+void GoUctPlayoutBenchmarkResult::Write(ostream& out,
+                       const GoUctPlayoutBenchmarkResult* baseline) const
+{
+    out << fixed << setprecision(3)
+        << "threads " << m_nuThreads
+        << " playouts " << m_nuPlayouts
+        << " moves " << m_nuMoves
+        << " time " << m_time
+        << " playouts/s " << setprecision(1) << PlayoutsPerSecond()
+        << " moves/s " << MovesPerSecond();
+    if (baseline != 0)
+    {
+        double efficiency = 0;
+        if (baseline->m_nuThreads > 0 && baseline->PlayoutsPerSecond() > 0)
+        {
+            double rateOneThread =
+                baseline->PlayoutsPerSecond() / baseline->m_nuThreads;
+            efficiency = PlayoutsPerSecond() / (rateOneThread * m_nuThreads);
+        }
+        out << " efficiency " << setprecision(3) << efficiency;
+    }
+    out << '\n';
+}
+
+void GoUctPlayoutBenchmarkResult::WriteMoveTypes(ostream& out) const
+{
+    const double totalTime = MoveGenerationTime();
+    out << fixed;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+    {
+        if (m_nuMoveType[i] == 0)
+            continue;
+        out << "type " << GoUctPlayoutPolicyTypeStr(GoUctPlayoutPolicyType(i))
+            << " moves " << m_nuMoveType[i]
+            << " fraction " << setprecision(3)
+            << (m_nuMoves > 0 ? double(m_nuMoveType[i]) / m_nuMoves : 0);
+        if (totalTime > 0)
+            out << " time " << m_moveTypeTime[i]
+                << " time_fraction " << m_moveTypeTime[i] / totalTime
+                << " ns/move " << setprecision(1)
+                << 1e9 * m_moveTypeTime[i] / double(m_nuMoveType[i]);
+        out << '\n';
+    }
+}
+
+//----------------------------------------------------------------------------
+
+GoUctPlayoutBenchmarkResult
+GoUctPlayoutBenchmark::Run(const GoBoard& bd,
+                           const GoUctPlayoutPolicyParam& param,
+                           size_t nuPlayouts, int nuThreads,
+                           bool timeMoveTypes, bool bitBoard)
+{
+    if (bitBoard)
+        return RunWorkers<GoUctBitBoard>(bd, param, nuPlayouts, nuThreads,
+                                         timeMoveTypes);
+    return RunWorkers<GoUctBoard>(bd, param, nuPlayouts, nuThreads,
+                                  timeMoveTypes);
+}
+
+size_t GoUctPlayoutBenchmark::CheckBitBoard(const GoBoard& bd,
+                                      const GoUctPlayoutPolicyParam& param,
+                                      size_t nuPlayouts)
+{
+    GoUctBoard uctBd(bd);
+    GoUctBitBoard bitBd(bd);
+    GoUctPlayoutPolicy<GoUctBoard> policy(uctBd, param);
+    const size_t maxLength = 3 * bd.Size() * bd.Size();
+    size_t nuMoves = 0;
+    for (size_t i = 0; i < nuPlayouts; ++i)
+    {
+        uctBd.Init(bd);
+        bitBd.Init(bd);
+        GoUctBitBoardUtil::CheckEqual(bitBd, uctBd);
+        policy.StartPlayout();
+        int nuPassMoves = 0;
+        for (size_t length = 0; length < maxLength; ++length)
+        {
+            SgPoint move = policy.GenerateMove();
+            uctBd.Play(move);
+            bitBd.Play(move);
+            policy.OnPlay();
+            ++nuMoves;
+            GoUctBitBoardUtil::CheckEqual(bitBd, uctBd);
+            if (move != SG_PASS)
+                nuPassMoves = 0;
+            else if (++nuPassMoves == 2)
+                break;
+        }
+        policy.EndPlayout();
+    }
+    return nuMoves;
+}
+
+//----------------------------------------------------------------------------
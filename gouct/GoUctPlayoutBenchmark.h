@@ -0,0 +1,114 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutBenchmark.h
+    Throughput benchmark for playouts with GoUctBoard or GoUctBitBoard and
+    GoUctPlayoutPolicy. */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_PLAYOUTBENCHMARK_H
+#define GOUCT_PLAYOUTBENCHMARK_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <boost/array.hpp>
+#include "GoUctPlayoutPolicy.h"
+
+class GoBoard;
+
+//----------------------------------------------------------------------------
+
+/** Result of a playout benchmark run. */
+struct GoUctPlayoutBenchmarkResult
+{
+    /** Number of threads used. */
+    int m_nuThreads;
+
+    /** Number of playouts played by all threads. */
+    std::size_t m_nuPlayouts;
+
+    /** Number of moves played in all playouts, including passes. */
+    std::size_t m_nuMoves;
+
+    /** Real time of the run in seconds. */
+    double m_time;
+
+    /** Number of generated moves per move type. */
+    boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuMoveType;
+
+    /** Time spent in GoUctPlayoutPolicy::GenerateMove() per move type.
+        The time of a call is attributed to the type of the generated move,
+        so it includes the time of the heuristics with higher priority that
+        were tried before and did not generate a move. Only measured if the
+        run was started with @c timeMoveTypes; the timer calls slow down the
+        playouts, so the time split is meant for comparing the heuristics, not
+        for measuring the throughput. */
+    boost::array<double,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_moveTypeTime;
+
+    GoUctPlayoutBenchmarkResult();
+
+    double PlayoutsPerSecond() const;
+
+    double MovesPerSecond() const;
+
+    /** Sum of m_moveTypeTime. */
+    double MoveGenerationTime() const;
+
+    /** Write the throughput as a single line of space-separated key value
+        pairs.
+        @param out The stream
+        @param baseline The result of a run with one thread, used to compute
+        the scaling efficiency (the speedup per thread). 0, if the
+        efficiency should not be written. */
+    void Write(std::ostream& out,
+               const GoUctPlayoutBenchmarkResult* baseline = 0) const;
+
+    /** Write the number of moves and time per move type.
+        One line per move type that occurred, in the same format as
+        Write(). */
+    void WriteMoveTypes(std::ostream& out) const;
+};
+
+//----------------------------------------------------------------------------
+
+/** Measure the playout throughput of GoUctBoard or GoUctBitBoard and
+    GoUctPlayoutPolicy.
+    Unlike GoBoardCheckPerformance, which measures GoBoard, this plays
+    complete playouts with the playout policy, like the playout phase of
+    GoUctGlobalSearch. The playouts do not use the mercy rule and the safe
+    points of the search, so the results measure only the board and the
+    policy. */
+namespace GoUctPlayoutBenchmark
+{
+    /** Run playouts from a position.
+        A playout ends after two passes in a row or after a maximum length
+        of three times the number of points on the board (GoUctBoard does not
+        check for repetitions).
+        The playouts are distributed equally between the threads. Each
+        thread uses its own board and policy, which are created before the
+        timing starts.
+        @param bd The start position
+        @param param The policy parameters
+        @param nuPlayouts The total number of playouts
+        @param nuThreads The number of threads
+        @param timeMoveTypes Measure the time per move type (see
+        GoUctPlayoutBenchmarkResult::m_moveTypeTime)
+        @param bitBoard Use GoUctBitBoard instead of GoUctBoard */
+    GoUctPlayoutBenchmarkResult Run(const GoBoard& bd,
+                                    const GoUctPlayoutPolicyParam& param,
+                                    std::size_t nuPlayouts, int nuThreads,
+                                    bool timeMoveTypes = false,
+                                    bool bitBoard = false);
+
+    /** Differential test of GoUctBitBoard against GoUctBoard.
+        Runs playouts with the policy on a GoUctBoard, plays the same moves
+        on a GoUctBitBoard and compares the boards with
+        GoUctBitBoardUtil::CheckEqual() after each move.
+        @return The number of moves compared
+        @throws SgException If the boards differ */
+    std::size_t CheckBitBoard(const GoBoard& bd,
+                              const GoUctPlayoutPolicyParam& param,
+                              std::size_t nuPlayouts);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_PLAYOUTBENCHMARK_H
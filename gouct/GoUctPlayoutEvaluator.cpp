@@ -0,0 +1,352 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutEvaluator.cpp
+    See GoUctPlayoutEvaluator.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "GoUctPlayoutEvaluator.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <boost/bind.hpp>
+#include <boost/io/ios_state.hpp>
+#include <boost/thread/thread.hpp>
+#include "GoBoard.h"
+#include "GoBoardUtil.h"
+#include "GoGame.h"
+#include "GoNodeUtil.h"
+#include "GoSetup.h"
+#include "GoUctBoard.h"
+#include "SgException.h"
+#include "SgGameReader.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+const GoBoard& ReadGame(istream& in, GoGame& game, float& komi)
+{
+    SgGameReader reader(in);
+    SgNode* root = reader.ReadGame();
+    if (root == 0)
+        throw SgException("no game");
+    int size = GoNodeUtil::GetBoardSize(root);
+    if (size < SG_MIN_SIZE || size > SG_MAX_SIZE)
+    {
+        root->DeleteTree();
+        throw SgException("invalid board size");
+    }
+    game.Init(root);
+    GoGameUtil::GotoBeforeMove(&game, -1);
+    komi = GoNodeUtil::GetKomi(game.CurrentNode()).ToFloat();
+    return game.Board();
+}
+
+bool EndsWith(const string& s, const string& suffix)
+{
+    return (  s.size() >= suffix.size()
+           && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0
+           );
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+GoUctPlayoutEvaluation::GoUctPlayoutEvaluation()
+    : m_nuPlayouts(0),
+      m_blackWinRate(0),
+      m_score(0),
+      m_ownership(0)
+{ }
+
+void GoUctPlayoutEvaluation::Write(ostream& out, int boardSize) const
+{
+    boost::io::ios_all_saver saver(out);
+    out << fixed << setprecision(3) << m_blackWinRate << ' '
+        << setprecision(1) << m_score << setprecision(2);
+    for (int row = boardSize; row >= 1; --row)
+        for (int col = 1; col <= boardSize; ++col)
+            out << ' ' << m_ownership[SgPointUtil::Pt(col, row)];
+}
+
+//----------------------------------------------------------------------------
+
+/** Board and policy of a thread. */
+class GoUctPlayoutEvaluator::Worker
+{
+public:
+    /** Board for positions in the compact text format. */
+    GoBoard m_bd;
+
+    /** Game for positions in SGF format. */
+    GoGame m_game;
+
+    Worker(const GoUctPlayoutPolicyParam& param);
+
+    GoUctPlayoutEvaluation Evaluate(const GoBoard& bd, float komi,
+                                    size_t nuPlayouts);
+
+private:
+    GoUctBoard m_uctBd;
+
+    GoUctPlayoutPolicy<GoUctBoard> m_policy;
+
+    /** Empty sets for GoBoardUtil::ScoreSimpleEndPosition() */
+    SgBWSet m_safe;
+
+    SgPointArray<SgEmptyBlackWhite> m_scoreBoard;
+
+    /** Play a playout from the current position of m_uctBd. */
+    void Playout(int maxLength);
+};
+
+GoUctPlayoutEvaluator::Worker::Worker(const GoUctPlayoutPolicyParam& param)
+    : m_uctBd(m_bd),
+      m_policy(m_uctBd, param)
+{ }
+
+GoUctPlayoutEvaluation GoUctPlayoutEvaluator::Worker::Evaluate(
+                          const GoBoard& bd, float komi, size_t nuPlayouts)
+{
+    GoUctPlayoutEvaluation result;
+    if (nuPlayouts == 0)
+        return result;
+    const int maxLength = 3 * bd.Size() * bd.Size();
+    m_uctBd.Init(bd);
+    m_uctBd.TakeSnapshot();
+    SgPointArray<int> ownership(0);
+    double nuWins = 0;
+    double scoreSum = 0;
+    for (size_t i = 0; i < nuPlayouts; ++i)
+    {
+        if (i > 0)
+            m_uctBd.RestoreSnapshot();
+        Playout(maxLength);
+        // The playout can end without two passes after maxLength moves, so
+        // the end position is not necessarily a simple end position
+        float score = GoBoardUtil::ScoreSimpleEndPosition(m_uctBd, komi,
+                                                          m_safe, true,
+                                                          &m_scoreBoard);
+        scoreSum += score;
+        if (score > 0)
+            nuWins += 1;
+        else if (score == 0)
+            nuWins += 0.5;
+        for (GoUctBoard::Iterator it(m_uctBd); it; ++it)
+            if (m_scoreBoard[*it] == SG_BLACK)
+                ++ownership[*it];
+            else if (m_scoreBoard[*it] == SG_WHITE)
+                --ownership[*it];
+    }
+    result.m_nuPlayouts = nuPlayouts;
+    result.m_blackWinRate = float(nuWins / double(nuPlayouts));
+    result.m_score = float(scoreSum / double(nuPlayouts));
+    for (GoUctBoard::Iterator it(m_uctBd); it; ++it)
+        result.m_ownership[*it] = float(ownership[*it]) / float(nuPlayouts);
+    return result;
+}
+
+void GoUctPlayoutEvaluator::Worker::Playout(int maxLength)
+{
+    m_policy.StartPlayout();
+    int nuPassMoves = 0;
+    for (int length = 0; length < maxLength; ++length)
+    {
+        SgPoint move = m_policy.GenerateMove();
+        m_uctBd.Play(move);
+        m_policy.OnPlay();
+        if (move != SG_PASS)
+            nuPassMoves = 0;
+        else if (++nuPassMoves == 2)
+            break;
+    }
+    m_policy.EndPlayout();
+}
+
+//----------------------------------------------------------------------------
+
+GoUctPlayoutEvaluator::GoUctPlayoutEvaluator(
+                                       const GoUctPlayoutPolicyParam& param,
+                                       int nuThreads)
+    : m_in(0),
+      m_out(0),
+      m_nuPlayouts(0),
+      m_lineNumber(0),
+      m_nextLine(1),
+      m_nuPositions(0)
+{
+    SG_ASSERT(nuThreads >= 1);
+    // Create the workers in this thread, because the constructor of SgRandom
+    // used in the policies is not thread-safe
+    for (int i = 0; i < nuThreads; ++i)
+        m_workers.push_back(boost::shared_ptr<Worker>(new Worker(param)));
+}
+
+GoUctPlayoutEvaluator::~GoUctPlayoutEvaluator()
+{ }
+
+void GoUctPlayoutEvaluator::AddResult(size_t lineNumber, const string& result)
+{
+    boost::mutex::scoped_lock lock(m_outMutex);
+    m_results[lineNumber] = result;
+    map<size_t,string>::iterator it;
+    while ((it = m_results.find(m_nextLine)) != m_results.end())
+    {
+        if (! it->second.empty())
+        {
+            *m_out << it->second << endl;
+            ++m_nuPositions;
+        }
+        m_results.erase(it);
+        ++m_nextLine;
+    }
+}
+
+GoUctPlayoutEvaluation GoUctPlayoutEvaluator::Evaluate(const GoBoard& bd,
+                                                       float komi,
+                                                       size_t nuPlayouts)
+{
+    return m_workers[0]->Evaluate(bd, komi, nuPlayouts);
+}
+
+size_t GoUctPlayoutEvaluator::EvaluateStream(istream& in, ostream& out,
+                                             size_t nuPlayouts)
+{
+    m_in = &in;
+    m_out = &out;
+    m_nuPlayouts = nuPlayouts;
+    m_lineNumber = 0;
+    m_results.clear();
+    m_nextLine = 1;
+    m_nuPositions = 0;
+    m_error.clear();
+    if (m_workers.size() == 1)
+        RunWorker(*m_workers[0]);
+    else
+    {
+        boost::thread_group threads;
+        for (size_t i = 0; i < m_workers.size(); ++i)
+            threads.create_thread(boost::bind(
+                                 &GoUctPlayoutEvaluator::RunWorker, this,
+                                 boost::ref(*m_workers[i])));
+        threads.join_all();
+    }
+    if (! m_error.empty())
+        throw SgException(m_error);
+    return m_nuPositions;
+}
+
+const GoBoard& GoUctPlayoutEvaluator::ReadPosition(const string& line,
+                                                   GoGame& game, GoBoard& bd,
+                                                   float& komi)
+{
+    if (EndsWith(line, ".sgf"))
+    {
+        ifstream in(line.c_str());
+        if (! in)
+            throw SgException("could not open file " + line);
+        return ReadGame(in, game, komi);
+    }
+    if (line.compare(0, 2, "(;") == 0)
+    {
+        istringstream in(line);
+        return ReadGame(in, game, komi);
+    }
+    istringstream in(line);
+    int size;
+    string toPlay;
+    string points;
+    if (! (in >> size >> toPlay >> komi >> points))
+        throw SgException("expected size, color, komi and points");
+    if (size < SG_MIN_SIZE || size > SG_MAX_SIZE)
+        throw SgException("invalid board size");
+    GoSetup setup;
+    if (toPlay == "b" || toPlay == "B")
+        setup.m_player = SG_BLACK;
+    else if (toPlay == "w" || toPlay == "W")
+        setup.m_player = SG_WHITE;
+    else
+        throw SgException("invalid color " + toPlay);
+    if (points.size() != static_cast<size_t>(size * size))
+        throw SgException("wrong number of points");
+    for (int i = 0; i < size * size; ++i)
+    {
+        SgPoint p = SgPointUtil::Pt(i % size + 1, size - i / size);
+        switch (points[i])
+        {
+        case 'X':
+            setup.AddBlack(p);
+            break;
+        case 'O':
+            setup.AddWhite(p);
+            break;
+        case '.':
+            break;
+        default:
+            throw SgException("invalid point character");
+        }
+    }
+    bd.Init(size, setup);
+    for (GoBoard::Iterator it(bd); it; ++it)
+        if (bd.Occupied(*it) && bd.NumLiberties(*it) == 0)
+            throw SgException("block without liberties");
+    return bd;
+}
+
+bool GoUctPlayoutEvaluator::ReadLine(string& line, size_t& lineNumber)
+{
+    boost::mutex::scoped_lock lock(m_inMutex);
+    if (! m_error.empty() || ! getline(*m_in, line))
+        return false;
+    lineNumber = ++m_lineNumber;
+    return true;
+}
+
+void GoUctPlayoutEvaluator::RunWorker(Worker& worker)
+{
+    string line;
+    size_t lineNumber;
+    while (ReadLine(line, lineNumber))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            AddResult(lineNumber, "");
+            continue;
+        }
+        ostringstream result;
+        try
+        {
+            float komi;
+            const GoBoard* bd;
+            {
+                boost::mutex::scoped_lock lock(m_readMutex);
+                bd = &ReadPosition(line, worker.m_game, worker.m_bd, komi);
+            }
+            result << lineNumber << ' ';
+            worker.Evaluate(*bd, komi, m_nuPlayouts).Write(result,
+                                                           bd->Size());
+        }
+        catch (const SgException& e)
+        {
+            ostringstream message;
+            message << "line " << lineNumber << ": " << e.what();
+            SetError(message.str());
+            return;
+        }
+        AddResult(lineNumber, result.str());
+    }
+}
+
+void GoUctPlayoutEvaluator::SetError(const string& message)
+{
+    boost::mutex::scoped_lock lock(m_inMutex);
+    if (m_error.empty())
+        m_error = message;
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,187 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutEvaluator.h
+    Evaluation of positions with playouts only, without a search tree. */
+//----------------------------------------------------------------------------
+
+#ifndef GOUCT_PLAYOUTEVALUATOR_H
+#define GOUCT_PLAYOUTEVALUATOR_H
+
+#include <cstddef>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include "GoUctPlayoutPolicy.h"
+#include "SgPointArray.h"
+
+class GoBoard;
+class GoGame;
+
+//----------------------------------------------------------------------------
+
+/** Result of the evaluation of a position by GoUctPlayoutEvaluator. */
+struct GoUctPlayoutEvaluation
+{
+    /** Number of playouts. */
+    std::size_t m_nuPlayouts;
+
+    /** Fraction of the playouts won by Black.
+        Draws count as half a win. */
+    float m_blackWinRate;
+
+    /** Mean score of the playouts including komi, positive for Black. */
+    float m_score;
+
+    /** Mean ownership of each point at the end of the playouts.
+        1 for Black, -1 for White, 0 for dame. */
+    SgPointArray<float> m_ownership;
+
+    GoUctPlayoutEvaluation();
+
+    /** Write the evaluation as a single line without end of line.
+        Contains the win rate of Black, the mean score and the ownership of
+        the points in the same order as in GoUctPlayoutEvaluator::ReadPosition
+        (rows from the top, columns from the left).
+        @param out The stream
+        @param boardSize The size of the board of the position */
+    void Write(std::ostream& out, int boardSize) const;
+};
+
+//----------------------------------------------------------------------------
+
+/** Evaluate positions with playouts of GoUctPlayoutPolicy on GoUctBoard.
+    Meant for bulk evaluations of many positions, e.g. for offline analysis,
+    where a GoUctSearch with its tree, prior knowledge and the GTP commands
+    for each position would be too slow. Each playout starts from the
+    position and is played with the policy until two passes; the end
+    position is scored with GoBoardUtil::ScoreSimpleEndPosition(). The
+    playouts do not use the mercy rule or the safety solver.
+    The evaluator keeps a board and a policy for each thread, which are
+    reused for all positions. */
+class GoUctPlayoutEvaluator
+{
+public:
+    /** Constructor.
+        @param param The policy parameters. Stores a reference; the lifetime
+        of the argument must exceed the lifetime of the evaluator.
+        @param nuThreads The number of threads used by EvaluateStream() */
+    GoUctPlayoutEvaluator(const GoUctPlayoutPolicyParam& param,
+                          int nuThreads);
+
+    ~GoUctPlayoutEvaluator();
+
+    /** Evaluate a position in the calling thread.
+        Uses the board and policy of the first thread.
+        @param bd The position
+        @param komi The komi used for scoring
+        @param nuPlayouts The number of playouts */
+    GoUctPlayoutEvaluation Evaluate(const GoBoard& bd, float komi,
+                                    std::size_t nuPlayouts);
+
+    /** Evaluate a stream of positions.
+        Reads one position per line (see ReadPosition()); empty lines and
+        lines starting with '#' are ignored. The positions are distributed
+        between the threads; each position is evaluated by a single thread
+        with all its playouts. For each position, a line with the line
+        number of the position in the input, followed by the evaluation
+        (see GoUctPlayoutEvaluation::Write()), is written to the output and
+        flushed as soon as the evaluations of all previous positions are
+        written, so that the output is in the order of the input.
+        @param in The input stream
+        @param out The output stream
+        @param nuPlayouts The number of playouts per position
+        @return The number of positions evaluated
+        @throws SgException If a line is not a valid position. Positions after
+        the invalid line are not evaluated. */
+    std::size_t EvaluateStream(std::istream& in, std::ostream& out,
+                               std::size_t nuPlayouts);
+
+    /** Read a position from a line of the input of EvaluateStream().
+        Three formats are supported:
+        - The name of an SGF file (the line ends with <tt>.sgf</tt>)
+        - An SGF game record on a single line (the line starts with
+          <tt>(;</tt>)
+        - A compact text format: the board size, the color to play
+          (<tt>b</tt> or <tt>w</tt>), the komi and the points of the board as
+          a string of size * size characters, row by row from the top and
+          column by column from the left, with <tt>X</tt> for Black,
+          <tt>O</tt> for White and <tt>.</tt> for empty points; separated by
+          spaces. Example: <tt>5 w 0.5 ..X....XO..XO...XO...O...</tt>
+        For SGF game records, the position is the end of the main variation
+        and the komi is taken from the game.
+        @param line The line
+        @param game Used for replaying the SGF game records
+        @param bd The board for the compact text format
+        @param komi The komi of the position
+        @return The board with the position, @c bd or the board of @c game
+        @throws SgException If the line is not a valid position */
+    static const GoBoard& ReadPosition(const std::string& line, GoGame& game,
+                                       GoBoard& bd, float& komi);
+
+private:
+    class Worker;
+
+    std::vector<boost::shared_ptr<Worker> > m_workers;
+
+    /** @name Members used by EvaluateStream() */
+    // @{
+
+    std::istream* m_in;
+
+    std::ostream* m_out;
+
+    std::size_t m_nuPlayouts;
+
+    /** Protects m_in, m_lineNumber and m_error. */
+    boost::mutex m_inMutex;
+
+    /** Number of the last line read from m_in. */
+    std::size_t m_lineNumber;
+
+    /** Serializes ReadPosition().
+        SgNode counts its allocations in static variables, so SGF game
+        records cannot be read in parallel. */
+    boost::mutex m_readMutex;
+
+    /** Protects m_out, m_results, m_nextLine and m_nuPositions. */
+    boost::mutex m_outMutex;
+
+    /** Results not yet written, by line number.
+        Ignored lines have an empty result. */
+    std::map<std::size_t,std::string> m_results;
+
+    /** Line number of the next result to write. */
+    std::size_t m_nextLine;
+
+    std::size_t m_nuPositions;
+
+    /** Message of the first error in a thread; empty if no error.
+        The threads stop reading positions after an error. */
+    std::string m_error;
+
+    // @} // @name
+
+    /** Store the result of a line and write all results that are
+        complete. */
+    void AddResult(std::size_t lineNumber, const std::string& result);
+
+    /** Read the next line of the input.
+        @return false at the end of the input or after an error */
+    bool ReadLine(std::string& line, std::size_t& lineNumber);
+
+    void SetError(const std::string& message);
+
+    void RunWorker(Worker& worker);
+
+    /** Not implemented */
+    GoUctPlayoutEvaluator(const GoUctPlayoutEvaluator&);
+
+    /** Not implemented */
+    GoUctPlayoutEvaluator& operator=(const GoUctPlayoutEvaluator&);
+};
+
+//----------------------------------------------------------------------------
+
+#endif // GOUCT_PLAYOUTEVALUATOR_H
@@ -12,9 +12,12 @@
 
 GoUctPlayoutPolicyParam::GoUctPlayoutPolicyParam()
     : m_statisticsEnabled(false),
+      m_skipRareHeuristics(false),
+      m_skipHitRate(0.002f),
       m_useNakadeHeuristic(false),
       m_usePatternsInPlayout(true),
       m_usePatternsInPriorKnowledge(true),
+      m_useGlobalGammaPlayout(false),
       m_fillboardTries(0),
       m_patternGammaThreshold(50.f),
       m_knowledgeType(KNOWLEDGE_GREENPEEP),
@@ -25,7 +28,7 @@ GoUctPlayoutPolicyParam::GoUctPlayoutPolicyParam()
 
 const char* GoUctPlayoutPolicyTypeStr(GoUctPlayoutPolicyType type)
 {
-    BOOST_STATIC_ASSERT(_GOUCT_NU_DEFAULT_PLAYOUT_TYPE == 13);
+    BOOST_STATIC_ASSERT(_GOUCT_NU_DEFAULT_PLAYOUT_TYPE == 14);
     switch (type)
     {
     case GOUCT_FILLBOARD:
@@ -42,6 +45,8 @@ const char* GoUctPlayoutPolicyTypeStr(GoUctPlayoutPolicyType type)
         return "Pattern";
     case GOUCT_GAMMA_PATTERN:
     	return "GammaPattern";
+    case GOUCT_GLOBAL_GAMMA:
+        return "GlobalGamma";
     case GOUCT_REPLACE_CAPTURE:
         return "ReplaceCapture";
     case GOUCT_CAPTURE:
@@ -59,6 +64,22 @@ const char* GoUctPlayoutPolicyTypeStr(GoUctPlayoutPolicyType type)
     }
 }
 
+const char* GoUctPlayoutPhaseStr(GoUctPlayoutPhase phase)
+{
+    BOOST_STATIC_ASSERT(_GOUCT_NU_PLAYOUT_PHASE == 3);
+    switch (phase)
+    {
+    case GOUCT_PHASE_OPENING:
+        return "Opening";
+    case GOUCT_PHASE_MIDDLEGAME:
+        return "Middle";
+    case GOUCT_PHASE_ENDGAME:
+        return "End";
+    default:
+        return "?";
+    }
+}
+
 //----------------------------------------------------------------------------
 
 void GoUctPlayoutPolicyStat::Clear()
@@ -67,6 +88,13 @@ void GoUctPlayoutPolicyStat::Clear()
     m_nonRandLen.Clear();
     m_moveListLen.Clear();
     std::fill(m_nuMoveType.begin(), m_nuMoveType.end(), 0);
+    for (int i = 0; i < _GOUCT_NU_PLAYOUT_PHASE; ++i)
+    {
+        m_nuTries[i].assign(0);
+        m_nuHits[i].assign(0);
+        m_nuSkipped[i].assign(0);
+        m_cycles[i].assign(0);
+    }
 }
 
 void GoUctPlayoutPolicyStat::Write(std::ostream& out) const
@@ -87,6 +115,30 @@ void GoUctPlayoutPolicyStat::Write(std::ostream& out) const
         << SgWriteLabel("MoveListLen");
     m_moveListLen.Write(out);
     out << '\n';
+    // Heuristics: hit rate, number of calls, average cycles per call and
+    // number of skipped calls per phase
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+        for (int j = 0; j < _GOUCT_NU_PLAYOUT_PHASE; ++j)
+        {
+            const uint64_t nuTries = m_nuTries[j][i];
+            const uint64_t nuSkipped = m_nuSkipped[j][i];
+            if (nuTries == 0 && nuSkipped == 0)
+                continue;
+            std::string label =
+                std::string(GoUctPlayoutPolicyTypeStr(
+                                static_cast<GoUctPlayoutPolicyType>(i)))
+                + '/'
+                + GoUctPlayoutPhaseStr(static_cast<GoUctPlayoutPhase>(j));
+            out << SgWriteLabel(label)
+                << (nuTries > 0 ? m_nuHits[j][i] * 100.0 / nuTries : 0)
+                << "% " << nuTries << " calls "
+                << (nuTries > 0 ? double(m_cycles[j][i]) / nuTries : 0)
+                << (SgCycleCounter::IsCycleCounter() ? " cycles" : " us")
+                << "/call";
+            if (nuSkipped > 0)
+                out << ' ' << nuSkipped << " skipped";
+            out << '\n';
+        }
 }
 
 //----------------------------------------------------------------------------
@@ -6,13 +6,17 @@
 #define GOUCT_PLAYOUTPOLICY_H
 
 #include <iostream>
+#include <stdint.h>
 #include <boost/array.hpp>
 #include "GoAdditiveKnowledge.h"
 #include "GoBoardUtil.h"
 #include "GoEyeUtil.h"
+#include "GoUctBoard.h"
 #include "GoUctPatterns.h"
 #include "GoUctPureRandomGenerator.h"
 #include "GoUctGammaMoveGenerator.h"
+#include "GoUctGlobalGammaMoveGenerator.h"
+#include "SgCycleCounter.h"
 
 //----------------------------------------------------------------------------
 
@@ -21,9 +25,25 @@ class GoUctPlayoutPolicyParam
 {
 public:
     /** Enable collection of statistics.
+        Includes the number of calls, hits and cycles of each heuristic (see
+        GoUctPlayoutPolicyStat::m_nuTries).
         Has a negative impact on performance. Default is false. */
     bool m_statisticsEnabled;
 
+    /** Skip heuristics that rarely generate a move.
+        The policy counts for each phase of the position (see
+        GoUctPlayoutPhase) how often the heuristics before the capture
+        heuristic (nakade, atari, low liberties, patterns) generate moves. If
+        the rate of a heuristic in the current phase drops below
+        m_skipHitRate, it is only tried in a small fraction of the calls, which
+        keeps its rate up to date. The counts are kept per policy, so each
+        thread adapts independently. Default is false. */
+    bool m_skipRareHeuristics;
+
+    /** Threshold of the hit rate for m_skipRareHeuristics.
+        Default is 0.002 */
+    float m_skipHitRate;
+
     /** Use Nakade heuristic.
         See section 6.2 of: Chaslot, Chatriot, Fiter, Gelly, Hoock, 
         Perez, Rimmel and Teytaud:
@@ -43,6 +63,13 @@ public:
     /** Use learned pattern probabilities in prior knowledge */
     bool m_usePatternsInPriorKnowledge;
 
+    /** Select the moves that are not generated by the tactical heuristics
+        (nakade, atari, low liberties) on the whole board according to the
+        gamma values of their 3x3 patterns.
+        If true, the pattern, capture and pure random heuristics are replaced
+        by GoUctGlobalGammaMoveGenerator. Default is false. */
+    bool m_useGlobalGammaPlayout;
+
     /** See GoUctPureRandomGenerator::GenerateFillboardMove.
         Default is 0 */
     int m_fillboardTries;
@@ -78,6 +105,8 @@ enum GoUctPlayoutPolicyType
 
     GOUCT_GAMMA_PATTERN,
 
+    GOUCT_GLOBAL_GAMMA,
+
     GOUCT_REPLACE_CAPTURE,
 
     GOUCT_CAPTURE,
@@ -97,6 +126,26 @@ const char* GoUctPlayoutPolicyTypeStr(GoUctPlayoutPolicyType type);
 
 //----------------------------------------------------------------------------
 
+/** Phases of a position used in the heuristic statistics of
+    GoUctPlayoutPolicy.
+    Determined by the fraction of empty points on the board. */
+enum GoUctPlayoutPhase
+{
+    /** More than 80% of the points are empty. */
+    GOUCT_PHASE_OPENING,
+
+    /** More than 50% of the points are empty. */
+    GOUCT_PHASE_MIDDLEGAME,
+
+    GOUCT_PHASE_ENDGAME,
+
+    _GOUCT_NU_PLAYOUT_PHASE
+};
+
+const char* GoUctPlayoutPhaseStr(GoUctPlayoutPhase phase);
+
+//----------------------------------------------------------------------------
+
 /** Statistics collected by GoUctPlayoutPolicy */
 struct GoUctPlayoutPolicyStat
 {
@@ -113,6 +162,25 @@ struct GoUctPlayoutPolicyStat
     /** Number of moves of a certain type. */
     boost::array<std::size_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE> m_nuMoveType;
 
+    /** Counts per phase of the position and heuristic. */
+    typedef boost::array<boost::array<uint64_t,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE>,
+                         _GOUCT_NU_PLAYOUT_PHASE> HeuristicCounts;
+
+    /** Number of calls of a heuristic.
+        Unlike m_nuMoveType, this includes the calls that did not generate a
+        move, because a heuristic with higher priority generated it. */
+    HeuristicCounts m_nuTries;
+
+    /** Number of calls of a heuristic that generated at least one move. */
+    HeuristicCounts m_nuHits;
+
+    /** Number of calls of a heuristic skipped because of
+        GoUctPlayoutPolicyParam::m_skipRareHeuristics. */
+    HeuristicCounts m_nuSkipped;
+
+    /** Time spent in a heuristic, measured with SgCycleCounter. */
+    HeuristicCounts m_cycles;
+
     void Clear();
 
     void Write(std::ostream& out) const;
@@ -148,7 +216,12 @@ public:
         -# Atari heuristic (if enabled)
         -# Proximity heuristic (if enabled) (using patterns if enabled)
         -# Capture heuristic (if enabled)
-        -# Purely random */
+        -# Purely random
+        If GoUctPlayoutPolicyParam::m_useGlobalGammaPlayout is set, the
+        proximity, capture and purely random heuristics are replaced by
+        GoUctGlobalGammaMoveGenerator. Heuristics that rarely generate a move
+        can be skipped (see GoUctPlayoutPolicyParam::m_skipRareHeuristics).
+        */
     SgPoint GenerateMove();
 
     void EndPlayout();
@@ -193,6 +266,9 @@ public:
     /** @see GoUctGammaMoveGenerator */
     const GoUctGammaMoveGenerator<BOARD>& GammaGenerator() const;
 
+    /** @see GoUctGlobalGammaMoveGenerator */
+    const GoUctGlobalGammaMoveGenerator<BOARD>& GlobalGammaGenerator() const;
+
     /** A function that tries to correct a given move if it is bad.
      Returns true of the move was replaced.
      */
@@ -220,7 +296,9 @@ public:
 
 private:
 
-    /** Incrementally keeps track of blocks in atari. */
+    /** Incrementally keeps track of blocks in atari.
+        Specialized for GoUctBoard, which maintains the blocks in atari
+        itself (see GoUctBoard::NumLowLibBlocks()). */
     class CaptureGenerator
     {
     public:
@@ -251,6 +329,28 @@ private:
 
     static const bool DEBUG_CORRECT_MOVE = false;
 
+    /** Minimum number of calls of a heuristic in a phase before it can be
+        skipped by GoUctPlayoutPolicyParam::m_skipRareHeuristics. */
+    static const uint32_t SKIP_MIN_TRIES = 1000;
+
+    /** A skipped heuristic is still tried in one of this number of calls. */
+    static const uint32_t SKIP_SAMPLE_INTERVAL = 64;
+
+    /** The counts of a heuristic are halved when the number of calls
+        reaches this value, so that the hit rate follows recent playouts. */
+    static const uint32_t SKIP_WINDOW = 1 << 16;
+
+    /** Counts of a heuristic in a phase for
+        GoUctPlayoutPolicyParam::m_skipRareHeuristics. */
+    struct HeuristicCount
+    {
+        uint32_t m_nuTries;
+
+        uint32_t m_nuHits;
+
+        uint32_t m_nuSkipped;
+    };
+
     const BOARD& m_bd;
 
     const GoUctPlayoutPolicyParam& m_param;
@@ -284,12 +384,39 @@ private:
 
     GoUctGammaMoveGenerator<BOARD> m_gammaGenerator;
 
+    GoUctGlobalGammaMoveGenerator<BOARD> m_globalGammaGenerator;
+
     CaptureGenerator m_captureGenerator;
 
     GoUctPureRandomGenerator<BOARD> m_pureRandomGenerator;
 
     SgBWArray<GoUctPlayoutPolicyStat> m_statistics;
 
+    /** Whether the heuristics are counted in the current call of
+        GenerateMove(). */
+    bool m_countHeuristics;
+
+    /** Phase of the position in the current call of GenerateMove().
+        Only computed if m_countHeuristics. */
+    GoUctPlayoutPhase m_phase;
+
+    /** Value of SgCycleCounter at the start of the current heuristic. */
+    uint64_t m_heuristicStart;
+
+    boost::array<boost::array<HeuristicCount,_GOUCT_NU_DEFAULT_PLAYOUT_TYPE>,
+                 _GOUCT_NU_PLAYOUT_PHASE> m_heuristicCount;
+
+    /** Start a heuristic in GenerateMove().
+        @return false, if the heuristic should be skipped (see
+        GoUctPlayoutPolicyParam::m_skipRareHeuristics) */
+    bool BeginHeuristic(GoUctPlayoutPolicyType type);
+
+    /** Count the result of a heuristic started with BeginHeuristic().
+        @param type The heuristic
+        @param found Whether the heuristic generated a move
+        @return @c found */
+    bool EndHeuristic(GoUctPlayoutPolicyType type, bool found);
+
     /** Captures if last move was self-atari */
     bool GenerateAtariCaptureMove();
 
@@ -314,11 +441,23 @@ private:
 
     bool GeneratePoint(SgPoint p) const;
 
+    /** Heuristics that can be skipped by
+        GoUctPlayoutPolicyParam::m_skipRareHeuristics. */
+    static bool IsSkippable(GoUctPlayoutPolicyType type);
+
+    /** Check if there can be a block of a color with nuLib liberties.
+        Used to skip the local searches of the heuristics for blocks with
+        few liberties. The default implementation returns true, the
+        specialization for GoUctBoard returns whether such a block exists. */
+    bool MayHaveLowLibBlocks(SgBlackWhite c, int nuLib) const;
+
     /** Does playing on a liberty increase number of liberties for block?
         If yes, add to m_moves.
         Disabled if both liberties are simple chain libs, e.g. bamboo. */
     void PlayGoodLiberties(SgPoint block);
 
+    GoUctPlayoutPhase Phase() const;
+
     /** see GoUctUtil::SelectRandom */
     SgPoint SelectRandom();
 
@@ -396,6 +535,103 @@ void GoUctPlayoutPolicy<BOARD>::CaptureGenerator::Generate(GoPointList& moves)
     }
 }
 
+template<>
+inline void GoUctPlayoutPolicy<GoUctBoard>::CaptureGenerator::StartPlayout()
+{ }
+
+template<>
+inline void GoUctPlayoutPolicy<GoUctBoard>::CaptureGenerator::OnPlay()
+{ }
+
+template<>
+inline void
+GoUctPlayoutPolicy<GoUctBoard>::CaptureGenerator::Generate(GoPointList& moves)
+{
+    SG_ASSERT(moves.IsEmpty());
+    const SgBlackWhite opp = m_bd.Opponent();
+    const int nuBlocks = m_bd.NumLowLibBlocks(opp, 1);
+    // Blocks in atari can share their liberty. There are nearly always
+    // zero or one blocks, so a linear check is cheaper than a marker
+    for (int i = 0; i < nuBlocks; ++i)
+    {
+        const SgPoint lib = m_bd.TheLiberty(m_bd.LowLibBlock(opp, 1, i));
+        if (! moves.Contains(lib))
+            moves.PushBack(lib);
+    }
+}
+
+template<class BOARD>
+inline bool GoUctPlayoutPolicy<BOARD>::MayHaveLowLibBlocks(SgBlackWhite c,
+                                                           int nuLib) const
+{
+    SG_UNUSED(c);
+    SG_UNUSED(nuLib);
+    return true;
+}
+
+template<>
+inline bool GoUctPlayoutPolicy<GoUctBoard>::MayHaveLowLibBlocks(
+                                               SgBlackWhite c, int nuLib) const
+{
+    return m_bd.NumLowLibBlocks(c, nuLib) > 0;
+}
+
+template<class BOARD>
+inline bool GoUctPlayoutPolicy<BOARD>::BeginHeuristic(
+                                                 GoUctPlayoutPolicyType type)
+{
+    if (! m_countHeuristics)
+        return true;
+    if (m_param.m_skipRareHeuristics && IsSkippable(type))
+    {
+        HeuristicCount& count = m_heuristicCount[m_phase][type];
+        if (  count.m_nuTries >= SKIP_MIN_TRIES
+           && count.m_nuHits < m_param.m_skipHitRate * count.m_nuTries
+           && ++count.m_nuSkipped % SKIP_SAMPLE_INTERVAL != 0
+           )
+        {
+            if (m_param.m_statisticsEnabled)
+                ++m_statistics[m_bd.ToPlay()].m_nuSkipped[m_phase][type];
+            return false;
+        }
+    }
+    if (m_param.m_statisticsEnabled)
+        m_heuristicStart = SgCycleCounter::Get();
+    return true;
+}
+
+template<class BOARD>
+inline bool GoUctPlayoutPolicy<BOARD>::EndHeuristic(
+                                     GoUctPlayoutPolicyType type, bool found)
+{
+    if (! m_countHeuristics)
+        return found;
+    if (m_param.m_statisticsEnabled)
+    {
+        const uint64_t now = SgCycleCounter::Get();
+        GoUctPlayoutPolicyStat& statistics = m_statistics[m_bd.ToPlay()];
+        // The time stamp counter can go back if the thread is moved to
+        // another processor
+        if (now > m_heuristicStart)
+            statistics.m_cycles[m_phase][type] += now - m_heuristicStart;
+        ++statistics.m_nuTries[m_phase][type];
+        if (found)
+            ++statistics.m_nuHits[m_phase][type];
+    }
+    if (m_param.m_skipRareHeuristics)
+    {
+        HeuristicCount& count = m_heuristicCount[m_phase][type];
+        if (++count.m_nuTries >= SKIP_WINDOW)
+        {
+            count.m_nuTries /= 2;
+            count.m_nuHits /= 2;
+        }
+        if (found)
+            ++count.m_nuHits;
+    }
+    return found;
+}
+
 template<class BOARD>
 GoUctPlayoutPolicy<BOARD>::GoUctPlayoutPolicy(const BOARD& bd,
     const GoUctPlayoutPolicyParam& param)
@@ -406,10 +642,17 @@ GoUctPlayoutPolicy<BOARD>::GoUctPlayoutPolicy(const BOARD& bd,
       m_checked(false),
       m_gammaGenerator(bd, param.m_patternGammaThreshold,
                        m_patterns, m_random),
+      m_globalGammaGenerator(bd, m_globalPatterns, m_random),
       m_captureGenerator(bd),
-      m_pureRandomGenerator(bd, m_random)
+      m_pureRandomGenerator(bd, m_random),
+      m_countHeuristics(false),
+      m_phase(GOUCT_PHASE_OPENING),
+      m_heuristicStart(0)
 {
     ClearStatistics();
+    const HeuristicCount zero = { 0, 0, 0 };
+    for (int i = 0; i < _GOUCT_NU_PLAYOUT_PHASE; ++i)
+        m_heuristicCount[i].assign(zero);
 }
 
 template<class BOARD>
@@ -462,6 +705,8 @@ bool GoUctPlayoutPolicy<BOARD>::GenerateAtariCaptureMove()
 template<class BOARD>
 bool GoUctPlayoutPolicy<BOARD>::GenerateAtariDefenseMove()
 {
+    if (! MayHaveLowLibBlocks(m_bd.ToPlay(), 1))
+        return false;
     return GoBoardUtil::AtariDefenseMoves(m_bd, m_lastMove, m_moves);
 }
 
@@ -485,6 +730,10 @@ bool GoUctPlayoutPolicy<BOARD>::GenerateLowLibMove(SgPoint lastMove)
     SG_ASSERT(m_moves.IsEmpty());
     
     const SgBlackWhite toPlay = m_bd.ToPlay();
+    if (  ! MayHaveLowLibBlocks(toPlay, 2)
+       && ! MayHaveLowLibBlocks(SgOppBW(toPlay), 2)
+       )
+        return false;
 
     // take liberty of last move
     if (m_bd.NumLiberties(lastMove) == 2)
@@ -521,12 +770,17 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
     m_moves.Clear();
     m_checked = false;
     SgPoint mv = SG_NULLMOVE;
+    m_countHeuristics =
+        (m_param.m_statisticsEnabled || m_param.m_skipRareHeuristics);
+    if (m_countHeuristics)
+        m_phase = Phase();
 
-    if (m_param.m_fillboardTries > 0)
+    if (m_param.m_fillboardTries > 0 && BeginHeuristic(GOUCT_FILLBOARD))
     {
         m_moveType = GOUCT_FILLBOARD;
         mv = m_pureRandomGenerator.
              GenerateFillboardMove(m_param.m_fillboardTries);
+        EndHeuristic(GOUCT_FILLBOARD, mv != SG_NULLMOVE);
     }
 
     m_lastMove = m_bd.GetLastMove();
@@ -536,34 +790,54 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
        && ! m_bd.IsEmpty(m_lastMove) // skip if move was suicide
        )
     {
-        if (m_param.m_useNakadeHeuristic && GenerateNakadeMove())
+        // The arguments of EndHeuristic() are evaluated after
+        // BeginHeuristic() returned true
+        if (  m_param.m_useNakadeHeuristic
+           && BeginHeuristic(GOUCT_NAKADE)
+           && EndHeuristic(GOUCT_NAKADE, GenerateNakadeMove())
+           )
         {
             m_moveType = GOUCT_NAKADE;
             mv = SelectRandom();
         }
-        if (mv == SG_NULLMOVE && GenerateAtariCaptureMove())
+        if (  mv == SG_NULLMOVE
+           && BeginHeuristic(GOUCT_ATARI_CAPTURE)
+           && EndHeuristic(GOUCT_ATARI_CAPTURE, GenerateAtariCaptureMove())
+           )
         {
             m_moveType = GOUCT_ATARI_CAPTURE;
             mv = SelectRandom();
         }
-        if (mv == SG_NULLMOVE && GenerateAtariDefenseMove())
+        if (  mv == SG_NULLMOVE
+           && BeginHeuristic(GOUCT_ATARI_DEFEND)
+           && EndHeuristic(GOUCT_ATARI_DEFEND, GenerateAtariDefenseMove())
+           )
         {
             m_moveType = GOUCT_ATARI_DEFEND;
             mv = SelectRandom();
         }
-        if (mv == SG_NULLMOVE && GenerateLowLibMove(m_lastMove))
+        if (  mv == SG_NULLMOVE
+           && BeginHeuristic(GOUCT_LOWLIB)
+           && EndHeuristic(GOUCT_LOWLIB, GenerateLowLibMove(m_lastMove))
+           )
         {
             m_moveType = GOUCT_LOWLIB;
             mv = SelectRandom();
         }
-        if (mv == SG_NULLMOVE)
+        if (mv == SG_NULLMOVE && ! m_param.m_useGlobalGammaPlayout)
         {
         	if (m_param.m_usePatternsInPlayout)
             {
-                m_moveType = GOUCT_GAMMA_PATTERN;
-                mv = m_gammaGenerator.GenerateBiasedPatternMove();
+                if (BeginHeuristic(GOUCT_GAMMA_PATTERN))
+                {
+                    m_moveType = GOUCT_GAMMA_PATTERN;
+                    mv = m_gammaGenerator.GenerateBiasedPatternMove();
+                    EndHeuristic(GOUCT_GAMMA_PATTERN, mv != SG_NULLMOVE);
+                }
             }
-            else if (GeneratePatternMove())
+            else if (  BeginHeuristic(GOUCT_PATTERN)
+                    && EndHeuristic(GOUCT_PATTERN, GeneratePatternMove())
+                    )
             {
                 m_moveType = GOUCT_PATTERN;
                 mv = SelectRandom();
@@ -571,19 +845,32 @@ SG_ATTR_FLATTEN SgPoint GoUctPlayoutPolicy<BOARD>::GenerateMove()
         }
     }
 
+    // The following heuristics are never skipped, BeginHeuristic() only
+    // starts their measurement
+    if (  mv == SG_NULLMOVE
+       && m_param.m_useGlobalGammaPlayout
+       && BeginHeuristic(GOUCT_GLOBAL_GAMMA)
+       )
+    {
+        m_moveType = GOUCT_GLOBAL_GAMMA;
+        mv = m_globalGammaGenerator.Generate();
+        EndHeuristic(GOUCT_GLOBAL_GAMMA, mv != SG_NULLMOVE);
+    }
     if (mv != SG_NULLMOVE)
         CorrectMove(GoUctUtil::DoFalseEyeToCaptureCorrection, mv,
                         GOUCT_REPLACE_CAPTURE);
-    if (mv == SG_NULLMOVE)
+    if (mv == SG_NULLMOVE && BeginHeuristic(GOUCT_CAPTURE))
     {
         m_moveType = GOUCT_CAPTURE;
         m_captureGenerator.Generate(m_moves);
+        EndHeuristic(GOUCT_CAPTURE, ! m_moves.IsEmpty());
         mv = SelectRandom();
     }
-    if (mv == SG_NULLMOVE)
+    if (mv == SG_NULLMOVE && BeginHeuristic(GOUCT_RANDOM))
     {
         m_moveType = GOUCT_RANDOM;
         mv = m_pureRandomGenerator.Generate();
+        EndHeuristic(GOUCT_RANDOM, mv != SG_NULLMOVE);
     }
     if (mv == SG_NULLMOVE)
     {
@@ -732,6 +1019,29 @@ inline bool GoUctPlayoutPolicy<BOARD>::GeneratePoint(SgPoint p) const
     return GoUctUtil::GeneratePoint(m_bd, p, m_bd.ToPlay());
 }
 
+template<class BOARD>
+inline bool GoUctPlayoutPolicy<BOARD>::IsSkippable(GoUctPlayoutPolicyType type)
+{
+    return (  type == GOUCT_NAKADE
+           || type == GOUCT_ATARI_CAPTURE
+           || type == GOUCT_ATARI_DEFEND
+           || type == GOUCT_LOWLIB
+           || type == GOUCT_PATTERN
+           || type == GOUCT_GAMMA_PATTERN
+           );
+}
+
+template<class BOARD>
+inline GoUctPlayoutPhase GoUctPlayoutPolicy<BOARD>::Phase() const
+{
+    const float emptyFraction = m_pureRandomGenerator.EmptyFraction();
+    if (emptyFraction > 0.8f)
+        return GOUCT_PHASE_OPENING;
+    if (emptyFraction > 0.5f)
+        return GOUCT_PHASE_MIDDLEGAME;
+    return GOUCT_PHASE_ENDGAME;
+}
+
 template<class BOARD>
 GoPointList GoUctPlayoutPolicy<BOARD>::AllRandomMoves() const
 {
@@ -825,6 +1135,8 @@ void GoUctPlayoutPolicy<BOARD>::OnPlay()
 {
     m_captureGenerator.OnPlay();
     m_pureRandomGenerator.OnPlay();
+    if (m_param.m_useGlobalGammaPlayout)
+        m_globalGammaGenerator.OnPlay();
 }
 
 template<class BOARD>
@@ -834,6 +1146,13 @@ GoUctPlayoutPolicy<BOARD>::GammaGenerator() const
     return m_gammaGenerator;
 }
 
+template<class BOARD>
+const GoUctGlobalGammaMoveGenerator<BOARD>&
+GoUctPlayoutPolicy<BOARD>::GlobalGammaGenerator() const
+{
+    return m_globalGammaGenerator;
+}
+
 template<class BOARD>
 const GoUctPatterns<BOARD>& 
 GoUctPlayoutPolicy<BOARD>::GlobalPatterns() const
@@ -866,6 +1185,8 @@ void GoUctPlayoutPolicy<BOARD>::StartPlayout()
 {
     m_captureGenerator.StartPlayout();
     m_pureRandomGenerator.Start();
+    if (m_param.m_useGlobalGammaPlayout)
+        m_globalGammaGenerator.StartPlayout();
     m_nonRandLen = 0;
 }
 
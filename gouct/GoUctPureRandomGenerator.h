@@ -47,6 +47,10 @@ public:
         they are really empty. */
     const std::vector<SgPoint>& Candidates() const;
 
+    /** Fraction of the points on the board that are empty.
+        Maintained incrementally in Start() and OnPlay(). */
+    float EmptyFraction() const;
+
     /** Generate a pure random move.
         Randomly select an empty point on the board that fulfills
         GoUctUtil::GeneratePoint() for the color currently to play on the
@@ -92,6 +96,8 @@ template<class BOARD>
 GoUctPureRandomGenerator<BOARD>::GoUctPureRandomGenerator(const BOARD& bd,
                                                           SgRandom& random)
     : m_bd(bd),
+      m_invNuPoints(0.f),
+      m_nuEmptyFloat(0.f),
       m_random(random)
 {
     m_candidates.reserve(GO_MAX_NUM_MOVES);
@@ -105,6 +111,12 @@ GoUctPureRandomGenerator<BOARD>::Candidates()
     return m_candidates;
 }
 
+template<class BOARD>
+inline float GoUctPureRandomGenerator<BOARD>::EmptyFraction() const
+{
+    return m_nuEmptyFloat * m_invNuPoints;
+}
+
 template<class BOARD>
 inline void GoUctPureRandomGenerator<BOARD>::CheckConsistency() const
 {
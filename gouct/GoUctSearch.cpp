@@ -100,6 +100,7 @@ GoUctState::GoUctState(unsigned int threadId, const GoBoard& bd)
 {
     m_synchronizer.SetSubscriber(m_bd);
     m_isInPlayout = false;
+    m_snapshotMoveNumber = -1;
 }
 
 void GoUctState::Dump(std::ostream& out) const
@@ -132,15 +133,45 @@ void GoUctState::ExecutePlayout(SgMove move)
     ++m_gameLength;
 }
 
+SgHashCode GoUctState::GetHashCode() const
+{
+    SG_ASSERT(! m_isInPlayout);
+    if (m_bd.KoPoint() != SG_NULLPOINT || m_bd.GetLastMove() == SG_PASS)
+        return SgHashCode();
+    return m_bd.GetHashCodeInclToPlay();
+}
+
 void GoUctState::GameStart()
 {
     m_isInPlayout = false;
     m_gameLength = 0;
 }
 
+/** Set the playout board to the in-tree position.
+    Restores the snapshot of the root position taken in StartSearch() and
+    replays the in-tree moves, which is faster than converting the whole
+    in-tree board with GoUctBoard::Init(). Falls back to Init() if the
+    in-tree board is not a followup position of the snapshot with
+    alternating moves. */
 void GoUctState::StartPlayout()
 {
-    m_uctBd.Init(m_bd);
+    const int moveNumber = m_bd.MoveNumber();
+    if (m_snapshotMoveNumber < 0 || moveNumber < m_snapshotMoveNumber)
+    {
+        m_uctBd.Init(m_bd);
+        return;
+    }
+    m_uctBd.RestoreSnapshot();
+    for (int i = m_snapshotMoveNumber; i < moveNumber; ++i)
+    {
+        const GoPlayerMove move = m_bd.Move(i);
+        if (move.Color() != m_uctBd.ToPlay())
+        {
+            m_uctBd.Init(m_bd);
+            return;
+        }
+        m_uctBd.Play(move.Point());
+    }
 }
 
 void GoUctState::StartPlayouts()
@@ -151,6 +182,9 @@ void GoUctState::StartPlayouts()
 void GoUctState::StartSearch()
 {
     m_synchronizer.UpdateSubscriber();
+    m_uctBd.Init(m_bd);
+    m_uctBd.TakeSnapshot();
+    m_snapshotMoveNumber = m_bd.MoveNumber();
 }
 
 void GoUctState::TakeBackInTree(std::size_t nuMoves)
@@ -58,6 +58,13 @@ public:
 
     void StartPlayouts();
 
+    /** Hash code of the in-tree board including the color to play.
+        Returns a zero hash code if the board has a ko point or the last
+        move was a pass, because the hash code of the board does not include
+        the ko point and the passes, which change the legal moves and the
+        end of the game. */
+    SgHashCode GetHashCode() const;
+
     // @} // @name
 
     /** Board used during in-tree phase. */
@@ -101,6 +108,11 @@ private:
 
     /** See GameLength() */
     std::size_t m_gameLength;
+
+    /** Move number of the in-tree board at the snapshot of the playout
+        board taken in StartSearch().
+        -1, if no snapshot was taken yet. */
+    int m_snapshotMoveNumber;
 };
 
 inline const GoBoard& GoUctState::Board() const
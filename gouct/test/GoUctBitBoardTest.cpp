@@ -0,0 +1,175 @@
+//----------------------------------------------------------------------------
+/** @file GoUctBitBoardTest.cpp
+    Unit tests for GoUctBitBoard. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <vector>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoUctBitBoard.h"
+#include "GoUctBoard.h"
+#include "GoUctPlayoutBenchmark.h"
+#include "SgRandom.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Play random games on a GoUctBitBoard and a GoUctBoard and compare the
+    boards after each move.
+    The games do not fill single point eyes, such that they contain many
+    captures and ko fights. */
+void CheckRandomGames(int size)
+{
+    SgRandom random;
+    GoBoard board(size);
+    GoUctBoard bd(board);
+    GoUctBitBoard bitBd(board);
+    int nuCaptures = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        bd.Init(board);
+        bitBd.Init(board);
+        BOOST_REQUIRE_NO_THROW(GoUctBitBoardUtil::CheckEqual(bitBd, bd));
+        for (int j = 0; j < 3 * size * size; ++j)
+        {
+            std::vector<SgPoint> moves;
+            for (GoUctBoard::Iterator it(bd); it; ++it)
+                if (bd.IsEmpty(*it) && bd.IsLegal(*it)
+                    && ! GoBoardUtil::IsCompletelySurrounded(bd, *it))
+                    moves.push_back(*it);
+            if (moves.empty())
+                break;
+            const SgPoint move = moves[random.Int(moves.size())];
+            bd.Play(move);
+            bitBd.Play(move);
+            if (bd.CapturingMove())
+                ++nuCaptures;
+            BOOST_REQUIRE_NO_THROW(GoUctBitBoardUtil::CheckEqual(bitBd, bd));
+        }
+    }
+    BOOST_CHECK(nuCaptures > 0);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctBitBoardTest_RandomGames)
+{
+    CheckRandomGames(9);
+    CheckRandomGames(19);
+}
+
+/** Compare the boards in playouts of the default playout policy. */
+BOOST_AUTO_TEST_CASE(GoUctBitBoardTest_Playouts)
+{
+    GoUctPlayoutPolicyParam param;
+    GoBoard bd(9);
+    BOOST_CHECK(GoUctPlayoutBenchmark::CheckBitBoard(bd, param, 20) > 0);
+    param.m_usePatternsInPlayout = true;
+    bd.Init(13);
+    BOOST_CHECK(GoUctPlayoutBenchmark::CheckBitBoard(bd, param, 5) > 0);
+}
+
+/** Test the specialization of GoBoardUtil::SelfAtari() in a position with
+    captures and ko.
+    Same position as in GoBoardUtilTest_SelfAtari_2. */
+BOOST_AUTO_TEST_CASE(GoUctBitBoardTest_SelfAtari)
+{
+    // . O @ . . . . . . 9
+    // O @ . . . @ @ O . 8
+    // @ . . . @ O . . O 7
+    // . . O @ . @ @ O . 6
+    // . O @ . @ O . . . 5
+    // . . O @ . @ @ O . 4
+    // . . . . . . . . . 3
+    // @ O . . . . . O @ 2
+    // . @ O . . . O . O 1
+    // 1 2 3 4 5 6 7 8 9
+    GoSetup setup;
+    setup.AddBlack(Pt(2, 1));
+    setup.AddBlack(Pt(1, 2));
+    setup.AddBlack(Pt(9, 2));
+    setup.AddBlack(Pt(4, 4));
+    setup.AddBlack(Pt(6, 4));
+    setup.AddBlack(Pt(7, 4));
+    setup.AddBlack(Pt(3, 5));
+    setup.AddBlack(Pt(5, 5));
+    setup.AddBlack(Pt(4, 6));
+    setup.AddBlack(Pt(6, 6));
+    setup.AddBlack(Pt(7, 6));
+    setup.AddBlack(Pt(1, 7));
+    setup.AddBlack(Pt(5, 7));
+    setup.AddBlack(Pt(2, 8));
+    setup.AddBlack(Pt(6, 8));
+    setup.AddBlack(Pt(7, 8));
+    setup.AddBlack(Pt(3, 9));
+    setup.AddWhite(Pt(3, 1));
+    setup.AddWhite(Pt(7, 1));
+    setup.AddWhite(Pt(9, 1));
+    setup.AddWhite(Pt(2, 2));
+    setup.AddWhite(Pt(8, 2));
+    setup.AddWhite(Pt(3, 4));
+    setup.AddWhite(Pt(8, 4));
+    setup.AddWhite(Pt(2, 5));
+    setup.AddWhite(Pt(6, 5));
+    setup.AddWhite(Pt(3, 6));
+    setup.AddWhite(Pt(8, 6));
+    setup.AddWhite(Pt(6, 7));
+    setup.AddWhite(Pt(9, 7));
+    setup.AddWhite(Pt(1, 8));
+    setup.AddWhite(Pt(8, 8));
+    setup.AddWhite(Pt(2, 9));
+    GoBoard board(9, setup);
+    board.SetToPlay(SG_BLACK);
+    GoUctBoard bd(board);
+    GoUctBitBoard bitBd(board);
+    BOOST_CHECK_NO_THROW(GoUctBitBoardUtil::CheckEqual(bitBd, bd));
+    int nuStones = 0;
+    BOOST_CHECK(GoBoardUtil::SelfAtari(bitBd, Pt(1, 1), nuStones));
+    BOOST_CHECK_EQUAL(nuStones, 3);
+    BOOST_CHECK(! GoBoardUtil::SelfAtari(bitBd, Pt(8, 1))); // ko
+    BOOST_CHECK(! GoBoardUtil::SelfAtari(bitBd, Pt(1, 9))); // capture 2
+    board.SetToPlay(SG_WHITE);
+    bd.Init(board);
+    bitBd.Init(board);
+    BOOST_CHECK_NO_THROW(GoUctBitBoardUtil::CheckEqual(bitBd, bd));
+    BOOST_CHECK(! GoBoardUtil::SelfAtari(bitBd, Pt(1, 1))); // ko
+    BOOST_CHECK(! GoBoardUtil::SelfAtari(bitBd, Pt(4, 5))); // ko
+    BOOST_CHECK(GoBoardUtil::SelfAtari(bitBd, Pt(7, 5), nuStones));
+    BOOST_CHECK_EQUAL(nuStones, 2);
+    BOOST_CHECK(GoBoardUtil::SelfAtari(bitBd, Pt(7, 7), nuStones));
+    BOOST_CHECK_EQUAL(nuStones, 2); // recapture situation
+}
+
+/** Test that the liberties are iterated in increasing order and merged
+    without duplicates. */
+BOOST_AUTO_TEST_CASE(GoUctBitBoardTest_Liberties)
+{
+    GoBoard board(9);
+    GoUctBitBoard bd(board);
+    bd.Play(Pt(3, 3));
+    bd.Play(Pt(9, 9));
+    bd.Play(Pt(5, 3));
+    bd.Play(Pt(9, 8));
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(3, 3)), 4);
+    bd.Play(Pt(4, 3));
+    BOOST_CHECK_EQUAL(bd.NumStones(Pt(3, 3)), 3);
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(3, 3)), 8);
+    BOOST_CHECK(bd.AreInSameBlock(Pt(3, 3), Pt(5, 3)));
+    SgPoint last = 0;
+    int n = 0;
+    for (GoUctBitBoard::LibertyIterator it(bd, Pt(4, 3)); it; ++it)
+    {
+        BOOST_CHECK(*it > last);
+        BOOST_CHECK(bd.IsEmpty(*it));
+        last = *it;
+        ++n;
+    }
+    BOOST_CHECK_EQUAL(n, 8);
+    BOOST_CHECK_EQUAL(bd.NumLiberties(Pt(9, 9)), 3);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
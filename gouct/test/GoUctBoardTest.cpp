@@ -5,8 +5,11 @@
 
 #include "SgSystem.h"
 
+#include <vector>
 #include <boost/test/auto_unit_test.hpp>
+#include "GoPattern3x3.h"
 #include "GoUctBoard.h"
+#include "SgRandom.h"
 
 using SgPointUtil::Pt;
 
@@ -14,6 +17,141 @@ using SgPointUtil::Pt;
 
 namespace {
 
+/** Check the incremental pattern codes against GoPattern3x3. */
+void CheckPatternCodes(const GoUctBoard& bd)
+{
+    for (GoUctBoard::Iterator it(bd); it; ++it)
+    {
+        const SgPoint p = *it;
+        if (bd.Line(p) > 1)
+            BOOST_REQUIRE_EQUAL(bd.CodeOf8Neighbors(p),
+                                GoPattern3x3::CodeOf8Neighbors(bd, p));
+        else if (bd.Pos(p) > 1)
+            BOOST_REQUIRE_EQUAL(bd.CodeOfEdgeNeighbors(p),
+                                GoPattern3x3::CodeOfEdgeNeighbors(bd, p));
+    }
+}
+
+/** Play random games and check the pattern codes after each move.
+    The games do not fill single point eyes, such that they contain many
+    captures. */
+void CheckPatternCodesRandomGames(int size)
+{
+    SgRandom random;
+    GoBoard board(size);
+    GoUctBoard bd(board);
+    BOOST_REQUIRE(bd.PatternCodes());
+    GoSetup setup;
+    int nuCaptures = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        bd.Init(board);
+        CheckPatternCodes(bd);
+        for (int j = 0; j < 3 * size * size; ++j)
+        {
+            std::vector<SgPoint> moves;
+            for (GoUctBoard::Iterator it(bd); it; ++it)
+                if (bd.IsEmpty(*it) && bd.IsLegal(*it)
+                    && ! GoBoardUtil::IsCompletelySurrounded(bd, *it))
+                    moves.push_back(*it);
+            if (moves.empty())
+                break;
+            bd.Play(moves[random.Int(moves.size())]);
+            if (bd.CapturingMove())
+                ++nuCaptures;
+            CheckPatternCodes(bd);
+            // Remember a position in the middle of the first game to test
+            // Init() from a position with stones
+            if (i == 0 && j == size * size / 2)
+                for (GoUctBoard::Iterator it(bd); it; ++it)
+                {
+                    if (bd.IsColor(*it, SG_BLACK))
+                        setup.AddBlack(*it);
+                    else if (bd.IsColor(*it, SG_WHITE))
+                        setup.AddWhite(*it);
+                }
+        }
+        if (i == 0)
+            board.Init(size, setup);
+    }
+    BOOST_CHECK(nuCaptures > 0);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_PatternCodes)
+{
+    CheckPatternCodesRandomGames(9);
+    CheckPatternCodesRandomGames(19);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_SetPatternCodes)
+{
+    GoBoard board(9);
+    GoUctBoard bd(board);
+    bd.SetPatternCodes(false);
+    BOOST_CHECK(! bd.PatternCodes());
+    bd.Play(Pt(3, 3));
+    bd.Play(Pt(1, 4));
+    bd.SetPatternCodes(true);
+    BOOST_CHECK(bd.PatternCodes());
+    CheckPatternCodes(bd);
+    bd.Play(Pt(4, 3));
+    CheckPatternCodes(bd);
+}
+
+/** Check GoUctBoard::LowLibBlock() against a scan of the board. */
+void CheckLowLibBlocks(const GoUctBoard& bd)
+{
+    for (SgBWIterator it; it; ++it)
+        for (int nuLib = 1; nuLib <= 2; ++nuLib)
+        {
+            const SgBlackWhite c = *it;
+            int n = 0;
+            for (GoUctBoard::Iterator it2(bd); it2; ++it2)
+                if (bd.IsColor(*it2, c) && bd.Anchor(*it2) == *it2
+                    && bd.NumLiberties(*it2) == nuLib)
+                    ++n;
+            BOOST_REQUIRE_EQUAL(bd.NumLowLibBlocks(c, nuLib), n);
+            for (int i = 0; i < n; ++i)
+            {
+                const SgPoint anchor = bd.LowLibBlock(c, nuLib, i);
+                BOOST_REQUIRE(bd.IsColor(anchor, c));
+                BOOST_REQUIRE_EQUAL(bd.Anchor(anchor), anchor);
+                BOOST_REQUIRE_EQUAL(bd.NumLiberties(anchor), nuLib);
+            }
+        }
+}
+
+/** Check the lists of blocks with one and two liberties in random games
+    and after restoring a snapshot. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_LowLibBlocks)
+{
+    SgRandom random;
+    GoBoard board(9);
+    GoUctBoard bd(board);
+    int nuAtari = 0;
+    for (int i = 0; i < 5; ++i)
+    {
+        bd.Init(board);
+        bd.TakeSnapshot();
+        for (int j = 0; j < 200; ++j)
+        {
+            std::vector<SgPoint> moves;
+            for (GoUctBoard::Iterator it(bd); it; ++it)
+                if (bd.IsEmpty(*it) && bd.IsLegal(*it)
+                    && ! GoBoardUtil::IsCompletelySurrounded(bd, *it))
+                    moves.push_back(*it);
+            if (moves.empty())
+                break;
+            bd.Play(moves[random.Int(moves.size())]);
+            CheckLowLibBlocks(bd);
+            nuAtari += bd.NumLowLibBlocks(bd.ToPlay(), 1);
+        }
+        bd.RestoreSnapshot();
+        CheckLowLibBlocks(bd);
+    }
+    BOOST_CHECK(nuAtari > 0);
+}
+
 /** Copied and adapted from GoBoardTest_GetLastMove.
     Parts removed that use Undo() */
 BOOST_AUTO_TEST_CASE(GoUctBoardTest_GetLastMove)
@@ -50,6 +188,60 @@ BOOST_AUTO_TEST_CASE(GoUctBoardTest_IsLibertyOfBlock)
     BOOST_CHECK(! bd.IsLibertyOfBlock(Pt(2, 3), bd.Anchor(Pt(1, 2))));
 }
 
+/** Check that RestoreSnapshot() restores the position after random games
+    with captures. */
+BOOST_AUTO_TEST_CASE(GoUctBoardTest_RestoreSnapshot)
+{
+    SgRandom random;
+    GoBoard board(9);
+    GoUctBoard bd(board);
+    for (int i = 0; i < 30; ++i)
+    {
+        std::vector<SgPoint> moves;
+        for (GoUctBoard::Iterator it(bd); it; ++it)
+            if (bd.IsEmpty(*it) && bd.IsLegal(*it))
+                moves.push_back(*it);
+        SgPoint p = moves[random.Int(moves.size())];
+        bd.Play(p);
+        board.Play(p);
+    }
+    GoUctBoard expected(board);
+    bd.TakeSnapshot();
+    for (int i = 0; i < 5; ++i)
+    {
+        for (int j = 0; j < 100; ++j)
+        {
+            std::vector<SgPoint> moves;
+            for (GoUctBoard::Iterator it(bd); it; ++it)
+                if (bd.IsEmpty(*it) && bd.IsLegal(*it)
+                    && ! GoBoardUtil::IsCompletelySurrounded(bd, *it))
+                    moves.push_back(*it);
+            if (moves.empty())
+                break;
+            bd.Play(moves[random.Int(moves.size())]);
+        }
+        bd.RestoreSnapshot();
+        BOOST_CHECK_EQUAL(bd.ToPlay(), expected.ToPlay());
+        BOOST_CHECK_EQUAL(bd.GetLastMove(), expected.GetLastMove());
+        for (GoUctBoard::Iterator it(bd); it; ++it)
+        {
+            const SgPoint p = *it;
+            BOOST_REQUIRE_EQUAL(bd.GetColor(p), expected.GetColor(p));
+            BOOST_REQUIRE_EQUAL(bd.NumEmptyNeighbors(p),
+                                expected.NumEmptyNeighbors(p));
+            if (bd.Occupied(p))
+            {
+                BOOST_REQUIRE_EQUAL(bd.NumStones(p), expected.NumStones(p));
+                BOOST_REQUIRE_EQUAL(bd.NumLiberties(p),
+                                    expected.NumLiberties(p));
+            }
+            else
+                BOOST_REQUIRE_EQUAL(bd.IsLegal(p), expected.IsLegal(p));
+        }
+        CheckPatternCodes(bd);
+    }
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
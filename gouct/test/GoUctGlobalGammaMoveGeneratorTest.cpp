@@ -0,0 +1,116 @@
+//----------------------------------------------------------------------------
+/** @file GoUctGlobalGammaMoveGeneratorTest.cpp
+    Unit tests for GoUctGlobalGammaMoveGenerator. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoUctBoard.h"
+#include "GoUctGlobalGammaMoveGenerator.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Check that the incrementally updated weights are equal to the weights
+    computed from scratch. */
+void CheckWeights(const GoUctGlobalGammaMoveGenerator<GoUctBoard>& generator,
+                  const GoUctBoard& bd)
+{
+    for (SgBWIterator it; it; ++it)
+    {
+        double total = 0;
+        for (GoUctBoard::Iterator it2(bd); it2; ++it2)
+        {
+            const double weight = generator.ComputeWeight(*it2, *it);
+            BOOST_REQUIRE_EQUAL(generator.Weight(*it2, *it), weight);
+            BOOST_REQUIRE_EQUAL(weight > 0, bd.IsEmpty(*it2));
+            total += weight;
+        }
+        BOOST_REQUIRE_CLOSE(generator.TotalWeight(*it), total, 1e-6);
+    }
+}
+
+/** Play games with the generator and check the weights after each move.
+    The games end with two passes when no move is left that fulfills
+    GoUctUtil::GeneratePoint(), so they contain many captures. */
+BOOST_AUTO_TEST_CASE(GoUctGlobalGammaMoveGeneratorTest_OnPlay)
+{
+    GoBoard board(9);
+    GoUctBoard bd(board);
+    GoUctPatterns<GoUctBoard>
+        patterns(bd, GoUctPatterns<GoUctBoard>::PATTERN_GLOBAL);
+    SgRandom random;
+    GoUctGlobalGammaMoveGenerator<GoUctBoard> generator(bd, patterns, random);
+    int nuCaptures = 0;
+    for (int i = 0; i < 3; ++i)
+    {
+        bd.Init(board);
+        generator.StartPlayout();
+        CheckWeights(generator, bd);
+        int nuPasses = 0;
+        while (nuPasses < 2)
+        {
+            SgPoint move = generator.Generate();
+            if (move == SG_NULLMOVE)
+            {
+                move = SG_PASS;
+                ++nuPasses;
+            }
+            else
+            {
+                BOOST_REQUIRE(GoUctUtil::GeneratePoint(bd, move, bd.ToPlay()));
+                nuPasses = 0;
+            }
+            bd.Play(move);
+            generator.OnPlay();
+            if (bd.CapturingMove())
+                ++nuCaptures;
+            CheckWeights(generator, bd);
+        }
+    }
+    BOOST_CHECK(nuCaptures > 0);
+}
+
+/** Test that a point with a high gamma value is selected more often. */
+BOOST_AUTO_TEST_CASE(GoUctGlobalGammaMoveGeneratorTest_Generate)
+{
+    GoSetup setup;
+    setup.AddBlack(Pt(3, 3));
+    setup.AddWhite(Pt(4, 4));
+    GoBoard board(9, setup);
+    GoUctBoard bd(board);
+    GoUctPatterns<GoUctBoard>
+        patterns(bd, GoUctPatterns<GoUctBoard>::PATTERN_GLOBAL);
+    SgRandom random;
+    GoUctGlobalGammaMoveGenerator<GoUctBoard> generator(bd, patterns, random);
+    generator.StartPlayout();
+    const SgBlackWhite toPlay = bd.ToPlay();
+    SgPoint best = SG_NULLMOVE;
+    for (GoUctBoard::Iterator it(bd); it; ++it)
+        if (  bd.IsEmpty(*it)
+           && (  best == SG_NULLMOVE
+              || generator.Weight(*it, toPlay)
+                 > generator.Weight(best, toPlay)
+              )
+           )
+            best = *it;
+    const double p = generator.Weight(best, toPlay)
+                     / generator.TotalWeight(toPlay);
+    const int n = 2000;
+    int count = 0;
+    for (int i = 0; i < n; ++i)
+        if (generator.Generate() == best)
+            ++count;
+    // The relative frequency should be close to the probability; the
+    // tolerance is more than 5 standard deviations
+    BOOST_CHECK_CLOSE_FRACTION(double(count) / n, p, 0.5);
+    CheckWeights(generator, bd);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,40 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutBenchmarkTest.cpp
+    Unit tests for GoUctPlayoutBenchmark. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoUctPlayoutBenchmark.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Test that the playouts are distributed between the threads and that
+    each generated move is counted in the move types. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutBenchmarkTest_Run)
+{
+    GoBoard bd(7);
+    GoUctPlayoutPolicyParam param;
+    GoUctPlayoutBenchmarkResult result =
+        GoUctPlayoutBenchmark::Run(bd, param, 5, 2, true);
+    BOOST_CHECK_EQUAL(result.m_nuThreads, 2);
+    BOOST_CHECK_EQUAL(result.m_nuPlayouts, 5u);
+    // A playout has at least two moves (two passes) and at most three
+    // times the number of points
+    BOOST_CHECK(result.m_nuMoves >= 2 * 5u);
+    BOOST_CHECK(result.m_nuMoves <= 3 * 7 * 7 * 5u);
+    std::size_t nuMoves = 0;
+    for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+        nuMoves += result.m_nuMoveType[i];
+    BOOST_CHECK_EQUAL(nuMoves, result.m_nuMoves);
+    BOOST_CHECK(result.m_nuMoveType[GOUCT_PASS] >= 2 * 5u);
+    BOOST_CHECK(result.MoveGenerationTime() >= 0);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
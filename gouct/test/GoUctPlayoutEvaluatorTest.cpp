@@ -0,0 +1,137 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutEvaluatorTest.cpp
+    Unit tests for GoUctPlayoutEvaluator. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <sstream>
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoGame.h"
+#include "GoUctPlayoutEvaluator.h"
+#include "SgException.h"
+
+using SgPointUtil::Pt;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Black owns the whole board with two eyes. */
+const std::string ALIVE_POSITION =
+    "5 w 0.5 X.XXXXXXXXXXXXXXXXXXXXX.X";
+
+/** Test the evaluation of a position that has only one outcome. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutEvaluatorTest_Evaluate)
+{
+    GoUctPlayoutPolicyParam param;
+    GoUctPlayoutEvaluator evaluator(param, 1);
+    GoGame game;
+    GoBoard bd;
+    float komi;
+    const GoBoard& position =
+        GoUctPlayoutEvaluator::ReadPosition(ALIVE_POSITION, game, bd, komi);
+    GoUctPlayoutEvaluation evaluation =
+        evaluator.Evaluate(position, komi, 10);
+    BOOST_CHECK_EQUAL(evaluation.m_nuPlayouts, 10u);
+    BOOST_CHECK_CLOSE(evaluation.m_blackWinRate, 1.f, 1e-3f);
+    BOOST_CHECK_CLOSE(evaluation.m_score, 24.5f, 1e-3f);
+    BOOST_CHECK_CLOSE(evaluation.m_ownership[Pt(1, 1)], 1.f, 1e-3f);
+    BOOST_CHECK_CLOSE(evaluation.m_ownership[Pt(4, 1)], 1.f, 1e-3f);
+    // The evaluator can be reused for positions of different sizes
+    GoBoard emptyBd(9);
+    evaluation = evaluator.Evaluate(emptyBd, 7.5f, 10);
+    BOOST_CHECK(evaluation.m_blackWinRate >= 0);
+    BOOST_CHECK(evaluation.m_blackWinRate <= 1);
+    BOOST_CHECK(evaluation.m_ownership[Pt(5, 5)] >= -1);
+    BOOST_CHECK(evaluation.m_ownership[Pt(5, 5)] <= 1);
+}
+
+/** Test that the results of EvaluateStream() are in the order of the input
+    and that empty lines and comments are skipped. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutEvaluatorTest_EvaluateStream)
+{
+    GoUctPlayoutPolicyParam param;
+    GoUctPlayoutEvaluator evaluator(param, 3);
+    std::istringstream in("# comment\n"
+                          + ALIVE_POSITION + "\n"
+                          "\n"
+                          "(;SZ[9]KM[6.5];B[ee];W[cc])\n"
+                          + ALIVE_POSITION + "\n"
+                          + ALIVE_POSITION + "\n");
+    std::ostringstream out;
+    BOOST_CHECK_EQUAL(evaluator.EvaluateStream(in, out, 5), 4u);
+    std::istringstream result(out.str());
+    std::string line;
+    const int lineNumbers[4] = { 2, 4, 5, 6 };
+    const int nuValues[4] = { 25, 81, 25, 25 };
+    for (int i = 0; i < 4; ++i)
+    {
+        BOOST_REQUIRE(std::getline(result, line));
+        std::istringstream values(line);
+        int lineNumber;
+        values >> lineNumber;
+        BOOST_CHECK_EQUAL(lineNumber, lineNumbers[i]);
+        float blackWinRate;
+        float score;
+        values >> blackWinRate >> score;
+        int n = 0;
+        float ownership;
+        while (values >> ownership)
+            ++n;
+        BOOST_CHECK_EQUAL(n, nuValues[i]);
+    }
+    BOOST_CHECK(! std::getline(result, line));
+}
+
+BOOST_AUTO_TEST_CASE(GoUctPlayoutEvaluatorTest_EvaluateStreamInvalid)
+{
+    GoUctPlayoutPolicyParam param;
+    GoUctPlayoutEvaluator evaluator(param, 2);
+    std::istringstream in(ALIVE_POSITION + "\n5 b 0.5 XXX\n");
+    std::ostringstream out;
+    BOOST_CHECK_THROW(evaluator.EvaluateStream(in, out, 5), SgException);
+}
+
+BOOST_AUTO_TEST_CASE(GoUctPlayoutEvaluatorTest_ReadPosition)
+{
+    GoGame game;
+    GoBoard bd;
+    float komi;
+    const GoBoard& position = GoUctPlayoutEvaluator::ReadPosition(
+                          "5 w 0.5 ..X....XO..XO...XO...O...", game, bd, komi);
+    BOOST_CHECK_EQUAL(&position, &bd);
+    BOOST_CHECK_EQUAL(bd.Size(), 5);
+    BOOST_CHECK_EQUAL(bd.ToPlay(), SG_WHITE);
+    BOOST_CHECK_CLOSE(komi, 0.5f, 1e-3f);
+    BOOST_CHECK_EQUAL(bd.GetColor(Pt(3, 5)), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.GetColor(Pt(3, 4)), SG_BLACK);
+    BOOST_CHECK_EQUAL(bd.GetColor(Pt(4, 4)), SG_WHITE);
+    BOOST_CHECK_EQUAL(bd.GetColor(Pt(2, 1)), SG_WHITE);
+    BOOST_CHECK_EQUAL(bd.TotalNumStones(SG_BLACK), 4);
+    BOOST_CHECK_EQUAL(bd.TotalNumStones(SG_WHITE), 4);
+
+    const GoBoard& sgfPosition = GoUctPlayoutEvaluator::ReadPosition(
+                          "(;SZ[9]KM[6.5];B[ee];W[cc])", game, bd, komi);
+    BOOST_CHECK_EQUAL(&sgfPosition, &game.Board());
+    BOOST_CHECK_EQUAL(sgfPosition.Size(), 9);
+    BOOST_CHECK_EQUAL(sgfPosition.ToPlay(), SG_BLACK);
+    BOOST_CHECK_CLOSE(komi, 6.5f, 1e-3f);
+    BOOST_CHECK_EQUAL(sgfPosition.GetColor(Pt(5, 5)), SG_BLACK);
+    BOOST_CHECK_EQUAL(sgfPosition.GetColor(Pt(3, 7)), SG_WHITE);
+
+    // Wrong number of points, invalid color, block without liberties
+    BOOST_CHECK_THROW(GoUctPlayoutEvaluator::ReadPosition(
+                          "5 b 0.5 XXX", game, bd, komi), SgException);
+    BOOST_CHECK_THROW(GoUctPlayoutEvaluator::ReadPosition(
+                          "5 x 0.5 ..X....XO..XO...XO...O...", game, bd,
+                          komi), SgException);
+    BOOST_CHECK_THROW(GoUctPlayoutEvaluator::ReadPosition(
+                          "5 b 0.5 XO...O...................", game, bd,
+                          komi), SgException);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
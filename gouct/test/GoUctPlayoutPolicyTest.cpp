@@ -0,0 +1,157 @@
+//----------------------------------------------------------------------------
+/** @file GoUctPlayoutPolicyTest.cpp
+    Unit tests for GoUctPlayoutPolicy. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "GoBoard.h"
+#include "GoSetupUtil.h"
+#include "GoUctBoard.h"
+#include "GoUctPlayoutPolicy.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+/** Play playouts with a policy.
+    @return The number of generated moves. */
+std::size_t PlayPlayouts(GoUctBoard& bd, const GoBoard& startBd,
+                         GoUctPlayoutPolicy<GoUctBoard>& policy,
+                         int nuPlayouts)
+{
+    const int maxLength = 3 * startBd.Size() * startBd.Size();
+    std::size_t nuMoves = 0;
+    for (int i = 0; i < nuPlayouts; ++i)
+    {
+        bd.Init(startBd);
+        policy.StartPlayout();
+        int nuPassMoves = 0;
+        for (int length = 0; length < maxLength; ++length)
+        {
+            SgPoint move = policy.GenerateMove();
+            BOOST_REQUIRE(bd.IsLegal(move));
+            bd.Play(move);
+            policy.OnPlay();
+            ++nuMoves;
+            if (move != SG_PASS)
+                nuPassMoves = 0;
+            else if (++nuPassMoves == 2)
+                break;
+        }
+        policy.EndPlayout();
+    }
+    return nuMoves;
+}
+
+/** Sum of a heuristic count over all phases. */
+uint64_t SumPhases(const GoUctPlayoutPolicyStat::HeuristicCounts& counts,
+                   GoUctPlayoutPolicyType type)
+{
+    uint64_t sum = 0;
+    for (int i = 0; i < _GOUCT_NU_PLAYOUT_PHASE; ++i)
+        sum += counts[i][type];
+    return sum;
+}
+
+/** Test the consistency of the heuristic statistics.
+    A heuristic has no more hits than calls, the random heuristic generates
+    at least the moves of its type, and without
+    GoUctPlayoutPolicyParam::m_skipRareHeuristics nothing is skipped. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutPolicyTest_HeuristicStatistics)
+{
+    GoBoard startBd(9);
+    GoUctBoard bd(startBd);
+    GoUctPlayoutPolicyParam param;
+    param.m_statisticsEnabled = true;
+    param.m_usePatternsInPlayout = false;
+    GoUctPlayoutPolicy<GoUctBoard> policy(bd, param);
+    std::size_t nuMoves = PlayPlayouts(bd, startBd, policy, 20);
+    std::size_t nuStatMoves = 0;
+    for (SgBWIterator it; it; ++it)
+    {
+        const GoUctPlayoutPolicyStat& stat = policy.Statistics(*it);
+        nuStatMoves += stat.m_nuMoves;
+        for (int i = 0; i < _GOUCT_NU_DEFAULT_PLAYOUT_TYPE; ++i)
+        {
+            GoUctPlayoutPolicyType type =
+                static_cast<GoUctPlayoutPolicyType>(i);
+            BOOST_CHECK(SumPhases(stat.m_nuHits, type)
+                        <= SumPhases(stat.m_nuTries, type));
+            BOOST_CHECK_EQUAL(SumPhases(stat.m_nuSkipped, type), 0u);
+        }
+        BOOST_CHECK(SumPhases(stat.m_nuTries, GOUCT_ATARI_CAPTURE) > 0);
+        BOOST_CHECK(SumPhases(stat.m_nuTries, GOUCT_PATTERN)
+                    >= stat.m_nuMoveType[GOUCT_PATTERN]);
+        // The move type can be changed by the move corrections
+        BOOST_CHECK(SumPhases(stat.m_nuHits, GOUCT_RANDOM)
+                    >= stat.m_nuMoveType[GOUCT_RANDOM]);
+        BOOST_CHECK(stat.m_nuTries[GOUCT_PHASE_OPENING][GOUCT_RANDOM] > 0);
+        BOOST_CHECK(stat.m_nuTries[GOUCT_PHASE_ENDGAME][GOUCT_RANDOM] > 0);
+    }
+    BOOST_CHECK_EQUAL(nuStatMoves, nuMoves);
+}
+
+/** Test that GoUctPlayoutPolicyParam::m_skipRareHeuristics skips the
+    heuristics below the hit rate but still samples them. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutPolicyTest_SkipRareHeuristics)
+{
+    GoBoard startBd(9);
+    GoUctBoard bd(startBd);
+    GoUctPlayoutPolicyParam param;
+    param.m_statisticsEnabled = true;
+    param.m_useNakadeHeuristic = true;
+    param.m_skipRareHeuristics = true;
+    // Every heuristic that does not always generate a move is rare
+    param.m_skipHitRate = 1.f;
+    GoUctPlayoutPolicy<GoUctBoard> policy(bd, param);
+    PlayPlayouts(bd, startBd, policy, 200);
+    uint64_t nuSkipped = 0;
+    uint64_t nuTries = 0;
+    for (SgBWIterator it; it; ++it)
+    {
+        const GoUctPlayoutPolicyStat& stat = policy.Statistics(*it);
+        nuSkipped += SumPhases(stat.m_nuSkipped, GOUCT_NAKADE);
+        nuTries += SumPhases(stat.m_nuTries, GOUCT_NAKADE);
+        // The fallback heuristics are never skipped
+        BOOST_CHECK_EQUAL(SumPhases(stat.m_nuSkipped, GOUCT_CAPTURE), 0u);
+        BOOST_CHECK_EQUAL(SumPhases(stat.m_nuSkipped, GOUCT_RANDOM), 0u);
+    }
+    BOOST_CHECK(nuSkipped > 0);
+    // After the minimum number of tries, the heuristic is still tried in
+    // some of the skipped calls
+    BOOST_CHECK(nuTries > 1000);
+    BOOST_CHECK(nuTries < nuSkipped);
+}
+
+/** Test that the capture heuristic generates a liberty shared by two blocks
+    in atari only once. */
+BOOST_AUTO_TEST_CASE(GoUctPlayoutPolicyTest_CaptureSharedLiberty)
+{
+    std::string s(".........\n"
+                  ".........\n"
+                  ".........\n"
+                  "...X.X...\n"
+                  "..XO.OX..\n"
+                  "...X.X...\n"
+                  ".........\n"
+                  ".........\n"
+                  ".........");
+    int boardSize;
+    GoSetup setup = GoSetupUtil::CreateSetupFromString(s, boardSize);
+    setup.m_player = SG_BLACK;
+    GoBoard startBd(boardSize, setup);
+    GoUctBoard bd(startBd);
+    GoUctPlayoutPolicyParam param;
+    GoUctPlayoutPolicy<GoUctBoard> policy(bd, param);
+    policy.StartPlayout();
+    BOOST_CHECK_EQUAL(policy.GenerateMove(), SgPointUtil::Pt(5, 5));
+    BOOST_CHECK_EQUAL(policy.MoveType(), GOUCT_CAPTURE);
+    BOOST_CHECK_EQUAL(policy.GetEquivalentBestMoves().Length(), 1);
+    policy.EndPlayout();
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,265 @@
+//----------------------------------------------------------------------------
+/** @file SgBitboard.h
+    Set of points stored as bits in machine words. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_BITBOARD_H
+#define SG_BITBOARD_H
+
+#include <stdint.h>
+#include "SgPoint.h"
+
+//----------------------------------------------------------------------------
+
+/** Set of points stored as one bit per point in 64-bit words.
+    Unlike SgPointSet, which is based on std::bitset and iterates by testing
+    every bit, this class is meant for the inner loops of the playouts: the
+    union of two sets and the number of elements need one operation per
+    word, and the iteration skips to the next element with a bit scan.
+    The elements must be in the range [0..SG_MAXPOINT - 1]. */
+class SgBitboard
+{
+public:
+    /** Number of words needed for SG_MAXPOINT bits. */
+    static const int NU_WORDS = (SG_MAXPOINT + 63) / 64;
+
+    /** Constructor; the set is empty. */
+    SgBitboard();
+
+    SgBitboard& operator|=(const SgBitboard& other);
+
+    SgBitboard& operator&=(const SgBitboard& other);
+
+    bool operator==(const SgBitboard& other) const;
+
+    bool operator!=(const SgBitboard& other) const;
+
+    void Clear();
+
+    bool Contains(SgPoint p) const;
+
+    void Exclude(SgPoint p);
+
+    void Include(SgPoint p);
+
+    bool IsEmpty() const;
+
+    /** Number of elements. */
+    int Size() const;
+
+    /** Number of elements of the intersection with another set. */
+    int SizeOfIntersection(const SgBitboard& other) const;
+
+    /** Smallest element.
+        Requires: ! IsEmpty() */
+    SgPoint First() const;
+
+    /** Iterate through the elements in increasing order.
+        The set must not be modified during the iteration. */
+    class Iterator
+    {
+    public:
+        Iterator(const SgBitboard& set);
+
+        /** Advance the state of the iteration to the next element. */
+        void operator++();
+
+        /** Return the value of the current element. */
+        SgPoint operator*() const;
+
+        /** Return true if iteration is valid, otherwise false. */
+        operator bool() const;
+
+    private:
+        const SgBitboard& m_set;
+
+        /** Index of the current word. */
+        int m_index;
+
+        /** The bits of the current word that were not visited yet,
+            including the current element. */
+        uint64_t m_word;
+
+        void FindNext();
+
+        /** Not implemented.
+            Prevent unintended usage of operator bool() as an int. */
+        operator int() const;
+    };
+
+    /** Number of bits set in a word. */
+    static int PopCount(uint64_t word);
+
+    /** Index of the lowest bit set in a word.
+        Requires: word != 0 */
+    static int LowestBit(uint64_t word);
+
+private:
+    uint64_t m_word[NU_WORDS];
+
+    static int WordIndex(SgPoint p);
+
+    static uint64_t Mask(SgPoint p);
+};
+
+inline SgBitboard::SgBitboard()
+{
+    Clear();
+}
+
+inline SgBitboard& SgBitboard::operator|=(const SgBitboard& other)
+{
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_word[i] |= other.m_word[i];
+    return *this;
+}
+
+inline SgBitboard& SgBitboard::operator&=(const SgBitboard& other)
+{
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_word[i] &= other.m_word[i];
+    return *this;
+}
+
+inline bool SgBitboard::operator==(const SgBitboard& other) const
+{
+    for (int i = 0; i < NU_WORDS; ++i)
+        if (m_word[i] != other.m_word[i])
+            return false;
+    return true;
+}
+
+inline bool SgBitboard::operator!=(const SgBitboard& other) const
+{
+    return ! operator==(other);
+}
+
+inline void SgBitboard::Clear()
+{
+    for (int i = 0; i < NU_WORDS; ++i)
+        m_word[i] = 0;
+}
+
+inline bool SgBitboard::Contains(SgPoint p) const
+{
+    return (m_word[WordIndex(p)] & Mask(p)) != 0;
+}
+
+inline void SgBitboard::Exclude(SgPoint p)
+{
+    m_word[WordIndex(p)] &= ~Mask(p);
+}
+
+inline SgPoint SgBitboard::First() const
+{
+    for (int i = 0; i < NU_WORDS; ++i)
+        if (m_word[i] != 0)
+            return 64 * i + LowestBit(m_word[i]);
+    SG_ASSERT(false);
+    return SG_NULLPOINT;
+}
+
+inline void SgBitboard::Include(SgPoint p)
+{
+    m_word[WordIndex(p)] |= Mask(p);
+}
+
+inline bool SgBitboard::IsEmpty() const
+{
+    for (int i = 0; i < NU_WORDS; ++i)
+        if (m_word[i] != 0)
+            return false;
+    return true;
+}
+
+inline int SgBitboard::LowestBit(uint64_t word)
+{
+    SG_ASSERT(word != 0);
+#ifdef __GNUC__
+    return __builtin_ctzll(word);
+#else
+    int n = 0;
+    while ((word & 1) == 0)
+    {
+        word >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline uint64_t SgBitboard::Mask(SgPoint p)
+{
+    return uint64_t(1) << (p % 64);
+}
+
+inline int SgBitboard::PopCount(uint64_t word)
+{
+#ifdef __GNUC__
+    return __builtin_popcountll(word);
+#else
+    int n = 0;
+    for ( ; word != 0; word &= word - 1)
+        ++n;
+    return n;
+#endif
+}
+
+inline int SgBitboard::Size() const
+{
+    int n = 0;
+    for (int i = 0; i < NU_WORDS; ++i)
+        n += PopCount(m_word[i]);
+    return n;
+}
+
+inline int SgBitboard::SizeOfIntersection(const SgBitboard& other) const
+{
+    int n = 0;
+    for (int i = 0; i < NU_WORDS; ++i)
+        n += PopCount(m_word[i] & other.m_word[i]);
+    return n;
+}
+
+inline int SgBitboard::WordIndex(SgPoint p)
+{
+    SG_ASSERT(p >= 0);
+    SG_ASSERT(p < SG_MAXPOINT);
+    return p / 64;
+}
+
+inline SgBitboard::Iterator::Iterator(const SgBitboard& set)
+    : m_set(set),
+      m_index(0),
+      m_word(set.m_word[0])
+{
+    FindNext();
+}
+
+inline void SgBitboard::Iterator::FindNext()
+{
+    while (m_word == 0 && ++m_index < NU_WORDS)
+        m_word = m_set.m_word[m_index];
+}
+
+inline void SgBitboard::Iterator::operator++()
+{
+    SG_ASSERT(m_word != 0);
+    m_word &= m_word - 1;
+    FindNext();
+}
+
+inline SgPoint SgBitboard::Iterator::operator*() const
+{
+    SG_ASSERT(m_word != 0);
+    return 64 * m_index + LowestBit(m_word);
+}
+
+inline SgBitboard::Iterator::operator bool() const
+{
+    return m_index < NU_WORDS;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_BITBOARD_H
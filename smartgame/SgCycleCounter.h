@@ -0,0 +1,58 @@
+//----------------------------------------------------------------------------
+/** @file SgCycleCounter.h
+    Low-overhead counter for profiling short code sections. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_CYCLECOUNTER_H
+#define SG_CYCLECOUNTER_H
+
+#include <stdint.h>
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define SG_CYCLECOUNTER_TSC 1
+#else
+#include <boost/date_time/posix_time/posix_time.hpp>
+#define SG_CYCLECOUNTER_TSC 0
+#endif
+
+//----------------------------------------------------------------------------
+
+/** Counter for profiling.
+    Uses the time stamp counter of the processor on x86 with GCC-compatible
+    compilers, which can be read in a few nanoseconds and does not require a
+    system call. On other platforms, it falls back to the real time in
+    microseconds, which has a much lower resolution and higher overhead.
+    The unit of the counter is therefore not specified; only ratios of
+    differences between counter values are meaningful. The counter is not
+    synchronized between processors on all systems, so differences should
+    only be taken between values read in the same thread. */
+namespace SgCycleCounter
+{
+    /** Get the current value of the counter. */
+    uint64_t Get();
+
+    /** Is the counter the processor's time stamp counter?
+        Otherwise it counts microseconds. */
+    bool IsCycleCounter();
+}
+
+inline uint64_t SgCycleCounter::Get()
+{
+#if SG_CYCLECOUNTER_TSC
+    return __rdtsc();
+#else
+    using namespace boost::posix_time;
+    static const ptime start = microsec_clock::universal_time();
+    time_duration diff = microsec_clock::universal_time() - start;
+    return static_cast<uint64_t>(diff.total_microseconds());
+#endif
+}
+
+inline bool SgCycleCounter::IsCycleCounter()
+{
+    return SG_CYCLECOUNTER_TSC;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_CYCLECOUNTER_H
@@ -0,0 +1,133 @@
+//----------------------------------------------------------------------------
+/** @file SgFenwickTree.h
+    Sum tree for sampling indices with probability proportional to a
+    weight. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_FENWICKTREE_H
+#define SG_FENWICKTREE_H
+
+#include "SgArray.h"
+
+//----------------------------------------------------------------------------
+
+/** Fenwick tree (binary indexed tree) of non-negative weights.
+    Changing a weight and finding the index for a given prefix sum take
+    O(log SIZE), so a random index can be selected with probability
+    proportional to its weight without scanning all weights (see Find()).
+    The weights are stored as double to keep the rounding errors of the
+    incremental updates small; clients that update the weights for a long
+    time should call Clear() and set the weights again from time to time. */
+template<int SIZE>
+class SgFenwickTree
+{
+public:
+    SgFenwickTree();
+
+    /** Set all weights to zero. */
+    void Clear();
+
+    /** The weight of an index. */
+    double Get(int i) const;
+
+    /** Change the weight of an index.
+        Requires: 0 <= i < SIZE, weight >= 0 */
+    void Set(int i, double weight);
+
+    /** Sum of the weights of the indices 0..i. */
+    double PrefixSum(int i) const;
+
+    /** Sum of all weights. */
+    double Total() const;
+
+    /** Find the smallest index, such that PrefixSum(index) > x.
+        If x is a uniformly distributed random number in [0, Total()), the
+        probability for returning an index is proportional to its weight.
+        Because of rounding errors, the weight of the returned index can be
+        zero in rare cases, if x is very close to a prefix sum or to
+        Total(); clients should check this and select again.
+        Requires: x >= 0 */
+    int Find(double x) const;
+
+private:
+    /** Largest power of two not greater than SIZE. */
+    int m_topStep;
+
+    SgArray<double,SIZE> m_weight;
+
+    /** The tree with 1-based indices. m_tree[i] contains the sum of the
+        weights of the indices i - (i & -i) .. i - 1. */
+    SgArray<double,SIZE + 1> m_tree;
+};
+
+template<int SIZE>
+SgFenwickTree<SIZE>::SgFenwickTree()
+{
+    m_topStep = 1;
+    while (2 * m_topStep <= SIZE)
+        m_topStep *= 2;
+    Clear();
+}
+
+template<int SIZE>
+void SgFenwickTree<SIZE>::Clear()
+{
+    m_weight.Fill(0);
+    m_tree.Fill(0);
+}
+
+template<int SIZE>
+int SgFenwickTree<SIZE>::Find(double x) const
+{
+    SG_ASSERT(x >= 0);
+    int pos = 0;
+    for (int step = m_topStep; step > 0; step /= 2)
+        if (pos + step <= SIZE && m_tree[pos + step] <= x)
+        {
+            pos += step;
+            x -= m_tree[pos];
+        }
+    // pos == SIZE only if x >= Total() (or rounding errors)
+    return pos < SIZE ? pos : SIZE - 1;
+}
+
+template<int SIZE>
+inline double SgFenwickTree<SIZE>::Get(int i) const
+{
+    return m_weight[i];
+}
+
+template<int SIZE>
+double SgFenwickTree<SIZE>::PrefixSum(int i) const
+{
+    SG_ASSERT(i >= 0);
+    SG_ASSERT(i < SIZE);
+    double sum = 0;
+    for (++i; i > 0; i -= (i & -i))
+        sum += m_tree[i];
+    return sum;
+}
+
+template<int SIZE>
+inline void SgFenwickTree<SIZE>::Set(int i, double weight)
+{
+    SG_ASSERT(i >= 0);
+    SG_ASSERT(i < SIZE);
+    SG_ASSERT(weight >= 0);
+    const double delta = weight - m_weight[i];
+    if (delta == 0)
+        return;
+    m_weight[i] = weight;
+    for (++i; i <= SIZE; i += (i & -i))
+        m_tree[i] += delta;
+}
+
+template<int SIZE>
+inline double SgFenwickTree<SIZE>::Total() const
+{
+    return PrefixSum(SIZE - 1);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_FENWICKTREE_H
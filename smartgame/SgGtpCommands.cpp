@@ -39,6 +39,31 @@ SgTimeMode TimeModeArg(const GtpCommand& cmd, size_t number)
     throw GtpFailure() << "unknown time mode argument \"" << arg << '"';
 }
 
+SgRandomGenerator RandomGeneratorArg(const GtpCommand& cmd, size_t number)
+{
+    string arg = cmd.ArgToLower(number);
+    if (arg == "mt19937")
+        return SG_RANDOM_MT19937;
+    if (arg == "xoshiro128")
+        return SG_RANDOM_XOSHIRO128;
+    throw GtpFailure() << "unknown random generator argument \"" << arg
+                       << '"';
+}
+
+string RandomGeneratorToString(SgRandomGenerator generator)
+{
+    switch (generator)
+    {
+    case SG_RANDOM_MT19937:
+        return "mt19937";
+    case SG_RANDOM_XOSHIRO128:
+        return "xoshiro128";
+    default:
+        SG_ASSERT(false);
+        return "?";
+    }
+}
+
 string TimeModeToString(SgTimeMode mode)
 {
     switch (mode)
@@ -205,6 +230,7 @@ void SgGtpCommands::CmdGetRandomSeed(GtpCommand& cmd)
 
 /** Set global parameters used in module SmartGame.
     Parameters:
+    @arg @c random_generator mt19937|xoshiro128 See SgRandom::SetGenerator
     @arg @c time_mode cpu|real See SgTime */
 void SgGtpCommands::CmdParam(GtpCommand& cmd)
 {
@@ -213,13 +239,17 @@ void SgGtpCommands::CmdParam(GtpCommand& cmd)
     {
         // Boolean parameters first for better layout of GoGui parameter
         // dialog, alphabetically otherwise
-        cmd << "[list/cpu/real] time_mode "
+        cmd << "[list/mt19937/xoshiro128] random_generator "
+            << RandomGeneratorToString(SgRandom::Generator()) << '\n'
+            << "[list/cpu/real] time_mode "
             << TimeModeToString(SgTime::DefaultMode()) << '\n';
     }
     else if (cmd.NuArg() >= 1 && cmd.NuArg() <= 2)
     {
         string name = cmd.Arg(0);
-        if (name == "time_mode")
+        if (name == "random_generator")
+            SgRandom::SetGenerator(RandomGeneratorArg(cmd, 1));
+        else if (name == "time_mode")
             SgTime::SetDefaultMode(TimeModeArg(cmd, 1));
         else
             throw GtpFailure() << "unknown parameter: " << name;
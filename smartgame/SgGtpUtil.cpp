@@ -69,6 +69,35 @@ SgUctMoveSelect SgGtpUtil::MoveSelectArg(const GtpCommand& cmd, size_t number)
     throw GtpFailure() << "unknown move select argument \"" << arg << '"';
 }
 
+SgUctMemoryMode SgGtpUtil::MemoryModeArg(const GtpCommand& cmd,
+                                         size_t number)
+{
+    std::string arg = cmd.ArgToLower(number);
+    if (arg == "default")
+        return SG_UCTMEMORY_DEFAULT;
+    if (arg == "huge_pages")
+        return SG_UCTMEMORY_HUGEPAGES;
+    if (arg == "hugetlb")
+        return SG_UCTMEMORY_HUGETLB;
+    throw GtpFailure() << "unknown memory mode argument \"" << arg << '"';
+}
+
+std::string SgGtpUtil::MemoryModeToString(SgUctMemoryMode mode)
+{
+    switch (mode)
+    {
+        case SG_UCTMEMORY_DEFAULT:
+            return "default";
+        case SG_UCTMEMORY_HUGEPAGES:
+            return "huge_pages";
+        case SG_UCTMEMORY_HUGETLB:
+            return "hugetlb";
+        default:
+            SG_ASSERT(false);
+            return "?";
+    }
+}
+
 std::string SgGtpUtil::MoveSelectToString(SgUctMoveSelect moveSelect)
 {
     switch (moveSelect)
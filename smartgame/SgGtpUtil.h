@@ -114,6 +114,10 @@ namespace SgGtpUtil
     
     std::string MoveSelectToString(SgUctMoveSelect moveSelect);
 
+    SgUctMemoryMode MemoryModeArg(const GtpCommand& cmd, size_t number);
+
+    std::string MemoryModeToString(SgUctMemoryMode mode);
+
 } // namespace SgGtpUtil
 
 //----------------------------------------------------------------------------
@@ -14,14 +14,39 @@
 //#include <boost/date_time/date.hpp>
 //----------------------------------------------------------------------------
 
+SgXoshiro128::SgXoshiro128(uint64_t seed)
+{
+    Seed(seed);
+}
+
+void SgXoshiro128::Seed(uint64_t seed)
+{
+    // SplitMix64
+    for (int i = 0; i < 4; i += 2)
+    {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        z ^= z >> 31;
+        m_state[i] = static_cast<uint32_t>(z);
+        m_state[i + 1] = static_cast<uint32_t>(z >> 32);
+    }
+}
+
+//----------------------------------------------------------------------------
+
 SgRandom::GlobalData::GlobalData()
 {
     m_seed = 0;
+    m_generatorType = SG_RANDOM_MT19937;
 }
 
 //----------------------------------------------------------------------------
 
-SgRandom::SgRandom() : m_floatGenerator(m_generator)
+SgRandom::SgRandom()
+    : m_floatGenerator(m_generator),
+      m_generatorType(GetGlobalData().m_generatorType),
+      m_bufferIndex(BUFFER_SIZE)
 {
     SetSeed();
     GetGlobalData().m_allGenerators.push_back(this);
@@ -38,17 +63,43 @@ SgRandom::GlobalData& SgRandom::GetGlobalData()
     return s_data;
 }
 
+void SgRandom::FillBuffer()
+{
+    for (int i = 0; i < BUFFER_SIZE; ++i)
+        m_buffer[i] = m_xoshiro();
+    m_bufferIndex = 0;
+}
+
+SgRandomGenerator SgRandom::Generator()
+{
+    return GetGlobalData().m_generatorType;
+}
+
 int SgRandom::Seed()
 {
     return GetGlobalData().m_seed;
 }
 
+void SgRandom::SetGenerator(SgRandomGenerator generator)
+{
+    GetGlobalData().m_generatorType = generator;
+    for (std::list<SgRandom*>::iterator it =
+             GetGlobalData().m_allGenerators.begin();
+         it != GetGlobalData().m_allGenerators.end(); ++it)
+    {
+        (*it)->m_generatorType = generator;
+        (*it)->SetSeed();
+    }
+}
+
 void SgRandom::SetSeed()
 {
+    m_bufferIndex = BUFFER_SIZE;
     boost::mt19937::result_type seed = GetGlobalData().m_seed;
     if (seed == 0)
         return;
     m_generator.seed(seed);
+    m_xoshiro.Seed(seed);
 }
 
 void SgRandom::SetGlobalRandomSeed()
@@ -8,16 +8,79 @@
 
 #include <algorithm>
 #include <list>
+#include <stdint.h>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/uniform_01.hpp>
 
 //----------------------------------------------------------------------------
 
+/** Algorithm used by SgRandom.
+    @see SgRandom::SetGenerator() */
+enum SgRandomGenerator
+{
+    /** Mersenne Twister boost::mt19937.
+        Reproduces the random sequences of previous versions for a given
+        seed. */
+    SG_RANDOM_MT19937,
+
+    /** xoshiro128** by Blackman and Vigna.
+        Has a state of only 16 bytes and needs a few shifts and rotations per
+        number. The numbers are generated in batches into a buffer of the
+        SgRandom instance. Integers in an interval are generated with
+        Lemire's multiply-shift method with rejection, which has no modulo
+        bias and avoids a division in the common case. */
+    SG_RANDOM_XOSHIRO128
+};
+
+//----------------------------------------------------------------------------
+
+/** The xoshiro128** random number generator.
+    See David Blackman, Sebastiano Vigna: Scrambled Linear Pseudorandom
+    Number Generators. ACM Transactions on Mathematical Software 47, 2021.
+    The state is initialized from the seed with SplitMix64, as recommended
+    by the authors. */
+class SgXoshiro128
+{
+public:
+    explicit SgXoshiro128(uint64_t seed = 5489u);
+
+    void Seed(uint64_t seed);
+
+    uint32_t operator()();
+
+private:
+    uint32_t m_state[4];
+
+    static uint32_t Rotl(uint32_t x, int k);
+};
+
+inline uint32_t SgXoshiro128::operator()()
+{
+    const uint32_t result = Rotl(m_state[1] * 5, 7) * 9;
+    const uint32_t t = m_state[1] << 9;
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = Rotl(m_state[3], 11);
+    return result;
+}
+
+inline uint32_t SgXoshiro128::Rotl(uint32_t x, int k)
+{
+    return (x << k) | (x >> (32 - k));
+}
+
+//----------------------------------------------------------------------------
+
 /** Random number generator.
-    Uses a Mersenne Twister, because this is faster than std::rand() and
-    game playing programs usually need faster random numbers more than
-    high quality ones. All random generators are internally registered to
-    make it possible to change the random seed for all of them.
+    Uses a Mersenne Twister by default, because this is faster than
+    std::rand() and game playing programs usually need faster random numbers
+    more than high quality ones. The faster xoshiro128** generator can be
+    selected with SetGenerator(). All random generators are internally
+    registered to make it possible to change the random seed and the
+    algorithm for all of them.
 
     SgRandom is thread-safe (w.r.t. different instances) after construction
     (the constructor is not thread-safe, because it uses a global variable
@@ -41,6 +104,16 @@ public:
         See SetSeed(int) for the special meaning of zero and negative values. */
     static int Seed();
 
+    /** Set the algorithm for all existing and future instances of SgRandom.
+        Re-seeds all existing instances if a seed is set (see
+        SetSeed(int)), such that a given seed produces the same random
+        sequences for a given algorithm.
+        Default is SG_RANDOM_MT19937.
+        @note This function is not thread-safe. */
+    static void SetGenerator(SgRandomGenerator generator);
+
+    static SgRandomGenerator Generator();
+
     /** Generate a float number in [0,range). */
     float Float(float range);
 
@@ -54,6 +127,8 @@ public:
     unsigned int Int();
 
     /** Get a random integer in an interval.
+        Uses a modulo operation with SG_RANDOM_MT19937 and the unbiased
+        method of SG_RANDOM_XOSHIRO128.
         @param range The upper limit of the interval (exclusive)
         @pre range > 0
         @pre range <= SgRandom::Max()
@@ -64,8 +139,9 @@ public:
     std::size_t Int(std::size_t range);
     
     /** Get a small random integer in an interval.
-        Uses only the lower 16 bits. Faster than SgRandom::Int(int) because it
-        avoids the expensive modulo operation.
+        Uses only the lower 16 bits with SG_RANDOM_MT19937. Faster than
+        SgRandom::Int(int) because it avoids the expensive modulo operation.
+        With SG_RANDOM_XOSHIRO128, equivalent to SgRandom::Int(int).
         @param range The upper limit of the interval (exclusive)
         @pre range > 0
         @pre range <= (1 << 16)
@@ -90,12 +166,17 @@ public:
     bool RandomEvent(unsigned int threshold);
 
 private:
+    /** Number of numbers generated at once by SG_RANDOM_XOSHIRO128. */
+    static const int BUFFER_SIZE = 64;
+
     struct GlobalData
     {
         /** The random seed.
             Zero means not to set a random seed. */
         boost::mt19937::result_type m_seed;
 
+        SgRandomGenerator m_generatorType;
+
         std::list<SgRandom*> m_allGenerators;
 
         GlobalData();
@@ -116,18 +197,38 @@ private:
 	*/
     boost::uniform_01<boost::mt19937, float> m_floatGenerator;
 
+    /** Copy of the global algorithm for fast access. */
+    SgRandomGenerator m_generatorType;
+
+    SgXoshiro128 m_xoshiro;
+
+    /** Numbers generated by m_xoshiro. */
+    uint32_t m_buffer[BUFFER_SIZE];
+
+    /** Index of the next unused number in m_buffer. */
+    int m_bufferIndex;
+
+    void FillBuffer();
+
     void SetSeed();
+
     static void SetGlobalRandomSeed();
+
+    /** Unbiased integer in [0..range - 1] for SG_RANDOM_XOSHIRO128. */
+    uint32_t UnbiasedInt(uint32_t range);
 };
 
 inline float SgRandom::Float_01()
 {
-    return m_floatGenerator();
+    if (m_generatorType == SG_RANDOM_MT19937)
+        return m_floatGenerator();
+    // Use the upper 24 bits, which are exactly representable in a float
+    return float(Int() >> 8) * (1.f / 16777216.f);
 }
 
 inline float SgRandom::Float(float range)
 {
-    float v = m_floatGenerator() * range;
+    float v = Float_01() * range;
     SG_ASSERT(v <= range); 
     // @todo: should be < range? Worried about rounding issues.
     return v;
@@ -135,14 +236,22 @@ inline float SgRandom::Float(float range)
 
 inline unsigned int SgRandom::Int()
 {
-    return m_generator();
+    if (m_generatorType == SG_RANDOM_MT19937)
+        return m_generator();
+    if (m_bufferIndex == BUFFER_SIZE)
+        FillBuffer();
+    return m_buffer[m_bufferIndex++];
 }
 
 inline int SgRandom::Int(int range)
 {
     SG_ASSERT(range > 0);
     SG_ASSERT(static_cast<unsigned int>(range) <= SgRandom::Max());
-    int i = Int() % range;
+    int i;
+    if (m_generatorType == SG_RANDOM_MT19937)
+        i = Int() % range;
+    else
+        i = static_cast<int>(UnbiasedInt(static_cast<uint32_t>(range)));
     SG_ASSERTRANGE(i, 0, range - 1);
     return i;
 }
@@ -150,7 +259,11 @@ inline int SgRandom::Int(int range)
 inline std::size_t SgRandom::Int(std::size_t range)
 {
     SG_ASSERT(range <= SgRandom::Max());
-    std::size_t i = Int() % range;
+    std::size_t i;
+    if (m_generatorType == SG_RANDOM_MT19937)
+        i = Int() % range;
+    else
+        i = UnbiasedInt(static_cast<uint32_t>(range));
     SG_ASSERT(i < range);
     return i;
 }
@@ -162,7 +275,7 @@ inline unsigned int SgRandom::Max()
 
 inline unsigned int SgRandom::PercentageThreshold(int percentage)
 {
-    return (m_generator.max() / 100) * percentage;
+    return (Max() / 100) * percentage;
 }
 
 inline bool SgRandom::RandomEvent(unsigned int threshold)
@@ -179,6 +292,8 @@ inline int SgRandom::SmallInt(int range)
 {
     SG_ASSERT(range > 0);
     SG_ASSERT(range <= (1 << 16));
+    if (m_generatorType != SG_RANDOM_MT19937)
+        return Int(range);
     int i = ((Int() & 0xffff) * range) >> 16;
     SG_ASSERTRANGE(i, 0, range - 1);
     return i;
@@ -187,9 +302,34 @@ inline int SgRandom::SmallInt(int range)
 inline std::size_t SgRandom::SmallInt(std::size_t range)
 {
     SG_ASSERT(range <= (1 << 16));
+    if (m_generatorType != SG_RANDOM_MT19937)
+        return Int(range);
     std::size_t i = ((Int() & 0xffff) * range) >> 16;
     SG_ASSERT(i < range);
     return i;
 }
 
+/** See D. Lemire: Fast Random Integer Generation in an Interval.
+    ACM Transactions on Modeling and Computer Simulation 29, 2019.
+    The upper 32 bits of the 64-bit product of a random number and the
+    range are uniform in [0..range - 1] after rejecting the products whose
+    lower 32 bits are below 2^32 mod range. The modulo is only computed if
+    the lower bits are below range, which is rare for small ranges. */
+inline uint32_t SgRandom::UnbiasedInt(uint32_t range)
+{
+    SG_ASSERT(range > 0);
+    uint64_t m = uint64_t(Int()) * uint64_t(range);
+    uint32_t low = static_cast<uint32_t>(m);
+    if (low < range)
+    {
+        const uint32_t threshold = (0u - range) % range;
+        while (low < threshold)
+        {
+            m = uint64_t(Int()) * uint64_t(range);
+            low = static_cast<uint32_t>(m);
+        }
+    }
+    return static_cast<uint32_t>(m >> 32);
+}
+
 #endif // SG_RANDOM_H
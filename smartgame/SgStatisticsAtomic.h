@@ -0,0 +1,252 @@
+//----------------------------------------------------------------------------
+/** @file SgStatisticsAtomic.h
+    Version of SgStatisticsBase for concurrent use without locks.
+    Replaces the volatile member variables of SgStatisticsVltBase by atomic
+    variables with explicit memory ordering, so that the assumptions made by
+    SgUctSearch in lock-free mode (see @ref sguctsearchlockfree) are
+    guaranteed by the language instead of by the x86 memory model. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_STATISTICSATOMIC_H
+#define SG_STATISTICSATOMIC_H
+
+#include <iostream>
+#include <limits>
+#include <boost/atomic.hpp>
+#include "SgException.h"
+
+//----------------------------------------------------------------------------
+
+/** Computes the mean of a statistical variable that is shared between
+    threads.
+    The mean is always written before the count (release store) and the
+    count is read before the mean (acquire load), so a reader that sees a
+    count greater zero also sees a valid mean. Updates are not
+    read-modify-write operations; concurrent updates can still be lost with
+    a small probability, as described in @ref sguctsearchlockfreevalues.
+    Loads and stores of lock-free atomics compile to plain moves on IA-32 and
+    Intel-64, so there is no overhead compared to SgStatisticsVltBase on these
+    platforms.
+    @see SgStatisticsBase */
+template<typename VALUE, typename COUNT>
+class SgStatisticsAtomicBase
+{
+public:
+    SgStatisticsAtomicBase();
+
+    /** Create statistics initialized with values.
+        Note that value must be initialized to 0 if count is 0.
+        Equivalent to creating a statistics and calling @c count times
+        Add(val) */
+    SgStatisticsAtomicBase(VALUE val, COUNT count);
+
+    /** Copy constructor.
+        Not an atomic snapshot of the other statistics. Only used for
+        copying nodes that are not concurrently accessed. */
+    SgStatisticsAtomicBase(const SgStatisticsAtomicBase& statistics);
+
+    /** See copy constructor. */
+    SgStatisticsAtomicBase& operator=(const SgStatisticsAtomicBase& statistics);
+
+    void Add(VALUE val);
+
+    void Remove(VALUE val);
+
+    /** Add a value n times */
+    void Add(VALUE val, COUNT n);
+
+    /** Remove a value n times. */
+    void Remove(VALUE val, COUNT n);
+
+    void Clear();
+
+    COUNT Count() const;
+
+    /** Initialize with values.
+        Equivalent to calling Clear() and calling @c count times
+        Add(val) */
+    void Initialize(VALUE val, COUNT count);
+
+    /** Check if the mean value is defined.
+        The mean value is defined, if the count if greater than zero. The
+        result of this function is equivalent to <tt>Count() > 0</tt>, for
+        integer count types and <tt>Count() > epsilon()</tt> for floating
+        point count types. */
+    bool IsDefined() const;
+
+    VALUE Mean() const;
+
+    /** Write in human readable format. */
+    void Write(std::ostream& out) const;
+
+    /** Save in a compact platform-independent text format.
+        The data is written in a single line, without trailing newline. */
+    void SaveAsText(std::ostream& out) const;
+
+    /** Load from text format.
+        See SaveAsText() */
+    void LoadFromText(std::istream& in);
+
+private:
+    boost::atomic<COUNT> m_count;
+
+    boost::atomic<VALUE> m_mean;
+
+    void Set(VALUE mean, COUNT count);
+};
+
+template<typename VALUE, typename COUNT>
+inline SgStatisticsAtomicBase<VALUE,COUNT>::SgStatisticsAtomicBase()
+    : m_count(0),
+      m_mean(0)
+{ }
+
+template<typename VALUE, typename COUNT>
+inline SgStatisticsAtomicBase<VALUE,COUNT>::SgStatisticsAtomicBase(VALUE val,
+                                                                   COUNT count)
+    : m_count(count),
+      m_mean(val)
+{ }
+
+template<typename VALUE, typename COUNT>
+inline SgStatisticsAtomicBase<VALUE,COUNT>::SgStatisticsAtomicBase(
+                                 const SgStatisticsAtomicBase& statistics)
+    : m_count(statistics.m_count.load(boost::memory_order_acquire)),
+      m_mean(statistics.m_mean.load(boost::memory_order_relaxed))
+{ }
+
+template<typename VALUE, typename COUNT>
+inline SgStatisticsAtomicBase<VALUE,COUNT>&
+SgStatisticsAtomicBase<VALUE,COUNT>::operator=(
+                                 const SgStatisticsAtomicBase& statistics)
+{
+    COUNT count = statistics.m_count.load(boost::memory_order_acquire);
+    Set(statistics.m_mean.load(boost::memory_order_relaxed), count);
+    return *this;
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::Add(VALUE val)
+{
+    COUNT count = m_count.load(boost::memory_order_relaxed);
+    ++count;
+    SG_ASSERT(! std::numeric_limits<COUNT>::is_exact
+              || count > 0); // overflow
+    VALUE mean = m_mean.load(boost::memory_order_relaxed);
+    val -= mean;
+    Set(mean + val / VALUE(count), count);
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::Remove(VALUE val)
+{
+    COUNT count = m_count.load(boost::memory_order_relaxed);
+    if (count > 1)
+    {
+        --count;
+        VALUE mean = m_mean.load(boost::memory_order_relaxed);
+        Set(mean + (mean - val) / VALUE(count), count);
+    }
+    else
+        Clear();
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::Remove(VALUE val, COUNT n)
+{
+    COUNT count = m_count.load(boost::memory_order_relaxed);
+    if (count > n)
+    {
+        count -= n;
+        VALUE mean = m_mean.load(boost::memory_order_relaxed);
+        Set(mean + VALUE(n) * (mean - val) / VALUE(count), count);
+    }
+    else
+        Clear();
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::Add(VALUE val, COUNT n)
+{
+    COUNT count = m_count.load(boost::memory_order_relaxed);
+    count += n;
+    SG_ASSERT(! std::numeric_limits<COUNT>::is_exact
+              || count > 0); // overflow
+    VALUE mean = m_mean.load(boost::memory_order_relaxed);
+    val -= mean;
+    Set(mean + VALUE(n) * val / VALUE(count), count);
+}
+
+template<typename VALUE, typename COUNT>
+inline void SgStatisticsAtomicBase<VALUE,COUNT>::Clear()
+{
+    m_count.store(0, boost::memory_order_relaxed);
+    m_mean.store(0, boost::memory_order_relaxed);
+}
+
+template<typename VALUE, typename COUNT>
+inline COUNT SgStatisticsAtomicBase<VALUE,COUNT>::Count() const
+{
+    return m_count.load(boost::memory_order_acquire);
+}
+
+template<typename VALUE, typename COUNT>
+inline void SgStatisticsAtomicBase<VALUE,COUNT>::Initialize(VALUE val,
+                                                            COUNT count)
+{
+    SG_ASSERT(count > 0);
+    Set(val, count);
+}
+
+template<typename VALUE, typename COUNT>
+inline bool SgStatisticsAtomicBase<VALUE,COUNT>::IsDefined() const
+{
+    if (std::numeric_limits<COUNT>::is_exact)
+        return Count() > 0;
+    else
+        return Count() > std::numeric_limits<COUNT>::epsilon();
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::LoadFromText(std::istream& in)
+{
+    COUNT count;
+    VALUE mean;
+    in >> count >> mean;
+    Set(mean, count);
+}
+
+template<typename VALUE, typename COUNT>
+inline VALUE SgStatisticsAtomicBase<VALUE,COUNT>::Mean() const
+{
+    SG_ASSERT(IsDefined());
+    return m_mean.load(boost::memory_order_relaxed);
+}
+
+/** Write order dependency: the mean must be visible to other threads before
+    the count. */
+template<typename VALUE, typename COUNT>
+inline void SgStatisticsAtomicBase<VALUE,COUNT>::Set(VALUE mean, COUNT count)
+{
+    m_mean.store(mean, boost::memory_order_relaxed);
+    m_count.store(count, boost::memory_order_release);
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::Write(std::ostream& out) const
+{
+    if (IsDefined())
+        out << Mean();
+    else
+        out << '-';
+}
+
+template<typename VALUE, typename COUNT>
+void SgStatisticsAtomicBase<VALUE,COUNT>::SaveAsText(std::ostream& out) const
+{
+    out << Count() << ' ' << m_mean.load(boost::memory_order_relaxed);
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_STATISTICSATOMIC_H
@@ -0,0 +1,92 @@
+//----------------------------------------------------------------------------
+/** @file SgUctPhaseProfile.cpp
+    See SgUctPhaseProfile.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "SgUctPhaseProfile.h"
+
+#include <iomanip>
+#include <iostream>
+#include <boost/io/ios_state.hpp>
+#include <boost/static_assert.hpp>
+#include "SgWrite.h"
+
+using namespace std;
+using boost::io::ios_all_saver;
+
+//----------------------------------------------------------------------------
+
+const char* SgUctSearchPhaseStr(SgUctSearchPhase phase)
+{
+    BOOST_STATIC_ASSERT(_SG_UCTPHASE_NU == 8);
+    switch (phase)
+    {
+    case SG_UCTPHASE_SELECT:
+        return "Select";
+    case SG_UCTPHASE_EXPAND:
+        return "Expand";
+    case SG_UCTPHASE_KNOWLEDGE:
+        return "Knowledge";
+    case SG_UCTPHASE_PLAYOUT:
+        return "Playout";
+    case SG_UCTPHASE_EVALUATE:
+        return "Evaluate";
+    case SG_UCTPHASE_UPDATE:
+        return "Update";
+    case SG_UCTPHASE_LOCK:
+        return "Lock";
+    case SG_UCTPHASE_OTHER:
+        return "Other";
+    default:
+        return "?";
+    }
+}
+
+//----------------------------------------------------------------------------
+
+SgUctPhaseProfile::SgUctPhaseProfile()
+{
+    Clear();
+}
+
+void SgUctPhaseProfile::Add(const SgUctPhaseProfile& profile)
+{
+    for (int i = 0; i < _SG_UCTPHASE_NU; ++i)
+    {
+        m_cycles[i] += profile.m_cycles[i];
+        m_count[i] += profile.m_count[i];
+    }
+}
+
+void SgUctPhaseProfile::Clear()
+{
+    m_phase = SG_UCTPHASE_OTHER;
+    m_start = 0;
+    m_cycles.assign(0);
+    m_count.assign(0);
+}
+
+uint64_t SgUctPhaseProfile::TotalCycles() const
+{
+    uint64_t total = 0;
+    for (int i = 0; i < _SG_UCTPHASE_NU; ++i)
+        total += m_cycles[i];
+    return total;
+}
+
+void SgUctPhaseProfile::Write(ostream& out) const
+{
+    ios_all_saver saver(out);
+    const uint64_t total = TotalCycles();
+    for (int i = 0; i < _SG_UCTPHASE_NU; ++i)
+    {
+        SgUctSearchPhase phase = static_cast<SgUctSearchPhase>(i);
+        out << SgWriteLabel(SgUctSearchPhaseStr(phase))
+            << fixed << setprecision(1) << right << setw(5)
+            << (total > 0 ? 100.0 * double(m_cycles[i]) / double(total) : 0)
+            << "% " << m_cycles[i] << " (" << m_count[i] << ")\n";
+    }
+}
+
+//----------------------------------------------------------------------------
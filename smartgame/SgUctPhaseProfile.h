@@ -0,0 +1,144 @@
+//----------------------------------------------------------------------------
+/** @file SgUctPhaseProfile.h
+    Class SgUctPhaseProfile and enum SgUctSearchPhase. */
+//----------------------------------------------------------------------------
+
+#ifndef SG_UCTPHASEPROFILE_H
+#define SG_UCTPHASEPROFILE_H
+
+#include <iosfwd>
+#include <stdint.h>
+#include <boost/array.hpp>
+#include "SgCycleCounter.h"
+
+//----------------------------------------------------------------------------
+
+/** Phases of the search measured by SgUctPhaseProfile.
+    @see SgUctSearch::ProfilePhases()
+    @ingroup sguctgroup */
+enum SgUctSearchPhase
+{
+    /** Selection of the children in the tree, including executing the moves
+        and the updates from transposed nodes. */
+    SG_UCTPHASE_SELECT,
+
+    /** Generation of the moves of a node without children and creation of
+        the children. */
+    SG_UCTPHASE_EXPAND,
+
+    /** Computation of knowledge at the knowledge thresholds, and sending
+        requests to and adding results of the knowledge threads (see
+        SgUctSearch::AsyncKnowledgeThreads()). */
+    SG_UCTPHASE_KNOWLEDGE,
+
+    /** Generation and execution of playout moves. */
+    SG_UCTPHASE_PLAYOUT,
+
+    /** SgUctThreadState::Evaluate() */
+    SG_UCTPHASE_EVALUATE,
+
+    /** Update of the move values, RAVE values and statistics after a
+        game. */
+    SG_UCTPHASE_UPDATE,
+
+    /** Waiting for the global lock of the search (only if
+        SgUctSearch::LockFree() is false). */
+    SG_UCTPHASE_LOCK,
+
+    /** Everything else, e.g. checking for the abort of the search. */
+    SG_UCTPHASE_OTHER,
+
+    _SG_UCTPHASE_NU
+};
+
+const char* SgUctSearchPhaseStr(SgUctSearchPhase phase);
+
+//----------------------------------------------------------------------------
+
+/** Counts the cycles spent in the phases of the search.
+    Each thread of the search measures its phases with its own instance,
+    which is not thread-safe. The time between two calls of SwitchPhase()
+    is added to the phase that was current since the first call. This needs
+    only one read of SgCycleCounter per phase change.
+    @ingroup sguctgroup */
+class SgUctPhaseProfile
+{
+public:
+    SgUctPhaseProfile();
+
+    void Clear();
+
+    /** Start measuring a phase.
+        Does not add the time since the last call of SwitchPhase(). */
+    void Start(SgUctSearchPhase phase);
+
+    /** Add the cycles since the last phase change to the current phase and
+        continue measuring another phase. */
+    void SwitchPhase(SgUctSearchPhase phase);
+
+    /** Add the cycles and counts of another profile, e.g. of another
+        thread. */
+    void Add(const SgUctPhaseProfile& profile);
+
+    /** The phase that is currently measured. */
+    SgUctSearchPhase Phase() const;
+
+    /** The number of cycles spent in a phase. */
+    uint64_t Cycles(SgUctSearchPhase phase) const;
+
+    /** How often a phase was measured. */
+    uint64_t Count(SgUctSearchPhase phase) const;
+
+    /** The sum of the cycles of all phases. */
+    uint64_t TotalCycles() const;
+
+    /** Write the percentage, cycles and count of each phase, one line per
+        phase. */
+    void Write(std::ostream& out) const;
+
+private:
+    SgUctSearchPhase m_phase;
+
+    uint64_t m_start;
+
+    boost::array<uint64_t,_SG_UCTPHASE_NU> m_cycles;
+
+    boost::array<uint64_t,_SG_UCTPHASE_NU> m_count;
+};
+
+inline uint64_t SgUctPhaseProfile::Count(SgUctSearchPhase phase) const
+{
+    return m_count[phase];
+}
+
+inline uint64_t SgUctPhaseProfile::Cycles(SgUctSearchPhase phase) const
+{
+    return m_cycles[phase];
+}
+
+inline SgUctSearchPhase SgUctPhaseProfile::Phase() const
+{
+    return m_phase;
+}
+
+inline void SgUctPhaseProfile::Start(SgUctSearchPhase phase)
+{
+    m_phase = phase;
+    m_start = SgCycleCounter::Get();
+}
+
+inline void SgUctPhaseProfile::SwitchPhase(SgUctSearchPhase phase)
+{
+    const uint64_t now = SgCycleCounter::Get();
+    // The time stamp counter can go back if the thread is moved to another
+    // processor
+    if (now > m_start)
+        m_cycles[m_phase] += now - m_start;
+    ++m_count[m_phase];
+    m_phase = phase;
+    m_start = now;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_UCTPHASEPROFILE_H
@@ -15,10 +15,9 @@
 #include "SgHashTable.h"
 #include "SgMath.h"
 #include "SgPlatform.h"
+#include "SgUctTreeUtil.h"
 #include "SgWrite.h"
 
-using boost::barrier;
-using boost::condition;
 using boost::format;
 using boost::mutex;
 using boost::shared_ptr;
@@ -34,23 +33,9 @@ namespace {
 
 const bool DEBUG_THREADS = false;
 
-/** Get a default value for lock-free mode.
-    Lock-free mode works only on IA-32/Intel-64 architectures or if the macro
-    ENABLE_CACHE_SYNC from Fuego's configure script is defined. The
-    architecture is determined by using the macro HOST_CPU from Fuego's
-    configure script. On Windows, an Intel architecture is always assumed. */
-bool GetLockFreeDefault()
-{
-#if defined(WIN32) || defined(ENABLE_CACHE_SYNC)
-    return true;
-#elif defined(HOST_CPU)
-    std::string hostCpu(HOST_CPU);
-    return hostCpu == "i386" || hostCpu == "i486" || hostCpu == "i586"
-        || hostCpu == "i686" || hostCpu == "x86_64";
-#else
-    return false;
-#endif
-}
+/** Maximum number of requests that a knowledge thread takes at a time.
+    See SgUctSearch::AsyncKnowledgeThreads() */
+const size_t KNOWLEDGE_BATCH_SIZE = 8;
 
 /** Get a default value for the tree size.
     The default value is that both trees used by SgUctSearch take no more than
@@ -78,12 +63,6 @@ size_t GetMaxNodesDefault()
     return nodesPerTree;
 }
 
-void Notify(mutex& aMutex, condition& aCondition)
-{
-    mutex::scoped_lock lock(aMutex);
-    aCondition.notify_all();
-}
-
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -91,6 +70,7 @@ void Notify(mutex& aMutex, condition& aCondition)
 void SgUctGameInfo::Clear(std::size_t numberPlayouts)
 {
     m_nodes.clear();
+    m_hashCodes.clear();
     m_inTreeSequence.clear();
     if (numberPlayouts != m_sequence.size())
     {
@@ -143,6 +123,11 @@ void SgUctThreadState::StartPlayouts()
     // Default implementation does nothing
 }
 
+SgHashCode SgUctThreadState::GetHashCode() const
+{
+    return SgHashCode();
+}
+
 //----------------------------------------------------------------------------
 
 SgUctThreadStateFactory::~SgUctThreadStateFactory()
@@ -163,19 +148,13 @@ SgUctSearch::Thread::Thread(SgUctSearch& search,
                             std::auto_ptr<SgUctThreadState> state)
     : m_state(state),
       m_search(search),
-      m_quit(false),
-      m_threadReady(2),
-      m_playFinishedLock(m_playFinishedMutex),
-      m_globalLock(search.m_globalMutex, boost::defer_lock),
+      m_epoch(search.m_searchEpoch),
       m_thread(Function(*this))
-{
-    m_threadReady.wait();
-}
+{ }
 
 SgUctSearch::Thread::~Thread()
 {
-    m_quit = true;
-    StartPlay();
+    SG_ASSERT(m_search.m_quitThreads);
     m_thread.join();
 }
 
@@ -184,29 +163,64 @@ void SgUctSearch::Thread::operator()()
     if (DEBUG_THREADS)
         SgDebug() << "SgUctSearch::Thread: starting thread "
                   << m_state->m_threadId << '\n';
-    mutex::scoped_lock lock(m_startPlayMutex);
-    m_threadReady.wait();
     while (true)
     {
-        m_startPlay.wait(lock);
-        if (m_quit)
+        bool quit;
+        m_epoch = m_search.WaitForSearchEpoch(m_epoch, quit);
+        if (quit)
             break;
-        m_search.SearchLoop(*m_state, &m_globalLock);
-        Notify(m_playFinishedMutex, m_playFinished);
+        m_search.SearchLoop(*m_state);
+        m_search.OnSearchLoopFinished();
     }
     if (DEBUG_THREADS)
         SgDebug() << "SgUctSearch::Thread: finishing thread "
                   << m_state->m_threadId << '\n';
 }
 
-void SgUctSearch::Thread::StartPlay()
+//----------------------------------------------------------------------------
+
+SgUctSearch::KnowledgeThread::Function::Function(KnowledgeThread& thread)
+    : m_thread(thread)
+{ }
+
+void SgUctSearch::KnowledgeThread::Function::operator()()
 {
-    Notify(m_startPlayMutex, m_startPlay);
+    m_thread();
 }
 
-void SgUctSearch::Thread::WaitPlayFinished()
+SgUctSearch::KnowledgeThread::KnowledgeThread(SgUctSearch& search,
+                                       std::auto_ptr<SgUctThreadState> state)
+    : m_state(state),
+      m_search(search),
+      m_thread(Function(*this))
+{ }
+
+SgUctSearch::KnowledgeThread::~KnowledgeThread()
 {
-    m_playFinished.wait(m_playFinishedLock);
+    SG_ASSERT(m_search.m_quitKnowledgeThreads);
+    m_thread.join();
+}
+
+void SgUctSearch::KnowledgeThread::operator()()
+{
+    if (DEBUG_THREADS)
+        SgDebug() << "SgUctSearch::KnowledgeThread: starting thread "
+                  << m_state->m_threadId << '\n';
+    unsigned int generation;
+    while (m_search.WaitForKnowledgeRequests(m_batch, generation))
+    {
+        const bool profilePhases = m_search.m_profilePhases;
+        if (profilePhases)
+            m_state->m_phaseProfile.Start(SG_UCTPHASE_KNOWLEDGE);
+        for (size_t i = 0; i < m_batch.size(); ++i)
+            m_search.ComputeKnowledge(*m_state, m_batch[i]);
+        if (profilePhases)
+            m_state->m_phaseProfile.SwitchPhase(SG_UCTPHASE_KNOWLEDGE);
+        m_search.FinishKnowledgeRequests(m_batch, generation);
+    }
+    if (DEBUG_THREADS)
+        SgDebug() << "SgUctSearch::KnowledgeThread: finishing thread "
+                  << m_state->m_threadId << '\n';
 }
 
 //----------------------------------------------------------------------------
@@ -215,10 +229,15 @@ void SgUctSearchStat::Clear()
 {
     m_time = 0;
     m_knowledge = 0;
+    m_knowledgeRequestsDropped = 0;
+    m_transpositions = 0;
+    m_transpositionGames = 0;
     m_gamesPerSecond = 0;
     m_gameLength.Clear();
     m_movesInTree.Clear();
     m_aborted.Clear();
+    m_phases.Clear();
+    m_knowledgeThreadPhases.Clear();
 }
 
 void SgUctSearchStat::Write(std::ostream& out) const
@@ -232,11 +251,35 @@ void SgUctSearchStat::Write(std::ostream& out) const
     m_movesInTree.Write(out);
     out << '\n'
         << SgWriteLabel("Aborted")
-        << static_cast<int>(100 * m_aborted.Mean()) << "%\n"
-        << SgWriteLabel("Games/s") << fixed << setprecision(1)
+        << static_cast<int>(100 * m_aborted.Mean()) << "%\n";
+    if (m_knowledgeRequestsDropped > 0)
+        out << SgWriteLabel("KnowDropped") << setprecision(0)
+            << m_knowledgeRequestsDropped << '\n';
+    if (m_transpositions > 0)
+        out << SgWriteLabel("Transpos") << setprecision(0)
+            << m_transpositions << " (" << m_transpositionGames
+            << " games)\n";
+    out << SgWriteLabel("Games/s") << fixed << setprecision(1)
         << m_gamesPerSecond << '\n';
 }
 
+void SgUctSearchStat::WritePhases(std::ostream& out) const
+{
+    if (m_phases.TotalCycles() == 0)
+    {
+        out << "No phase profile (see SgUctSearch::ProfilePhases())\n";
+        return;
+    }
+    out << "Counter: "
+        << (SgCycleCounter::IsCycleCounter() ? "cycles" : "microseconds")
+        << '\n';
+    m_phases.Write(out);
+    if (m_knowledgeThreadPhases.TotalCycles() > 0)
+        out << SgWriteLabel("KnowledgeThr")
+            << m_knowledgeThreadPhases.Cycles(SG_UCTPHASE_KNOWLEDGE) << " ("
+            << m_knowledgeThreadPhases.Count(SG_UCTPHASE_KNOWLEDGE) << ")\n";
+}
+
 //----------------------------------------------------------------------------
 
 SgUctSearch::SgUctSearch(SgUctThreadStateFactory* threadStateFactory,
@@ -246,12 +289,26 @@ SgUctSearch::SgUctSearch(SgUctThreadStateFactory* threadStateFactory,
       m_rave(false),
       m_knowledgeThreshold(),
       m_maxKnowledgeThreads(1024),
+      m_asyncKnowledgeThreads(0),
+      m_maxKnowledgeRequests(1000),
+      m_aborted(false),
+      m_isTreeOutOfMemory(false),
+      m_searchEpoch(0),
+      m_quitThreads(false),
+      m_nuRunningThreads(0),
+      m_nuKnowledgeResults(0),
+      m_knowledgeGeneration(0),
+      m_nuBusyKnowledgeThreads(0),
+      m_quitKnowledgeThreads(false),
       m_moveSelect(SG_UCTMOVESELECT_COUNT),
       m_raveCheckSame(false),
       m_randomizeRaveFrequency(20),
-      m_lockFree(GetLockFreeDefault()),
+      m_lockFree(true),
       m_weightRaveUpdates(true),
       m_pruneFullTree(true),
+      m_pruneInPlace(true),
+      m_transpositions(false),
+      m_profilePhases(false),
       m_checkFloatPrecision(true),
       m_numberThreads(1),
       m_numberPlayouts(1),
@@ -284,6 +341,51 @@ SgUctSearch::~SgUctSearch()
     DeleteThreads();
 }
 
+/** Add the finished knowledge requests to the tree.
+    See AsyncKnowledgeThreads() */
+void SgUctSearch::AddKnowledgeResults(SgUctThreadState& state)
+{
+    vector<SgUctKnowledgeRequest>& results = state.m_knowledgeResults;
+    {
+        mutex::scoped_lock lock(m_knowledgeMutex);
+        results.swap(m_knowledgeResults);
+        m_knowledgeResults.clear();
+        m_nuKnowledgeResults = 0;
+        // Terminal positions that are not proven stay in m_knowledgeNodes,
+        // such that they are not requested again
+        for (size_t i = 0; i < results.size(); ++i)
+            if (  results[i].m_count == 0
+               && (  ! results[i].m_moves.empty()
+                  || results[i].m_provenType != SG_NOT_PROVEN
+                  )
+               )
+                m_knowledgeNodes.erase(results[i].m_node);
+    }
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const SgUctKnowledgeRequest& result = results[i];
+        const SgUctNode& node = *result.m_node;
+        state.m_moves = result.m_moves;
+        if (result.m_count == 0)
+        {
+            if (result.m_provenType == SG_NOT_PROVEN
+                && ! state.m_moves.empty() && ! node.HasChildren())
+                ExpandNode(state, node);
+        }
+        else if (node.HasChildren())
+            CreateChildren(state, node, result.m_truncate);
+        if (result.m_provenType != SG_NOT_PROVEN)
+        {
+            m_tree.SetProvenType(node, result.m_provenType);
+            if (FindNodes(result.m_sequence, state.m_knowledgePath)
+                && state.m_knowledgePath.back() == &node)
+                PropagateProvenStatus(state.m_knowledgePath);
+        }
+        if (state.m_isTreeOutOfMem)
+            break;
+    }
+}
+
 void SgUctSearch::ApplyRootFilter(vector<SgUctMoveInfo>& moves)
 {
     // Filter without changing the order of the unfiltered moves
@@ -296,6 +398,27 @@ void SgUctSearch::ApplyRootFilter(vector<SgUctMoveInfo>& moves)
     moves = filteredMoves;
 }
 
+/** Find the nodes along a move sequence from the root.
+    @param sequence The moves
+    @param[out] nodes The root and the nodes of the moves
+    @return @c false, if a move of the sequence is not in the tree */
+bool SgUctSearch::FindNodes(const vector<SgMove>& sequence,
+                            vector<const SgUctNode*>& nodes) const
+{
+    nodes.clear();
+    const SgUctNode* current = &m_tree.Root();
+    nodes.push_back(current);
+    for (size_t i = 0; i < sequence.size(); ++i)
+    {
+        current = SgUctTreeUtil::FindChildWithMove(m_tree, *current,
+                                                   sequence[i]);
+        if (current == 0)
+            return false;
+        nodes.push_back(current);
+    }
+    return true;
+}
+
 SgUctValue SgUctSearch::GamesPlayed() const
 {
     return m_tree.Root().MoveCount() - m_startRootMoveCount;
@@ -429,8 +552,50 @@ void SgUctSearch::CreateThreads()
     }
     m_tree.CreateAllocators(m_numberThreads);
     m_tree.SetMaxNodes(m_maxNodes);
+}
+
+/** Compute the knowledge for a request in a knowledge thread.
+    @param state The thread state of the knowledge thread
+    @param request The request */
+void SgUctSearch::ComputeKnowledge(SgUctThreadState& state,
+                                   SgUctKnowledgeRequest& request)
+{
+    state.GameStart();
+    const vector<SgMove>& sequence = request.m_sequence;
+    for (size_t i = 0; i < sequence.size(); ++i)
+        state.Execute(sequence[i]);
+    request.m_moves.clear();
+    request.m_provenType = SG_NOT_PROVEN;
+    request.m_truncate = state.GenerateAllMoves(request.m_count,
+                                                request.m_moves,
+                                                request.m_provenType);
+    if (sequence.empty())
+        ApplyRootFilter(request.m_moves);
+    if (  request.m_count == 0
+       && request.m_moves.empty()
+       && request.m_provenType == SG_NOT_PROVEN
+       )
+    {
+        // Terminal position, handled like in PlayGame()
+        SgUctValue eval = state.Evaluate();
+        if (eval > 0.6)
+            request.m_provenType = SG_PROVEN_WIN;
+        else if (eval < 0.4)
+            request.m_provenType = SG_PROVEN_LOSS;
+    }
+    state.TakeBackInTree(sequence.size());
+}
 
-    m_searchLoopFinished.reset(new barrier(m_numberThreads));
+void SgUctSearch::CreateKnowledgeThreads()
+{
+    DeleteKnowledgeThreads();
+    for (unsigned int i = 0; i < m_asyncKnowledgeThreads; ++i)
+    {
+        std::auto_ptr<SgUctThreadState>
+        state(m_threadStateFactory->Create(m_numberThreads + i, *this));
+        shared_ptr<KnowledgeThread> thread(new KnowledgeThread(*this, state));
+        m_knowledgeThreads.push_back(thread);
+    }
 }
 
 /** Write a debugging line of text from within a thread.
@@ -452,16 +617,70 @@ void SgUctSearch::Debug(const SgUctThreadState& state,
         SgDebug() << (format("%1%\n") % textLine);
 }
 
+/** Continue measuring another phase of the game in a thread.
+    Does nothing if ProfilePhases() is disabled. */
+inline void SgUctSearch::SwitchPhase(SgUctThreadState& state,
+                                     SgUctSearchPhase phase)
+{
+    if (m_profilePhases)
+        state.m_phaseProfile.SwitchPhase(phase);
+}
+
+void SgUctSearch::DeleteKnowledgeThreads()
+{
+    if (m_knowledgeThreads.empty())
+        return;
+    {
+        mutex::scoped_lock lock(m_knowledgeMutex);
+        m_quitKnowledgeThreads = true;
+        m_knowledgeRequestAdded.notify_all();
+    }
+    m_knowledgeThreads.clear();
+    m_quitKnowledgeThreads = false;
+    DiscardKnowledgeRequests();
+}
+
 void SgUctSearch::DeleteThreads()
 {
+    DeleteKnowledgeThreads();
+    if (m_threads.empty())
+        return;
+    {
+        mutex::scoped_lock lock(m_epochMutex);
+        m_quitThreads = true;
+        ++m_searchEpoch;
+        m_epochChanged.notify_all();
+    }
     m_threads.clear();
+    m_quitThreads = false;
+}
+
+/** Discard all pending and finished knowledge requests.
+    Must be called if the nodes of the requests can become invalid (e.g.
+    at the end of a search or before pruning the tree). Requests that are
+    currently computed in a knowledge thread are discarded when they are
+    finished. */
+void SgUctSearch::DiscardKnowledgeRequests()
+{
+    mutex::scoped_lock lock(m_knowledgeMutex);
+    m_knowledgeRequests.clear();
+    m_knowledgeResults.clear();
+    m_nuKnowledgeResults = 0;
+    m_knowledgeNodes.clear();
+    ++m_knowledgeGeneration;
 }
 
 /** Expand a node.
+    Does nothing if the node was expanded by another thread while waiting
+    for the lock in LockIfNotLockFree().
     @param state The thread state with state.m_moves already computed.
     @param node The node to expand. */
 void SgUctSearch::ExpandNode(SgUctThreadState& state, const SgUctNode& node)
 {
+    GlobalLock lock(m_globalMutex, boost::defer_lock);
+    LockIfNotLockFree(state, lock);
+    if (lock.owns_lock() && node.HasChildren())
+        return;
     unsigned int threadId = state.m_threadId;
     if (! m_tree.HasCapacity(threadId, state.m_moves.size()))
     {
@@ -469,12 +688,32 @@ void SgUctSearch::ExpandNode(SgUctThreadState& state, const SgUctNode& node)
                          % m_tree.MaxNodes()));
         state.m_isTreeOutOfMem = true;
         m_isTreeOutOfMemory = true;
-        SgSynchronizeThreadMemory();
         return;
     }
     m_tree.CreateChildren(threadId, node, state.m_moves);
 }
 
+/** Called by a knowledge thread after computing a batch of requests.
+    @param batch The computed requests
+    @param generation The value of m_knowledgeGeneration when the requests
+    were taken from the queue. The results are discarded, if it has
+    changed. */
+void SgUctSearch::FinishKnowledgeRequests(
+                                     vector<SgUctKnowledgeRequest>& batch,
+                                     unsigned int generation)
+{
+    mutex::scoped_lock lock(m_knowledgeMutex);
+    if (generation == m_knowledgeGeneration)
+    {
+        m_knowledgeResults.insert(m_knowledgeResults.end(), batch.begin(),
+                                  batch.end());
+        m_nuKnowledgeResults = m_knowledgeResults.size();
+    }
+    batch.clear();
+    if (--m_nuBusyKnowledgeThreads == 0)
+        m_knowledgeThreadsIdle.notify_all();
+}
+
 const SgUctNode*
 SgUctSearch::FindBestChild(const SgUctNode& node,
                            const vector<SgMove>* excludeMoves) const
@@ -612,6 +851,27 @@ SgUctTree& SgUctSearch::GetTempTree()
     return m_tempTree;
 }
 
+void SgUctSearch::SetMemoryMode(SgUctMemoryMode mode)
+{
+    m_tree.SetMemoryMode(mode);
+    m_tempTree.SetMemoryMode(mode);
+}
+
+SgUctTree& SgUctSearch::PromoteSubtree(const vector<SgMove>& sequence)
+{
+    SgUctTree& initTree = GetTempTree();
+    if (  m_tree.NuAllocators() != initTree.NuAllocators()
+       || m_tree.MaxNodes() != initTree.MaxNodes()
+       )
+        return initTree;
+    const SgUctNode* node = SgUctTreeUtil::FindMatchingNode(m_tree, sequence);
+    if (node == 0)
+        return initTree;
+    m_tree.PromoteSubtree(*node);
+    m_tree.Swap(initTree);
+    return initTree;
+}
+
 SgUctValue SgUctSearch::GetValueEstimate(bool useRave, const SgUctNode& child) const
 {
     SgUctValue value = 0;
@@ -710,11 +970,12 @@ SgUctValue SgUctSearch::GetValueEstimateRave(const SgUctNode& child) const
         }
         else
         {
-            // This can happen only in lock-free multi-threading. Normally,
-            // each move played in a position should also cause a RAVE value
-            // to be added. But in lock-free multi-threading it can happen
-            // that the move value was already updated but the RAVE value not
-            SG_ASSERT(m_numberThreads > 1 && m_lockFree);
+            // This can happen only in multi-threading. Normally, each move
+            // played in a position should also cause a RAVE value to be
+            // added. But the values are updated without locking (also if
+            // LockFree() is false), so it can happen that the move value
+            // was already updated but the RAVE value not
+            SG_ASSERT(m_numberThreads > 1);
             value = moveValue;
         }
     }
@@ -732,6 +993,23 @@ std::string SgUctSearch::LastGameSummaryLine() const
     return SummaryLine(LastGameInfo());
 }
 
+/** Lock the global mutex, if the search is not lock-free.
+    Used for the changes of the tree structure and for OnSearchIteration()
+    in multi-threaded searches, if LockFree() is false. The waiting time is
+    measured in phase SG_UCTPHASE_LOCK.
+    @param state The thread state
+    @param lock An unlocked lock of m_globalMutex */
+void SgUctSearch::LockIfNotLockFree(SgUctThreadState& state,
+                                    GlobalLock& lock)
+{
+    if (m_lockFree || m_numberThreads == 1)
+        return;
+    const SgUctSearchPhase phase = state.m_phaseProfile.Phase();
+    SwitchPhase(state, SG_UCTPHASE_LOCK);
+    lock.lock();
+    SwitchPhase(state, phase);
+}
+
 SgUctValue SgUctSearch::Log(SgUctValue x) const
 {
 #if SG_UCTFASTLOG
@@ -747,6 +1025,8 @@ void SgUctSearch::CreateChildren(SgUctThreadState& state,
                                  const SgUctNode& node,
                                  bool deleteChildTrees)
 {
+    GlobalLock lock(m_globalMutex, boost::defer_lock);
+    LockIfNotLockFree(state, lock);
     unsigned int threadId = state.m_threadId;
     if (! m_tree.HasCapacity(threadId, state.m_moves.size()))
     {
@@ -754,7 +1034,6 @@ void SgUctSearch::CreateChildren(SgUctThreadState& state,
                          % m_tree.MaxNodes()));
         state.m_isTreeOutOfMem = true;
         m_isTreeOutOfMemory = true;
-        SgSynchronizeThreadMemory();
         return;
     }
     m_tree.MergeChildren(threadId, node, state.m_moves, deleteChildTrees);
@@ -850,8 +1129,9 @@ void SgUctSearch::OnSearchIteration(SgUctValue gameNumber,
     }
 }
 
-void SgUctSearch::PlayGame(SgUctThreadState& state, GlobalLock* lock)
+void SgUctSearch::PlayGame(SgUctThreadState& state)
 {
+    SwitchPhase(state, SG_UCTPHASE_SELECT);
     state.m_isTreeOutOfMem = false;
     state.GameStart();
     SgUctGameInfo& info = state.m_gameInfo;
@@ -859,13 +1139,10 @@ void SgUctSearch::PlayGame(SgUctThreadState& state, GlobalLock* lock)
     bool isTerminal;
     bool abortInTree = ! PlayInTree(state, isTerminal);
 
-    // The playout phase is always unlocked
-    if (lock != 0)
-        lock->unlock();
-
     if (! info.m_nodes.empty() && isTerminal)
     {
         const SgUctNode& terminalNode = *info.m_nodes.back();
+        SwitchPhase(state, SG_UCTPHASE_EVALUATE);
         SgUctValue eval = state.Evaluate();
         if (eval > 0.6) 
             m_tree.SetProvenType(terminalNode, SG_PROVEN_WIN);
@@ -893,6 +1170,7 @@ void SgUctSearch::PlayGame(SgUctThreadState& state, GlobalLock* lock)
     }
     else 
     {
+        SwitchPhase(state, SG_UCTPHASE_PLAYOUT);
         state.StartPlayouts();
         for (size_t i = 0; i < m_numberPlayouts; ++i)
         {
@@ -907,7 +1185,11 @@ void SgUctSearch::PlayGame(SgUctThreadState& state, GlobalLock* lock)
             if (abort)
                 eval = UnknownEval();
             else
+            {
+                SwitchPhase(state, SG_UCTPHASE_EVALUATE);
                 eval = state.Evaluate();
+                SwitchPhase(state, SG_UCTPHASE_PLAYOUT);
+            }
             size_t nuMoves = info.m_sequence[i].size();
             if (nuMoves % 2 != 0)
                 eval = InverseEval(eval);
@@ -919,14 +1201,12 @@ void SgUctSearch::PlayGame(SgUctThreadState& state, GlobalLock* lock)
     }
     state.TakeBackInTree(nuMovesInTree);
 
-    // End of unlocked part if ! m_lockFree
-    if (lock != 0)
-        lock->lock();
-
+    SwitchPhase(state, SG_UCTPHASE_UPDATE);
     UpdateTree(info);
     if (m_rave)
         UpdateRaveValues(state);
     UpdateStatistics(info);
+    SwitchPhase(state, SG_UCTPHASE_OTHER);
 }
 
 /** Backs up proven information. Last node of nodes is the newly
@@ -975,8 +1255,18 @@ bool SgUctSearch::PlayInTree(SgUctThreadState& state, bool& isTerminal)
     if (m_virtualLoss && m_numberThreads > 1)
         m_tree.AddVirtualLoss(*current);
     nodes.push_back(current);
-    bool breakAfterSelect = false;
+    if (m_transpositions)
+        state.m_gameInfo.m_hashCodes.push_back(SgHashCode());
     isTerminal = false;
+    if (m_asyncKnowledgeThreads > 0 && m_nuKnowledgeResults > 0)
+    {
+        SwitchPhase(state, SG_UCTPHASE_KNOWLEDGE);
+        AddKnowledgeResults(state);
+        if (state.m_isTreeOutOfMem)
+            return true;
+        SwitchPhase(state, SG_UCTPHASE_SELECT);
+    }
+    bool breakAfterSelect = false;
     bool useBiasTerm = false;
     if (--state.m_randomizeBiasCounter == 0)
     {
@@ -991,8 +1281,19 @@ bool SgUctSearch::PlayInTree(SgUctThreadState& state, bool& isTerminal)
             return false;
         if (current->IsProven())
             break;
+        if (! current->HasChildren() && m_asyncKnowledgeThreads > 0
+            && current != root)
+        {
+            if (current->MoveCount() < m_expandThreshold)
+                break;
+            SwitchPhase(state, SG_UCTPHASE_KNOWLEDGE);
+            if (RequestKnowledge(state, *current, 0))
+                break;
+            // The queue is full, expand the node in this thread
+        }
         if (! current->HasChildren())
         {
+            SwitchPhase(state, SG_UCTPHASE_EXPAND);
             state.m_moves.clear();
             SgUctProvenType provenType = SG_NOT_PROVEN;
             state.GenerateAllMoves(0, state.m_moves, provenType);
@@ -1019,33 +1320,50 @@ bool SgUctSearch::PlayInTree(SgUctThreadState& state, bool& isTerminal)
             else
                 break;
         }
-        else if (state.m_threadId < m_maxKnowledgeThreads 
-                 && NeedToComputeKnowledge(current))
+        else if (  (  m_asyncKnowledgeThreads > 0
+                   || state.m_threadId < m_maxKnowledgeThreads
+                   )
+                && NeedToComputeKnowledge(current))
         {
             m_statistics.m_knowledge++;
-            state.m_moves.clear();
-            SgUctProvenType provenType = SG_NOT_PROVEN;
-            bool truncate = state.GenerateAllMoves(current->KnowledgeCount(), 
-                                                   state.m_moves,
-                                                   provenType);
-            if (current == root)
-                ApplyRootFilter(state.m_moves);
-            CreateChildren(state, *current, truncate);
-            if (provenType != SG_NOT_PROVEN)
-            {
-                m_tree.SetProvenType(*current, provenType);
-                PropagateProvenStatus(nodes);
-                break;
-            }
-            if (state.m_moves.empty())
+            SwitchPhase(state, SG_UCTPHASE_KNOWLEDGE);
+            if (  m_asyncKnowledgeThreads > 0
+               && RequestKnowledge(state, *current,
+                                   current->KnowledgeCount())
+               )
+                SwitchPhase(state, SG_UCTPHASE_SELECT);
+            else
             {
-                isTerminal = true;
-                break;
+                // Computed in this thread without knowledge threads or if
+                // the queue of the knowledge threads is full, because
+                // NeedToComputeKnowledge() already marked the knowledge as
+                // computed
+                state.m_moves.clear();
+                SgUctProvenType provenType = SG_NOT_PROVEN;
+                bool truncate =
+                    state.GenerateAllMoves(current->KnowledgeCount(),
+                                           state.m_moves, provenType);
+                if (current == root)
+                    ApplyRootFilter(state.m_moves);
+                CreateChildren(state, *current, truncate);
+                if (provenType != SG_NOT_PROVEN)
+                {
+                    m_tree.SetProvenType(*current, provenType);
+                    PropagateProvenStatus(nodes);
+                    break;
+                }
+                if (state.m_moves.empty())
+                {
+                    isTerminal = true;
+                    break;
+                }
+                if (state.m_isTreeOutOfMem)
+                    return true;
+                breakAfterSelect = true;
             }
-            if (state.m_isTreeOutOfMem)
-                return true;
-            breakAfterSelect = true;
         }
+        if (breakAfterSelect)
+            SwitchPhase(state, SG_UCTPHASE_SELECT);
         current = &SelectChild(state.m_randomizeRaveCounter, useBiasTerm, *current);
         if (m_virtualLoss && m_numberThreads > 1)
             m_tree.AddVirtualLoss(*current);
@@ -1053,6 +1371,8 @@ bool SgUctSearch::PlayInTree(SgUctThreadState& state, bool& isTerminal)
         SgMove move = current->Move();
         state.Execute(move);
         sequence.push_back(move);
+        if (m_transpositions)
+            UpdateFromTransposition(state, *current);
         if (breakAfterSelect)
             break;
     }
@@ -1111,11 +1431,9 @@ SgUctValue SgUctSearch::Search(SgUctValue maxGames, double maxTime,
     while (true)
     {
         m_isTreeOutOfMemory = false;
-        SgSynchronizeThreadMemory();
-        for (size_t i = 0; i < m_threads.size(); ++i)
-            m_threads[i]->StartPlay();
-        for (size_t i = 0; i < m_threads.size(); ++i)
-            m_threads[i]->WaitPlayFinished();
+        StartSearchLoops();
+        WaitSearchLoopsFinished();
+        DiscardKnowledgeRequests();
         if (m_aborted || ! m_pruneFullTree)
             break;
         else
@@ -1124,18 +1442,38 @@ SgUctValue SgUctSearch::Search(SgUctValue maxGames, double maxTime,
             SgDebug() << "SgUctSearch: pruning nodes with count < "
                   << pruneMinCount << " (at time " << fixed << setprecision(1)
                   << startPruneTime << ")\n";
-            SgUctTree& tempTree = GetTempTree();
-            m_tree.CopyPruneLowCount(tempTree, pruneMinCount, true);
+            const size_t nuNodes = m_tree.NuNodes();
+            if (m_pruneInPlace)
+                m_tree.PruneLowCount(pruneMinCount);
+            else
+            {
+                SgUctTree& tempTree = GetTempTree();
+                m_tree.CopyPruneLowCount(tempTree, pruneMinCount, true);
+                m_tree.Swap(tempTree);
+            }
             int prunedSizePercentage =
-                static_cast<int>(tempTree.NuNodes() * 100 / m_tree.NuNodes());
-            SgDebug() << "SgUctSearch: pruned size: " << tempTree.NuNodes()
+                static_cast<int>(m_tree.NuNodes() * 100 / nuNodes);
+            SgDebug() << "SgUctSearch: pruned size: " << m_tree.NuNodes()
                       << " (" << prunedSizePercentage << "%) time: "
                       << (m_timer.GetTime() - startPruneTime) << "\n";
             if (prunedSizePercentage > 50)
                 pruneMinCount *= 2;
             else
                  pruneMinCount = m_pruneMinCount; 
-            m_tree.Swap(tempTree);
+        }
+    }
+    for (size_t i = 0; i < m_threads.size(); ++i)
+        OnThreadEndSearch(*m_threads[i]->m_state);
+    if (m_profilePhases)
+    {
+        for (size_t i = 0; i < m_threads.size(); ++i)
+            m_statistics.m_phases.Add(m_threads[i]->m_state->m_phaseProfile);
+        // Knowledge threads can still compute discarded requests
+        WaitKnowledgeThreadsIdle();
+        for (size_t i = 0; i < m_knowledgeThreads.size(); ++i)
+        {
+            const SgUctThreadState& state = *m_knowledgeThreads[i]->m_state;
+            m_statistics.m_knowledgeThreadPhases.Add(state.m_phaseProfile);
         }
     }
     EndSearch();
@@ -1150,43 +1488,153 @@ SgUctValue SgUctSearch::Search(SgUctValue maxGames, double maxTime,
            SgUctValue(0.5);
 }
 
+/** Send a request to compute knowledge to the knowledge threads.
+    A node without children is requested only once until the request is
+    finished or discarded.
+    @param state The thread state with the current position at the node
+    @param node The node
+    @param count The count argument to SgUctThreadState::GenerateAllMoves()
+    @return @c false, if the request was dropped, because the queue has
+    MaxKnowledgeRequests() requests. The caller must compute the knowledge
+    itself in this case.
+    @see AsyncKnowledgeThreads() */
+bool SgUctSearch::RequestKnowledge(SgUctThreadState& state,
+                                   const SgUctNode& node, SgUctValue count)
+{
+    mutex::scoped_lock lock(m_knowledgeMutex);
+    if (count == 0 && m_knowledgeNodes.count(&node) > 0)
+        return true;
+    if (m_knowledgeRequests.size() >= m_maxKnowledgeRequests)
+    {
+        ++m_statistics.m_knowledgeRequestsDropped;
+        return false;
+    }
+    if (count == 0)
+        m_knowledgeNodes.insert(&node);
+    m_knowledgeRequests.push_back(SgUctKnowledgeRequest());
+    SgUctKnowledgeRequest& request = m_knowledgeRequests.back();
+    request.m_node = &node;
+    request.m_count = count;
+    request.m_sequence = state.m_gameInfo.m_inTreeSequence;
+    m_knowledgeRequestAdded.notify_one();
+    return true;
+}
+
 /** Loop invoked by each thread for playing games. */
-void SgUctSearch::SearchLoop(SgUctThreadState& state, GlobalLock* lock)
+void SgUctSearch::SearchLoop(SgUctThreadState& state)
 {
     if (! state.m_isSearchInitialized)
     {
         OnThreadStartSearch(state);
         state.m_isSearchInitialized = true;
     }
+    m_tree.FirstTouch(state.m_threadId);
 
-    if (NumberThreads() == 1 || m_lockFree)
-        lock = 0;
-    if (lock != 0)
-        lock->lock();
+    if (m_profilePhases)
+        state.m_phaseProfile.Start(SG_UCTPHASE_OTHER);
     state.m_isTreeOutOfMem = false;
     while (! state.m_isTreeOutOfMem)
     {
-        PlayGame(state, lock);
-        OnSearchIteration(m_numberGames + 1, state.m_threadId,
-                          state.m_gameInfo);
-        if (m_logGames)
-            m_log << SummaryLine(state.m_gameInfo) << '\n';
-        ++m_numberGames;
+        PlayGame(state);
+        {
+            GlobalLock lock(m_globalMutex, boost::defer_lock);
+            LockIfNotLockFree(state, lock);
+            OnSearchIteration(m_numberGames + 1, state.m_threadId,
+                              state.m_gameInfo);
+            if (m_logGames)
+                m_log << SummaryLine(state.m_gameInfo) << '\n';
+            ++m_numberGames;
+        }
         if (m_isTreeOutOfMemory)
             break;
         if (m_aborted || CheckAbortSearch(state))
         {
             m_aborted = true;
-            SgSynchronizeThreadMemory();
             break;
         }
     }
-    if (lock != 0)
-        lock->unlock();
+    SwitchPhase(state, SG_UCTPHASE_OTHER);
+}
+
+/** Start SearchLoop() in all threads.
+    Does not wait for the threads. Requires that no search loops are
+    running. */
+void SgUctSearch::StartSearchLoops()
+{
+    SG_ASSERT(m_nuRunningThreads == 0);
+    mutex::scoped_lock lock(m_epochMutex);
+    m_nuRunningThreads = static_cast<unsigned int>(m_threads.size());
+    ++m_searchEpoch;
+    m_epochChanged.notify_all();
+}
+
+/** Wait until all threads have finished SearchLoop().
+    Afterwards, OnThreadEndSearch() can be called for the thread states from
+    the calling thread. */
+void SgUctSearch::WaitSearchLoopsFinished()
+{
+    mutex::scoped_lock lock(m_epochMutex);
+    while (m_nuRunningThreads > 0)
+        m_threadsFinished.wait(lock);
+}
+
+/** Called by a thread after its SearchLoop() has finished.
+    The last thread to finish wakes up WaitSearchLoopsFinished(). */
+void SgUctSearch::OnSearchLoopFinished()
+{
+    if (m_nuRunningThreads.fetch_sub(1) == 1)
+    {
+        // Lock to avoid a lost wake-up between the check of the counter
+        // and the wait in WaitSearchLoopsFinished()
+        mutex::scoped_lock lock(m_epochMutex);
+        m_threadsFinished.notify_all();
+    }
+}
+
+/** Wait in a knowledge thread until there are requests.
+    @param[out] batch The requests taken from the queue (at most
+    KNOWLEDGE_BATCH_SIZE)
+    @param[out] generation The current value of m_knowledgeGeneration
+    @return @c false, if the thread should terminate */
+bool SgUctSearch::WaitForKnowledgeRequests(
+                                      vector<SgUctKnowledgeRequest>& batch,
+                                      unsigned int& generation)
+{
+    mutex::scoped_lock lock(m_knowledgeMutex);
+    while (m_knowledgeRequests.empty() && ! m_quitKnowledgeThreads)
+        m_knowledgeRequestAdded.wait(lock);
+    if (m_quitKnowledgeThreads)
+        return false;
+    const size_t n =
+        std::min(m_knowledgeRequests.size(), KNOWLEDGE_BATCH_SIZE);
+    batch.assign(m_knowledgeRequests.begin(),
+                 m_knowledgeRequests.begin() + n);
+    m_knowledgeRequests.erase(m_knowledgeRequests.begin(),
+                              m_knowledgeRequests.begin() + n);
+    generation = m_knowledgeGeneration;
+    ++m_nuBusyKnowledgeThreads;
+    return true;
+}
+
+/** Wait until no knowledge thread is computing requests. */
+void SgUctSearch::WaitKnowledgeThreadsIdle()
+{
+    mutex::scoped_lock lock(m_knowledgeMutex);
+    while (m_nuBusyKnowledgeThreads > 0)
+        m_knowledgeThreadsIdle.wait(lock);
+}
 
-    m_searchLoopFinished->wait();
-    if (m_aborted || ! m_pruneFullTree)
-        OnThreadEndSearch(state);
+/** Wait in a thread until the search epoch differs from a given one.
+    @param epoch The last epoch seen by the thread
+    @param[out] quit Whether the thread should terminate
+    @return The new epoch */
+unsigned int SgUctSearch::WaitForSearchEpoch(unsigned int epoch, bool& quit)
+{
+    mutex::scoped_lock lock(m_epochMutex);
+    while (m_searchEpoch == epoch)
+        m_epochChanged.wait(lock);
+    quit = m_quitThreads;
+    return m_searchEpoch;
 }
 
 void SgUctSearch::OnThreadStartSearch(SgUctThreadState& state)
@@ -1380,12 +1828,22 @@ void SgUctSearch::StartSearch(const vector<SgMove>& rootFilter,
                 "root filter not applied (tree reached maximum size)\n";
     }
     m_statistics.Clear();
+    if (m_transpositions)
+        m_transpositionTable.SetMaxEntries(
+                                      std::max(MaxNodes() / 8, size_t(1)));
+    else
+        m_transpositionTable.SetMaxEntries(0);
     m_aborted = false;
     m_wasEarlyAbort = false;
     if (! SgDeterministic::DeterministicMode())
        m_checkTimeInterval = 1;
     m_numberGames = 0;
     m_lastScoreDisplayTime = m_timer.GetTime();
+    if (m_knowledgeThreads.size() != m_asyncKnowledgeThreads)
+        CreateKnowledgeThreads();
+    // The knowledge threads can still compute discarded requests of the
+    // last search, and their states use the data set in OnStartSearch()
+    WaitKnowledgeThreadsIdle();
     OnStartSearch();
     
     m_nextCheckTime = SgUctValue(m_checkTimeInterval);
@@ -1396,8 +1854,14 @@ void SgUctSearch::StartSearch(const vector<SgMove>& rootFilter,
         SgUctThreadState& state = ThreadState(i);
         state.m_randomizeRaveCounter = m_randomizeRaveFrequency;
         state.m_randomizeBiasCounter = m_biasTermFrequency;
+        state.m_phaseProfile.Clear();
         state.StartSearch();
     }
+    for (size_t i = 0; i < m_knowledgeThreads.size(); ++i)
+    {
+        m_knowledgeThreads[i]->m_state->m_phaseProfile.Clear();
+        m_knowledgeThreads[i]->m_state->StartSearch();
+    }
 }
 
 void SgUctSearch::EndSearch()
@@ -1447,8 +1911,115 @@ void SgUctSearch::UpdateCheckTimeInterval(double time)
     @see SgUctSearch::Rave() */
 void SgUctSearch::UpdateRaveValues(SgUctThreadState& state)
 {
-    for (size_t i = 0; i < m_numberPlayouts; ++i)
-        UpdateRaveValues(state, i);
+    if (m_numberPlayouts == 1)
+        UpdateRaveValues(state, 0);
+    else
+        UpdateRaveValuesMultiplePlayouts(state);
+}
+
+/** Update the RAVE values for all NumberPlayouts() playouts of a game at
+    once.
+    Equivalent to calling UpdateRaveValues(state, playout) for each playout,
+    but each RAVE value in the tree is changed only once with the weighted
+    mean of the contributions of all playouts. This reduces the number of
+    writes to shared tree nodes by a factor of up to NumberPlayouts(). The
+    first-play arrays of all playouts are scanned backwards in lockstep
+    through the in-tree part of the sequence, which is the same for all
+    playouts. */
+void SgUctSearch::UpdateRaveValuesMultiplePlayouts(SgUctThreadState& state)
+{
+    SgUctGameInfo& info = state.m_gameInfo;
+    const vector<const SgUctNode*>& nodes = info.m_nodes;
+    const size_t nuNodes = nodes.size();
+    const size_t nuPlayouts = m_numberPlayouts;
+    SG_ASSERT(m_moveRange > 0);
+    const size_t moveRange = m_moveRange;
+    vector<size_t>& firstPlays = state.m_firstPlays;
+    vector<size_t>& firstPlaysOpp = state.m_firstPlaysOpp;
+    firstPlays.assign(nuPlayouts * moveRange, numeric_limits<size_t>::max());
+    firstPlaysOpp.assign(nuPlayouts * moveRange,
+                         numeric_limits<size_t>::max());
+    size_t maxLength = 0;
+    for (size_t playout = 0; playout < nuPlayouts; ++playout)
+    {
+        const vector<SgMove>& sequence = info.m_sequence[playout];
+        const vector<bool>& skipRaveUpdate = info.m_skipRaveUpdate[playout];
+        maxLength = std::max(maxLength, sequence.size());
+        size_t* firstPlay = &firstPlays[playout * moveRange];
+        size_t* firstPlayOpp = &firstPlaysOpp[playout * moveRange];
+        // Update firstPlay, firstPlayOpp arrays using playout moves
+        for (size_t i = sequence.size(); i-- > nuNodes; )
+            if (! skipRaveUpdate[i])
+            {
+                SgMove mv = sequence[i];
+                size_t& first = (i % 2 != 0 ? firstPlayOpp[mv]
+                                 : firstPlay[mv]);
+                if (i < first)
+                    first = i;
+            }
+    }
+    if (maxLength == 0)
+        return;
+    for (size_t i = std::min(maxLength, nuNodes); i-- > 0; )
+    {
+        const bool opp = (i % 2 != 0);
+        bool isAnyUpdate = false;
+        for (size_t playout = 0; playout < nuPlayouts; ++playout)
+        {
+            const vector<SgMove>& sequence = info.m_sequence[playout];
+            const vector<bool>& skipRaveUpdate =
+                info.m_skipRaveUpdate[playout];
+            if (i >= sequence.size() || skipRaveUpdate[i])
+                continue;
+            isAnyUpdate = true;
+            SgMove mv = sequence[i];
+            size_t& first = (opp ? firstPlaysOpp[playout * moveRange + mv]
+                             : firstPlays[playout * moveRange + mv]);
+            if (i < first)
+                first = i;
+        }
+        const SgUctNode* node = nodes[i];
+        if (! isAnyUpdate || ! node->HasChildren())
+            continue;
+        for (SgUctChildIterator it(m_tree, *node); it; ++it)
+        {
+            const SgUctNode& child = *it;
+            SgMove mv = child.Move();
+            SgUctValue sumWeight = 0;
+            SgUctValue sumValue = 0;
+            for (size_t playout = 0; playout < nuPlayouts; ++playout)
+            {
+                const vector<SgMove>& sequence = info.m_sequence[playout];
+                if (i >= sequence.size()
+                    || info.m_skipRaveUpdate[playout][i])
+                    continue;
+                const size_t* firstPlay = &(opp ? firstPlaysOpp : firstPlays)
+                    [playout * moveRange];
+                const size_t* firstPlayOpp =
+                    &(opp ? firstPlays : firstPlaysOpp)[playout * moveRange];
+                size_t first = firstPlay[mv];
+                SG_ASSERT(first >= i);
+                if (first == numeric_limits<size_t>::max())
+                    continue;
+                if (m_raveCheckSame
+                    && SgUtil::InRange(firstPlayOpp[mv], i, first))
+                    continue;
+                const size_t len = sequence.size();
+                SgUctValue weight;
+                if (m_weightRaveUpdates)
+                    weight = 2 - SgUctValue(first - i) / SgUctValue(len - i);
+                else
+                    weight = 1;
+                SgUctValue eval = info.m_eval[playout];
+                if (opp)
+                    eval = InverseEval(eval);
+                sumWeight += weight;
+                sumValue += weight * eval;
+            }
+            if (sumWeight > 0)
+                m_tree.AddRaveValue(child, sumValue / sumWeight, sumWeight);
+        }
+    }
 }
 
 void SgUctSearch::UpdateRaveValues(SgUctThreadState& state,
@@ -1554,6 +2125,32 @@ void SgUctSearch::UpdateStatistics(const SgUctGameInfo& info)
     }
 }
 
+/** Update the move value of a node from the transposition table.
+    Also stores the hash code of the current position in the game info of the
+    thread state.
+    @param state The thread state after executing the move of the node
+    @param node The node
+    @see Transpositions() */
+void SgUctSearch::UpdateFromTransposition(SgUctThreadState& state,
+                                          const SgUctNode& node)
+{
+    const SgHashCode hashCode = state.GetHashCode();
+    state.m_gameInfo.m_hashCodes.push_back(hashCode);
+    if (hashCode.IsZero())
+        return;
+    SgUctValue value;
+    SgUctValue count;
+    if (! m_transpositionTable.Lookup(hashCode, value, count))
+        return;
+    const SgUctValue moveCount = node.MoveCount();
+    if (count > moveCount)
+    {
+        m_tree.InitializeValue(node, value, count);
+        ++m_statistics.m_transpositions;
+        m_statistics.m_transpositionGames += count - moveCount;
+    }
+}
+
 void SgUctSearch::UpdateTree(const SgUctGameInfo& info)
 {
     SgUctValue eval = 0;
@@ -1570,6 +2167,9 @@ void SgUctSearch::UpdateTree(const SgUctGameInfo& info)
         const SgUctNode* father = (i > 0 ? nodes[i - 1] : 0);
         m_tree.AddGameResults(node, father, i % 2 == 0 ? eval : inverseEval,
                               count);
+        if (m_transpositions && ! info.m_hashCodes[i].IsZero())
+            m_transpositionTable.Add(info.m_hashCodes[i],
+                                     i % 2 == 0 ? eval : inverseEval, count);
         // Remove the virtual loss
         if (m_virtualLoss && m_numberThreads > 1)
             m_tree.RemoveVirtualLoss(node);
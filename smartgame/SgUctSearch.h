@@ -6,11 +6,13 @@
 #ifndef SG_UCTSEARCH_H
 #define SG_UCTSEARCH_H
 
+#include <deque>
 #include <fstream>
+#include <set>
 #include <vector>
+#include <boost/atomic.hpp>
 #include <boost/scoped_array.hpp>
 #include <boost/shared_ptr.hpp>
-#include <boost/thread/barrier.hpp>
 #include <boost/thread/condition.hpp>
 #include <boost/thread/mutex.hpp>
 #include <boost/thread/recursive_mutex.hpp>
@@ -18,7 +20,10 @@
 #include "SgAdditiveKnowledge.h"
 #include "SgBlackWhite.h"
 #include "SgBWArray.h"
+#include "SgHash.h"
 #include "SgTimer.h"
+#include "SgUctPhaseProfile.h"
+#include "SgUctTranspositionTable.h"
 #include "SgUctTree.h"
 #include "SgUctValue.h"
 #include "SgMpiSynchronizer.h"
@@ -69,9 +74,8 @@
 /** @page sguctsearchlockfree Lock-free mode in SgUctSearch
 
 The basic idea of the lock-free mode in SgUctSearch is to share a tree between
-multiple threads without using any locks. Because of specific requirements on
-the memory model of the hardware platform, lock-free mode is an optional
-feature of the SgUctSearch and needs to be enabled explicitly.
+multiple threads without using any locks. Lock-free mode is an optional
+feature of the SgUctSearch and is enabled by default.
 
 @section sguctsearchlockfreetree Modifying the Tree Structure
 
@@ -89,10 +93,12 @@ lost.
 The child information of a node consists of two variables: a pointer to the
 first child in the array, and the number of children. To avoid that another
 thread sees an inconsistent state of these variables, all threads assume that
-the number of children is valid if the pointer to the first child is not null.
-Linking a parent to a new set of children requires first writing the number of
-children, then the pointer to the first child. The compiler is prevented from
-reordering the writes by declaring these variables as volatile.
+the pointer to the first child and the children are valid if the number of
+children is greater zero. Linking a parent to a new set of children requires
+first writing the pointer to the first child, then the number of children.
+Both are atomic variables written with release and read with acquire memory
+ordering, which guarantees that a thread that sees the new number of children
+also sees the initialized children.
 
 @section sguctsearchlockfreevalues Updating Values
 
@@ -104,7 +110,9 @@ without increment of the count. It could also happen that one thread reads the
 count and mean while they are written by another thread, and the first thread
 sees an erroneous state that exists only temporarily. In practice, these
 faulty updates occur with a low probability and will have only a small effect
-on the counts and mean values. They are intentionally ignored.
+on the counts and mean values. They are intentionally ignored, because
+read-modify-write operations on the most contended nodes near the root would
+reduce the scalability of the search.
 
 The only problematic case is if a count is zero, because the mean value is
 undefined if the count is zero, and this case has a special meaning at several
@@ -116,20 +124,28 @@ only the RAVE mean is used, and if both counts are zero, a configurable
 constant value, the first play urgency, is used. To avoid this problem, all
 threads assume that a mean value is only valid if the corresponding count is
 non-zero. Updating a value requires first writing the new mean value, then the
-new count. The compiler is prevented from reordering the writes by declaring
-the counts and mean values as volatile.
+new count with release memory ordering (see SgStatisticsAtomicBase).
 
 @section sguctsearchlockfreeplatform Platform Requirements
 
-There are some requirements on the memory model of the platform to make the
-lock-free search algorithm work. Writes of certain basic types (size_t, int,
-float, pointers) must be atomic. Writes by one thread must be seen by other
-threads in the same order. The IA-32 and Intel-64 CPU architectures, which are
-used in most modern standard computers, guarantee these assumptions. They also
-synchronize CPU caches after writes. (See
+Since the tree nodes use atomic variables with explicit memory ordering, the
+lock-free search does not depend on the memory model of the hardware
+platform. The atomic variables used for counts, mean values and pointers must
+be lock-free to avoid overhead, which is the case on all common platforms.
+On IA-32 and Intel-64, the loads and stores compile to plain moves (see
 <a href="http://download.intel.com/design/processor/manuals/253668.pdf">
 Intel 64 and IA-32 Architectures Software Developer's Manual</a>, chapter
-7.1 Locked Atomic Operations and 7.2 Memory Ordering). */
+7.2 Memory Ordering).
+
+@section sguctsearchlockfreelocked Locked Mode
+
+If lock-free mode is disabled, only the changes of the tree structure (the
+creation of children in the in-tree phase and in the knowledge computation)
+and the calls of SgUctSearch::OnSearchIteration() are protected by a global
+mutex. A thread that waited for the mutex does not expand a node again that
+was expanded by another thread in the meantime, so no children are lost.
+The selection, playouts and value updates do not use the
+mutex and work as in lock-free mode. */
 
 /** @page sguctsearchweights Estimator weights in SgUctSearch
     The weights of the estimators (move value, RAVE value) are chosen by
@@ -229,6 +245,12 @@ struct SgUctGameInfo
     /** Nodes visited in the in-tree phase. */
     std::vector<const SgUctNode*> m_nodes;
 
+    /** Hash codes of the positions of the nodes in m_nodes.
+        Only used if SgUctSearch::Transpositions() is enabled. Contains a
+        zero hash code for positions that are not shared with transposed
+        nodes (including the root). */
+    std::vector<SgHashCode> m_hashCodes;
+
     /** Flag to skip RAVE update for moves of the playout(s).
         For convenient usage, the index corresponds to the move number from
         the root position on, even if the flag is currently only used for
@@ -261,6 +283,34 @@ enum SgUctMoveSelect
 
 //----------------------------------------------------------------------------
 
+/** Request to compute the knowledge of a node in a knowledge thread.
+    Also contains the result of the computation.
+    @see SgUctSearch::AsyncKnowledgeThreads()
+    @ingroup sguctgroup */
+struct SgUctKnowledgeRequest
+{
+    /** The node. */
+    const SgUctNode* m_node;
+
+    /** The count argument to SgUctThreadState::GenerateAllMoves().
+        0 for expanding a node without children. */
+    SgUctValue m_count;
+
+    /** The move sequence from the root to the node. */
+    std::vector<SgMove> m_sequence;
+
+    /** The moves returned by SgUctThreadState::GenerateAllMoves(). */
+    std::vector<SgUctMoveInfo> m_moves;
+
+    /** The proven type returned by SgUctThreadState::GenerateAllMoves(). */
+    SgUctProvenType m_provenType;
+
+    /** The return value of SgUctThreadState::GenerateAllMoves(). */
+    bool m_truncate;
+};
+
+//----------------------------------------------------------------------------
+
 /** Base class for the thread state.
     Subclasses must be thread-safe, it must be possible to use different
     instances of this class in different threads (after construction, the
@@ -294,6 +344,15 @@ public:
         Like m_firstPlayToPlay, but for opponent color. */
     boost::scoped_array<std::size_t> m_firstPlayOpp;
 
+    /** Local variable for SgUctSearch::UpdateRaveValuesMultiplePlayouts().
+        Like m_firstPlay, but with one array of size moveRange for each
+        playout, stored one after another. */
+    std::vector<std::size_t> m_firstPlays;
+
+    /** Local variable for SgUctSearch::UpdateRaveValuesMultiplePlayouts().
+        Like m_firstPlays, but for opponent color. */
+    std::vector<std::size_t> m_firstPlaysOpp;
+
     /** Local variable for SgUctSearch::PlayInTree().
         Reused for efficiency. */
     std::vector<SgUctMoveInfo> m_moves;
@@ -302,6 +361,18 @@ public:
         Reused for efficiency. */
     std::vector<SgMove> m_excludeMoves;
 
+    /** Local variable for SgUctSearch::AddKnowledgeResults().
+        Reused for efficiency. */
+    std::vector<SgUctKnowledgeRequest> m_knowledgeResults;
+
+    /** Local variable for SgUctSearch::AddKnowledgeResults().
+        Reused for efficiency. */
+    std::vector<const SgUctNode*> m_knowledgePath;
+
+    /** Cycles spent by this thread in the phases of the current search.
+        See SgUctSearch::ProfilePhases() */
+    SgUctPhaseProfile m_phaseProfile;
+
     /** Thread's counter for Randomized Rave in SgUctSearch::SelectChild(). */
     int m_randomizeRaveCounter;
 
@@ -394,6 +465,14 @@ public:
         Default implementation does nothing. */
     virtual void EndPlayout();
 
+    /** Hash code of the current position in the in-tree phase.
+        Used if SgUctSearch::Transpositions() is enabled to find transposed
+        nodes. The hash code must identify all information that the value of
+        the position depends on (e.g. the color to play). Positions that
+        should not be shared with other nodes can return a zero hash code.
+        Default implementation returns a zero hash code. */
+    virtual SgHashCode GetHashCode() const;
+
     // @} // name
 };
 
@@ -423,6 +502,22 @@ struct SgUctSearchStat
     /** Number of nodes for which the knowledge threshold was exceeded. */ 
     SgUctValue m_knowledge;
 
+    /** Number of knowledge requests that were not sent to the knowledge
+        threads, because the queue was full. The knowledge of these requests
+        was computed by the search thread.
+        @see SgUctSearch::MaxKnowledgeRequests() */
+    SgUctValue m_knowledgeRequestsDropped;
+
+    /** Number of times that the move value of a node was updated from a
+        transposed node.
+        @see SgUctSearch::Transpositions() */
+    SgUctValue m_transpositions;
+
+    /** Number of games that were added to nodes from transposed nodes.
+        The playouts that the search saved by sharing the statistics of
+        transposed nodes. */
+    SgUctValue m_transpositionGames;
+
     /** Games per second.
         Useful values only if search time is higher than resolution of
         SgTime::Get(). */
@@ -434,9 +529,22 @@ struct SgUctSearchStat
 
     SgUctStatistics m_aborted;
 
+    /** Cycles spent in the phases of the search by the search threads.
+        Only measured if SgUctSearch::ProfilePhases() is enabled. */
+    SgUctPhaseProfile m_phases;
+
+    /** Cycles spent by the knowledge threads.
+        Only measured if SgUctSearch::ProfilePhases() is enabled. Contains
+        only the phase SG_UCTPHASE_KNOWLEDGE.
+        @see SgUctSearch::AsyncKnowledgeThreads() */
+    SgUctPhaseProfile m_knowledgeThreadPhases;
+
     void Clear();
 
     void Write(std::ostream& out) const;
+
+    /** Write m_phases and m_knowledgeThreadPhases. */
+    void WritePhases(std::ostream& out) const;
 };
 
 //----------------------------------------------------------------------------
@@ -541,6 +649,10 @@ public:
 
     virtual void OnThreadStartSearch(SgUctThreadState& state);
 
+    /** Hook function that will be called for each thread state at the end
+        of Search().
+        It is called after all threads have finished playing games, from the
+        thread that called Search(). */
     virtual void OnThreadEndSearch(SgUctThreadState& state);
 
     virtual SgUctValue GamesPlayed() const;
@@ -649,6 +761,18 @@ public:
         used by other code while the search is not running. */
     SgUctTree& GetTempTree();
 
+    /** Reuse a subtree of the current tree without copying it.
+        Makes the node reached by a sequence of moves from the root the new
+        root (see SgUctTree::PromoteSubtree()) and moves the current tree
+        into the temporary tree. The nodes that are no longer reachable are
+        reclaimed by the pruning of a full tree during the next search (see
+        PruneFullTree()).
+        @param sequence The moves leading from the root to the new root.
+        @return The temporary tree (see GetTempTree()), which can be used as
+        the initTree argument of Search(). It is empty if no node matches
+        the sequence. */
+    SgUctTree& PromoteSubtree(const std::vector<SgMove>& sequence);
+
     // @} // name
 
 
@@ -693,6 +817,37 @@ public:
 
     void SetMaxKnowledgeThreads(unsigned int threads);
 
+    /** Number of threads that compute knowledge asynchronously.
+        If greater than zero, the search threads do not call
+        SgUctThreadState::GenerateAllMoves() themselves for expanding nodes
+        (apart from the root) and for the knowledge thresholds (see
+        KnowledgeThreshold()). Instead, they send the move sequence to the
+        node to a pool of knowledge threads, which have their own thread
+        states and take the requests in small batches, and continue the
+        game. A node that waits for its children is handled like a node
+        below the expand threshold, so the game continues with the playout
+        phase; a node that waits for a knowledge update keeps its current
+        children. The results are added to the tree by the next search
+        thread that starts a game. Requests that are not finished when the
+        search ends or the tree is pruned are discarded.
+        MaxKnowledgeThreads() is not used in this mode. Default is 0
+        (knowledge is computed in the search threads). */
+    unsigned int AsyncKnowledgeThreads() const;
+
+    /** See AsyncKnowledgeThreads() */
+    void SetAsyncKnowledgeThreads(unsigned int threads);
+
+    /** Maximum number of pending requests for the knowledge threads.
+        If the queue is full, the search thread computes the knowledge
+        itself, as without knowledge threads. This limits the memory of the
+        queue and the delay of the knowledge if the knowledge threads cannot
+        keep up with the search threads. Default is 1000.
+        @see AsyncKnowledgeThreads() */
+    std::size_t MaxKnowledgeRequests() const;
+
+    /** See MaxKnowledgeRequests() */
+    void SetMaxKnowledgeRequests(std::size_t n);
+
     /** Maximum number of nodes in the tree.
         @note The search owns two trees, one of which is used as a temporary
         tree for some operations (see GetTempTree()). This functions sets
@@ -703,6 +858,18 @@ public:
         @param maxNodes Maximum number of nodes (>= 1) */
     void SetMaxNodes(std::size_t maxNodes);
 
+    /** How the trees allocate their nodes.
+        In the huge page modes, each search thread touches the storage of its
+        node allocator before its first search, so that the nodes it creates
+        are local to the thread on NUMA systems.
+        Default is SG_UCTMEMORY_DEFAULT.
+        @see SgUctMemoryMode */
+    SgUctMemoryMode MemoryMode() const;
+
+    /** See MemoryMode()
+        Clears the trees. */
+    void SetMemoryMode(SgUctMemoryMode mode);
+
     /** The number of threads to use during the search. */
     unsigned int NumberThreads() const;
 
@@ -782,7 +949,14 @@ public:
     void SetExpandThreshold(SgUctValue expandThreshold);
 
     /** The number of playouts per simulated game.
-        Useful for multi-threading to increase the workload of the threads.
+        Leaf parallelization: a single descent of the tree is followed by
+        this number of playouts, which are played back-to-back by the same
+        thread, each starting from the position at the end of the in-tree
+        phase. The results update the tree once: the move values with the
+        mean of the playout results (see UpdateMultiplePlayoutsAsSingle())
+        and each RAVE value once with the weighted mean of the contributions
+        of all playouts. Useful for multi-threading to increase the workload
+        of the threads and reduce the contention on the tree.
         Default is 1. */
     std::size_t NumberPlayouts() const;
 
@@ -844,13 +1018,54 @@ public:
         This will prune nodes below a minimum count, if the tree gets full
         during a search. The minimum count is PruneMinCount() at the beginning
         of the search and is doubled every time a pruning operation does not
-        reduce the tree by at least a factor of 2. The creation of the pruned
-        tree uses the temporary tree (see GetTempTree()). */
+        reduce the tree by at least a factor of 2. See PruneInPlace() for
+        how the tree is pruned. */
     bool PruneFullTree() const;
 
     /** See PruneFullTree() */
     void SetPruneFullTree(bool enable);
 
+    /** Prune a full tree in place.
+        If true, the tree is pruned with SgUctTree::PruneLowCount(), which
+        reclaims the pruned and all other unreachable nodes in the allocators
+        of the tree. The search threads continue with the same tree. If
+        false, the pruned tree is copied to the temporary tree (see
+        GetTempTree()), which needs twice the memory, but stores the nodes
+        in depth-first order. Default is true.
+        @see PruneFullTree() */
+    bool PruneInPlace() const;
+
+    /** See PruneInPlace() */
+    void SetPruneInPlace(bool enable);
+
+    /** Share the move values of transposed nodes.
+        If true, the search stores the move value statistics of each
+        position in the in-tree phase in a transposition table keyed by
+        SgUctThreadState::GetHashCode(), in addition to the statistics of
+        the node. If a node is visited and the table contains more games for
+        its position than the node, because the position was also reached by
+        a different move sequence, the move value of the node is replaced by
+        the statistics in the table. The tree structure, the RAVE values and
+        the proven types of the nodes are not shared. The table is cleared
+        at the beginning of each search and has MaxNodes() / 8 entries.
+        Default is false. */
+    bool Transpositions() const;
+
+    /** See Transpositions() */
+    void SetTranspositions(bool enable);
+
+    /** Measure the cycles spent in the phases of the search.
+        If true, each thread counts the cycles spent in the phases of a
+        game (see SgUctSearchPhase) with SgCycleCounter. The counts of all
+        threads are merged at the end of the search into
+        SgUctSearchStat::m_phases. The overhead is one read of the counter
+        per phase change, i.e. a few per game and one per level of the tree.
+        Default is false. */
+    bool ProfilePhases() const;
+
+    /** See ProfilePhases() */
+    void SetProfilePhases(bool enable);
+
     /** See PruneFullTree() */
     SgUctValue PruneMinCount() const;
 
@@ -905,19 +1120,22 @@ private:
 
     friend class Thread;
 
+    /** Worker thread.
+        The thread waits for a new search epoch (see StartSearchLoops()),
+        runs SearchLoop() once and waits again. */
     class Thread
     {
     public:
         std::auto_ptr<SgUctThreadState> m_state;
 
+        /** Constructor.
+            Must not be called while a search is running. */
         Thread(SgUctSearch& search, std::auto_ptr<SgUctThreadState> state);
 
+        /** Destructor.
+            Requires that the thread was told to quit (see DeleteThreads()) */
         ~Thread();
 
-        void StartPlay();
-
-        void WaitPlayFinished();
-
     private:
         /** Copyable function object that invokes Thread::operator().
             Needed because the the constructor of boost::thread copies the
@@ -937,21 +1155,59 @@ private:
 
         SgUctSearch& m_search;
 
-        bool m_quit;
+        /** The last search epoch seen by this thread.
+            Initialized in the constructor to avoid that the thread misses
+            the first search, if it starts running after the first call to
+            StartSearchLoops(). */
+        unsigned int m_epoch;
+
+        /** The thread.
+            Order dependency: must be constructed as the last member, because
+            the constructor starts the thread. */
+        boost::thread m_thread;
+
+        void operator()();
+    };
 
-        boost::barrier m_threadReady;
+    friend class KnowledgeThread;
 
-        boost::mutex m_startPlayMutex;
+    /** Thread that computes knowledge.
+        See AsyncKnowledgeThreads() */
+    class KnowledgeThread
+    {
+    public:
+        std::auto_ptr<SgUctThreadState> m_state;
+
+        /** Constructor.
+            Must not be called while a search is running. */
+        KnowledgeThread(SgUctSearch& search,
+                        std::auto_ptr<SgUctThreadState> state);
+
+        /** Destructor.
+            Requires that the thread was told to quit (see
+            DeleteKnowledgeThreads()) */
+        ~KnowledgeThread();
+
+    private:
+        /** Copyable function object that invokes
+            KnowledgeThread::operator(). */
+        class Function
+        {
+        public:
+            Function(KnowledgeThread& thread);
 
-        boost::mutex m_playFinishedMutex;
+            void operator()();
 
-        boost::condition m_startPlay;
+        private:
+            KnowledgeThread& m_thread;
+        };
 
-        boost::condition m_playFinished;
+        friend class KnowledgeThread::Function;
 
-        boost::mutex::scoped_lock m_playFinishedLock;
+        SgUctSearch& m_search;
 
-        GlobalLock m_globalLock;
+        /** The requests that are currently computed. */
+        std::vector<SgUctKnowledgeRequest> m_batch;
 
         /** The thread.
             Order dependency: must be constructed as the last member, because
@@ -959,8 +1215,6 @@ private:
         boost::thread m_thread;
 
         void operator()();
-
-        void PlayGames();
     };
 
     std::auto_ptr<SgUctThreadStateFactory> m_threadStateFactory;
@@ -976,13 +1230,89 @@ private:
     
     unsigned int m_maxKnowledgeThreads;
 
+    /** See AsyncKnowledgeThreads() */
+    unsigned int m_asyncKnowledgeThreads;
+
+    /** See MaxKnowledgeRequests() */
+    std::size_t m_maxKnowledgeRequests;
+
     /** Flag indicating that the search was terminated because the maximum
         time or number of games was reached. */
-    volatile bool m_aborted;
+    boost::atomic<bool> m_aborted;
     
-    volatile bool m_isTreeOutOfMemory;
+    boost::atomic<bool> m_isTreeOutOfMemory;
+
+    /** @name Thread scheduling
+        Starting the search loops of all threads is a single increment of
+        m_searchEpoch and the end of all search loops is detected with the
+        counter m_nuRunningThreads, so that no barrier round-trips or
+        per-thread mutexes are needed at the start and end of a search. */
+    // @{
+
+    /** Protects m_searchEpoch and m_quitThreads and is used with the
+        conditions m_epochChanged and m_threadsFinished. */
+    boost::mutex m_epochMutex;
+
+    boost::condition m_epochChanged;
+
+    boost::condition m_threadsFinished;
+
+    /** Incremented each time the threads should run SearchLoop() (or
+        quit if m_quitThreads is true). */
+    unsigned int m_searchEpoch;
+
+    bool m_quitThreads;
+
+    /** Number of threads that have not yet finished SearchLoop() in the
+        current epoch. */
+    boost::atomic<unsigned int> m_nuRunningThreads;
 
-    std::auto_ptr<boost::barrier> m_searchLoopFinished;
+    // @} // @name
+
+    /** @name Asynchronous knowledge
+        See AsyncKnowledgeThreads() */
+    // @{
+
+    /** Protects the members of this group apart from m_nuKnowledgeResults
+        and m_knowledgeThreads and is used with the conditions
+        m_knowledgeRequestAdded and m_knowledgeThreadsIdle. */
+    boost::mutex m_knowledgeMutex;
+
+    /** Notifies the knowledge threads about new requests and
+        m_quitKnowledgeThreads. */
+    boost::condition m_knowledgeRequestAdded;
+
+    /** Notifies that m_nuBusyKnowledgeThreads became zero. */
+    boost::condition m_knowledgeThreadsIdle;
+
+    std::deque<SgUctKnowledgeRequest> m_knowledgeRequests;
+
+    /** Finished requests that are not yet added to the tree. */
+    std::vector<SgUctKnowledgeRequest> m_knowledgeResults;
+
+    /** Size of m_knowledgeResults.
+        Allows the search threads to check for results without locking. */
+    boost::atomic<std::size_t> m_nuKnowledgeResults;
+
+    /** Nodes without children that have a pending request.
+        Avoids multiple requests for expanding the same node. Also contains
+        nodes in terminal positions, for which the request returned no
+        moves and the evaluation did not prove the position. */
+    std::set<const SgUctNode*> m_knowledgeNodes;
+
+    /** Incremented whenever the requests are discarded, such that the
+        results of requests that were computed at that time are discarded
+        too. */
+    unsigned int m_knowledgeGeneration;
+
+    /** Number of knowledge threads that are computing requests. */
+    unsigned int m_nuBusyKnowledgeThreads;
+
+    bool m_quitKnowledgeThreads;
+
+    std::vector<boost::shared_ptr<KnowledgeThread> > m_knowledgeThreads;
+
+    // @} // @name
 
     /** See SgUctEarlyAbortParam. */
     bool m_wasEarlyAbort;
@@ -1009,6 +1339,15 @@ private:
     /** See PruneFullTree() */
     bool m_pruneFullTree;
 
+    /** See PruneInPlace() */
+    bool m_pruneInPlace;
+
+    /** See Transpositions() */
+    bool m_transpositions;
+
+    /** See ProfilePhases() */
+    bool m_profilePhases;
+
     /** See CheckFloatPrecision() */
     bool m_checkFloatPrecision;
 
@@ -1091,15 +1430,17 @@ private:
     /** See GetTempTree() */
     SgUctTree m_tempTree;
 
+    /** See Transpositions() */
+    SgUctTranspositionTable m_transpositionTable;
+
     /** See parameter rootFilter in function Search() */
     std::vector<SgMove> m_rootFilter;
 
     std::ofstream m_log;
 
-    /** Mutex for protecting global variables during multi-threading.
-        Currently, only the play-out phase of games is thread safe, therefore
-        this lock is always locked elsewhere (in-tree phase, updating of
-        values and statistics, etc.) */
+    /** Mutex for protecting changes of the tree structure and
+        OnSearchIteration(), if LockFree() is false.
+        See LockIfNotLockFree() */
     boost::recursive_mutex m_globalMutex;
 
     SgUctSearchStat m_statistics;
@@ -1115,8 +1456,13 @@ private:
 
     boost::shared_ptr<SgMpiSynchronizer> m_mpiSynchronizer;
 
+    void AddKnowledgeResults(SgUctThreadState& state);
+
     void ApplyRootFilter(std::vector<SgUctMoveInfo>& moves);
 
+    bool FindNodes(const std::vector<SgMove>& sequence,
+                   std::vector<const SgUctNode*>& nodes) const;
+
     void PropagateProvenStatus(const std::vector<const SgUctNode*>& nodes);
 
     bool CheckAbortSearch(SgUctThreadState& state);
@@ -1126,12 +1472,24 @@ private:
     bool CheckCountAbort(SgUctThreadState& state,
                          SgUctValue remainingGames) const;
 
+    void ComputeKnowledge(SgUctThreadState& state,
+                          SgUctKnowledgeRequest& request);
+
+    void CreateKnowledgeThreads();
+
     void Debug(const SgUctThreadState& state, const std::string& textLine);
 
+    void DeleteKnowledgeThreads();
+
     void DeleteThreads();
 
+    void DiscardKnowledgeRequests();
+
     void ExpandNode(SgUctThreadState& state, const SgUctNode& node);
 
+    void FinishKnowledgeRequests(std::vector<SgUctKnowledgeRequest>& batch,
+                                 unsigned int generation);
+
     void CreateChildren(SgUctThreadState& state, const SgUctNode& node,
                         bool deleteChildTrees);
 
@@ -1143,19 +1501,39 @@ private:
 
     SgUctValue GetValueEstimateRave(const SgUctNode& child) const;
 
+    void LockIfNotLockFree(SgUctThreadState& state, GlobalLock& lock);
+
     SgUctValue Log(SgUctValue x) const;
 
     bool NeedToComputeKnowledge(const SgUctNode* current);
 
-    void PlayGame(SgUctThreadState& state, GlobalLock* lock);
+    void PlayGame(SgUctThreadState& state);
 
     bool PlayInTree(SgUctThreadState& state, bool& isTerminal);
 
     bool PlayoutGame(SgUctThreadState& state, std::size_t playout);
 
     void PrintSearchProgress(double currTime) const;
+
+    bool RequestKnowledge(SgUctThreadState& state, const SgUctNode& node,
+                          SgUctValue count);
     
-    void SearchLoop(SgUctThreadState& state, GlobalLock* lock);
+    void SearchLoop(SgUctThreadState& state);
+
+    void StartSearchLoops();
+
+    void SwitchPhase(SgUctThreadState& state, SgUctSearchPhase phase);
+
+    void WaitSearchLoopsFinished();
+
+    unsigned int WaitForSearchEpoch(unsigned int epoch, bool& quit);
+
+    bool WaitForKnowledgeRequests(std::vector<SgUctKnowledgeRequest>& batch,
+                                  unsigned int& generation);
+
+    void WaitKnowledgeThreadsIdle();
+
+    void OnSearchLoopFinished();
 
     const SgUctNode& SelectChild(int& randomizeCounter, bool useBiasTerm, const SgUctNode& node);
 
@@ -1169,6 +1547,8 @@ private:
 
     void UpdateRaveValues(SgUctThreadState& state, std::size_t playout);
 
+    void UpdateRaveValuesMultiplePlayouts(SgUctThreadState& state);
+
     void UpdateRaveValues(SgUctThreadState& state, std::size_t playout,
                           SgUctValue eval, std::size_t i,
                           const std::size_t firstPlay[],
@@ -1176,6 +1556,9 @@ private:
 
     void UpdateStatistics(const SgUctGameInfo& info);
 
+    void UpdateFromTransposition(SgUctThreadState& state,
+                                 const SgUctNode& node);
+
     void UpdateTree(const SgUctGameInfo& info);
 };
 
@@ -1270,6 +1653,11 @@ inline std::size_t SgUctSearch::MaxNodes() const
     return m_maxNodes;
 }
 
+inline SgUctMemoryMode SgUctSearch::MemoryMode() const
+{
+    return m_tree.MemoryMode();
+}
+
 inline SgUctMoveSelect SgUctSearch::MoveSelect() const
 {
     return m_moveSelect;
@@ -1297,7 +1685,7 @@ inline bool SgUctSearch::UpdateMultiplePlayoutsAsSingle() const
 
 inline void SgUctSearch::PlayGame()
 {
-    PlayGame(ThreadState(0), 0);
+    PlayGame(ThreadState(0));
 }
 
 inline bool SgUctSearch::PruneFullTree() const
@@ -1305,6 +1693,16 @@ inline bool SgUctSearch::PruneFullTree() const
     return m_pruneFullTree;
 }
 
+inline bool SgUctSearch::PruneInPlace() const
+{
+    return m_pruneInPlace;
+}
+
+inline bool SgUctSearch::ProfilePhases() const
+{
+    return m_profilePhases;
+}
+
 inline SgUctValue SgUctSearch::PruneMinCount() const
 {
     return m_pruneMinCount;
@@ -1400,6 +1798,26 @@ SgUctSearch::SetMaxKnowledgeThreads(unsigned int threads)
     m_maxKnowledgeThreads = threads;
 }
 
+inline unsigned int SgUctSearch::AsyncKnowledgeThreads() const
+{
+    return m_asyncKnowledgeThreads;
+}
+
+inline void SgUctSearch::SetAsyncKnowledgeThreads(unsigned int threads)
+{
+    m_asyncKnowledgeThreads = threads;
+}
+
+inline std::size_t SgUctSearch::MaxKnowledgeRequests() const
+{
+    return m_maxKnowledgeRequests;
+}
+
+inline void SgUctSearch::SetMaxKnowledgeRequests(std::size_t n)
+{
+    m_maxKnowledgeRequests = n;
+}
+
 inline void SgUctSearch::SetNumberPlayouts(std::size_t n)
 {
     SG_ASSERT(n >= 1);
@@ -1416,6 +1834,21 @@ inline void SgUctSearch::SetPruneFullTree(bool enable)
     m_pruneFullTree = enable;
 }
 
+inline void SgUctSearch::SetPruneInPlace(bool enable)
+{
+    m_pruneInPlace = enable;
+}
+
+inline void SgUctSearch::SetTranspositions(bool enable)
+{
+    m_transpositions = enable;
+}
+
+inline void SgUctSearch::SetProfilePhases(bool enable)
+{
+    m_profilePhases = enable;
+}
+
 inline void SgUctSearch::SetPruneMinCount(SgUctValue n)
 {
     m_pruneMinCount = n;
@@ -1493,6 +1926,11 @@ inline SgUctThreadState& SgUctSearch::ThreadState(int i) const
     return *m_threads[i]->m_state;
 }
 
+inline bool SgUctSearch::Transpositions() const
+{
+    return m_transpositions;
+}
+
 inline const SgUctTree& SgUctSearch::Tree() const
 {
     return m_tree;
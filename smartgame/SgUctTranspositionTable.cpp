@@ -0,0 +1,94 @@
+//----------------------------------------------------------------------------
+/** @file SgUctTranspositionTable.cpp
+    See SgUctTranspositionTable.h */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+#include "SgUctTranspositionTable.h"
+
+#include <limits>
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+SgUctTranspositionTable::Entry::Entry()
+    : m_key(0)
+{ }
+
+//----------------------------------------------------------------------------
+
+SgUctTranspositionTable::SgUctTranspositionTable(size_t maxEntries)
+    : m_maxEntries(0)
+{
+    SetMaxEntries(maxEntries);
+}
+
+void SgUctTranspositionTable::Add(const SgHashCode& hash, SgUctValue eval,
+                                  SgUctValue count)
+{
+    if (m_maxEntries == 0)
+        return;
+    Entry& entry = m_entries[hash.Hash(static_cast<int>(m_maxEntries))];
+    const unsigned int key = Key(hash);
+    if (entry.m_key.load(boost::memory_order_relaxed) == key
+        && entry.m_statistics.IsDefined())
+        entry.m_statistics.Add(eval, count);
+    else
+    {
+        // Initialize instead of Clear() and Add(), such that concurrent
+        // readers never see an entry with an undefined mean
+        entry.m_statistics.Initialize(eval, count);
+        entry.m_key.store(key, boost::memory_order_relaxed);
+    }
+}
+
+void SgUctTranspositionTable::Clear()
+{
+    for (size_t i = 0; i < m_maxEntries; ++i)
+    {
+        m_entries[i].m_key.store(0, boost::memory_order_relaxed);
+        m_entries[i].m_statistics.Clear();
+    }
+}
+
+/** The index uses the lower bits of the hash code, so the key uses the
+    upper 32 bits. */
+unsigned int SgUctTranspositionTable::Key(const SgHashCode& hash)
+{
+    return hash.Code2();
+}
+
+bool SgUctTranspositionTable::Lookup(const SgHashCode& hash,
+                                     SgUctValue& value,
+                                     SgUctValue& count) const
+{
+    if (m_maxEntries == 0)
+        return false;
+    const Entry& entry =
+        m_entries[hash.Hash(static_cast<int>(m_maxEntries))];
+    if (entry.m_key.load(boost::memory_order_relaxed) != Key(hash)
+        || ! entry.m_statistics.IsDefined())
+        return false;
+    count = entry.m_statistics.Count();
+    value = entry.m_statistics.Mean();
+    return true;
+}
+
+void SgUctTranspositionTable::SetMaxEntries(size_t maxEntries)
+{
+    SG_ASSERT(maxEntries
+              <= static_cast<size_t>(numeric_limits<int>::max()));
+    if (maxEntries == m_maxEntries)
+    {
+        Clear();
+        return;
+    }
+    m_entries.reset(0);
+    m_maxEntries = 0;
+    if (maxEntries > 0)
+        m_entries.reset(new Entry[maxEntries]);
+    m_maxEntries = maxEntries;
+}
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,96 @@
+//----------------------------------------------------------------------------
+/** @file SgUctTranspositionTable.h
+    Class SgUctTranspositionTable */
+//----------------------------------------------------------------------------
+
+#ifndef SG_UCTTRANSPOSITIONTABLE_H
+#define SG_UCTTRANSPOSITIONTABLE_H
+
+#include <cstddef>
+#include <boost/atomic.hpp>
+#include <boost/scoped_array.hpp>
+#include "SgHash.h"
+#include "SgUctValue.h"
+
+//----------------------------------------------------------------------------
+
+/** Move value statistics of positions, shared between transposed nodes of
+    a SgUctTree.
+    Used by SgUctSearch if SgUctSearch::Transpositions() is enabled. The
+    table stores one entry per index; an entry is replaced if a position
+    with a different hash code is stored at the same index.
+
+    The table can be used concurrently without locks. The statistics are
+    updated like the statistics of the nodes in lock-free mode (see
+    @ref sguctsearchlockfreevalues), so some updates can be lost. If two
+    threads replace the same entry at the same time, a few game results can
+    also be added to the wrong position. Both happen with a very low
+    probability and are tolerated by the search.
+    @ingroup sguctgroup */
+class SgUctTranspositionTable
+{
+public:
+    /** Constructor.
+        @param maxEntries The number of entries (0 creates an empty table,
+        which stores nothing) */
+    explicit SgUctTranspositionTable(std::size_t maxEntries = 0);
+
+    /** Remove all positions.
+        Not thread-safe. */
+    void Clear();
+
+    /** The number of entries. */
+    std::size_t MaxEntries() const;
+
+    /** Set the number of entries.
+        Not thread-safe. Removes all positions. */
+    void SetMaxEntries(std::size_t maxEntries);
+
+    /** Get the statistics of a position.
+        @param hash The hash code of the position
+        @param[out] value The mean value of the position
+        @param[out] count The count of the position
+        @return @c false, if the position is not in the table */
+    bool Lookup(const SgHashCode& hash, SgUctValue& value,
+                SgUctValue& count) const;
+
+    /** Add game results to the statistics of a position.
+        Replaces another position stored in the same entry.
+        @param hash The hash code of the position
+        @param eval The game result from the view of the player who made the
+        move to the position (like the move value of a node)
+        @param count The number of times the result is added */
+    void Add(const SgHashCode& hash, SgUctValue eval, SgUctValue count);
+
+private:
+    struct Entry
+    {
+        /** Bits of the hash code that are not used for the index. */
+        boost::atomic<unsigned int> m_key;
+
+        SgUctStatisticsAtomic m_statistics;
+
+        Entry();
+    };
+
+    std::size_t m_maxEntries;
+
+    boost::scoped_array<Entry> m_entries;
+
+    static unsigned int Key(const SgHashCode& hash);
+
+    /** Not implemented */
+    SgUctTranspositionTable(const SgUctTranspositionTable&);
+
+    /** Not implemented */
+    SgUctTranspositionTable& operator=(const SgUctTranspositionTable&);
+};
+
+inline std::size_t SgUctTranspositionTable::MaxEntries() const
+{
+    return m_maxEntries;
+}
+
+//----------------------------------------------------------------------------
+
+#endif // SG_UCTTRANSPOSITIONTABLE_H
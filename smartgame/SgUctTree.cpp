@@ -6,22 +6,97 @@
 #include "SgSystem.h"
 #include "SgUctTree.h"
 
+#include <algorithm>
 #include <boost/format.hpp>
 #include "SgDebug.h"
 #include "SgTimer.h"
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 using boost::format;
 using boost::shared_ptr;
 
 //----------------------------------------------------------------------------
 
-SgUctAllocator::~SgUctAllocator()
+namespace {
+
+/** Size of huge pages used for aligning the storage.
+    2 MB on Intel-64. Larger huge pages are only used if explicitly
+    configured in the operating system. */
+const std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+/** Size for touching the pages in SgUctAllocator::FirstTouch().
+    The smallest page size of all supported platforms. */
+const std::size_t TOUCH_PAGE_SIZE = 4096;
+
+#ifdef HAVE_SYS_MMAN_H
+
+/** Map anonymous memory aligned to HUGE_PAGE_SIZE.
+    @return The memory or 0 if the mapping failed. */
+void* MapHugePages(std::size_t size, SgUctMemoryMode mode)
 {
-    if (m_start != 0)
+#ifdef MAP_HUGETLB
+    if (mode == SG_UCTMEMORY_HUGETLB)
     {
-        Clear();
-        std::free(m_start);
+        void* ptr = mmap(0, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+            return ptr;
+        SgDebug() << "SgUctAllocator: no reserved huge pages available,"
+                     " using transparent huge pages\n";
     }
+#else
+    SG_UNUSED(mode);
+#endif
+    // Map more than needed and unmap the unaligned parts, because mmap only
+    // guarantees alignment to the normal page size
+    void* ptr = mmap(0, size + HUGE_PAGE_SIZE, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (ptr == MAP_FAILED)
+        return 0;
+    char* start = static_cast<char*>(ptr);
+    char* aligned = start + (HUGE_PAGE_SIZE
+                             - reinterpret_cast<std::size_t>(start)
+                               % HUGE_PAGE_SIZE) % HUGE_PAGE_SIZE;
+    if (aligned > start)
+        munmap(start, aligned - start);
+    char* end = start + size + HUGE_PAGE_SIZE;
+    if (end > aligned + size)
+        munmap(aligned + size, end - (aligned + size));
+#ifdef MADV_HUGEPAGE
+    madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+    return aligned;
+}
+
+#endif // HAVE_SYS_MMAN_H
+
+} // namespace
+
+//----------------------------------------------------------------------------
+
+SgUctAllocator::~SgUctAllocator()
+{
+    FreeStorage();
+}
+
+/** Get storage for n nodes from the smallest reclaimed block that is large
+    enough. The remainder of the block stays reclaimed. */
+SgUctNode* SgUctAllocator::AllocateFromFreeBlocks(std::size_t n)
+{
+    FreeBlocks::iterator it = m_freeBlocks.lower_bound(n);
+    SG_ASSERT(it != m_freeBlocks.end());
+    const std::size_t size = it->first;
+    SgUctNode* first = it->second;
+    m_freeBlocks.erase(it);
+    if (size > n)
+        m_freeBlocks.insert(FreeBlocks::value_type(size - n, first + n));
+    m_nuFreeNodes -= n;
+    for (SgUctNode* node = first; node != first + n; ++node)
+        node->~SgUctNode();
+    return first;
 }
 
 bool SgUctAllocator::Contains(const SgUctNode& node) const
@@ -34,21 +109,94 @@ void SgUctAllocator::Swap(SgUctAllocator& allocator)
     std::swap(m_start, allocator.m_start);
     std::swap(m_finish, allocator.m_finish);
     std::swap(m_endOfStorage, allocator.m_endOfStorage);
+    m_freeBlocks.swap(allocator.m_freeBlocks);
+    std::swap(m_nuFreeNodes, allocator.m_nuFreeNodes);
+    std::swap(m_mappedSize, allocator.m_mappedSize);
+    std::swap(m_isTouched, allocator.m_isTouched);
 }
 
-void SgUctAllocator::SetMaxNodes(std::size_t maxNodes)
+void SgUctAllocator::Sweep(const std::vector<bool>& isMarked)
 {
-    if (m_start != 0)
+    const std::size_t size = m_finish - m_start;
+    SG_ASSERT(isMarked.size() == size);
+    m_freeBlocks.clear();
+    m_nuFreeNodes = 0;
+    std::size_t last = size;
+    while (last > 0 && ! isMarked[last - 1])
+        --last;
+    for (SgUctNode* it = m_start + last; it != m_finish; ++it)
+        it->~SgUctNode();
+    m_finish = m_start + last;
+    std::size_t i = 0;
+    while (i < last)
     {
-        Clear();
+        if (isMarked[i])
+        {
+            ++i;
+            continue;
+        }
+        std::size_t begin = i;
+        while (! isMarked[i])
+            ++i;
+        m_freeBlocks.insert(FreeBlocks::value_type(i - begin,
+                                                   m_start + begin));
+        m_nuFreeNodes += i - begin;
+    }
+}
+
+void SgUctAllocator::FirstTouch()
+{
+    if (m_isTouched)
+        return;
+    char* begin = reinterpret_cast<char*>(m_finish);
+    char* end = reinterpret_cast<char*>(m_endOfStorage);
+    for (char* p = begin; p < end; p += TOUCH_PAGE_SIZE)
+        *p = 0;
+    m_isTouched = true;
+}
+
+void SgUctAllocator::FreeStorage()
+{
+    if (m_start == 0)
+        return;
+    Clear();
+#ifdef HAVE_SYS_MMAN_H
+    if (m_mappedSize > 0)
+        munmap(m_start, m_mappedSize);
+    else
+#endif
         std::free(m_start);
+    m_start = 0;
+    m_mappedSize = 0;
+}
+
+void SgUctAllocator::SetMaxNodes(std::size_t maxNodes, SgUctMemoryMode mode)
+{
+    FreeStorage();
+    std::size_t size = maxNodes * sizeof(SgUctNode);
+    void* ptr = 0;
+#ifdef HAVE_SYS_MMAN_H
+    if (mode != SG_UCTMEMORY_DEFAULT && size > 0)
+    {
+        std::size_t mappedSize =
+            (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+        ptr = MapHugePages(mappedSize, mode);
+        if (ptr != 0)
+            m_mappedSize = mappedSize;
     }
-    void* ptr = std::malloc(maxNodes * sizeof(SgUctNode));
+#else
+    SG_UNUSED(mode);
+#endif
     if (ptr == 0)
-        throw std::bad_alloc();
+    {
+        ptr = std::malloc(size);
+        if (ptr == 0)
+            throw std::bad_alloc();
+    }
     m_start = static_cast<SgUctNode*>(ptr);
     m_finish = m_start;
     m_endOfStorage = m_start + maxNodes;
+    m_isTouched = (m_mappedSize == 0);
 }
 
 //----------------------------------------------------------------------------
@@ -112,6 +260,7 @@ std::ostream& operator<<(std::ostream& stream, const SgUctProvenType& type)
 
 SgUctTree::SgUctTree()
     : m_maxNodes(0),
+      m_memoryMode(SG_UCTMEMORY_DEFAULT),
       m_root(SG_NULLMOVE)
 { }
 
@@ -124,32 +273,35 @@ void SgUctTree::ApplyFilter(std::size_t allocatorId,
     if (! node.HasChildren())
         return;
 
+    int nuChildren = 0;
+    for (SgUctChildIterator it(*this, node); it; ++it)
+        if (find(rootFilter.begin(), rootFilter.end(), (*it).Move())
+            == rootFilter.end())
+            ++nuChildren;
     SgUctAllocator& allocator = Allocator(allocatorId);
-    const SgUctNode* firstChild = allocator.Finish();
+    const SgUctNode* firstChild = allocator.CreateN(nuChildren);
 
-    int nuChildren = 0;
+    SgUctNode* child = const_cast<SgUctNode*>(firstChild);
     for (SgUctChildIterator it(*this, node); it; ++it)
     {
         SgMove move = (*it).Move();
         if (find(rootFilter.begin(), rootFilter.end(), move)
             == rootFilter.end())
         {
-            SgUctNode* child = allocator.CreateOne(move);
             child->CopyDataFrom(*it);
             int childNuChildren = (*it).NuChildren();
             child->SetNuChildren(childNuChildren);
             if (childNuChildren > 0)
                 child->SetFirstChild((*it).FirstChild());
-            ++nuChildren;
+            ++child;
         }
     }
 
     SgUctNode& nonConstNode = const_cast<SgUctNode&>(node);
     // Write order dependency: SgUctSearch in lock-free mode assumes that
-    // m_firstChild is valid if m_nuChildren is greater zero
-    SgSynchronizeThreadMemory();
+    // m_firstChild is valid if m_nuChildren is greater zero (guaranteed by
+    // the release stores in SgUctNode)
     nonConstNode.SetFirstChild(firstChild);
-    SgSynchronizeThreadMemory();
     nonConstNode.SetNuChildren(nuChildren);
 }
 
@@ -161,11 +313,12 @@ void SgUctTree::SetChildren(std::size_t allocatorId, const SgUctNode& node,
     SG_ASSERT(node.HasChildren());
 
     SgUctAllocator& allocator = Allocator(allocatorId);
-    const SgUctNode* firstChild = allocator.Finish();
+    const SgUctNode* firstChild = allocator.CreateN(moves.size());
 
     int nuChildren = 0;
     for (size_t i = 0; i < moves.size(); ++i)
     {
+        SgUctNode* child = const_cast<SgUctNode*>(&firstChild[i]);
         bool found = false;
         for (SgUctChildIterator it(*this, node); it; ++it)
         {
@@ -173,7 +326,6 @@ void SgUctTree::SetChildren(std::size_t allocatorId, const SgUctNode& node,
             if (move == moves[i])
             {
                 found = true;
-                SgUctNode* child = allocator.CreateOne(move);
                 child->CopyDataFrom(*it);
                 int childNuChildren = (*it).NuChildren();
                 child->SetNuChildren(childNuChildren);
@@ -185,7 +337,7 @@ void SgUctTree::SetChildren(std::size_t allocatorId, const SgUctNode& node,
         }
         if (! found)
         {
-            allocator.CreateOne(moves[i]);
+            *child = SgUctNode(moves[i]);
             ++nuChildren;
         }
     }
@@ -193,10 +345,9 @@ void SgUctTree::SetChildren(std::size_t allocatorId, const SgUctNode& node,
 
     SgUctNode& nonConstNode = const_cast<SgUctNode&>(node);
     // Write order dependency: SgUctSearch in lock-free mode assumes that
-    // m_firstChild is valid if m_nuChildren is greater zero
-    SgSynchronizeThreadMemory();
+    // m_firstChild is valid if m_nuChildren is greater zero (guaranteed by
+    // the release stores in SgUctNode)
     nonConstNode.SetFirstChild(firstChild);
-    SgSynchronizeThreadMemory();
     nonConstNode.SetNuChildren(nuChildren);
 }
 
@@ -312,13 +463,11 @@ SgUctProvenType SgUctTree::CopySubtree(SgUctTree& target, SgUctNode& targetNode,
         return SG_NOT_PROVEN;
     }
 
-    SgUctNode* firstTargetChild = targetAllocator.Finish();
+    // Create target nodes first (must be contiguous in the target tree)
+    SgUctNode* firstTargetChild = targetAllocator.CreateN(nuChildren);
     targetNode.SetFirstChild(firstTargetChild);
     targetNode.SetNuChildren(nuChildren);
 
-    // Create target nodes first (must be contiguous in the target tree)
-    targetAllocator.CreateN(nuChildren);
-
     // Recurse
     SgUctProvenType childProvenType;
     SgUctProvenType parentProvenType = SG_PROVEN_LOSS;
@@ -395,7 +544,6 @@ void SgUctTree::MergeChildren(std::size_t allocatorId, const SgUctNode& node,
     {
         // Write order dependency
         nonConstNode.SetNuChildren(0);
-        SgSynchronizeThreadMemory();
         nonConstNode.SetFirstChild(0);
         return;
     }
@@ -403,8 +551,8 @@ void SgUctTree::MergeChildren(std::size_t allocatorId, const SgUctNode& node,
     SgUctAllocator& allocator = Allocator(allocatorId);
     SG_ASSERT(allocator.HasCapacity(nuNewChildren));
 
-    const SgUctNode* newFirstChild = allocator.Finish();
-    SgUctValue parentCount = allocator.Create(moves);
+    SgUctValue parentCount;
+    const SgUctNode* newFirstChild = allocator.Create(moves, parentCount);
     
     // Update new children with data in old children
     for (std::size_t i = 0; i < moves.size(); ++i) 
@@ -436,22 +584,28 @@ void SgUctTree::MergeChildren(std::size_t allocatorId, const SgUctNode& node,
     // Write order dependency: We do not want an SgUctChildIterator to
     // run past the end of a node's children, which can happen if one
     // is created between the two statements below. We modify node in
-    // such a way so as to avoid that.
-    SgSynchronizeThreadMemory();
+    // such a way so as to avoid that. The release stores in SgUctNode keep
+    // the two writes in program order.
     if (nonConstNode.NuChildren() < nuNewChildren)
     {
         nonConstNode.SetFirstChild(newFirstChild);
-        SgSynchronizeThreadMemory();
         nonConstNode.SetNuChildren(nuNewChildren);
     }
     else
     {
         nonConstNode.SetNuChildren(nuNewChildren);
-        SgSynchronizeThreadMemory();
         nonConstNode.SetFirstChild(newFirstChild);
     }
 }
 
+void SgUctTree::PromoteSubtree(const SgUctNode& node)
+{
+    SG_ASSERT(Contains(node));
+    if (&node == &m_root)
+        return;
+    m_root = node;
+}
+
 std::size_t SgUctTree::NuNodes() const
 {
     size_t nuNodes = 1; // Count root node
@@ -460,6 +614,71 @@ std::size_t SgUctTree::NuNodes() const
     return nuNodes;
 }
 
+/** Mark the block of children of a node as used for
+    SgUctAllocator::Sweep(). */
+void SgUctTree::MarkChildren(const SgUctNode& node,
+                             std::vector<std::vector<bool> >& isMarked) const
+{
+    SG_ASSERT(node.HasChildren());
+    const SgUctNode* firstChild = node.FirstChild();
+    for (size_t i = 0; i < NuAllocators(); ++i)
+        if (Allocator(i).Contains(*firstChild))
+        {
+            std::vector<bool>::iterator begin =
+                isMarked[i].begin() + (firstChild - Allocator(i).Start());
+            std::fill(begin, begin + node.NuChildren(), true);
+            return;
+        }
+    SG_ASSERT(false);
+}
+
+void SgUctTree::PruneLowCount(SgUctValue minCount)
+{
+    std::vector<std::vector<bool> > isMarked(NuAllocators());
+    for (size_t i = 0; i < NuAllocators(); ++i)
+        isMarked[i].resize(Allocator(i).NuNodes()
+                           + Allocator(i).NuFreeNodes(), false);
+    PruneSubtree(m_root, minCount, isMarked);
+    for (size_t i = 0; i < NuAllocators(); ++i)
+        Allocator(i).Sweep(isMarked[i]);
+}
+
+/** Recursive function used by SgUctTree::PruneLowCount.
+    Removes the children of nodes below the minimum count, marks the
+    remaining nodes and updates the proven types like CopySubtree(). */
+SgUctProvenType SgUctTree::PruneSubtree(const SgUctNode& node,
+                                        SgUctValue minCount,
+                                        std::vector<std::vector<bool> >&
+                                        isMarked)
+{
+    SG_ASSERT(Contains(node));
+    if (! node.HasChildren())
+        return node.ProvenType();
+    SgUctNode& nonConstNode = const_cast<SgUctNode&>(node);
+    if (&node != &m_root && node.MoveCount() < minCount)
+    {
+        // Write order dependency, see MergeChildren()
+        nonConstNode.SetNuChildren(0);
+        nonConstNode.SetFirstChild(0);
+        nonConstNode.SetProvenType(SG_NOT_PROVEN);
+        return SG_NOT_PROVEN;
+    }
+    MarkChildren(node, isMarked);
+    SgUctProvenType childProvenType;
+    SgUctProvenType parentProvenType = SG_PROVEN_LOSS;
+    for (SgUctChildIterator it(*this, node); it; ++it)
+    {
+        childProvenType = PruneSubtree(*it, minCount, isMarked);
+        if (childProvenType == SG_PROVEN_LOSS)
+            parentProvenType = SG_PROVEN_WIN;
+        else if (  parentProvenType != SG_PROVEN_WIN
+                && childProvenType == SG_NOT_PROVEN)
+            parentProvenType = SG_NOT_PROVEN;
+    }
+    nonConstNode.SetProvenType(parentProvenType);
+    return parentProvenType;
+}
+
 void SgUctTree::SetMaxNodes(std::size_t maxNodes)
 {
     Clear();
@@ -473,7 +692,14 @@ void SgUctTree::SetMaxNodes(std::size_t maxNodes)
     m_maxNodes = maxNodes;
     size_t maxNodesPerAlloc = maxNodes / nuAllocators;
     for (size_t i = 0; i < NuAllocators(); ++i)
-        Allocator(i).SetMaxNodes(maxNodesPerAlloc);
+        Allocator(i).SetMaxNodes(maxNodesPerAlloc, m_memoryMode);
+}
+
+void SgUctTree::SetMemoryMode(SgUctMemoryMode mode)
+{
+    m_memoryMode = mode;
+    if (NuAllocators() > 0)
+        SetMaxNodes(m_maxNodes);
 }
 
 void SgUctTree::Swap(SgUctTree& tree)
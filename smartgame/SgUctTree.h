@@ -8,7 +8,10 @@
 
 #include <iostream>
 #include <limits>
+#include <map>
 #include <stack>
+#include <vector>
+#include <boost/atomic.hpp>
 #include <boost/shared_ptr.hpp>
 #include "SgMove.h"
 #include "SgStatistics.h"
@@ -129,12 +132,18 @@ std::ostream& operator<<(std::ostream& stream, const SgUctProvenType& type);
 //----------------------------------------------------------------------------
 
 /** Node used in SgUctTree.
-    All data members are declared as volatile to avoid that the compiler
-    re-orders writes, which can break assumptions made by SgUctSearch in
-    lock-free mode (see @ref sguctsearchlockfree). For example, the search
+    Data members that are modified during a search are atomic variables with
+    explicit memory ordering to guarantee the assumptions made by SgUctSearch
+    in lock-free mode (see @ref sguctsearchlockfree). For example, the search
     relies on the fact that m_firstChild is valid, if m_nuChildren is greater
     zero or that the mean value of the move and RAVE value statistics is valid
     if the corresponding count is greater zero.
+
+    The data members are split into a hot part, which is read for every
+    child in SgUctSearch::SelectChild() and written in every update of the
+    tree, and a cold part, which is rarely written. The hot part is at the
+    beginning of the node and fits into a single 64-byte cache line if
+    SgUctValue is double.
     @ingroup sguctgroup */
 class SgUctNode
 {
@@ -142,6 +151,14 @@ public:
     /** Initializes node with given move, value and count. */
     SgUctNode(const SgUctMoveInfo& info);
 
+    /** Copy constructor.
+        Copies all data including the children information. Only used for
+        nodes that are not concurrently modified (e.g. the root node). */
+    SgUctNode(const SgUctNode& node);
+
+    /** See copy constructor. */
+    SgUctNode& operator=(const SgUctNode& node);
+
     /** Add game result.
         @param eval The game result (e.g. score or 0/1 for win loss) */
     void AddGameResult(SgUctValue eval);
@@ -278,29 +295,45 @@ public:
     void SetProvenType(SgUctProvenType type);
 
 private:
-    SgUctStatisticsVolatile m_statistics;
-
-    const SgUctNode* volatile m_firstChild;
-
-    volatile int m_nuChildren;
-
-    volatile SgMove m_move;
+    /** @name Hot data
+        Read in the selection of children and written in updates. */
+    // @{
 
-    /* Value of additive predictor */
-    volatile float m_predictorValue;
+    SgUctStatisticsAtomic m_statistics;
 
     /** RAVE statistics.
         Uses double for count to allow adding fractional values if RAVE
         updates are weighted. */
-    SgUctStatisticsVolatile m_raveValue;
+    SgUctStatisticsAtomic m_raveValue;
+
+    boost::atomic<SgUctValue> m_posCount;
 
-    volatile SgUctValue m_posCount;
+    boost::atomic<const SgUctNode*> m_firstChild;
 
-    volatile SgUctValue m_knowledgeCount;
+    boost::atomic<int> m_nuChildren;
 
-    volatile SgUctProvenType m_provenType;
+    boost::atomic<int> m_virtualLossCount;
 
-    volatile int m_virtualLossCount;
+    /** Move of the node.
+        Not atomic, because it is written only before the node is linked
+        to its parent (see SgUctTree::CreateChildren()). */
+    SgMove m_move;
+
+    // @} // @name
+
+
+    /** @name Cold data */
+    // @{
+
+    /** Value of additive predictor.
+        Not atomic, see m_move. */
+    float m_predictorValue;
+
+    boost::atomic<SgUctProvenType> m_provenType;
+
+    boost::atomic<SgUctValue> m_knowledgeCount;
+
+    // @} // @name
 };
 
 //----------------------------------------------------------------------------
@@ -310,16 +343,36 @@ std::ostream& operator<<(std::ostream& stream, const SgUctNode& node);
 //----------------------------------------------------------------------------
 inline SgUctNode::SgUctNode(const SgUctMoveInfo& info)
     : m_statistics(info.m_value, info.m_count),
+      m_raveValue(info.m_raveValue, info.m_raveCount),
+      m_posCount(0),
+      m_firstChild(0),
       m_nuChildren(0),
+      m_virtualLossCount(0),
       m_move(info.m_move),
       m_predictorValue(info.m_predictorValue),
-      m_raveValue(info.m_raveValue, info.m_raveCount),
-      m_posCount(0),
-      m_knowledgeCount(0),
       m_provenType(SG_NOT_PROVEN),
-      m_virtualLossCount(0)
+      m_knowledgeCount(0)
+{ }
+
+inline SgUctNode::SgUctNode(const SgUctNode& node)
+    : m_statistics(node.m_statistics),
+      m_raveValue(node.m_raveValue),
+      m_posCount(node.PosCount()),
+      m_firstChild(node.m_firstChild.load(boost::memory_order_acquire)),
+      m_nuChildren(node.NuChildren()),
+      m_virtualLossCount(node.VirtualLossCount()),
+      m_move(node.m_move),
+      m_predictorValue(node.m_predictorValue),
+      m_provenType(node.ProvenType()),
+      m_knowledgeCount(node.KnowledgeCount())
+{ }
+
+inline SgUctNode& SgUctNode::operator=(const SgUctNode& node)
 {
-    // m_firstChild is not initialized, only defined if m_nuChildren > 0
+    CopyDataFrom(node);
+    SetFirstChild(node.m_firstChild.load(boost::memory_order_acquire));
+    SetNuChildren(node.NuChildren());
+    return *this;
 }
 
 inline void SgUctNode::AddGameResult(SgUctValue eval)
@@ -371,36 +424,27 @@ inline void SgUctNode::CopyDataFrom(const SgUctNode& node)
     m_move = node.m_move;
     m_predictorValue = node.m_predictorValue;
     m_raveValue = node.m_raveValue;
-    m_posCount = node.m_posCount;
-    m_knowledgeCount = node.m_knowledgeCount;
-    m_provenType = node.m_provenType;
-    m_virtualLossCount = node.m_virtualLossCount;
+    SetPosCount(node.PosCount());
+    SetKnowledgeCount(node.KnowledgeCount());
+    SetProvenType(node.ProvenType());
+    m_virtualLossCount.store(node.VirtualLossCount(),
+                             boost::memory_order_relaxed);
 }
 
 inline const SgUctNode* SgUctNode::FirstChild() const
 {
     SG_ASSERT(HasChildren()); // Otherwise m_firstChild is undefined
-    return m_firstChild;
+    return m_firstChild.load(boost::memory_order_acquire);
 }
 
 inline bool SgUctNode::HasChildren() const
 {
-    // Read-order dependency.  Calls to HasChildren() are often used
-    // to decide whether a node has children and whether those
-    // children can safely be iterated over.  A problem can occur if
-    // the compiler or the processor's out-of-order execution engine
-    // executes the iterator constructor before the test for children
-    // when the node's children are being allocated in parallel.  The
-    // iterator constructor can be executed before the children are
-    // created and thereby receive a null pointer, but the test for
-    // children can be called after allocation completes and therefore
-    // succeeds.  The end result is a null pointer exception.  The
-    // memory synchronization below is necessary on architectures that
-    // do not guarantee read order consistency.
-
-    bool retval = (m_nuChildren > 0);
-    SgSynchronizeThreadMemory();
-    return retval;
+    // Read-order dependency. Calls to HasChildren() are often used to decide
+    // whether a node has children and whether those children can safely be
+    // iterated over. The acquire load pairs with the release store in
+    // SetNuChildren(), so the children and m_firstChild written before
+    // are visible if the result is true.
+    return NuChildren() > 0;
 }
 
 inline bool SgUctNode::HasMean() const
@@ -415,48 +459,42 @@ inline bool SgUctNode::HasRaveValue() const
 
 inline int SgUctNode::VirtualLossCount() const
 {
-    return m_virtualLossCount;
+    return m_virtualLossCount.load(boost::memory_order_relaxed);
 }
 
 inline void SgUctNode::AddVirtualLoss()
 {
-    m_virtualLossCount++;
+    m_virtualLossCount.fetch_add(1, boost::memory_order_relaxed);
 }
 
 inline void SgUctNode::RemoveVirtualLoss()
 {
-    // May become negative with lock-free multithreading.  Negative
-    // values are allowed so that errors introduced by multithreading
-    // will tend to average out.
-    m_virtualLossCount--;
+    m_virtualLossCount.fetch_sub(1, boost::memory_order_relaxed);
 }
 
 inline void SgUctNode::IncPosCount()
 {
-    ++m_posCount;
+    // Not a read-modify-write operation to avoid a locked instruction on the
+    // most contended nodes; lost updates are tolerated like in the move and
+    // RAVE statistics (see @ref sguctsearchlockfreevalues)
+    IncPosCount(1);
 }
 
 inline void SgUctNode::IncPosCount(SgUctValue count)
 {
-    m_posCount += count;
+    SetPosCount(PosCount() + count);
 }
 
 inline void SgUctNode::DecPosCount()
 {
-    SgUctValue posCount = m_posCount;
-    if (posCount > 0)
-    {
-        m_posCount = posCount - 1;
-    }
+    DecPosCount(1);
 }
 
 inline void SgUctNode::DecPosCount(SgUctValue count)
 {
-    SgUctValue posCount = m_posCount;
+    SgUctValue posCount = PosCount();
     if (posCount >= count)
-    {
-        m_posCount = posCount - count;
-    }
+        SetPosCount(posCount - count);
 }
 
 inline bool SgUctNode::HasMove() const
@@ -492,12 +530,12 @@ inline SgUctValue SgUctNode::MoveCount() const
 
 inline int SgUctNode::NuChildren() const
 {
-    return m_nuChildren;
+    return m_nuChildren.load(boost::memory_order_acquire);
 }
 
 inline SgUctValue SgUctNode::PosCount() const
 {
-    return m_posCount;
+    return m_posCount.load(boost::memory_order_relaxed);
 }
 
 inline float SgUctNode::PredictorValue() const
@@ -517,60 +555,88 @@ inline SgUctValue SgUctNode::RaveValue() const
 
 inline void SgUctNode::SetFirstChild(const SgUctNode* child)
 {
-    m_firstChild = child;
+    m_firstChild.store(child, boost::memory_order_release);
 }
 
 inline void SgUctNode::SetNuChildren(int nuChildren)
 {
     SG_ASSERT(nuChildren >= 0);
-    m_nuChildren = nuChildren;
+    m_nuChildren.store(nuChildren, boost::memory_order_release);
 }
 
 inline void SgUctNode::SetPosCount(SgUctValue value)
 {
-    m_posCount = value;
+    m_posCount.store(value, boost::memory_order_relaxed);
 }
 
 inline SgUctValue SgUctNode::KnowledgeCount() const
 {
-    return m_knowledgeCount;
+    return m_knowledgeCount.load(boost::memory_order_relaxed);
 }
 
 inline void SgUctNode::SetKnowledgeCount(SgUctValue count)
 {
-    m_knowledgeCount = count;
+    m_knowledgeCount.store(count, boost::memory_order_relaxed);
 }
 
 inline bool SgUctNode::IsProven() const
 {
-    return m_provenType != SG_NOT_PROVEN;
+    return ProvenType() != SG_NOT_PROVEN;
 }
 
 inline bool SgUctNode::IsProvenWin() const
 {
-    return m_provenType == SG_PROVEN_WIN;
+    return ProvenType() == SG_PROVEN_WIN;
 }
 
 inline bool SgUctNode::IsProvenLoss() const
 {
-    return m_provenType == SG_PROVEN_LOSS;
+    return ProvenType() == SG_PROVEN_LOSS;
 }
 
 inline SgUctProvenType SgUctNode::ProvenType() const
 {
-    return m_provenType;
+    return m_provenType.load(boost::memory_order_relaxed);
 }
 
 inline void SgUctNode::SetProvenType(SgUctProvenType type)
 {
-    m_provenType = type;
+    m_provenType.store(type, boost::memory_order_relaxed);
 }
 
 //----------------------------------------------------------------------------
 
+/** How SgUctAllocator gets the storage for its nodes.
+    In the huge page modes, the storage is not touched when it is allocated.
+    The search thread that owns the allocator touches it before its first
+    use (see SgUctAllocator::FirstTouch()), so that on NUMA systems with a
+    first-touch policy the pages are local to that thread. If huge pages are
+    not supported on the platform, the huge page modes fall back to normal
+    pages.
+    @ingroup sguctgroup */
+enum SgUctMemoryMode
+{
+    /** Allocate with malloc. */
+    SG_UCTMEMORY_DEFAULT,
+
+    /** Use transparent huge pages. */
+    SG_UCTMEMORY_HUGEPAGES,
+
+    /** Use pages reserved for explicit huge page mappings (hugetlbfs on
+        Linux). Falls back to SG_UCTMEMORY_HUGEPAGES if no reserved huge
+        pages are available. */
+    SG_UCTMEMORY_HUGETLB
+};
+
+//----------------------------------------------------------------------------
+
 /** Allocater for nodes used in the implementation of SgUctTree.
     Each thread has its own node allocator to allow lock-free usage of
     SgUctTree.
+    Nodes are allocated in contiguous blocks from the end of the storage.
+    If the storage is exhausted, blocks that were reclaimed by Sweep() are
+    reused. Reclaimed nodes stay constructed until they are reused or the
+    allocator is cleared.
     @ingroup sguctgroup */
 class SgUctAllocator
 {
@@ -581,14 +647,29 @@ public:
 
     void Clear();
 
-    /** Does the allocator have the capacity for n more nodes? */
+    /** Does the allocator have the capacity for n more contiguous nodes? */
     bool HasCapacity(std::size_t n) const;
 
+    /** Number of nodes in use.
+        Does not include nodes reclaimed by Sweep(). */
     std::size_t NuNodes() const;
 
+    /** Number of nodes reclaimed by Sweep() and not yet reused. */
+    std::size_t NuFreeNodes() const;
+
     std::size_t MaxNodes() const;
 
-    void SetMaxNodes(std::size_t maxNodes);
+    /** Allocate new storage.
+        Also clears the allocator.
+        @param maxNodes The number of nodes
+        @param mode See SgUctMemoryMode */
+    void SetMaxNodes(std::size_t maxNodes,
+                     SgUctMemoryMode mode = SG_UCTMEMORY_DEFAULT);
+
+    /** Touch the unused part of the storage from the calling thread.
+        Does nothing, if the storage was already touched (which is always the
+        case in mode SG_UCTMEMORY_DEFAULT). */
+    void FirstTouch();
 
     /** Check if allocator contains node.
         This function uses pointer comparisons. Since the result of
@@ -604,32 +685,61 @@ public:
 
     const SgUctNode* Finish() const;
 
-    /** Create a new node at the end of the storage.
-        REQUIRES: HasCapacity(1)
-        @param move The constructor argument.
-        @return A pointer to new newly created node. */
-    SgUctNode* CreateOne(SgMove move);
-
-    /** Create a number of new nodes with a given list of moves at the end of
-        the storage. Returns the sum of counts of moves.
+    /** Create a contiguous block of new nodes with a given list of moves.
         REQUIRES: HasCapacity(moves.size())
-        @param moves The list of moves. */
-    SgUctValue Create(const std::vector<SgUctMoveInfo>& moves);
+        @param moves The list of moves.
+        @param[out] count The sum of counts of moves.
+        @return A pointer to the first new node. */
+    SgUctNode* Create(const std::vector<SgUctMoveInfo>& moves,
+                      SgUctValue& count);
 
-    /** Create a number of new nodes at the end of the storage.
+    /** Create a contiguous block of new nodes without move.
         REQUIRES: HasCapacity(n)
-        @param n The number of nodes to create. */
-    void CreateN(std::size_t n);
+        @param n The number of nodes to create.
+        @return A pointer to the first new node. */
+    SgUctNode* CreateN(std::size_t n);
+
+    /** Reclaim all nodes that are not marked.
+        Replaces the reclaimed blocks by the unmarked ranges of the storage.
+        Unmarked nodes at the end of the storage are destroyed, the others
+        are kept for reuse by the create functions.
+        @param isMarked Flags for the nodes in use, indexed by the position
+        of the node in the storage (must have NuNodes() + NuFreeNodes()
+        elements) */
+    void Sweep(const std::vector<bool>& isMarked);
 
     void Swap(SgUctAllocator& allocator);
 
 private:
+    /** Reclaimed blocks of nodes, indexed by size. */
+    typedef std::multimap<std::size_t,SgUctNode*> FreeBlocks;
+
     SgUctNode* m_start;
 
     SgUctNode* m_finish;
 
     SgUctNode* m_endOfStorage;
 
+    FreeBlocks m_freeBlocks;
+
+    /** Total number of nodes in m_freeBlocks. */
+    std::size_t m_nuFreeNodes;
+
+    /** Size of the storage in bytes, if it was mapped with mmap.
+        Zero, if the storage was allocated with malloc. */
+    std::size_t m_mappedSize;
+
+    /** See FirstTouch() */
+    bool m_isTouched;
+
+    void FreeStorage();
+
+    /** Get storage for n contiguous nodes.
+        The nodes are not constructed. */
+    SgUctNode* Allocate(std::size_t n);
+
+    SgUctNode* AllocateFromFreeBlocks(std::size_t n);
+
     /** Not implemented.
         Cannot be copied because array contains pointers to elements.
         Use Swap() instead. */
@@ -637,10 +747,25 @@ private:
 };
 
 inline SgUctAllocator::SgUctAllocator()
+    : m_nuFreeNodes(0),
+      m_mappedSize(0),
+      m_isTouched(true)
 {
     m_start = 0;
 }
 
+inline SgUctNode* SgUctAllocator::Allocate(std::size_t n)
+{
+    SG_ASSERT(HasCapacity(n));
+    if (m_finish + n <= m_endOfStorage)
+    {
+        SgUctNode* first = m_finish;
+        m_finish += n;
+        return first;
+    }
+    return AllocateFromFreeBlocks(n);
+}
+
 inline void SgUctAllocator::Clear()
 {
     if (m_start != 0)
@@ -649,35 +774,32 @@ inline void SgUctAllocator::Clear()
             it->~SgUctNode();
         m_finish = m_start;
     }
+    m_freeBlocks.clear();
+    m_nuFreeNodes = 0;
 }
 
-inline SgUctNode* SgUctAllocator::CreateOne(SgMove move)
-{
-    SG_ASSERT(HasCapacity(1));
-    new(m_finish) SgUctNode(move);
-    return (m_finish++);
-}
-
-inline SgUctValue SgUctAllocator::Create(
-                                         const std::vector<SgUctMoveInfo>& moves)
+inline SgUctNode* SgUctAllocator::Create(
+                                   const std::vector<SgUctMoveInfo>& moves,
+                                   SgUctValue& count)
 {
-    SG_ASSERT(HasCapacity(moves.size()));
-    SgUctValue count = 0;
+    SgUctNode* first = Allocate(moves.size());
+    SgUctNode* node = first;
+    count = 0;
     for (std::vector<SgUctMoveInfo>::const_iterator it = moves.begin();
-         it != moves.end(); ++it, ++m_finish)
+         it != moves.end(); ++it, ++node)
     {
-        new(m_finish) SgUctNode(*it);
+        new(node) SgUctNode(*it);
         count += it->m_count;
     }
-    return count;
+    return first;
 }
 
-inline void SgUctAllocator::CreateN(std::size_t n)
+inline SgUctNode* SgUctAllocator::CreateN(std::size_t n)
 {
-    SG_ASSERT(HasCapacity(n));
-    SgUctNode* newFinish = m_finish + n;
-    for ( ; m_finish != newFinish; ++m_finish)
-        new(m_finish) SgUctNode(SG_NULLMOVE);
+    SgUctNode* first = Allocate(n);
+    for (SgUctNode* node = first; node != first + n; ++node)
+        new(node) SgUctNode(SG_NULLMOVE);
+    return first;
 }
 
 inline SgUctNode* SgUctAllocator::Finish()
@@ -692,7 +814,11 @@ inline const SgUctNode* SgUctAllocator::Finish() const
 
 inline bool SgUctAllocator::HasCapacity(std::size_t n) const
 {
-    return (m_finish + n <= m_endOfStorage);
+    return (  m_finish + n <= m_endOfStorage
+           || (  ! m_freeBlocks.empty()
+              && m_freeBlocks.rbegin()->first >= n
+              )
+           );
 }
 
 inline std::size_t SgUctAllocator::MaxNodes() const
@@ -700,9 +826,14 @@ inline std::size_t SgUctAllocator::MaxNodes() const
     return m_endOfStorage - m_start;
 }
 
+inline std::size_t SgUctAllocator::NuFreeNodes() const
+{
+    return m_nuFreeNodes;
+}
+
 inline std::size_t SgUctAllocator::NuNodes() const
 {
-    return m_finish - m_start;
+    return m_finish - m_start - m_nuFreeNodes;
 }
 
 inline const SgUctNode* SgUctAllocator::Start() const
@@ -781,6 +912,19 @@ public:
         @param maxNodes Maximum number of nodes */
     void SetMaxNodes(std::size_t maxNodes);
 
+    /** How the allocators get their storage.
+        Default is SG_UCTMEMORY_DEFAULT. */
+    SgUctMemoryMode MemoryMode() const;
+
+    /** See MemoryMode()
+        Reallocates the storage of the allocators (and clears the tree), if
+        allocators are already registered. */
+    void SetMemoryMode(SgUctMemoryMode mode);
+
+    /** Touch the storage of an allocator from the thread that will use it.
+        See SgUctAllocator::FirstTouch() */
+    void FirstTouch(std::size_t allocatorId);
+
     /** Swap content with another tree.
         The other tree must have the same number of allocators and
         the same maximum number of nodes. */
@@ -815,6 +959,19 @@ public:
                    double maxTime = std::numeric_limits<double>::max(),
                    SgUctValue minCount = 0) const;
 
+    /** Make a node of the tree the new root without copying the subtree.
+        The data and the child links of the node are copied to the root
+        node, the descendants stay where they are in the allocators.
+        Siblings of the node and of its ancestors become unreachable, but
+        their storage is not reclaimed until the tree is cleared, copied
+        (e.g. with CopyPruneLowCount()) or pruned with PruneLowCount(), so
+        NuNodes() will report more nodes than are reachable from the root. In contrast to
+        ExtractSubtree(), this takes constant time and never truncates the
+        subtree.
+        Must not be used while a search is running on the tree.
+        @param node The new root node. */
+    void PromoteSubtree(const SgUctNode& node);
+
     /** Get a copy of the tree with low count nodes pruned.
         The tree will be truncated if one of the allocators overflows (can
         happen due to reassigning nodes to different allocators), the given
@@ -829,6 +986,17 @@ public:
                    bool warnTruncate,
                    double maxTime = std::numeric_limits<double>::max()) const;
 
+    /** Prune nodes with low count in place.
+        Removes the children of all non-root nodes with a count below
+        minCount, like CopyPruneLowCount(), but without copying the tree.
+        All nodes that are no longer reachable from the root, including
+        the ones that became unreachable by previous operations like
+        PromoteSubtree(), ApplyFilter() or MergeChildren(), are reclaimed by
+        the allocators and reused for new nodes.
+        Must not be used while a search is running on the tree.
+        @param minCount The minimum count (SgUctNode::MoveCount()) */
+    void PruneLowCount(SgUctValue minCount);
+
     const SgUctNode& Root() const;
 
     std::size_t NuAllocators() const;
@@ -901,6 +1069,8 @@ public:
 private:
     std::size_t m_maxNodes;
 
+    SgUctMemoryMode m_memoryMode;
+
     SgUctNode m_root;
 
     /** Allocators.
@@ -917,6 +1087,12 @@ private:
 
     const SgUctAllocator& Allocator(std::size_t i) const;
 
+    void MarkChildren(const SgUctNode& node,
+                      std::vector<std::vector<bool> >& isMarked) const;
+
+    SgUctProvenType PruneSubtree(const SgUctNode& node, SgUctValue minCount,
+                                 std::vector<std::vector<bool> >& isMarked);
+
     SgUctProvenType CopySubtree(SgUctTree& target, SgUctNode& targetNode,
                                 const SgUctNode& node, SgUctValue minCount,
                                 std::size_t& currentAllocatorId, bool warnTruncate,
@@ -969,16 +1145,14 @@ inline void SgUctTree::CreateChildren(std::size_t allocatorId,
     // thread)
     SG_ASSERT(NuAllocators() > 1 || ! node.HasChildren());
 
-    const SgUctNode* firstChild = allocator.Finish();
-    
-    SgUctValue parentCount = allocator.Create(moves);
+    SgUctValue parentCount;
+    const SgUctNode* firstChild = allocator.Create(moves, parentCount);
 
     // Write order dependency: SgUctSearch in lock-free mode assumes that
-    // m_firstChild is valid if m_nuChildren is greater zero
+    // m_firstChild and the children are valid if m_nuChildren is greater
+    // zero (guaranteed by the release store in SetNuChildren())
     nonConstNode.SetPosCount(parentCount);
-    SgSynchronizeThreadMemory();
     nonConstNode.SetFirstChild(firstChild);
-    SgSynchronizeThreadMemory();
     nonConstNode.SetNuChildren(nuChildren);
 }
 
@@ -1080,6 +1254,16 @@ inline std::size_t SgUctTree::NuAllocators() const
     return m_allocators.size();
 }
 
+inline void SgUctTree::FirstTouch(std::size_t allocatorId)
+{
+    Allocator(allocatorId).FirstTouch();
+}
+
+inline SgUctMemoryMode SgUctTree::MemoryMode() const
+{
+    return m_memoryMode;
+}
+
 inline std::size_t SgUctTree::NuNodes(std::size_t allocatorId) const
 {
     return Allocator(allocatorId).NuNodes();
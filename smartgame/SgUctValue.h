@@ -10,6 +10,7 @@
 #include <limits>
 #include <boost/static_assert.hpp>
 #include "SgStatistics.h"
+#include "SgStatisticsAtomic.h"
 #include "SgStatisticsVlt.h"
 
 //----------------------------------------------------------------------------
@@ -36,6 +37,8 @@ typedef SgStatisticsBase<SgUctValue,SgUctValue> SgUctStatistics;
 
 typedef SgStatisticsVltBase<SgUctValue,SgUctValue> SgUctStatisticsVolatile;
 
+typedef SgStatisticsAtomicBase<SgUctValue,SgUctValue> SgUctStatisticsAtomic;
+
 //----------------------------------------------------------------------------
 
 namespace SgUctValueUtil
@@ -0,0 +1,83 @@
+//----------------------------------------------------------------------------
+/** @file SgBitboardTest.cpp
+    Unit tests for SgBitboard. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "SgBitboard.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(SgBitboardTest_IncludeExclude)
+{
+    SgBitboard set;
+    BOOST_CHECK(set.IsEmpty());
+    BOOST_CHECK_EQUAL(set.Size(), 0);
+    set.Include(0);
+    set.Include(63);
+    set.Include(64);
+    set.Include(SG_MAXPOINT - 1);
+    set.Include(64);
+    BOOST_CHECK_EQUAL(set.Size(), 4);
+    BOOST_CHECK(set.Contains(63));
+    BOOST_CHECK(set.Contains(64));
+    BOOST_CHECK(! set.Contains(65));
+    BOOST_CHECK_EQUAL(set.First(), 0);
+    set.Exclude(0);
+    set.Exclude(1);
+    BOOST_CHECK_EQUAL(set.Size(), 3);
+    BOOST_CHECK_EQUAL(set.First(), 63);
+    set.Clear();
+    BOOST_CHECK(set.IsEmpty());
+}
+
+BOOST_AUTO_TEST_CASE(SgBitboardTest_Iterator)
+{
+    SgBitboard set;
+    SgBitboard::Iterator it0(set);
+    BOOST_CHECK(! it0);
+    set.Include(SG_MAXPOINT - 1);
+    set.Include(200);
+    set.Include(5);
+    set.Include(6);
+    SgBitboard::Iterator it(set);
+    BOOST_REQUIRE(it);
+    BOOST_CHECK_EQUAL(*it, 5);
+    ++it;
+    BOOST_REQUIRE(it);
+    BOOST_CHECK_EQUAL(*it, 6);
+    ++it;
+    BOOST_REQUIRE(it);
+    BOOST_CHECK_EQUAL(*it, 200);
+    ++it;
+    BOOST_REQUIRE(it);
+    BOOST_CHECK_EQUAL(*it, SG_MAXPOINT - 1);
+    ++it;
+    BOOST_CHECK(! it);
+}
+
+BOOST_AUTO_TEST_CASE(SgBitboardTest_Operators)
+{
+    SgBitboard a;
+    a.Include(10);
+    a.Include(100);
+    SgBitboard b;
+    b.Include(100);
+    b.Include(300);
+    BOOST_CHECK_EQUAL(a.SizeOfIntersection(b), 1);
+    SgBitboard c = a;
+    BOOST_CHECK(c == a);
+    c |= b;
+    BOOST_CHECK(c != a);
+    BOOST_CHECK_EQUAL(c.Size(), 3);
+    c &= b;
+    BOOST_CHECK(c == b);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -0,0 +1,57 @@
+//----------------------------------------------------------------------------
+/** @file SgFenwickTreeTest.cpp
+    Unit tests for SgFenwickTree. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "SgFenwickTree.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(SgFenwickTreeTest_Find)
+{
+    SgFenwickTree<10> tree;
+    BOOST_CHECK_EQUAL(tree.Total(), 0.);
+    tree.Set(2, 1.);
+    tree.Set(5, 3.);
+    tree.Set(9, 0.5);
+    BOOST_CHECK_EQUAL(tree.Total(), 4.5);
+    BOOST_CHECK_EQUAL(tree.PrefixSum(1), 0.);
+    BOOST_CHECK_EQUAL(tree.PrefixSum(4), 1.);
+    BOOST_CHECK_EQUAL(tree.PrefixSum(8), 4.);
+    BOOST_CHECK_EQUAL(tree.Find(0.), 2);
+    BOOST_CHECK_EQUAL(tree.Find(0.99), 2);
+    BOOST_CHECK_EQUAL(tree.Find(1.), 5);
+    BOOST_CHECK_EQUAL(tree.Find(3.99), 5);
+    BOOST_CHECK_EQUAL(tree.Find(4.), 9);
+    BOOST_CHECK_EQUAL(tree.Find(4.49), 9);
+    BOOST_CHECK_EQUAL(tree.Find(10.), 9);
+}
+
+BOOST_AUTO_TEST_CASE(SgFenwickTreeTest_Set)
+{
+    SgFenwickTree<7> tree;
+    for (int i = 0; i < 7; ++i)
+        tree.Set(i, i + 1);
+    BOOST_CHECK_EQUAL(tree.Total(), 28.);
+    tree.Set(3, 0.);
+    BOOST_CHECK_EQUAL(tree.Get(3), 0.);
+    BOOST_CHECK_EQUAL(tree.Total(), 24.);
+    BOOST_CHECK_EQUAL(tree.PrefixSum(3), 6.);
+    BOOST_CHECK_EQUAL(tree.Find(5.5), 2);
+    BOOST_CHECK_EQUAL(tree.Find(6.), 4);
+    tree.Set(6, 1.);
+    BOOST_CHECK_EQUAL(tree.Total(), 18.);
+    BOOST_CHECK_EQUAL(tree.Find(17.5), 6);
+    tree.Clear();
+    BOOST_CHECK_EQUAL(tree.Total(), 0.);
+    BOOST_CHECK_EQUAL(tree.Get(6), 0.);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
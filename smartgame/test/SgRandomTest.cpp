@@ -37,6 +37,39 @@ BOOST_AUTO_TEST_CASE(SgRandomTestFloat)
     }
 }
 
+/** Test SG_RANDOM_XOSHIRO128 and the restoring of the default generator.
+    Checks that a seed produces the same sequence for each algorithm and that
+    the integers in an interval are in range and roughly uniform. */
+BOOST_AUTO_TEST_CASE(SgRandomTestGenerator)
+{
+    const int oldSeed = SgRandom::Seed();
+    SgRandom::SetSeed(42);
+    SgRandom mt;
+    const unsigned int mtFirst = mt.Int();
+    SgRandom::SetGenerator(SG_RANDOM_XOSHIRO128);
+    BOOST_CHECK_EQUAL(SgRandom::Generator(), SG_RANDOM_XOSHIRO128);
+    SgRandom r1;
+    SgRandom r2;
+    for (int i = 0; i < 1000; ++i)
+        BOOST_CHECK_EQUAL(r1.Int(), r2.Int());
+    const int range = 10;
+    int count[range] = { 0 };
+    for (int i = 0; i < 100000; ++i)
+    {
+        int j = r1.Int(range);
+        BOOST_REQUIRE(j >= 0 && j < range);
+        ++count[j];
+        BOOST_REQUIRE_LT(r1.SmallInt(range), range);
+        float f = r1.Float_01();
+        BOOST_REQUIRE(f >= 0.f && f < 1.f);
+    }
+    for (int j = 0; j < range; ++j)
+        BOOST_CHECK(count[j] > 9000 && count[j] < 11000);
+    SgRandom::SetGenerator(SG_RANDOM_MT19937);
+    BOOST_CHECK_EQUAL(mt.Int(), mtFirst);
+    SgRandom::SetSeed(oldSeed == 0 ? -1 : oldSeed);
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -8,6 +8,7 @@
 #include <boost/test/auto_unit_test.hpp>
 #include <boost/test/floating_point_comparison.hpp>
 #include "SgStatistics.h"
+#include "SgStatisticsAtomic.h"
 
 using namespace std;
 
@@ -71,6 +72,38 @@ BOOST_AUTO_TEST_CASE(SgStatisticsBaseTest_CheckRemove)
 
 //----------------------------------------------------------------------------
 
+/** Check that SgStatisticsAtomicBase computes the same values as
+    SgStatisticsBase. */
+BOOST_AUTO_TEST_CASE(SgStatisticsAtomicBaseTest_CheckAddRemoveCount)
+{
+    SgStatisticsAtomicBase<double,double> statistics;
+    BOOST_CHECK(! statistics.IsDefined());
+    statistics.Add(2., 1.);
+    BOOST_CHECK_CLOSE(statistics.Mean(), 2., 0.1);
+    statistics.Add(5., 0.5);
+    BOOST_CHECK_CLOSE(statistics.Mean(), 3., 0.1);
+    statistics.Add(1., 1.5);
+    BOOST_CHECK_CLOSE(statistics.Mean(), 2., 0.1);
+    statistics.Remove(0.5, 2.0);
+    BOOST_CHECK_CLOSE(statistics.Mean(), 5., 0.1);
+
+    SgStatisticsAtomicBase<double,double> copy(statistics);
+    BOOST_CHECK_EQUAL(copy.Count(), 1.0);
+    BOOST_CHECK_CLOSE(copy.Mean(), 5., 0.1);
+    copy.Remove(5.);
+    BOOST_CHECK(! copy.IsDefined());
+    copy = statistics;
+    BOOST_CHECK_CLOSE(copy.Mean(), 5., 0.1);
+
+    statistics.Initialize(0.25, 4.0);
+    BOOST_CHECK_EQUAL(statistics.Count(), 4.0);
+    BOOST_CHECK_CLOSE(statistics.Mean(), 0.25, 0.1);
+    statistics.Clear();
+    BOOST_CHECK(! statistics.IsDefined());
+}
+
+//----------------------------------------------------------------------------
+
 BOOST_AUTO_TEST_CASE(SgStatisticsTest_Basics)
 {
     typedef SgStatistics<double,std::size_t> Statistics;
@@ -0,0 +1,41 @@
+//----------------------------------------------------------------------------
+/** @file SgUctPhaseProfileTest.cpp
+    Unit tests for SgUctPhaseProfile. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "SgUctPhaseProfile.h"
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(SgUctPhaseProfileTest_SwitchPhase)
+{
+    SgUctPhaseProfile profile;
+    BOOST_CHECK_EQUAL(profile.TotalCycles(), 0u);
+    profile.Start(SG_UCTPHASE_SELECT);
+    profile.SwitchPhase(SG_UCTPHASE_PLAYOUT);
+    profile.SwitchPhase(SG_UCTPHASE_SELECT);
+    profile.SwitchPhase(SG_UCTPHASE_UPDATE);
+    BOOST_CHECK_EQUAL(profile.Count(SG_UCTPHASE_SELECT), 2u);
+    BOOST_CHECK_EQUAL(profile.Count(SG_UCTPHASE_PLAYOUT), 1u);
+    BOOST_CHECK_EQUAL(profile.Count(SG_UCTPHASE_UPDATE), 0u);
+    BOOST_CHECK_EQUAL(profile.TotalCycles(),
+                      profile.Cycles(SG_UCTPHASE_SELECT)
+                      + profile.Cycles(SG_UCTPHASE_PLAYOUT));
+    SgUctPhaseProfile sum;
+    sum.Add(profile);
+    sum.Add(profile);
+    BOOST_CHECK_EQUAL(sum.Count(SG_UCTPHASE_SELECT), 4u);
+    BOOST_CHECK_EQUAL(sum.TotalCycles(), 2 * profile.TotalCycles());
+    profile.Clear();
+    BOOST_CHECK_EQUAL(profile.Count(SG_UCTPHASE_SELECT), 0u);
+    BOOST_CHECK_EQUAL(profile.TotalCycles(), 0u);
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -74,7 +74,8 @@ class TestThreadState
     : public SgUctThreadState
 {
 public:
-    TestThreadState(unsigned int threadId, const vector<TestNode>& nodes);
+    TestThreadState(unsigned int threadId, const vector<TestNode>& nodes,
+                    int moveRange);
 
 
     /** @name Virtual functions of SgUctThreadState */
@@ -116,8 +117,9 @@ private:
 };
 
 TestThreadState::TestThreadState(unsigned int threadId,
-                                 const vector<TestNode>& nodes)
-    : SgUctThreadState(threadId),
+                                 const vector<TestNode>& nodes,
+                                 int moveRange)
+    : SgUctThreadState(threadId, moveRange),
       m_currentNode(0),
       m_toPlay(SG_BLACK),
       m_nodes(nodes)
@@ -251,23 +253,27 @@ class TestThreadStateFactory
     : public SgUctThreadStateFactory
 {
 public:
-    TestThreadStateFactory(const vector<TestNode>& nodes);
+    TestThreadStateFactory(const vector<TestNode>& nodes, int moveRange);
 
     SgUctThreadState* Create(unsigned int threadId, const SgUctSearch& search);
 
 private:
     const vector<TestNode>& m_nodes;
+
+    int m_moveRange;
 };
 
-TestThreadStateFactory::TestThreadStateFactory(const vector<TestNode>& nodes)
-    : m_nodes(nodes)
+TestThreadStateFactory::TestThreadStateFactory(const vector<TestNode>& nodes,
+                                               int moveRange)
+    : m_nodes(nodes),
+      m_moveRange(moveRange)
 { }
 
 SgUctThreadState* TestThreadStateFactory::Create(unsigned int threadId,
                                                  const SgUctSearch& search)
 {
     SG_UNUSED(search);
-    return new TestThreadState(threadId, m_nodes);
+    return new TestThreadState(threadId, m_nodes, m_moveRange);
 }
 
 //----------------------------------------------------------------------------
@@ -278,7 +284,10 @@ class TestUctSearch
     : public SgUctSearch
 {
 public:
-    TestUctSearch();
+    /** Constructor.
+        @param moveRange Must be larger than the largest move in the test
+        tree, if RAVE is used. */
+    TestUctSearch(int moveRange = 0);
 
     ~TestUctSearch();
 
@@ -311,8 +320,8 @@ private:
     void AddNode(size_t father, SgMove move, bool isLeaf, float eval);
 };
 
-TestUctSearch::TestUctSearch()
-    : SgUctSearch(new TestThreadStateFactory(m_nodes))
+TestUctSearch::TestUctSearch(int moveRange)
+    : SgUctSearch(new TestThreadStateFactory(m_nodes, moveRange), moveRange)
 { }
 
 TestUctSearch::~TestUctSearch()
@@ -636,6 +645,147 @@ BOOST_AUTO_TEST_CASE(SgUctSearchTest_Knowledge)
     }
 }
 
+/** Test that nodes are expanded with SgUctSearch::AsyncKnowledgeThreads().
+    Uses the same test tree as SgUctSearchTest_Simple. The root is expanded
+    by the search thread, the other nodes by the knowledge thread, which
+    runs concurrently, so only the final tree is checked. The terminal
+    positions are proven by the knowledge thread and the proven status is
+    propagated to the root like in SgUctSearchTest_Simple. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_AsyncKnowledge)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    search.SetAsyncKnowledgeThreads(1);
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    search.AddNode(0, 1);
+    search.AddNode(0, 2);
+    search.AddNode(0, 3);
+    search.AddNode(0, 4);
+    search.AddLeafNode(1, 5, 0.f);
+    search.AddLeafNode(1, 6, 1.f);
+    search.AddLeafNode(2, 7, 1.f);
+    search.AddLeafNode(2, 8, 1.f);
+    search.AddLeafNode(3, 9, 1.f);
+    search.AddLeafNode(3, 10, 0.f);
+    search.AddLeafNode(4, 11, 0.f);
+    search.AddLeafNode(4, 12, 0.f);
+
+    search.StartSearch();
+    search.PlayGame();
+    search.PlayGame();
+    const SgUctTree& tree = search.Tree();
+    BOOST_CHECK_EQUAL(5u, tree.NuNodes());
+    for (int i = 0; i < 100000 && ! tree.Root().IsProven(); ++i)
+    {
+        search.PlayGame();
+        boost::this_thread::yield();
+    }
+    BOOST_CHECK_EQUAL(SG_PROVEN_WIN, tree.Root().ProvenType());
+    const SgUctNode* node = GetNode(tree, 2);
+    BOOST_CHECK_EQUAL(2, node->NuChildren());
+    BOOST_CHECK_EQUAL(SG_PROVEN_LOSS, node->ProvenType());
+    for (SgUctChildIterator it(tree, *node); it; ++it)
+        BOOST_CHECK_EQUAL(SG_PROVEN_WIN, (*it).ProvenType());
+}
+
+/** Build the test tree of SgUctSearchTest_Simple. */
+void AddSimpleTree(TestUctSearch& search)
+{
+    search.AddNode(NO_NODE, SG_NULLMOVE);
+    search.AddNode(0, 1);
+    search.AddNode(0, 2);
+    search.AddNode(0, 3);
+    search.AddNode(0, 4);
+    search.AddLeafNode(1, 5, 0.f);
+    search.AddLeafNode(1, 6, 1.f);
+    search.AddLeafNode(2, 7, 1.f);
+    search.AddLeafNode(2, 8, 1.f);
+    search.AddLeafNode(3, 9, 1.f);
+    search.AddLeafNode(3, 10, 0.f);
+    search.AddLeafNode(4, 11, 0.f);
+    search.AddLeafNode(4, 12, 0.f);
+}
+
+/** Test SgUctSearch::AsyncKnowledgeThreads() with a full request queue.
+    With SgUctSearch::MaxKnowledgeRequests() zero, all requests are dropped
+    and the search thread must expand the nodes itself, so the search
+    builds the same tree as without knowledge threads. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_AsyncKnowledgeQueueFull)
+{
+    TestUctSearch search;
+    search.SetExpandThreshold(1);
+    AddSimpleTree(search);
+    TestUctSearch asyncSearch;
+    asyncSearch.SetExpandThreshold(1);
+    asyncSearch.SetAsyncKnowledgeThreads(1);
+    asyncSearch.SetMaxKnowledgeRequests(0);
+    AddSimpleTree(asyncSearch);
+
+    search.StartSearch();
+    asyncSearch.StartSearch();
+    const SgUctTree& tree = search.Tree();
+    const SgUctTree& asyncTree = asyncSearch.Tree();
+    for (int i = 0; i < 20; ++i)
+    {
+        search.PlayGame();
+        asyncSearch.PlayGame();
+        BOOST_CHECK_EQUAL(asyncTree.NuNodes(), tree.NuNodes());
+        BOOST_CHECK_EQUAL(asyncTree.Root().MoveCount(),
+                          tree.Root().MoveCount());
+    }
+    // Leaves below the expand threshold are not evaluated with
+    // GenerateAllMoves() with knowledge threads, so the proven status can
+    // reach the root some games later
+    BOOST_CHECK_EQUAL(SG_PROVEN_WIN, tree.Root().ProvenType());
+    BOOST_CHECK_EQUAL(SG_PROVEN_WIN, asyncTree.Root().ProvenType());
+    BOOST_CHECK(asyncSearch.Statistics().m_knowledgeRequestsDropped > 0);
+}
+
+/** Test the aggregated RAVE update of SgUctSearch::NumberPlayouts() > 1.
+    The playouts of the test tree are deterministic, so the aggregated
+    update of three identical playouts must give the same RAVE values as
+    a single playout with three times the RAVE count. */
+BOOST_AUTO_TEST_CASE(SgUctSearchTest_NumberPlayoutsRave)
+{
+    TestUctSearch search1(13);
+    TestUctSearch search3(13);
+    AddSimpleTree(search1);
+    AddSimpleTree(search3);
+    search1.SetRave(true);
+    search3.SetRave(true);
+    search1.SetExpandThreshold(1);
+    search3.SetExpandThreshold(1);
+    search3.SetNumberPlayouts(3);
+    search1.StartSearch();
+    search3.StartSearch();
+    for (int i = 0; i < 8; ++i)
+    {
+        search1.PlayGame();
+        search3.PlayGame();
+    }
+    const SgUctTree& tree1 = search1.Tree();
+    const SgUctTree& tree3 = search3.Tree();
+    BOOST_REQUIRE_EQUAL(tree1.NuNodes(), tree3.NuNodes());
+    int nuRaveValues = 0;
+    for (SgMove move = 1; move <= 4; ++move)
+    {
+        const SgUctNode* node1 = GetNode(tree1, move);
+        const SgUctNode* node3 = GetNode(tree3, move);
+        BOOST_REQUIRE(node1 != 0);
+        BOOST_REQUIRE(node3 != 0);
+        BOOST_CHECK_EQUAL(node1->MoveCount(), node3->MoveCount());
+        BOOST_CHECK_CLOSE(3 * node1->RaveCount(), node3->RaveCount(),
+                          1e-3f);
+        if (node1->HasRaveValue())
+        {
+            BOOST_CHECK_CLOSE(node1->RaveValue(), node3->RaveValue(),
+                              1e-3f);
+            ++nuRaveValues;
+        }
+    }
+    BOOST_CHECK(nuRaveValues > 0);
+}
+
 //----------------------------------------------------------------------------
 
 } // namespace
@@ -0,0 +1,66 @@
+//----------------------------------------------------------------------------
+/** @file SgUctTranspositionTableTest.cpp
+    Unit tests for SgUctTranspositionTable. */
+//----------------------------------------------------------------------------
+
+#include "SgSystem.h"
+
+#include <boost/test/auto_unit_test.hpp>
+#include "SgUctTranspositionTable.h"
+
+using namespace std;
+
+//----------------------------------------------------------------------------
+
+namespace {
+
+BOOST_AUTO_TEST_CASE(SgUctTranspositionTableTest_Add)
+{
+    SgUctTranspositionTable table(16);
+    SgHashCode hash1(1);
+    SgHashCode hash2(2);
+    SgUctValue value;
+    SgUctValue count;
+    BOOST_CHECK(! table.Lookup(hash1, value, count));
+    table.Add(hash1, 1, 1);
+    table.Add(hash1, 0, 3);
+    BOOST_REQUIRE(table.Lookup(hash1, value, count));
+    BOOST_CHECK_EQUAL(count, SgUctValue(4));
+    BOOST_CHECK_EQUAL(value, SgUctValue(0.25));
+    BOOST_CHECK(! table.Lookup(hash2, value, count));
+    table.Clear();
+    BOOST_CHECK(! table.Lookup(hash1, value, count));
+}
+
+/** Test that a position replaces another position stored in the same
+    entry. */
+BOOST_AUTO_TEST_CASE(SgUctTranspositionTableTest_Replace)
+{
+    SgUctTranspositionTable table(1);
+    SgHashCode hash1(1);
+    SgHashCode hash2(2);
+    table.Add(hash1, 1, 5);
+    table.Add(hash2, 0, 2);
+    SgUctValue value;
+    SgUctValue count;
+    BOOST_CHECK(! table.Lookup(hash1, value, count));
+    BOOST_REQUIRE(table.Lookup(hash2, value, count));
+    BOOST_CHECK_EQUAL(count, SgUctValue(2));
+    BOOST_CHECK_EQUAL(value, SgUctValue(0));
+}
+
+/** Test that an empty table stores nothing. */
+BOOST_AUTO_TEST_CASE(SgUctTranspositionTableTest_Empty)
+{
+    SgUctTranspositionTable table;
+    BOOST_CHECK_EQUAL(table.MaxEntries(), 0u);
+    SgHashCode hash(1);
+    table.Add(hash, 1, 1);
+    SgUctValue value;
+    SgUctValue count;
+    BOOST_CHECK(! table.Lookup(hash, value, count));
+}
+
+} // namespace
+
+//----------------------------------------------------------------------------
@@ -48,6 +48,39 @@ BOOST_AUTO_TEST_CASE(SgUctMoveInfo_Add_2)
     BOOST_CHECK_EQUAL(info.m_raveCount, 4);
 }
 
+/** Test that copying a node copies all data including the children
+    information. */
+BOOST_AUTO_TEST_CASE(SgUctNodeTest_Copy)
+{
+    SgUctMoveInfo info(10, 0.3, 5, 0.6, 7);
+    info.m_predictorValue = 0.5;
+    SgUctNode child(SG_NULLMOVE);
+    SgUctNode node(info);
+    node.SetFirstChild(&child);
+    node.SetNuChildren(1);
+    node.SetPosCount(3);
+    node.SetKnowledgeCount(4);
+    node.SetProvenType(SG_PROVEN_WIN);
+    node.AddVirtualLoss();
+    SgUctNode copy(node);
+    BOOST_CHECK_EQUAL(copy.Move(), 10);
+    BOOST_CHECK_CLOSE(copy.Mean(), 0.3, EPSILON);
+    BOOST_CHECK_EQUAL(copy.MoveCount(), 5);
+    BOOST_CHECK_CLOSE(copy.RaveValue(), 0.6, EPSILON);
+    BOOST_CHECK_EQUAL(copy.RaveCount(), 7);
+    BOOST_CHECK_CLOSE(copy.PredictorValue(), 0.5f, EPSILON);
+    BOOST_CHECK_EQUAL(copy.PosCount(), 3);
+    BOOST_CHECK_EQUAL(copy.KnowledgeCount(), 4);
+    BOOST_CHECK(copy.IsProvenWin());
+    BOOST_CHECK_EQUAL(copy.VirtualLossCount(), 1);
+    BOOST_CHECK_EQUAL(copy.NuChildren(), 1);
+    BOOST_CHECK_EQUAL(copy.FirstChild(), &child);
+    copy = SgUctNode(SG_NULLMOVE);
+    BOOST_CHECK(! copy.HasMove());
+    BOOST_CHECK(! copy.HasMean());
+    BOOST_CHECK(! copy.HasChildren());
+    BOOST_CHECK_EQUAL(copy.VirtualLossCount(), 0);
+}
 
 /** Test SgUctTreeIterator on a small tree. */
 BOOST_AUTO_TEST_CASE(SgUctTreeIteratorTest_Simple)
@@ -140,6 +173,134 @@ BOOST_AUTO_TEST_CASE(SgUctTreeIteratorTest_ApplyFilter)
     BOOST_CHECK_CLOSE((*it).Mean(), SgUctValue(0.5), 1e-4);
 }
 
+/** Test SgUctTree::PromoteSubtree() */
+BOOST_AUTO_TEST_CASE(SgUctTreeTest_PromoteSubtree)
+{
+    SgUctTree tree;
+    tree.CreateAllocators(1);
+    tree.SetMaxNodes(10);
+    vector<SgUctMoveInfo> moves;
+    moves.push_back(SgUctMoveInfo(10));
+    moves.push_back(SgUctMoveInfo(20));
+    const SgUctNode& root = tree.Root();
+    tree.CreateChildren(0, root, moves);
+    const SgUctNode& node2 = *FindChildWithMove(tree, root, 20);
+    moves.clear();
+    moves.push_back(SgUctMoveInfo(30));
+    moves.push_back(SgUctMoveInfo(40));
+    tree.CreateChildren(0, node2, moves);
+    const SgUctNode& node3 = *FindChildWithMove(tree, node2, 30);
+    tree.AddGameResult(node2, &root, 1.f);
+    tree.AddGameResult(node3, &node2, 0.f);
+    tree.PromoteSubtree(node2);
+    BOOST_CHECK_EQUAL(root.Move(), 20);
+    BOOST_CHECK_EQUAL(root.MoveCount(), 1u);
+    BOOST_CHECK_EQUAL(root.PosCount(), 1u);
+    BOOST_CHECK_EQUAL(root.NuChildren(), 2);
+    // Children are not copied
+    BOOST_CHECK_EQUAL(root.FirstChild(), &node3);
+    BOOST_CHECK_EQUAL(node3.MoveCount(), 1u);
+    // Unreachable nodes are not reclaimed
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 5u);
+    int nuNodes = 0;
+    for (SgUctTreeIterator it(tree); it; ++it)
+        ++nuNodes;
+    BOOST_CHECK_EQUAL(nuNodes, 3);
+}
+
+/** Test SgUctTree::PruneLowCount() and the reuse of reclaimed nodes. */
+BOOST_AUTO_TEST_CASE(SgUctTreeTest_PruneLowCount)
+{
+    SgUctTree tree;
+    tree.CreateAllocators(1);
+    tree.SetMaxNodes(6);
+    vector<SgUctMoveInfo> moves;
+    moves.push_back(SgUctMoveInfo(10));
+    moves.push_back(SgUctMoveInfo(20));
+    const SgUctNode& root = tree.Root();
+    tree.CreateChildren(0, root, moves);
+    const SgUctNode& node1 = *FindChildWithMove(tree, root, 10);
+    const SgUctNode& node2 = *FindChildWithMove(tree, root, 20);
+    moves.clear();
+    moves.push_back(SgUctMoveInfo(30));
+    moves.push_back(SgUctMoveInfo(40));
+    tree.CreateChildren(0, node1, moves);
+    moves.clear();
+    moves.push_back(SgUctMoveInfo(50));
+    moves.push_back(SgUctMoveInfo(60));
+    tree.CreateChildren(0, node2, moves);
+    tree.AddGameResult(node1, &root, 1.f);
+    tree.AddGameResult(node1, &root, 1.f);
+    tree.AddGameResult(node2, &root, 0.f);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 7u);
+    BOOST_CHECK(! tree.HasCapacity(0, 1));
+
+    tree.PruneLowCount(2);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 5u);
+    BOOST_CHECK_EQUAL(node1.NuChildren(), 2);
+    BOOST_CHECK(! node2.HasChildren());
+    BOOST_CHECK_EQUAL(node2.MoveCount(), 1u);
+    BOOST_CHECK(tree.HasCapacity(0, 2));
+    BOOST_CHECK(! tree.HasCapacity(0, 3));
+
+    // Reclaimed nodes are reused for new children
+    moves.clear();
+    moves.push_back(SgUctMoveInfo(70));
+    tree.CreateChildren(0, node2, moves);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 6u);
+    BOOST_CHECK_EQUAL(FindChildWithMove(tree, node2, 70)->Move(), 70);
+    BOOST_CHECK(tree.HasCapacity(0, 1));
+    BOOST_CHECK(! tree.HasCapacity(0, 2));
+    int nuNodes = 0;
+    for (SgUctTreeIterator it(tree); it; ++it)
+        ++nuNodes;
+    BOOST_CHECK_EQUAL(nuNodes, 6);
+}
+
+/** Test that SgUctTree::PruneLowCount() reclaims nodes that became
+    unreachable by SgUctTree::PromoteSubtree(). */
+BOOST_AUTO_TEST_CASE(SgUctTreeTest_PruneLowCount_Unreachable)
+{
+    SgUctTree tree;
+    tree.CreateAllocators(1);
+    tree.SetMaxNodes(10);
+    vector<SgUctMoveInfo> moves;
+    moves.push_back(SgUctMoveInfo(10));
+    moves.push_back(SgUctMoveInfo(20));
+    const SgUctNode& root = tree.Root();
+    tree.CreateChildren(0, root, moves);
+    const SgUctNode& node2 = *FindChildWithMove(tree, root, 20);
+    moves.clear();
+    moves.push_back(SgUctMoveInfo(30));
+    tree.CreateChildren(0, node2, moves);
+    tree.PromoteSubtree(node2);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 4u);
+    tree.PruneLowCount(0);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 2u);
+    BOOST_CHECK_EQUAL(root.Move(), 20);
+    BOOST_CHECK_EQUAL(FindChildWithMove(tree, root, 30)->Move(), 30);
+}
+
+/** Test that a tree works with storage allocated in huge page mode. */
+BOOST_AUTO_TEST_CASE(SgUctTreeTest_MemoryMode)
+{
+    SgUctTree tree;
+    tree.CreateAllocators(2);
+    tree.SetMaxNodes(100000);
+    tree.SetMemoryMode(SG_UCTMEMORY_HUGEPAGES);
+    BOOST_CHECK_EQUAL(tree.MemoryMode(), SG_UCTMEMORY_HUGEPAGES);
+    BOOST_CHECK_EQUAL(tree.MaxNodes(), 100000u);
+    tree.FirstTouch(0);
+    tree.FirstTouch(1);
+    vector<SgUctMoveInfo> moves;
+    moves.push_back(SgUctMoveInfo(10));
+    moves.push_back(SgUctMoveInfo(20));
+    tree.CreateChildren(1, tree.Root(), moves);
+    BOOST_CHECK_EQUAL(tree.NuNodes(), 3u);
+    BOOST_CHECK_EQUAL(FindChildWithMove(tree, tree.Root(), 20)->Move(), 20);
+    BOOST_CHECK(tree.HasCapacity(0, 50000));
+}
+
 } // namespace
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,145 @@
+#!/usr/bin/perl -w
+
+# Measures the playout throughput of GoUctBoard (or GoUctBitBoard for the
+# configurations with bit_board) and GoUctPlayoutPolicy with
+# the command fuegotest_playout_benchmark of fuego_test for a fixed set of
+# positions, policy configurations and numbers of threads. Writes the
+# results as CSV to stdout, such that the results of different versions can
+# be compared. Must be run in the regression directory, because the
+# positions use relative paths to the SGF files.
+
+use Getopt::Long;
+use File::Temp qw/ tempfile /;
+
+$verbose = 0;
+
+$program = "../fuegotest/fuego_test";
+$playouts = 10000;
+$threads = "1,2,4";
+
+# Positions: name, SGF file (empty for an empty board), move number or
+# board size of the empty board
+@positions = (
+    [ "empty9", "", 9 ],
+    [ "game9", "sgf/games/2009/CGOS/703006.sgf", 30 ],
+    [ "empty13", "", 13 ],
+    [ "game13", "sgf/lifeanddeath/nakade-6pts-realgame.sgf", 0 ],
+    [ "empty19", "", 19 ],
+    [ "game19", "sgf/games/2014/Fuego-GnuGo-2014-10-26.sgf", 100 ],
+);
+
+# Policy configurations: name, fuegotest_param_playout settings
+@configs = (
+    [ "gamma", "use_patterns_in_playout 1" ],
+    [ "pattern", "use_patterns_in_playout 0" ],
+    [ "nakade", "use_patterns_in_playout 1\nnakade_heuristic 1" ],
+    [ "fillboard", "use_patterns_in_playout 1\nfillboard_tries 5" ],
+    [ "global", "use_global_gamma_playout 1" ],
+    [ "gamma-bit", "use_patterns_in_playout 1\nbit_board 1" ],
+    [ "pattern-bit", "use_patterns_in_playout 0\nbit_board 1" ],
+);
+
+
+sub printUsage {
+    print STDERR "Usage: fuego-playout-benchmark [options]\n";
+    print STDERR "  Options\n";
+    print STDERR "    --playouts <n>     Number of playouts per run. (default $playouts)\n";
+    print STDERR "    --threads <list>   Comma-separated numbers of threads. The first\n";
+    print STDERR "                       is the baseline for the scaling efficiency.\n";
+    print STDERR "                       (default $threads)\n";
+    print STDERR "    --types            Write the number of moves and time per move\n";
+    print STDERR "                       type of the policy instead of the throughput.\n";
+    print STDERR "    --program <path>   Path to the fuego_test executable.\n";
+    print STDERR "    --verbose          Display fuego_test's output.\n";
+    print STDERR "    --help             Displays this help message.\n";
+    exit 0;
+}
+
+
+GetOptions('verbose' => \$verbose,
+	   'program=s' => \$program,
+           'playouts=i' => \$playouts,
+           'threads=s' => \$threads,
+           'types' => \$types,
+           'help' => \$help);
+
+if ($help) {
+    printUsage();
+}
+
+@threadList = split(/,/, $threads);
+
+if ($types) {
+    print STDOUT "position,config,size,type,moves,fraction,time_fraction,ns_per_move\n";
+}
+else {
+    print STDOUT "position,config,size,threads,playouts,moves,time,playouts_per_s,moves_per_s,efficiency\n";
+}
+
+foreach $position (@positions) {
+    ($positionName, $file, $arg) = @$position;
+    foreach $config (@configs) {
+	($configName, $settings) = @$config;
+	print STDERR "$positionName $configName...\n";
+	my ($CONFIG, $configFilename) = tempfile( UNLINK=> 1 );
+	if ($file eq "") {
+	    print $CONFIG "boardsize $arg\n";
+	    print $CONFIG "clear_board\n";
+	}
+	elsif ($arg > 0) {
+	    print $CONFIG "loadsgf $file $arg\n";
+	}
+	else {
+	    print $CONFIG "loadsgf $file\n";
+	}
+	foreach $setting (split(/\n/, $settings)) {
+	    print $CONFIG "fuegotest_param_playout $setting\n";
+	}
+	print $CONFIG "fuegotest_playout_benchmark $playouts @threadList\n";
+	close($CONFIG);
+
+	$size = 0;
+	$nuResults = 0;
+	open(FUEGO, "$program --srand 1 <$configFilename 2>&1 |");
+	while (<FUEGO>) {
+	    if ($verbose) {
+		print STDERR $_;
+	    }
+	    chomp($_);
+	    $_ =~ s/^= //;
+	    if ($_ =~ /^\? (.*)/) {
+		die "$positionName $configName: $1\n";
+	    }
+	    my @fields = split(/ /, $_);
+	    if (@fields % 2 != 0) {
+		next;
+	    }
+	    my %values = @fields;
+	    if (exists $values{"size"}) {
+		$size = $values{"size"};
+	    }
+	    elsif (exists $values{"threads"}) {
+		++$nuResults;
+		if (! $types) {
+		    print STDOUT join(",", $positionName, $configName, $size,
+				      $values{"threads"}, $values{"playouts"},
+				      $values{"moves"}, $values{"time"},
+				      $values{"playouts/s"},
+				      $values{"moves/s"},
+				      $values{"efficiency"}), "\n";
+		}
+	    }
+	    elsif (exists $values{"type"} && $types) {
+		print STDOUT join(",", $positionName, $configName, $size,
+				  $values{"type"}, $values{"moves"},
+				  $values{"fraction"},
+				  $values{"time_fraction"},
+				  $values{"ns/move"}), "\n";
+	    }
+	}
+	close(FUEGO);
+	if ($nuResults != @threadList) {
+	    die "$positionName $configName: could not find results in output\n";
+	}
+    }
+}
@@ -0,0 +1,114 @@
+#!/usr/bin/perl -w
+
+# Runs the positions of regression test files with a fixed number of games
+# per search and reports how many games the search got from transposed
+# nodes with "uct_param_search transpositions 1" (see
+# SgUctSearch::Transpositions). Must be run in the regression directory,
+# because the test files use relative paths to the SGF files.
+
+use Getopt::Long;
+use File::Temp qw/ tempfile /;
+
+$verbose = 0;
+
+$program = "../fuegomain/fuego";
+$games = 10000;
+$threads = 1;
+$list = "performance.list";
+
+
+sub printUsage {
+    print STDERR "Usage: fuego-transposition-test [options] [testfile...]\n";
+    print STDERR "  Options\n";
+    print STDERR "    --games <n>        Number of games per search. (default $games)\n";
+    print STDERR "    --threads <n>      Number of threads. (default $threads)\n";
+    print STDERR "    --list <file>      List of test files, used if no test files\n";
+    print STDERR "                       are given. (default $list)\n";
+    print STDERR "    --program <path>   Path to the Fuego executable.\n";
+    print STDERR "    --verbose          Display Fuego's output.\n";
+    print STDERR "    --help             Displays this help message.\n";
+    exit 0;
+}
+
+
+GetOptions('verbose' => \$verbose,
+	   'program=s' => \$program,
+           'games=i' => \$games,
+           'threads=i' => \$threads,
+           'list=s' => \$list,
+           'help' => \$help);
+
+if ($help) {
+    printUsage();
+}
+
+@files = @ARGV;
+if (! @files) {
+    open(LIST, "< $list") or die "Cannot open $list\n";
+    while (<LIST>) {
+	chomp($_);
+	if ($_ =~ /^([^#@\s]\S*\.tst)\s*$/) {
+	    push(@files, $1);
+	}
+    }
+    close(LIST);
+}
+
+# Run all searches of a test file and return the number of games played,
+# the number of transpositions and the number of games from transpositions
+sub runTest {
+    my ($file, $transpositions) = @_;
+    my ($CONFIG, $configFilename) = tempfile( UNLINK=> 1 );
+    print $CONFIG "book_clear\n";
+    print $CONFIG "uct_param_player ignore_clock 1\n";
+    print $CONFIG "uct_param_player max_games $games\n";
+    print $CONFIG "uct_param_player reuse_subtree 0\n";
+    print $CONFIG "uct_param_search number_threads $threads\n";
+    print $CONFIG "uct_param_search transpositions $transpositions\n";
+    open(TEST, "< $file") or die "Cannot open $file\n";
+    while (<TEST>) {
+	print $CONFIG $_;
+    }
+    close(TEST);
+    close($CONFIG);
+
+    my $count = 0;
+    my $nuTranspositions = 0;
+    my $transpositionGames = 0;
+    open(FUEGO, "$program --srand 1 <$configFilename 2>&1 |");
+    while (<FUEGO>) {
+	if ($verbose) {
+	    print $_;
+	}
+	chomp($_);
+	if ($_ =~ /^Count\s+(\S+)/) {
+	    $count += $1;
+	}
+	elsif ($_ =~ /^Transpos\s+(\S+) \((\S+) games\)/) {
+	    $nuTranspositions += $1;
+	    $transpositionGames += $2;
+	}
+    }
+    close(FUEGO);
+    return ($count, $nuTranspositions, $transpositionGames);
+}
+
+$totalGames = 0;
+$totalGamesTransposition = 0;
+$totalSaved = 0;
+foreach $file (@files) {
+    print STDERR "$file...\n";
+    ($count) = runTest($file, 0);
+    ($countT, $nuTranspositions, $saved) = runTest($file, 1);
+    $totalGames += $count;
+    $totalGamesTransposition += $countT;
+    $totalSaved += $saved;
+    printf STDOUT "%-40s games %8d %8d  transpositions %7d  saved %8d (%.1f%%)\n",
+        $file, $count, $countT, $nuTranspositions, $saved,
+        $countT > 0 ? 100 * $saved / $countT : 0;
+}
+
+printf STDOUT "%-40s games %8d %8d  saved %8d (%.1f%%)\n",
+    "Total", $totalGames, $totalGamesTransposition, $totalSaved,
+    $totalGamesTransposition > 0 ?
+    100 * $totalSaved / $totalGamesTransposition : 0;